@@ -0,0 +1,36 @@
+include_guard (DIRECTORY)
+
+ccl_find_path (lz4_DIR NAMES "lib/lz4frame.h" HINTS "${CCL_SUBMODULES_DIR}/lz4" DOC "LZ4 directory")
+mark_as_advanced (lz4_DIR)
+
+if (NOT lz4_DIR)
+	message (STATUS "Warning: LZ4 not found! Building without LZ4 compression support.")
+	return ()
+endif ()
+
+list (APPEND lz4_sources
+	${lz4_DIR}/lib/lz4.c
+	${lz4_DIR}/lib/lz4.h
+	${lz4_DIR}/lib/lz4frame.c
+	${lz4_DIR}/lib/lz4frame.h
+	${lz4_DIR}/lib/lz4hc.c
+	${lz4_DIR}/lib/lz4hc.h
+	${lz4_DIR}/lib/xxhash.c
+	${lz4_DIR}/lib/xxhash.h
+)
+source_group ("libs\\lz4" FILES ${lz4_sources})
+
+if (NOT TARGET lz4)
+	ccl_add_library (lz4 INTERFACE)
+	target_sources (lz4 INTERFACE ${lz4_sources})
+	target_include_directories (lz4 INTERFACE ${lz4_DIR}/lib)
+	target_compile_definitions (lz4 INTERFACE XXH_NAMESPACE=LZ4_)
+endif ()
+
+set (lz4_INCLUDE_DIR ${lz4_DIR}/lib)
+set (lz4_LIBRARY lz4)
+
+include (FindPackageHandleStandardArgs)
+find_package_handle_standard_args (lz4
+	REQUIRED_VARS lz4_LIBRARY
+)
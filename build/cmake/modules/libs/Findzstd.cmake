@@ -0,0 +1,59 @@
+include_guard (DIRECTORY)
+
+ccl_find_path (zstd_DIR NAMES "lib/zstd.h" HINTS "${CCL_SUBMODULES_DIR}/zstd" DOC "Zstandard directory")
+mark_as_advanced (zstd_DIR)
+
+if (NOT zstd_DIR)
+	message (STATUS "Warning: Zstandard not found! Building without zstd compression support.")
+	return ()
+endif ()
+
+list (APPEND zstd_sources
+	${zstd_DIR}/lib/zstd.h
+	${zstd_DIR}/lib/zdict.h
+	${zstd_DIR}/lib/common/debug.c
+	${zstd_DIR}/lib/common/entropy_common.c
+	${zstd_DIR}/lib/common/error_private.c
+	${zstd_DIR}/lib/common/fse_decompress.c
+	${zstd_DIR}/lib/common/pool.c
+	${zstd_DIR}/lib/common/threading.c
+	${zstd_DIR}/lib/common/xxhash.c
+	${zstd_DIR}/lib/common/zstd_common.c
+	${zstd_DIR}/lib/compress/fse_compress.c
+	${zstd_DIR}/lib/compress/hist.c
+	${zstd_DIR}/lib/compress/huf_compress.c
+	${zstd_DIR}/lib/compress/zstd_compress.c
+	${zstd_DIR}/lib/compress/zstd_compress_literals.c
+	${zstd_DIR}/lib/compress/zstd_compress_sequences.c
+	${zstd_DIR}/lib/compress/zstd_compress_superblock.c
+	${zstd_DIR}/lib/compress/zstd_double_fast.c
+	${zstd_DIR}/lib/compress/zstd_fast.c
+	${zstd_DIR}/lib/compress/zstd_lazy.c
+	${zstd_DIR}/lib/compress/zstd_ldm.c
+	${zstd_DIR}/lib/compress/zstd_opt.c
+	${zstd_DIR}/lib/compress/zstd_preSplit.c
+	${zstd_DIR}/lib/decompress/huf_decompress.c
+	${zstd_DIR}/lib/decompress/zstd_ddict.c
+	${zstd_DIR}/lib/decompress/zstd_decompress.c
+	${zstd_DIR}/lib/decompress/zstd_decompress_block.c
+	${zstd_DIR}/lib/dictBuilder/cover.c
+	${zstd_DIR}/lib/dictBuilder/divsufsort.c
+	${zstd_DIR}/lib/dictBuilder/fastcover.c
+	${zstd_DIR}/lib/dictBuilder/zdict.c
+)
+source_group ("libs\\zstd" FILES ${zstd_sources})
+
+if (NOT TARGET zstd)
+	ccl_add_library (zstd INTERFACE)
+	target_sources (zstd INTERFACE ${zstd_sources})
+	target_include_directories (zstd INTERFACE ${zstd_DIR}/lib)
+	target_compile_definitions (zstd INTERFACE ZSTD_DISABLE_ASM=1 ZSTD_LEGACY_SUPPORT=0)
+endif ()
+
+set (zstd_INCLUDE_DIR ${zstd_DIR}/lib)
+set (zstd_LIBRARY zstd)
+
+include (FindPackageHandleStandardArgs)
+find_package_handle_standard_args (zstd
+	REQUIRED_VARS zstd_LIBRARY
+)
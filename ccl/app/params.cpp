@@ -1114,40 +1114,35 @@ END_METHOD_NAMES (ListParam)
 
 tbool CCL_API ListParam::invokeMethod (Variant& returnValue, MessageRef msg)
 {
-	if(msg == "appendString")
+	MEMBER_SWITCH (msg.getID ())
 	{
+	MEMBER_CASE ("appendString")
 		appendString (msg[0].asString ());
 		return true;
-	}
-	else if(msg == "appendValue")
-	{
+
+	MEMBER_CASE ("appendValue")
 		appendValue (msg[0]);
 		return true;
-	}
-	else if(msg == "removeAll")
-	{
+
+	MEMBER_CASE ("removeAll")
 		removeAll ();
 		return true;
-	}
-	else if(msg == "getValueAt")
-	{
+
+	MEMBER_CASE ("getValueAt")
 		returnValue = getValueAt (msg[0].asInt ());
 		returnValue.share ();
 		return true;
-	}
-	else if(msg == "getSelectedValue")
-	{
+
+	MEMBER_CASE ("getSelectedValue")
 		returnValue = getSelectedValue ();
 		returnValue.share ();
 		return true;
-	}
-	else if(msg == "selectValue")
-	{
+
+	MEMBER_CASE ("selectValue")
 		selectValue (msg[0], msg.getArgCount () > 1 ? msg[1].asBool () : false);
 		return true;
 	}
-	else
-		return SuperClass::invokeMethod (returnValue, msg);
+	return SuperClass::invokeMethod (returnValue, msg);
 }
 
 //************************************************************************************************
@@ -2494,58 +2489,54 @@ END_PROPERTY_NAMES (Parameter)
 
 tbool CCL_API Parameter::getProperty (Variant& var, MemberID propertyId) const
 {
-	if(propertyId == "type")
+	MEMBER_SWITCH (propertyId)
 	{
+	MEMBER_CASE ("type")
 		var = getType ();
 		return true;
-	}
-	else if(propertyId == "value")
-	{
+
+	MEMBER_CASE ("value")
 		var = getValue ();
 		return true;
-	}
-	else if(propertyId == "min")
-	{
+
+	MEMBER_CASE ("min")
 		var = getMin ();
 		return true;
-	}
-	else if(propertyId == "max")
-	{
+
+	MEMBER_CASE ("max")
 		var = getMax ();
 		return true;
-	}
-	else if(propertyId == "default")
-	{
+
+	MEMBER_CASE ("default")
 		var = getDefaultValue ();
 		return true;
-	}
-	else if(propertyId == "name")
-	{	
-		String temp (getName ());
-		var = temp;
-		var.share ();
-		return true;
-	}
-	else if(propertyId == "string")
-	{	
-		String temp;
-		toString (temp);
-		var = temp;
-		var.share ();
-		return true;
-	}
-	else if(propertyId == "enabled")
-	{
+
+	MEMBER_CASE ("name")
+		{
+			String temp (getName ());
+			var = temp;
+			var.share ();
+			return true;
+		}
+
+	MEMBER_CASE ("string")
+		{
+			String temp;
+			toString (temp);
+			var = temp;
+			var.share ();
+			return true;
+		}
+
+	MEMBER_CASE ("enabled")
 		var = isEnabled ();
 		return true;
-	}
-	else if(propertyId == "signalAlways")
-	{
+
+	MEMBER_CASE ("signalAlways")
 		var = isSignalAlways ();
 		return true;
-	}
-	else if(propertyId == "reverse")
-	{
+
+	MEMBER_CASE ("reverse")
 		var = isReverse ();
 		return true;
 	}
@@ -2556,53 +2547,47 @@ tbool CCL_API Parameter::getProperty (Variant& var, MemberID propertyId) const
 
 tbool CCL_API Parameter::setProperty (MemberID propertyId, VariantRef var)
 {
-	if(propertyId == "value")
+	MEMBER_SWITCH (propertyId)
 	{
+	MEMBER_CASE ("value")
 		restoreValue (this, var); // use restoreValue() to handle variant types
 		return true;
-	}
-	else if(propertyId == "name")
-	{
-		MutableCString name (var.asString ());
-		setName (name);
-		return true;
-	}
-	else if(propertyId == "min")
-	{
+
+	MEMBER_CASE ("name")
+		{
+			MutableCString name (var.asString ());
+			setName (name);
+			return true;
+		}
+
+	MEMBER_CASE ("min")
 		setMin (var);
 		return true;
-	}
-	else if(propertyId == "max")
-	{
+
+	MEMBER_CASE ("max")
 		setMax (var);
 		return true;
-	}
-	else if(propertyId == "default")
-	{
+
+	MEMBER_CASE ("default")
 		setDefaultValue (var);
 		return true;
-	}
-	else if(propertyId == "string")
-	{
+
+	MEMBER_CASE ("string")
 		fromString (var.asString ());
 		return true;
-	}
-	else if(propertyId == "enabled")
-	{
+
+	MEMBER_CASE ("enabled")
 		enable (var.asBool ());
 		return true;
-	}
-	else if(propertyId == "signalAlways")
-	{
+
+	MEMBER_CASE ("signalAlways")
 		setSignalAlways (var.asBool ());
 		return true;
-	}
-	else if(propertyId == "reverse")
-	{
+
+	MEMBER_CASE ("reverse")
 		setReverse (var.asBool ());
 		return true;
 	}
-
 	return Object::setProperty (propertyId, var);
 }
 
@@ -2623,61 +2608,62 @@ END_METHOD_NAMES (Parameter)
 
 tbool CCL_API Parameter::invokeMethod (Variant& returnValue, MessageRef msg)
 {
-	if(msg == "setValue")
+	MEMBER_SWITCH (msg.getID ())
 	{
+	MEMBER_CASE ("setValue")
 		restoreValue (this, msg[0], msg.getArgCount () > 1 ? msg[1].asBool () : false); // use restoreValue() to handle variant types
 		return true;
-	}
-	else if(msg == "fromString")
-	{
+
+	MEMBER_CASE ("fromString")
 		fromString (msg[0].asString (), msg.getArgCount () > 1 ? msg[1].asBool () : false);
 		return true;
-	}
-	else if(msg == "setNormalized")
-	{
+
+	MEMBER_CASE ("setNormalized")
 		setNormalized (msg[0].asFloat (), msg.getArgCount () > 1 ? msg[1].asBool () : false);
 		return true;
-	}
-	else if(msg == "getNormalized")
-	{
+
+	MEMBER_CASE ("getNormalized")
 		returnValue = getNormalized ();
 		return true;
-	}
-	else if(msg == "setFormatter")
-	{
-		UnknownPtr<IFormatter> formatter (msg[0].asUnknown ());
-		setFormatter (formatter);
-		return true;
-	}
-	else if(msg == "setCurve")
-	{
-		MutableCString curveName;
-		if(msg.getArgCount () == 0)
+
+	MEMBER_CASE ("setFormatter")
 		{
-			returnValue = false;
+			UnknownPtr<IFormatter> formatter (msg[0].asUnknown ());
+			setFormatter (formatter);
 			return true;
 		}
+
+	MEMBER_CASE ("setCurve")
+		{
+			MutableCString curveName;
+			if(msg.getArgCount () == 0)
+			{
+				returnValue = false;
+				return true;
+			}
 		
-		msg[0].toCString (curveName);
+			msg[0].toCString (curveName);
 
-		setCurve (ParamCurveFactory::instance().create (curveName));
-		return true;
-	}
-	else if(msg == "isType")
-	{
-		MutableCString typeName (msg[0].asString ());
-		const MetaClass* type = Kernel::instance ().getClassRegistry ().findType (typeName);
-		returnValue = type && canCast (*type);
-		return true;
-	}
-	else if(msg == "setSignalAlways")
-	{
-		bool state = msg.getArgCount () > 0 ? msg[0].asBool () : true;
-		setSignalAlways (state);
-		return true;
+			setCurve (ParamCurveFactory::instance().create (curveName));
+			return true;
+		}
+
+	MEMBER_CASE ("isType")
+		{
+			MutableCString typeName (msg[0].asString ());
+			const MetaClass* type = Kernel::instance ().getClassRegistry ().findType (typeName);
+			returnValue = type && canCast (*type);
+			return true;
+		}
+
+	MEMBER_CASE ("setSignalAlways")
+		{
+			bool state = msg.getArgCount () > 0 ? msg[0].asBool () : true;
+			setSignalAlways (state);
+			return true;
+		}
 	}
-	else
-		return SuperClass::invokeMethod (returnValue, msg);
+	return SuperClass::invokeMethod (returnValue, msg);
 }
 
 //************************************************************************************************
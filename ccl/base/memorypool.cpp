@@ -39,6 +39,13 @@ void AtomicPolicy::releaseStack (Stack* stack)
 	stack->release ();
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+Threading::ThreadID AtomicPolicy::getThreadID ()
+{
+	return System::GetThreadSelfID ();
+}
+
 //************************************************************************************************
 // MemoryPool
 //************************************************************************************************
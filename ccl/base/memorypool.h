@@ -44,6 +44,8 @@ public:
 	static Stack* createStack ();
 	static void releaseStack (Stack* stack);
 	static INLINE int32 add (int32 volatile& variable, int32 value) { return AtomicAddInline (variable, value); }
+	static INLINE bool testAndSet (int32 volatile& variable, int32 value, int32 comperand) { return AtomicTestAndSetInline (variable, value, comperand); }
+	static Threading::ThreadID getThreadID ();
 };
 
 //************************************************************************************************
@@ -55,7 +57,7 @@ public:
 class MemoryPool: public Core::MemoryPool<AtomicPolicy>
 {
 public:
-	MemoryPool (uint32 blockSize, uint32 count = 0, CStringPtr name = nullptr);
+	MemoryPool (uint32 blockSize, uint32 count = 0, CStringPtr name = nullptr, bool threadCacheEnabled = false);
 	~MemoryPool ();
 
 	void dump () const;
@@ -73,8 +75,8 @@ protected:
 // MemoryPool inline
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-inline MemoryPool::MemoryPool (uint32 blockSize, uint32 count, CStringPtr name)
-: Core::MemoryPool<AtomicPolicy> (blockSize, count, name)
+inline MemoryPool::MemoryPool (uint32 blockSize, uint32 count, CStringPtr name, bool threadCacheEnabled)
+: Core::MemoryPool<AtomicPolicy> (blockSize, count, name, threadCacheEnabled)
 {
 	#if DEBUG
 	getRegistrar ().append (this);
@@ -85,7 +87,7 @@ inline MemoryPool::MemoryPool (uint32 blockSize, uint32 count, CStringPtr name)
 
 inline MemoryPool::~MemoryPool ()
 {
-	SOFT_ASSERT (numBlocksUsed == 0, "Memory blocks still in use!")
+	SOFT_ASSERT (getNumBlocksUsed () == 0, "Memory blocks still in use!")
 
 	#if DEBUG
 	getRegistrar ().remove (this);
@@ -25,6 +25,7 @@
 
 #include "ccl/public/base/unknown.h"
 #include "ccl/public/base/iobserver.h"
+#include "ccl/public/base/memberid.h"
 
 namespace CCL {
 
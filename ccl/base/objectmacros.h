@@ -235,6 +235,44 @@ static const CCL::MetaClass::AttributeModifier UNIQUE_IDENT (AttributeModifier)
 static const CCL::MetaClass::ConstructorModifier UNIQUE_IDENT (ConstructorModifier) \
 (CCL::ccl_typeid<ClassName> (), CCL::ccl_typeid<ReplacementClassName> ());
 
+//************************************************************************************************
+// Member dispatch macros
+//************************************************************************************************
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	Example:
+
+	tbool CCL_API MyClass::getProperty (Variant& var, MemberID propertyId) const
+	{
+		MEMBER_SWITCH (propertyId)
+		{
+		MEMBER_CASE ("title")
+			var = title;
+			return true;
+
+		MEMBER_CASE ("count")
+			var = count;
+			return true;
+		}
+		return SuperClass::getProperty (var, propertyId);
+	}
+
+	Use MEMBER_SWITCH (msg.getID ()) in invokeMethod. Each case must end with return or break.
+	Names with equal hash values within one switch are reported as duplicate case values.
+*/
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Switch on a member ID (CStringRef) by its hash value, requires "ccl/public/base/memberid.h". */
+#define MEMBER_SWITCH(memberId) \
+if(CCL::MemberSwitch __memberSwitch (memberId); true) \
+switch(__memberSwitch.hash)
+
+/** Case for the given member name (string literal), leaves the switch if only the hash matches. */
+#define MEMBER_CASE(name) \
+case CCL::MemberHash::compute (name): \
+if(!__memberSwitch.is (name)) break;
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 // Helper macros for template classes derived from Object
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -21,6 +21,53 @@
 #include "ccl/base/collections/objectarray.h"
 
 #include "ccl/public/base/variant.h"
+#include "ccl/public/collections/hashmap.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// ObjectNode::ChildIndex
+/** Maps child IDs to the first child with that ID. */
+//************************************************************************************************
+
+class ObjectNode::ChildIndex
+{
+public:
+	ChildIndex (int tableSize)
+	: table (tableSize, hashID, nullptr),
+	  tableSize (tableSize),
+	  hasDuplicates (false)
+	{}
+
+	HashMap<String, ObjectNode*> table;
+	int tableSize;
+	bool hasDuplicates;	///< IDs of some children are not unique
+
+	static int hashID (const String& id, int size)
+	{
+		return int (id.getHashCode () % (unsigned int)size);
+	}
+
+	bool isFull () const
+	{
+		return table.count () > 2 * tableSize;
+	}
+
+	/** Add child if ID is unique, returns false otherwise. */
+	bool add (ObjectNode* child)
+	{
+		StringRef id = child->getObjectID ();
+		if(table.contains (id))
+		{
+			hasDuplicates = true;
+			return false;
+		}
+		table.add (id, child);
+		return true;
+	}
+};
+
+} // namespace CCL
 
 using namespace CCL;
 
@@ -36,7 +83,9 @@ DEFINE_CLASS_NAMESPACE (ObjectNode, NAMESPACE_CCL)
 ObjectNode::ObjectNode (StringRef objectID)
 : objectID (objectID),
   parent (nullptr),
-  children (nullptr)
+  children (nullptr),
+  childIndex (nullptr),
+  childIndexEnabled (false)
 {}
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -45,7 +94,9 @@ ObjectNode::ObjectNode (const ObjectNode& g)
 : objectID (g.objectID),
   objectUID (kNullUID), // do not copy unique id!
   parent (nullptr),
-  children (nullptr)
+  children (nullptr),
+  childIndex (nullptr),
+  childIndexEnabled (g.childIndexEnabled)
 {
 	// clone children
 	IterForEach (g.newIterator (), ObjectNode, child)
@@ -57,6 +108,7 @@ ObjectNode::ObjectNode (const ObjectNode& g)
 
 ObjectNode::~ObjectNode ()
 {
+	delete childIndex;
 	if(children)
 		children->release ();
 }
@@ -92,6 +144,61 @@ ObjectArray& ObjectNode::getChildArray () const
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+void ObjectNode::enableChildIndex (bool state)
+{
+	childIndexEnabled = state;
+	rebuildChildIndex ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ObjectNode::rebuildChildIndex ()
+{
+	delete childIndex;
+	childIndex = nullptr;
+
+	int count = countChildren ();
+	if(!childIndexEnabled || count < kChildIndexThreshold)
+		return;
+
+	childIndex = NEW ChildIndex (count);
+	ArrayForEachFast (*children, ObjectNode, child)
+		childIndex->add (child);
+	EndFor
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ObjectNode::updateChildIndex (ObjectNode* child, bool added)
+{
+	if(!childIndexEnabled)
+		return;
+
+	if(childIndex == nullptr || childIndex->isFull ())
+	{
+		rebuildChildIndex ();
+		return;
+	}
+
+	if(added)
+	{
+		// a duplicate ID might precede the indexed child now
+		bool appended = children->at (children->count () - 1) == child;
+		if(!childIndex->add (child) && !appended)
+			rebuildChildIndex ();
+	}
+	else
+	{
+		// another child with same ID might take its place
+		if(childIndex->hasDuplicates)
+			rebuildChildIndex ();
+		else
+			childIndex->table.remove (child->getObjectID ());
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 Container& ObjectNode::getChildren () const
 {
 	return getChildArray ();
@@ -106,7 +213,14 @@ bool ObjectNode::addChild (ObjectNode* child)
 		return false;
 
 	child->parent = this;
-	return getChildArray ().add (child);
+	if(!getChildArray ().add (child))
+	{
+		child->parent = nullptr;
+		return false;
+	}
+
+	updateChildIndex (child, true);
+	return true;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -122,6 +236,8 @@ bool ObjectNode::insertChild (int index, ObjectNode* child)
 
 	if(result == false)
 		child->parent = nullptr;
+	else
+		updateChildIndex (child, true);
 
 	return result;
 }
@@ -139,6 +255,8 @@ bool ObjectNode::addChildSorted (ObjectNode* child)
 
 	if(result == false)
 		child->parent = nullptr;
+	else
+		updateChildIndex (child, true);
 
 	return result;
 }
@@ -151,6 +269,7 @@ bool ObjectNode::removeChild (ObjectNode* child)
 	if(children && children->remove (child))
 	{
 		child->parent = nullptr;
+		updateChildIndex (child, false);
 		return true;
 	}
 	return false;
@@ -162,6 +281,9 @@ void ObjectNode::removeAll ()
 {
 	if(children)
 		children->removeAll ();
+
+	delete childIndex;
+	childIndex = nullptr;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -233,6 +355,9 @@ IObjectNode* CCL_API ObjectNode::findChild (StringRef id) const
 
 ObjectNode* ObjectNode::findChildNode (StringRef id) const
 {
+	if(childIndex)
+		return childIndex->table.lookup (id);
+
 	if(children)
 		ArrayForEach (*children, ObjectNode, child)
 			if(child->getObjectID () == id)
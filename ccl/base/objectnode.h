@@ -31,6 +31,9 @@ class ObjectArray;
 
 //************************************************************************************************
 // ObjectNode
+/** Node in an object tree. Lookup of children by ID is linear, subclasses with many children
+	can enable a hash index which is maintained once the number of children exceeds
+	kChildIndexThreshold. */
 //************************************************************************************************
 
 class ObjectNode: public Object,
@@ -44,7 +47,7 @@ public:
 	ObjectNode (const ObjectNode&);
 	~ObjectNode ();
 
-	void setName (StringRef name);
+	void setName (StringRef name);	///< updates index of parent
 	bool setUniqueName (StringRef name); // accept name only when unique
 	StringRef getName () const;
 
@@ -95,6 +98,9 @@ public:
 	CLASS_INTERFACE (IObjectNode, Object)
 
 protected:
+	static const int kChildIndexThreshold = 32;
+
+	void enableChildIndex (bool state);		///< index children by ID, array must not be modified directly!
 	ObjectArray& getChildArray () const;
 	Container& getChildren () const;
 	void setObjectUID (UIDRef uid);
@@ -112,6 +118,12 @@ private:
 	mutable UID objectUID;
 	ObjectNode* parent;
 	mutable ObjectArray* children;
+	class ChildIndex;
+	ChildIndex* childIndex;
+	bool childIndexEnabled;
+
+	void updateChildIndex (ObjectNode* child, bool added);
+	void rebuildChildIndex ();
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -119,7 +131,7 @@ private:
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 inline void ObjectNode::setName (StringRef name)
-{ objectID = name; }
+{ objectID = name; if(parent && parent->childIndex) parent->rebuildChildIndex (); }
 
 inline StringRef ObjectNode::getName () const
 { return objectID; }
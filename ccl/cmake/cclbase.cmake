@@ -45,6 +45,7 @@ ccl_list_append_once (cclbase_public_headers
 	${CCL_DIR}/public/base/itrigger.h
 	${CCL_DIR}/public/base/itypelib.h
 	${CCL_DIR}/public/base/iunknown.h
+	${CCL_DIR}/public/base/memberid.h
 	${CCL_DIR}/public/base/platform.h
 	${CCL_DIR}/public/base/primitives.h
 	${CCL_DIR}/public/base/profiler.h
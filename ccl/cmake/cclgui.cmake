@@ -456,6 +456,8 @@ ccl_list_append_once (cclgui_source_files
 	${CCL_DIR}/gui/itemviews/listview.h
 	${CCL_DIR}/gui/itemviews/namenavigator.cpp
 	${CCL_DIR}/gui/itemviews/namenavigator.h
+	${CCL_DIR}/gui/itemviews/rowheightindex.cpp
+	${CCL_DIR}/gui/itemviews/rowheightindex.h
 	${CCL_DIR}/gui/itemviews/treeitem.cpp
 	${CCL_DIR}/gui/itemviews/treeitem.h
 	${CCL_DIR}/gui/itemviews/treeview.cpp
@@ -529,6 +531,8 @@ ccl_list_append_once (cclgui_source_files
 	${CCL_DIR}/gui/skin/form.h
 	${CCL_DIR}/gui/skin/skinattributes.cpp
 	${CCL_DIR}/gui/skin/skinattributes.h
+	${CCL_DIR}/gui/skin/skincompiler.cpp
+	${CCL_DIR}/gui/skin/skincompiler.h
 	${CCL_DIR}/gui/skin/skincontrols.cpp
 	${CCL_DIR}/gui/skin/skincontrols.h
 	${CCL_DIR}/gui/skin/skinelement.cpp
@@ -583,7 +587,10 @@ ccl_list_append_once (cclgui_source_files
 
 	${CCL_DIR}/gui/test/elementsizeparsertest.cpp
 	${CCL_DIR}/gui/test/flexboxtest.cpp
+	${CCL_DIR}/gui/test/imagecachetest.cpp
 	${CCL_DIR}/gui/test/layouttest.cpp
+	${CCL_DIR}/gui/test/listviewtest.cpp
+	${CCL_DIR}/gui/test/skincompilertest.cpp
 
 	${CCL_DIR}/gui/theme/colorreference.h
 	${CCL_DIR}/gui/theme/colorscheme.cpp
@@ -70,6 +70,8 @@ ccl_list_append_once (cclnet_public_source_files
 	${CCL_DIR}/public/system/ithreading.h
 	${CCL_DIR}/public/system/threadsync.cpp
 	${CCL_DIR}/public/system/threadsync.h
+	${CCL_DIR}/public/system/userthread.cpp
+	${CCL_DIR}/public/system/userthread.h
 
 	${CCL_DIR}/public/text/cclstring.cpp
 	${CCL_DIR}/public/text/cclstring.h
@@ -79,6 +81,8 @@ ccl_list_append_once (cclnet_public_source_files
 ccl_list_append_once (cclnet_source_files
 	${CCL_DIR}/network/netdiscovery.cpp
 	${CCL_DIR}/network/netdiscovery.h
+	${CCL_DIR}/network/neteventloop.cpp
+	${CCL_DIR}/network/neteventloop.h
 	${CCL_DIR}/network/netservices.cpp
 	${CCL_DIR}/network/netsocket.cpp
 	${CCL_DIR}/network/netsocket.h
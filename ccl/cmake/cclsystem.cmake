@@ -181,6 +181,8 @@ ccl_list_append_once (cclsystem_source_files
 	${CCL_DIR}/system/atomtable.h
 	${CCL_DIR}/system/console.cpp
 	${CCL_DIR}/system/console.h
+	${CCL_DIR}/system/diagnosticmetrics.cpp
+	${CCL_DIR}/system/diagnosticmetrics.h
 	${CCL_DIR}/system/diagnosticstore.cpp
 	${CCL_DIR}/system/diagnosticstore.h
 	${CCL_DIR}/system/errorhandler.cpp
@@ -248,6 +250,8 @@ ccl_list_append_once (cclsystem_source_files
 	${CCL_DIR}/system/plugins/module.h
 	${CCL_DIR}/system/plugins/objecttable.cpp
 	${CCL_DIR}/system/plugins/objecttable.h
+	${CCL_DIR}/system/plugins/plugcache.cpp
+	${CCL_DIR}/system/plugins/plugcache.h
 	${CCL_DIR}/system/plugins/plugcollect.cpp
 	${CCL_DIR}/system/plugins/plugcollect.h
 	${CCL_DIR}/system/plugins/plugmanager.cpp
@@ -273,6 +277,9 @@ ccl_list_append_once (cclsystem_source_files
 	${CCL_DIR}/system/system.h
 	${CCL_DIR}/system/systemservices.cpp
 
+	${CCL_DIR}/system/test/loggertest.cpp
+	${CCL_DIR}/system/test/plugcachetest.cpp
+
 	${CCL_DIR}/system/threading/atomic.cpp
 	${CCL_DIR}/system/threading/interprocess.cpp
 	${CCL_DIR}/system/threading/interprocess.h
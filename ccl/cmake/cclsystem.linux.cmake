@@ -6,6 +6,8 @@ ccl_list_append_once (cclsystem_linux_sources
 	${CCL_DIR}/platform/linux/system/debug.linux.cpp
 	${CCL_DIR}/platform/linux/system/filemanager.linux.cpp
 	${CCL_DIR}/platform/linux/system/mediathreadservice.linux.cpp
+	${CCL_DIR}/platform/linux/system/nativefilesearcher.linux.cpp
+	${CCL_DIR}/platform/linux/system/nativefilesearcher.linux.h
 	${CCL_DIR}/platform/linux/system/nativefilesystem.linux.cpp
 	${CCL_DIR}/platform/linux/system/resourceloader.linux.cpp
 	${CCL_DIR}/platform/linux/system/system.linux.cpp
@@ -20,6 +20,7 @@ set (ccltext_exports
 	CCLModuleMain
 	${CCL_EXPORT_PREFIX}GetEmptyString${CCL_EXPORT_POSTFIX}
 	${CCL_EXPORT_PREFIX}GetConstantString${CCL_EXPORT_POSTFIX}
+	${CCL_EXPORT_PREFIX}GetStringPoolStatistics${CCL_EXPORT_POSTFIX}
 	${CCL_EXPORT_PREFIX}GetUnicodeUtilities${CCL_EXPORT_POSTFIX}
 	${CCL_EXPORT_PREFIX}CreateTranslationTable${CCL_EXPORT_POSTFIX}
 	${CCL_EXPORT_PREFIX}CreateStringDictionary${CCL_EXPORT_POSTFIX}
@@ -187,6 +188,29 @@ ccl_list_append_once (CMAKE_MODULE_PATH "${CMAKE_CURRENT_LIST_DIR}")
 find_package (corelib REQUIRED)
 find_package (pcre REQUIRED)
 find_package (expat REQUIRED)
+find_package (zstd)
+find_package (lz4)
+
+# Optional compression codecs
+if (zstd_FOUND)
+	list (APPEND ccltext_codec_source_files
+		${CCL_DIR}/text/transform/zstdcompression.cpp
+		${CCL_DIR}/text/transform/zstdcompression.h
+	)
+	list (APPEND ccltext_codec_libraries ${zstd_LIBRARY})
+	list (APPEND ccltext_codec_definitions "CCL_ZSTD_COMPRESSION_ENABLED=1")
+endif ()
+
+if (lz4_FOUND)
+	list (APPEND ccltext_codec_source_files
+		${CCL_DIR}/text/transform/lz4compression.cpp
+		${CCL_DIR}/text/transform/lz4compression.h
+	)
+	list (APPEND ccltext_codec_libraries ${lz4_LIBRARY})
+	list (APPEND ccltext_codec_definitions "CCL_LZ4_COMPRESSION_ENABLED=1")
+endif ()
+
+source_group ("source/transform" FILES ${ccltext_codec_source_files})
 
 # Options
 option (CCL_PRINT_STRING_STATS "Print the string statistics for debug builds." ON)
@@ -213,15 +237,16 @@ if (NOT TARGET ${ccltext})
 
 	# Preprocessor Definitions
 	if (${CCL_STATIC_ONLY})
-		target_compile_definitions (${ccltext} INTERFACE "CCL_PRINT_STRING_STATS=${print_string_stats}")
+		target_compile_definitions (${ccltext} INTERFACE "CCL_PRINT_STRING_STATS=${print_string_stats}" ${ccltext_codec_definitions})
 	else ()
-		target_compile_definitions (${ccltext} PRIVATE "CCL_PRINT_STRING_STATS=${print_string_stats}")
+		target_compile_definitions (${ccltext} PRIVATE "CCL_PRINT_STRING_STATS=${print_string_stats}" ${ccltext_codec_definitions})
 	endif ()
 
 	# collect source files for target
 	ccl_list_append_once (ccltext_sources
 		${ccltext_public_source_files}
 		${ccltext_source_files}
+		${ccltext_codec_source_files}
 		${ccltext_system_source_files}
 	)
 
@@ -229,7 +254,7 @@ if (NOT TARGET ${ccltext})
 		target_sources (${ccltext} PRIVATE ${ccltext_sources} ${CMAKE_CURRENT_LIST_FILE})
 		ccl_target_headers (${ccltext} INSTALL ${CCL_SYSTEM_INSTALL} DESTINATION ${CCL_PUBLIC_HEADERS_DESTINATION} BASE_DIRS ${CCL_DIR} FILES ${ccltext_public_headers})
 
-		target_link_libraries (${ccltext} PRIVATE corelib ${expat_LIBRARY} ${PCRE_LIBRARY})
+		target_link_libraries (${ccltext} PRIVATE corelib ${expat_LIBRARY} ${PCRE_LIBRARY} ${ccltext_codec_libraries})
 		target_include_directories (${ccltext} INTERFACE "$<INSTALL_INTERFACE:${VENDOR_PUBLIC_HEADERS_DESTINATION}>")
 
 		ccl_export_symbols (${ccltext} ${ccltext_exports})
@@ -257,6 +282,6 @@ elseif (NOT XCODE)
 	ccl_include_platform_specifics (ccltext)
 endif ()
 
-ccl_list_append_once (CCL_STATIC_LINK_LIBRARIES ${expat_LIBRARY} ${PCRE_LIBRARY})
-ccl_list_append_once (CCL_STATIC_INCLUDE_DIRS ${expat_INCLUDE_DIR} ${PCRE_INCLUDE_DIR})
+ccl_list_append_once (CCL_STATIC_LINK_LIBRARIES ${expat_LIBRARY} ${PCRE_LIBRARY} ${ccltext_codec_libraries})
+ccl_list_append_once (CCL_STATIC_INCLUDE_DIRS ${expat_INCLUDE_DIR} ${PCRE_INCLUDE_DIR} ${zstd_INCLUDE_DIR} ${lz4_INCLUDE_DIR})
 ccl_list_append_once (CCL_STATIC_COMPILE_DEFINITIONS PCRE2_STATIC=1 PCRE2_CODE_UNIT_WIDTH=16)
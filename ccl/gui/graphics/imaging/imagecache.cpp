@@ -33,6 +33,43 @@
 
 using namespace CCL;
 
+//************************************************************************************************
+// ImageCacheStatistics
+//************************************************************************************************
+
+int64 ImageCacheStatistics::estimateMemorySize (IImage* image, Coord width, Coord height)
+{
+	if(width < 0)
+		width = image->getWidth ();
+	if(height < 0)
+		height = image->getHeight ();
+
+	// 32 bit pixels for all frames, multi-resolution bitmaps have a 1x and a 2x representation (see ImageCache::createImage)
+	int64 size = (int64)width * height * ccl_max (image->getFrameCount (), 1) * 4;
+	if(UnknownPtr<IMultiResolutionBitmap> (image).isValid () || image->getType () == IImage::kScalable)
+		size *= 5;
+	return size;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ImageCacheStatistics::getProperty (Variant& var, IObject::MemberID propertyId) const
+{
+	if(propertyId == "hits")
+		var = hits;
+	else if(propertyId == "misses")
+		var = misses;
+	else if(propertyId == "evictions")
+		var = evictions;
+	else if(propertyId == "memoryUsage")
+		var = memoryUsage;
+	else if(propertyId == "count")
+		var = count;
+	else
+		return false;
+	return true;
+}
+
 //************************************************************************************************
 // ImageCache
 //************************************************************************************************
@@ -42,31 +79,97 @@ DEFINE_CLASS (ImageCache, Object)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-ImageCache::ImageCache ()
+int ImageCache::CacheKey::hash (const CacheKey& key, int size)
 {
+	uint32 h = (uint32)ccl_hash_pointer (key.source, 0x7FFFFFFF);
+	h = h * 31 + (uint32)key.width;
+	h = h * 31 + (uint32)key.height;
+	return (int)(h % (uint32)size);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+ImageCache::ImageCache ()
+: entries (1024, CacheKey::hash),
+  entriesByImage (1024),
+  memoryBudget (kDefaultMemoryBudget)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 ImageCache::~ImageCache ()
 {
+	while(CacheEntry* entry = unusedEntries.getFirst ())
+		removeEntry (entry);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ImageCache::setMemoryBudget (int64 bytes)
+{
+	memoryBudget = bytes;
+	purge ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int64 ImageCache::getMemoryBudget () const
+{
+	return memoryBudget;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+const ImageCacheStatistics& ImageCache::getStatistics () const
+{
+	return statistics;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API ImageCache::getProperty (Variant& var, MemberID propertyId) const
+{
+	if(propertyId == "memoryBudget")
+	{
+		var = memoryBudget;
+		return true;
+	}
+	if(statistics.getProperty (var, propertyId))
+		return true;
+	return SuperClass::getProperty (var, propertyId);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 IImage* ImageCache::requestImage (IImage* source, Coord width, Coord height)
 {
-	ListIterator<CacheEntry> iter (cache);
-	while(!iter.done ())
+	CacheKey key (source, width, height);
+	if(CacheEntry* entry = entries.lookup (key))
 	{
-		CacheEntry& entry = iter.next ();
-		if(entry.source == source && entry.width == width && entry.height == height)
-		{
-			entry.useCount++;
-			return entry.cached;
-		}
+		if(entry->useCount++ == 0)
+			unusedEntries.remove (entry);
+		statistics.hits++;
+		return entry->cached;
 	}
 
+	statistics.misses++;
+	IImage* image = createImage (source, width, height);
+
+	int64 memorySize = ImageCacheStatistics::estimateMemorySize (source, width, height);
+	CacheEntry* entry = NEW CacheEntry (key, image, memorySize);
+	entries.add (key, entry);
+	entriesByImage.add (image, entry);
+	statistics.memoryUsage += memorySize;
+	statistics.count++;
+
+	purge ();
+	return image;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IImage* ImageCache::createImage (IImage* source, Coord width, Coord height) const
+{
 	// try to keep alpha channel intact
 	bool useAlpha = true;
 	Bitmap* bitmap = nullptr;
@@ -130,14 +233,6 @@ IImage* ImageCache::requestImage (IImage* source, Coord width, Coord height)
 	else
 		image = bitmap;
 
-	CacheEntry entry;
-	entry.useCount = 1;
-	entry.source = source;
-	entry.cached = image;
-	entry.width = width;
-	entry.height = height;
-	cache.append (entry);
-
 	return image;
 }
 
@@ -145,22 +240,59 @@ IImage* ImageCache::requestImage (IImage* source, Coord width, Coord height)
 
 void ImageCache::releaseImage (IImage* cached)
 {
-	ListIterator<CacheEntry> iter (cache);
-	while(!iter.done ())
+	CacheEntry* entry = entriesByImage.lookup (cached);
+	ASSERT (entry && entry->useCount > 0)
+	if(!entry || entry->useCount <= 0)
+		return;
+
+	// keep unused image for later requests
+	if(--entry->useCount == 0)
+	{
+		unusedEntries.append (entry);
+		purge ();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ImageCache::removeUnused ()
+{
+	while(CacheEntry* entry = unusedEntries.getFirst ())
 	{
-		CacheEntry& entry = iter.next ();
-		if(entry.cached == cached)
-		{
-			if(--entry.useCount == 0)
-			{
-				entry.cached->release ();
-				cache.remove (entry);
-			}
-			break;
-		}
+		removeEntry (entry);
+		statistics.evictions++;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ImageCache::purge ()
+{
+	while(statistics.memoryUsage > memoryBudget)
+	{
+		CacheEntry* entry = unusedEntries.getFirst ();
+		if(!entry)
+			break; // remaining images are in use
+		removeEntry (entry);
+		statistics.evictions++;
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ImageCache::removeEntry (CacheEntry* entry)
+{
+	ASSERT (entry->useCount == 0)
+	unusedEntries.remove (entry);
+	entries.remove (entry->key);
+	entriesByImage.remove (entry->cached);
+	statistics.memoryUsage -= entry->memorySize;
+	statistics.count--;
+
+	entry->cached->release ();
+	delete entry;
+}
+
 //************************************************************************************************
 // CachedImage
 //************************************************************************************************
@@ -184,6 +316,7 @@ IImage* CachedImage::operator = (IImage* image)
 {
 	if(cached)
 		ImageCache::instance ().releaseImage (cached);
+	cached = nullptr;
 	source = image;
 	return image;
 }
@@ -251,12 +384,23 @@ DEFINE_CLASS_UID (ModifiedImageCache, 0x9bc5ef85, 0x43cd, 0x4b45, 0xaf, 0x42, 0x
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-ModifiedImageCache::ModifiedImageCache ()
+int ModifiedImageCache::CacheKey::hash (const CacheKey& key, int size)
 {
+	uint32 h = (uint32)ccl_hash_pointer (key.source, 0x7FFFFFFF);
+	h = h * 31 + key.color;
+	h = h * 31 + (key.colorizeTemplate ? 1 : 0);
+	return (int)(h % (uint32)size);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+ModifiedImageCache::ModifiedImageCache ()
+: entries (1024, CacheKey::hash),
+  memoryBudget (kDefaultMemoryBudget)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 ModifiedImageCache::~ModifiedImageCache ()
 {
 	removeAll ();
@@ -266,15 +410,44 @@ ModifiedImageCache::~ModifiedImageCache ()
 
 void ModifiedImageCache::removeAll ()
 {
-	ListIterator<CacheEntry> iter (cache);
-	while(!iter.done ())
-	{
-		CacheEntry& entry = iter.next ();
+	while(CacheEntry* entry = lruList.getFirst ())
+		removeEntry (entry);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
 
-		for(int i = 0; i < entry.modifications.count (); i++)
-			entry.modifications[i].image->release ();
+void ModifiedImageCache::setMemoryBudget (int64 bytes)
+{
+	memoryBudget = bytes;
+	purge (nullptr);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int64 ModifiedImageCache::getMemoryBudget () const
+{
+	return memoryBudget;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+const ImageCacheStatistics& ModifiedImageCache::getStatistics () const
+{
+	return statistics;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API ModifiedImageCache::getProperty (Variant& var, MemberID propertyId) const
+{
+	if(propertyId == "memoryBudget")
+	{
+		var = memoryBudget;
+		return true;
 	}
-	cache.removeAll ();
+	if(statistics.getProperty (var, propertyId))
+		return true;
+	return SuperClass::getProperty (var, propertyId);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -294,72 +467,68 @@ IImage* CCL_API ModifiedImageCache::lookup (IImage* source, ColorRef color, tboo
 	if(source == nullptr)
 		return nullptr;
 	
-	IImage* modifiedImage = nullptr;
-	
-	ListIterator<CacheEntry> iter (cache);
-	while(!iter.done ())
+	CacheKey key (source, color, drawAsTemplate != 0);
+	CacheEntry* entry = entries.lookup (key);
+	if(entry)
 	{
-		CacheEntry& entry = iter.next ();
-		
-		if(entry.source == source)
-		{
-			for(int i = 0; i < entry.modifications.count (); i++)
-			{
-				const CachedModification& modification = entry.modifications[i];
-				if(modification.color == color)
-				{
-					modifiedImage = modification.image;	//modification found
-					break;
-				}
-			}
-			
-			// create new modification in existing entry (dispose oldest modification)
-			if(!modifiedImage)
-			{
-				if(entry.modifications.isFull ())
-				{
-					entry.modifications[0].image->release ();
-					entry.modifications.removeFirst ();
-				}
-				modifiedImage = addModification (entry, color, drawAsTemplate);
-			}
-			
-			if(modifiedImage)
-				break;
-		}
+		// move to most recently used position
+		lruList.remove (entry);
+		lruList.append (entry);
+		statistics.hits++;
 	}
-
-	if(modifiedImage)
+	else
 	{
-		modifiedImage->setCurrentFrame (source->getCurrentFrame ());
+		statistics.misses++;
+		IImage* modifiedImage = createModification (source, color, drawAsTemplate != 0);
+		if(!modifiedImage)
+			return nullptr;
+
+		entry = NEW CacheEntry (key, modifiedImage, ImageCacheStatistics::estimateMemorySize (modifiedImage));
+		entries.add (key, entry);
+		lruList.append (entry);
+		statistics.memoryUsage += entry->memorySize;
+		statistics.count++;
+
+		purge (entry);
 	}
-	else // create new entry with modification
-	{
-		CacheEntry entry (source);
 
-		if(modifiedImage = addModification (entry, color, drawAsTemplate))
-		{
-			cache.append (entry);
-			modifiedImage->setCurrentFrame (source->getCurrentFrame ());
-		}
-	}
-	
-	return modifiedImage;
+	entry->image->setCurrentFrame (source->getCurrentFrame ());
+	return entry->image;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-IImage* ModifiedImageCache::addModification (CacheEntry& entry, ColorRef color, bool colorizeTemplate)
+void ModifiedImageCache::purge (CacheEntry* keep)
 {
-	if(entry.source->getType () == IImage::kScalable)
+	while(statistics.memoryUsage > memoryBudget)
 	{
-		IImage* image = createModifiedShape (entry.source, color, colorizeTemplate);
-		
-		if(image)
-			entry.modifications.add (CachedModification (image, color));
-		
-		return image;
+		CacheEntry* entry = lruList.getFirst ();
+		if(!entry || entry == keep)
+			break;
+		removeEntry (entry);
+		statistics.evictions++;
 	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ModifiedImageCache::removeEntry (CacheEntry* entry)
+{
+	lruList.remove (entry);
+	entries.remove (entry->key);
+	statistics.memoryUsage -= entry->memorySize;
+	statistics.count--;
+
+	entry->image->release ();
+	delete entry;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IImage* ModifiedImageCache::createModification (IImage* source, ColorRef color, bool colorizeTemplate)
+{
+	if(source->getType () == IImage::kScalable)
+		return createModifiedShape (source, color, colorizeTemplate);
 		
 	BitmapFilter* filter = nullptr;
 	if(colorizeTemplate)
@@ -375,12 +544,7 @@ IImage* ModifiedImageCache::addModification (CacheEntry& entry, ColorRef color,
 		filter = lightAdapter;
 	}
 	
-	IImage* image = createModifiedImage (entry.source, filter);
-	
-	if(image)
-		entry.modifications.add (CachedModification (image, color));
-	
-	return image;
+	return createModifiedImage (source, filter);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -23,6 +23,8 @@
 #include "ccl/base/singleton.h"
 
 #include "ccl/public/collections/linkedlist.h"
+#include "ccl/public/collections/intrusivelist.h"
+#include "ccl/public/collections/hashmap.h"
 #include "ccl/public/gui/graphics/types.h"
 #include "ccl/public/gui/graphics/iimage.h"
 #include "ccl/public/gui/graphics/iimagecache.h"
@@ -33,9 +35,39 @@ namespace CCL {
 
 class BitmapFilter;
 class Shape;
-	
+
+//************************************************************************************************
+// ImageCacheStatistics
+//************************************************************************************************
+
+struct ImageCacheStatistics
+{
+	int64 hits;
+	int64 misses;
+	int64 evictions;
+	int64 memoryUsage;	///< estimated size of cached images in bytes
+	int count;			///< number of cached images
+
+	ImageCacheStatistics ()
+	: hits (0),
+	  misses (0),
+	  evictions (0),
+	  memoryUsage (0),
+	  count (0)
+	{}
+
+	/** Estimate memory used by the image when drawn at the given size (or its own size if not given). */
+	static int64 estimateMemorySize (IImage* image, Coord width = -1, Coord height = -1);
+
+	/** Get statistics as property, returns false for unknown properties. */
+	bool getProperty (Variant& var, IObject::MemberID propertyId) const;
+};
+
 //************************************************************************************************
 // ImageCache
+/** Caches scaled copies of images, keyed by source image and size.
+	Images no longer requested are kept until the memory budget is exceeded, least recently used
+	images are evicted first. Images in use are never evicted. */
 //************************************************************************************************
 
 class ImageCache: public Object,
@@ -47,22 +79,65 @@ public:
 	ImageCache ();
 	~ImageCache ();
 
+	static const int64 kDefaultMemoryBudget = 64 * 1024 * 1024;
+
 	IImage* requestImage (IImage* source, Coord width, Coord height);
 	void releaseImage (IImage* cached);
 
+	void setMemoryBudget (int64 bytes);
+	int64 getMemoryBudget () const;
+	const ImageCacheStatistics& getStatistics () const;
+
+	/** Evict all images not in use. */
+	void removeUnused ();
+
+	// Object
+	tbool CCL_API getProperty (Variant& var, MemberID propertyId) const override;
+
 protected:
-	struct CacheEntry 
+	struct CacheKey
 	{
-		bool operator == (const CacheEntry& other) { return source == other.source && width == other.width && height == other.height; }
-
 		IImage* source;
-		IImage* cached;
 		Coord width;
 		Coord height;
+
+		CacheKey (IImage* source = nullptr, Coord width = 0, Coord height = 0)
+		: source (source),
+		  width (width),
+		  height (height)
+		{}
+
+		bool operator == (const CacheKey& other) const { return source == other.source && width == other.width && height == other.height; }
+
+		static int hash (const CacheKey& key, int size);
+	};
+
+	struct CacheEntry: IntrusiveLink<CacheEntry>
+	{
+		CacheKey key;
+		SharedPtr<IImage> source; ///< keep key valid while unused
+		IImage* cached;
 		int useCount;
+		int64 memorySize;
+
+		CacheEntry (const CacheKey& key, IImage* cached, int64 memorySize)
+		: key (key),
+		  source (key.source),
+		  cached (cached),
+		  useCount (1),
+		  memorySize (memorySize)
+		{}
 	};
 
-	LinkedList<CacheEntry> cache;
+	HashMap<CacheKey, CacheEntry*> entries;
+	PointerHashMap<CacheEntry*> entriesByImage;
+	IntrusiveLinkedList<CacheEntry> unusedEntries; ///< least recently used first
+	int64 memoryBudget;
+	ImageCacheStatistics statistics;
+
+	IImage* createImage (IImage* source, Coord width, Coord height) const;
+	void removeEntry (CacheEntry* entry);
+	void purge ();
 };
 
 //************************************************************************************************
@@ -90,6 +165,9 @@ private:
 
 //************************************************************************************************
 // ModifiedImageCache
+/** Caches colorized copies of images, keyed by source image, color and template mode.
+	Least recently used images are evicted when the memory budget is exceeded. Images returned by
+	lookup() are owned by the cache and must not be kept by the caller. */
 //************************************************************************************************
 
 class ModifiedImageCache: public Object,
@@ -101,42 +179,67 @@ public:
 	
 	ModifiedImageCache ();
 	~ModifiedImageCache ();
+
+	static const int64 kDefaultMemoryBudget = 32 * 1024 * 1024;
 	
 	static IImage* createModifiedImage (IImage* source, BitmapFilter* ownedFilter);
 
+	void setMemoryBudget (int64 bytes);
+	int64 getMemoryBudget () const;
+	const ImageCacheStatistics& getStatistics () const;
+
 	// IImageCache
 	IImage* CCL_API lookup (IImage* image, ColorRef color, tbool drawAsTemplate = false) override;
 
+	// Object
+	tbool CCL_API getProperty (Variant& var, MemberID propertyId) const override;
+
 	CLASS_INTERFACE (IImageCache, Object)
 
 private:
 	void applyShapeModificationDeep (ColorRef color, Shape* shape, bool colorizeTemplate);
-	
-	struct CachedModification
+
+	struct CacheKey
 	{
-		CachedModification () : image (nullptr) {}
-		CachedModification (IImage* image, Color color) : image (image), color (color) {}
-		IImage* image;
-		Color color;
+		IImage* source;
+		uint32 color;
+		bool colorizeTemplate;
+
+		CacheKey (IImage* source = nullptr, ColorRef color = Color (), bool colorizeTemplate = false)
+		: source (source),
+		  color (color),
+		  colorizeTemplate (colorizeTemplate)
+		{}
+
+		bool operator == (const CacheKey& other) const { return source == other.source && color == other.color && colorizeTemplate == other.colorizeTemplate; }
+
+		static int hash (const CacheKey& key, int size);
 	};
-	
-	struct CacheEntry
+
+	struct CacheEntry: IntrusiveLink<CacheEntry>
 	{
-		static const int kMaxCachedModifications = 6;
-		typedef Core::FixedSizeVector<CachedModification, kMaxCachedModifications> CachedModification;
-		
-		CacheEntry () {}
-		CacheEntry (IImage* source) : source (source) {}
+		CacheKey key;
 		SharedPtr<IImage> source;
-		CachedModification modifications;
+		IImage* image;
+		int64 memorySize;
+
+		CacheEntry (const CacheKey& key, IImage* image, int64 memorySize)
+		: key (key),
+		  source (key.source),
+		  image (image),
+		  memorySize (memorySize)
+		{}
 	};
 
-	LinkedList<CacheEntry> cache;
-		
-	IImage* addModification (CacheEntry& entry, ColorRef color, bool colorizeTemplate);
-	IImage* createModifiedShape (IImage* source, ColorRef color, bool colorizeTemplate);
-	
+	HashMap<CacheKey, CacheEntry*> entries;
+	IntrusiveLinkedList<CacheEntry> lruList; ///< least recently used first
+	int64 memoryBudget;
+	ImageCacheStatistics statistics;
 
+	IImage* createModification (IImage* source, ColorRef color, bool colorizeTemplate);
+	IImage* createModifiedShape (IImage* source, ColorRef color, bool colorizeTemplate);
+	void removeEntry (CacheEntry* entry);
+	void purge (CacheEntry* keep);
 	void removeAll ();
 };
 
@@ -61,6 +61,61 @@ private:
 	ListIterator<ItemIndex> iter;
 };
 
+//************************************************************************************************
+// ItemRangeSelectionIterator
+//************************************************************************************************
+
+class ItemRangeSelectionIterator: public Unknown,
+								  public IItemSelectionIterator,
+								  public IItemRangeIterator
+{
+public:
+	ItemRangeSelectionIterator (const Vector<ItemRangeSelection::Range>& ranges, const LinkedList<ItemIndex>& others)
+	: ranges (ranges),
+	  rangeIndex (0),
+	  nextIndex (ranges.isEmpty () ? 0 : ranges.first ().first),
+	  iter (others)
+	{}
+
+	// IItemSelectionIterator
+	tbool CCL_API next (ItemIndex& index) override
+	{
+		if(rangeIndex < ranges.count ())
+		{
+			index = ItemIndex (nextIndex);
+			if(nextIndex < ranges.at (rangeIndex).last)
+				nextIndex++;
+			else if(++rangeIndex < ranges.count ())
+				nextIndex = ranges.at (rangeIndex).first;
+			return true;
+		}
+
+		if(iter.done ())
+			return false;
+		index = iter.next ();
+		return true;
+	}
+
+	// IItemRangeIterator
+	tbool CCL_API next (int& first, int& last) override
+	{
+		if(rangeIndex >= ranges.count ())
+			return false;
+		const ItemRangeSelection::Range& range = ranges.at (rangeIndex++);
+		first = range.first;
+		last = range.last;
+		return true;
+	}
+
+	CLASS_INTERFACE2 (IItemSelectionIterator, IItemRangeIterator, Unknown)
+
+private:
+	const Vector<ItemRangeSelection::Range>& ranges;
+	int rangeIndex;
+	int nextIndex;
+	ListIterator<ItemIndex> iter;
+};
+
 } // namespace CCL
 
 //************************************************************************************************
@@ -1208,6 +1263,211 @@ void CCL_API ItemListSelection::unselectAll ()
 	items.removeAll ();
 }
 
+//************************************************************************************************
+// ItemRangeSelection
+//************************************************************************************************
+
+DEFINE_CLASS (ItemRangeSelection, Object)
+DEFINE_CLASS_UID (ItemRangeSelection, 0xc15a9cd7, 0xfe8a, 0x46e5, 0xb1, 0x8e, 0xc0, 0xda, 0x8e, 0xc1, 0xb2, 0x3b)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ItemRangeSelection::ItemRangeSelection ()
+: ranges (0, 16),
+  numIndices (0)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ItemRangeSelection::ItemRangeSelection (const ItemRangeSelection& selection)
+: ranges (selection.ranges),
+  numIndices (selection.numIndices)
+{
+	ListForEach (selection.others, ItemIndex, idx)
+		others.append (idx);
+	EndFor
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int ItemRangeSelection::findRange (int index) const
+{
+	int low = 0;
+	int high = ranges.count ();
+	while(low < high)
+	{
+		int mid = (low + high) / 2;
+		if(ranges.at (mid).last < index)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API ItemRangeSelection::clone (IItemSelection*& selection) const
+{
+	selection = NEW ItemRangeSelection (*this);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API ItemRangeSelection::isEmpty () const
+{
+	return numIndices == 0 && others.isEmpty ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API ItemRangeSelection::isMultiple () const
+{
+	if(numIndices == 0)
+		return others.isMultiple ();
+	return numIndices > 1 || !others.isEmpty ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API ItemRangeSelection::isSelected (ItemIndexRef index) const
+{
+	int i = 0;
+	if(!index.getIndex (i))
+		return others.contains (index);
+
+	int r = findRange (i);
+	return r < ranges.count () && ranges.at (r).first <= i;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IItemSelectionIterator* CCL_API ItemRangeSelection::newIterator () const
+{
+	return NEW ItemRangeSelectionIterator (ranges, others);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API ItemRangeSelection::select (ItemIndexRef index)
+{
+	int i = 0;
+	if(index.getIndex (i))
+		selectRange (i, i);
+	else
+	{
+		ASSERT (!others.contains (index))
+		others.append (index);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API ItemRangeSelection::unselect (ItemIndexRef index)
+{
+	int i = 0;
+	if(!index.getIndex (i))
+		return others.remove (index);
+
+	if(!isSelected (index))
+		return false;
+	unselectRange (i, i);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API ItemRangeSelection::unselectAll ()
+{
+	ranges.removeAll ();
+	numIndices = 0;
+	others.removeAll ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API ItemRangeSelection::selectRange (int first, int last)
+{
+	ccl_order (first, last);
+
+	// merge with overlapping and adjacent ranges
+	int start = findRange (first - 1);
+	int end = start;
+	Range merged (first, last);
+	int numMerged = 0;
+	while(end < ranges.count () && ranges.at (end).first <= last + 1)
+	{
+		const Range& range = ranges.at (end);
+		merged.first = ccl_min (merged.first, range.first);
+		merged.last = ccl_max (merged.last, range.last);
+		numMerged += range.count ();
+		end++;
+	}
+
+	if(end == start)
+		ranges.insertAt (start, merged);
+	else
+	{
+		ranges.at (start) = merged;
+		for(int i = start + 1; i < end; i++)
+			ranges.removeAt (start + 1);
+	}
+	numIndices += merged.count () - numMerged;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API ItemRangeSelection::unselectRange (int first, int last)
+{
+	ccl_order (first, last);
+
+	int r = findRange (first);
+	while(r < ranges.count () && ranges.at (r).first <= last)
+	{
+		Range& range = ranges.at (r);
+		if(range.first < first && range.last > last)
+		{
+			// split
+			Range tail (last + 1, range.last);
+			range.last = first - 1;
+			ranges.insertAt (r + 1, tail);
+			numIndices -= last - first + 1;
+			break;
+		}
+		else if(range.first < first)
+		{
+			numIndices -= range.last - first + 1;
+			range.last = first - 1;
+			r++;
+		}
+		else if(range.last > last)
+		{
+			numIndices -= last - range.first + 1;
+			range.first = last + 1;
+			break;
+		}
+		else
+		{
+			numIndices -= range.count ();
+			ranges.removeAt (r);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int CCL_API ItemRangeSelection::countIndices () const
+{
+	return numIndices;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IItemRangeIterator* CCL_API ItemRangeSelection::newRangeIterator () const
+{
+	return NEW ItemRangeSelectionIterator (ranges, others);
+}
+
 //************************************************************************************************
 // ParamItemModel
 //************************************************************************************************
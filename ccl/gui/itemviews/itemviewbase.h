@@ -204,6 +204,62 @@ private:
 	LinkedList<ItemIndex> items;
 };
 
+//************************************************************************************************
+// ItemRangeSelection
+/** Implementation of IItemSelection storing integer indices as sorted, disjoint ranges.
+	Membership is a binary search, selecting a range merges it with its neighbors.
+	Other index types are kept in a list. */
+//************************************************************************************************
+
+class ItemRangeSelection: public Object,
+						  public IItemSelection,
+						  public IItemRangeSelection
+{
+public:
+	DECLARE_CLASS (ItemRangeSelection, Object)
+
+	ItemRangeSelection ();
+	ItemRangeSelection (const ItemRangeSelection& selection);
+
+	struct Range
+	{
+		int first;
+		int last;
+
+		Range (int first = 0, int last = -1)
+		: first (first),
+		  last (last)
+		{}
+
+		int count () const { return last - first + 1; }
+	};
+
+	// IItemSelection
+	void CCL_API clone (IItemSelection*& selection) const override;
+	tbool CCL_API isEmpty () const override;
+	tbool CCL_API isMultiple () const override;
+	tbool CCL_API isSelected (ItemIndexRef index) const override;
+	IItemSelectionIterator* CCL_API newIterator () const override;
+	void CCL_API select (ItemIndexRef index) override;
+	tbool CCL_API unselect (ItemIndexRef index) override;
+	void CCL_API unselectAll () override;
+
+	// IItemRangeSelection
+	void CCL_API selectRange (int first, int last) override;
+	void CCL_API unselectRange (int first, int last) override;
+	int CCL_API countIndices () const override;
+	IItemRangeIterator* CCL_API newRangeIterator () const override;
+
+	CLASS_INTERFACE2 (IItemSelection, IItemRangeSelection, Object)
+
+private:
+	Vector<Range> ranges;		///< sorted, disjoint and not adjacent
+	int numIndices;
+	LinkedList<ItemIndex> others;
+
+	int findRange (int index) const; ///< index of first range with last >= index
+};
+
 //************************************************************************************************
 // ParamItemModel
 //************************************************************************************************
@@ -29,6 +29,8 @@
 #include "ccl/gui/graphics/imaging/image.h"
 #include "ccl/gui/graphics/imaging/bitmappainter.h"
 
+#include "ccl/base/message.h"
+
 #include "ccl/public/text/translation.h"
 #include "ccl/public/math/mathprimitives.h"
 #include "ccl/public/gui/icontextmenu.h"
@@ -256,7 +258,7 @@ public:
 	bool nextRow ();
 
 private:
-	const Vector<Coord>& itemBottoms;
+	const RowHeightIndex& rowHeights;
 	Coord centerMargin;
 	Coord startCoord;
 	Coord endCoord;
@@ -268,25 +270,25 @@ private:
 //************************************************************************************************
 
 inline ListView::RowIterator::RowIterator (const ListView& view, Coord startCoord, Coord endCoord)
-: numRows (view.itemBottoms.count ()),
+: numRows (view.rowHeights.count ()),
   row (-1),
   top (0),
   bottom (0),
   endCoord (endCoord),
   startCoord (startCoord),
   centerMargin (0),
-  itemBottoms (view.itemBottoms)
+  rowHeights (view.rowHeights)
 {
 	if(numRows > 0)
 	{
-		if(view.getStyle ().isCustomStyle (Styles::kListViewAppearanceCenterRows))
-			bottom = top = centerMargin = (view.getHeight () - itemBottoms.last ()) / 2;
+		bottom = top = centerMargin = view.getCenterMargin ();
 		
-		// skip rows until next row is in requested range
-		while(row + 1 < numRows - 1 && (itemBottoms[row + 1] + centerMargin) < startCoord)
+		// skip rows until next row is in requested range (the last row is never skipped)
+		int firstRow = ccl_min (rowHeights.findRow (startCoord - centerMargin - 1), numRows - 1);
+		if(firstRow > 0)
 		{
-			row++;
-			bottom = itemBottoms[row] + centerMargin;
+			row = firstRow - 1;
+			bottom = rowHeights.getBottom (row) + centerMargin;
 		}
 	}
 }
@@ -301,7 +303,7 @@ inline bool ListView::RowIterator::nextRow ()
 
 	row++;
 	top = bottom;
-	bottom = itemBottoms[row] + centerMargin;
+	bottom = top + rowHeights.getHeight (row);
 	
 	// it is the last row and it is above the area start
 	if(row >= numRows - 1 && bottom < startCoord)
@@ -324,6 +326,7 @@ BEGIN_STYLEDEF (ListView::customStyles)
 	{"drawcustomitem",	Styles::kListViewAppearanceDrawCustomItem},
 	{"navigateflat",	Styles::kListViewBehaviorNavigateFlat},
 	{"centerrows",		Styles::kListViewAppearanceCenterRows},
+	{"virtuallayout",	Styles::kListViewBehaviorVirtualLayout},
 END_STYLEDEF
 
 BEGIN_STYLEDEF (ListView::viewTypeNames)
@@ -335,6 +338,7 @@ END_STYLEDEF
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 DEFINE_CLASS (ListView, ItemView)
+DEFINE_STRINGID_MEMBER_ (ListView, kUpdateRowLayout, "updateRowLayout")
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -342,7 +346,9 @@ ListView::ListView (const Rect& size, IItemModel* model, StyleRef style)
 : ItemView (size, style),
   viewType (Styles::kListViewList),
   textTrimMode (Font::kTrimModeDefault),
-  anchorIndex (0)
+  anchorIndex (0),
+  rowHeightsValid (false),
+  rowLayoutPending (false)
 {
 	setItemStyle (NEW ListStyle);
 	setModel (model);
@@ -436,6 +442,10 @@ void ListView::onSize (const Point& delta)
 		invalidate (rect);
 	}
 
+	// row heights might depend on the width
+	if(delta.x != 0 && isVirtualLayout ())
+		rowHeights.invalidateAll ();
+
 	updateSize ();
 	
 	auto numberOfIconColumnsChanged = [&]()
@@ -497,8 +507,8 @@ int ListView::getItemHeight (ItemIndexRef index) const
 	else if(index.isValid ())
 	{
 		int i = index.getIndex ();
-		if(i < itemBottoms.count ())
-			return i > 0 ? itemBottoms[i] - itemBottoms[i - 1] : itemBottoms[0];
+		if(i < rowHeights.count ())
+			return rowHeights.getHeight (i);
 	}
 	return listStyle.getRowHeight ();
 }
@@ -512,12 +522,9 @@ void ListView::getRowRect (Rect& rect, ItemIndexRef index) const
 		int i = -1;
 		if(index.getIndex (i))
 		{
-			Coord centerMargin = 0;
-			if(getStyle ().isCustomStyle (Styles::kListViewAppearanceCenterRows))
-				centerMargin = (getHeight () - itemBottoms.last ()) / 2;
-			
-			if(i < itemBottoms.count ())
-				rect (0, i > 0 ? itemBottoms[i - 1] : centerMargin, getWidth (), itemBottoms[i] + centerMargin);
+			Coord centerMargin = getCenterMargin ();
+			if(i < rowHeights.count ())
+				rect (0, rowHeights.getTop (i) + centerMargin, getWidth (), rowHeights.getBottom (i) + centerMargin);
 		}
 	}
 }
@@ -723,14 +730,23 @@ void ListView::getSizeInfo (SizeInfo& info)
 			w += getListStyle ().getTextRect (viewType).left + 2;
 		}
 
-		// determine item heights and cache bottom coords
-		itemBottoms.resize (numItems);
-		itemBottoms.setCount (numItems);
-		for(int i = 0; i < numItems; i++)
+		if(isVirtualLayout ())
 		{
-			h += determineRowHeight (ItemIndex (i));
-			itemBottoms[i] = h;
+			// estimate item heights, rows are measured when they get drawn
+			if(!rowHeightsValid || rowHeights.count () != numItems)
+				rowHeights.reset (numItems, numItems > 0 ? determineRowHeight (ItemIndex (0)) : 0);
 		}
+		else
+		{
+			// determine item heights
+			Vector<Coord> heights (numItems);
+			heights.setCount (numItems);
+			for(int i = 0; i < numItems; i++)
+				heights[i] = determineRowHeight (ItemIndex (i));
+			rowHeights.assign (heights);
+		}
+		rowHeightsValid = true;
+		h = rowHeights.getTotal ();
 	}
 
 	info.width = w;
@@ -974,17 +990,20 @@ tbool CCL_API ListView::selectAll (tbool state)
 			return false;
 
 		selection->unselectAll ();
-		if(state)
-			for(int i = 0; i <= countItems (); i++)
-				if(model->canSelectItem (i))
-					selection->select (i);
+		selectItems (0, countItems () - 1);
 		invalidate ();
 	}
 	else
 	{
-		ForEachItem (*selection, idx)
-			invalidateItem (idx);
-		EndFor
+		UnknownPtr<IItemRangeSelection> rangeSelection (selection);
+		if(rangeSelection && rangeSelection->countIndices () > kMaxItemInvalidations)
+			invalidate ();
+		else
+		{
+			ForEachItem (*selection, idx)
+				invalidateItem (idx);
+			EndFor
+		}
 		selection->unselectAll ();
 	}
 	signalSelectionChanged ();
@@ -1002,12 +1021,20 @@ bool ListView::selectRange (ItemIndexRef index1, ItemIndexRef index2)
 		to = from;
 
 	getSelection ();
-	for(int i = from; i <= to; i++)
+	if(to - from >= kMaxItemInvalidations)
 	{
-		if(model->canSelectItem (i) && selection->isSelected (i) == false)
+		selectItems (from, to);
+		invalidate ();
+	}
+	else
+	{
+		for(int i = from; i <= to; i++)
 		{
-			selection->select (i);
-			invalidateItem (ItemIndex (i));
+			if(model->canSelectItem (i) && selection->isSelected (i) == false)
+			{
+				selection->select (i);
+				invalidateItem (ItemIndex (i));
+			}
 		}
 	}
 	signalSelectionChanged ();
@@ -1016,6 +1043,38 @@ bool ListView::selectRange (ItemIndexRef index1, ItemIndexRef index2)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+void ListView::selectItems (int from, int to)
+{
+	// add runs of selectable items, without invalidating them
+	UnknownPtr<IItemRangeSelection> rangeSelection (selection);
+	int runStart = -1;
+	for(int i = from; i <= to + 1; i++)
+	{
+		if(i <= to && model->canSelectItem (i))
+		{
+			if(runStart < 0)
+				runStart = i;
+			if(!rangeSelection && !selection->isSelected (i))
+				selection->select (i);
+		}
+		else if(runStart >= 0)
+		{
+			if(rangeSelection)
+				rangeSelection->selectRange (runStart, i - 1);
+			runStart = -1;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IItemSelection* ListView::createSelection () const
+{
+	return NEW ItemRangeSelection;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 tbool CCL_API ListView::removeItem (ItemIndexRef index)
 {
 	if(model && model->removeItem (index))
@@ -1609,6 +1668,18 @@ bool ListView::onContextMenu (const ContextMenuEvent& event)
 
 void ListView::modelChanged (int changeType, ItemIndexRef item)
 {
+	if(changeType == kItemModified)
+	{
+		// measure again when drawn, all rows if the item is unknown
+		int i = -1;
+		if(item.getIndex (i) && i >= 0 && i < rowHeights.count ())
+			rowHeights.invalidate (i);
+		else
+			rowHeights.invalidateAll ();
+	}
+	else
+		rowHeightsValid = false;
+
 	if(changeType == kItemRemoved)
 	{
 		if(item.getIndex () == anchorIndex)
@@ -1649,6 +1720,64 @@ void ListView::modelChanged (int changeType, ItemIndexRef item)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+void CCL_API ListView::notify (ISubject* subject, MessageRef msg)
+{
+	if(msg == kUpdateRowLayout)
+	{
+		rowLayoutPending = false;
+		updateSize ();
+	}
+	else
+		SuperClass::notify (subject, msg);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ListView::isVirtualLayout () const
+{
+	return style.isCustomStyle (Styles::kListViewBehaviorVirtualLayout) && viewType < Styles::kListViewIcons;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+Coord ListView::getCenterMargin () const
+{
+	if(getStyle ().isCustomStyle (Styles::kListViewAppearanceCenterRows) && !rowHeights.isEmpty ())
+		return (getHeight () - rowHeights.getTotal ()) / 2;
+	return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ListView::measureRows (Coord top, Coord bottom)
+{
+	Coord oldTotal = rowHeights.getTotal ();
+
+	// rows are laid out below the center margin
+	Coord centerMargin = getCenterMargin ();
+	top -= centerMargin;
+	bottom -= centerMargin;
+
+	int numRows = rowHeights.count ();
+	int row = rowHeights.findRow (top);
+	Coord rowTop = row < numRows ? rowHeights.getTop (row) : 0;
+	for(; row < numRows && rowTop <= bottom; row++)
+	{
+		if(!rowHeights.isMeasured (row))
+			rowHeights.setHeight (row, determineRowHeight (ItemIndex (row)));
+		rowTop += rowHeights.getHeight (row);
+	}
+
+	// adjust total size later, we might be called while drawing
+	if(rowHeights.getTotal () != oldTotal && !rowLayoutPending)
+	{
+		rowLayoutPending = true;
+		(NEW Message (kUpdateRowLayout))->post (this, -1);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 void ListView::drawItems (GraphicsPort& port, const UpdateRgn& updateRgn, const Font& font)
 {
 	int rowH = getItemHeight (ItemIndex ());
@@ -1971,6 +2100,9 @@ void ListView::drawListMatrix (GraphicsPort& port, const UpdateRgn& updateRgn, F
 	if(numColumns < 1)
 		numColumns = 1;
 
+	if(isVirtualLayout ())
+		measureRows (updateRgn.bounds.top, updateRgn.bounds.bottom);
+
 	RowIterator rowIter (*this, updateRgn.bounds.top, updateRgn.bounds.bottom);
 	while(rowIter.nextRow ())
 	{
@@ -20,6 +20,7 @@
 #define _ccl_listview_h
 
 #include "ccl/gui/itemviews/itemview.h"
+#include "ccl/gui/itemviews/rowheightindex.h"
 
 #include "ccl/gui/views/scrollview.h"
 
@@ -126,9 +127,16 @@ public:
 	ITouchHandler* createTouchHandler (const TouchEvent& event) override;
 	IUnknown* CCL_API getController () const override;
 
+	// IObserver
+	void CCL_API notify (ISubject* subject, MessageRef msg) override;
+
 	CLASS_INTERFACE (IListView, ItemView)
 
 protected:
+	DECLARE_STRINGID_MEMBER (kUpdateRowLayout)
+
+	static const int kMaxItemInvalidations = 64; ///< invalidate whole view when (un)selecting more items
+
 	struct ItemInfo
 	{
 		int row;
@@ -150,7 +158,9 @@ protected:
 	int textTrimMode;
 	int anchorIndex; ///< the starting item for a range selection
 	ItemInfo focusItem; ///< the item that has keyboard focus (rect not used)
-	Vector<Coord> itemBottoms;
+	RowHeightIndex rowHeights;
+	bool rowHeightsValid;
+	bool rowLayoutPending;
 	
 	int getItemWidth () const;
 	int getDefaultItemWidth () const;
@@ -160,6 +170,9 @@ protected:
 	int countRows () const;
 	int countColumns () const;
 	void autoCenterItemRect (Rect& rect);
+	bool isVirtualLayout () const;
+	Coord getCenterMargin () const;
+	void measureRows (Coord top, Coord bottom);
 	
 	void drawListMatrix (GraphicsPort& port, const UpdateRgn& updateRgn, FontRef font);
 	void drawCell (GraphicsPort& port, const Rect& rect, int row, int column, int state, FontRef font, BrushRef textBrush);
@@ -177,8 +190,10 @@ protected:
 	bool getCellAddress (int& row, int& column, PointRef where) const;
 	void setFocusCell (int row, int column);
 	bool onTap (const GestureEvent& event);
+	void selectItems (int from, int to);
 
 	// ItemView
+	IItemSelection* createSelection () const override;
 	bool getAnchorItem (ItemIndex& index) const override;
 	bool setAnchorItem (ItemIndexRef index) override;
 	bool selectRange (ItemIndexRef fromIndex, ItemIndexRef toIndex) override;
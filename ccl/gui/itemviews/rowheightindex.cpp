@@ -0,0 +1,188 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/gui/itemviews/rowheightindex.cpp
+// Description : Row Height Index
+//
+//************************************************************************************************
+
+#include "ccl/gui/itemviews/rowheightindex.h"
+
+#include "ccl/public/base/debug.h"
+
+using namespace CCL;
+
+//************************************************************************************************
+// RowHeightIndex
+//************************************************************************************************
+
+RowHeightIndex::RowHeightIndex ()
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void RowHeightIndex::reset (int count, Coord estimatedHeight)
+{
+	heights.resize (count);
+	heights.setCount (count);
+	for(int i = 0; i < count; i++)
+		heights[i] = estimatedHeight;
+
+	measured.resize (count);
+	measured.setAllBits (false);
+	build ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void RowHeightIndex::assign (const Vector<Coord>& _heights)
+{
+	heights.copyVector (_heights);
+
+	measured.resize (heights.count ());
+	measured.setAllBits (true);
+	build ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void RowHeightIndex::build ()
+{
+	// O(n): each node passes its sum on to its parent
+	int n = heights.count ();
+	tree.resize (n + 1);
+	tree.setCount (n + 1);
+	tree[0] = 0;
+	for(int i = 1; i <= n; i++)
+		tree[i] = heights[i - 1];
+	for(int i = 1; i <= n; i++)
+	{
+		int parent = i + (i & -i);
+		if(parent <= n)
+			tree[parent] += tree[i];
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int RowHeightIndex::count () const
+{
+	return heights.count ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool RowHeightIndex::isEmpty () const
+{
+	return heights.isEmpty ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+Coord RowHeightIndex::getHeight (int row) const
+{
+	ASSERT (row >= 0 && row < heights.count ())
+	return heights[row];
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void RowHeightIndex::setHeight (int row, Coord height)
+{
+	ASSERT (row >= 0 && row < heights.count ())
+	ASSERT (height >= 0)
+	measured.setBit (row, true);
+
+	Coord delta = height - heights[row];
+	if(delta == 0)
+		return;
+
+	heights[row] = height;
+	int n = heights.count ();
+	for(int i = row + 1; i <= n; i += i & -i)
+		tree[i] += delta;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool RowHeightIndex::isMeasured (int row) const
+{
+	return measured.getBit (row);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void RowHeightIndex::invalidate (int row)
+{
+	if(row >= 0 && row < heights.count ())
+		measured.setBit (row, false);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void RowHeightIndex::invalidateAll ()
+{
+	measured.setAllBits (false);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+Coord RowHeightIndex::getTop (int row) const
+{
+	ASSERT (row >= 0 && row <= heights.count ())
+	Coord sum = 0;
+	for(int i = row; i > 0; i -= i & -i)
+		sum += tree[i];
+	return sum;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+Coord RowHeightIndex::getBottom (int row) const
+{
+	return getTop (row + 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+Coord RowHeightIndex::getTotal () const
+{
+	return getTop (heights.count ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int RowHeightIndex::findRow (Coord y) const
+{
+	if(y < 0)
+		return 0;
+
+	// descend the tree, skipping subtrees that end at or above y
+	int n = heights.count ();
+	int step = 1;
+	while(step * 2 <= n)
+		step *= 2;
+
+	int position = 0;
+	Coord remaining = y;
+	for(; step > 0; step /= 2)
+	{
+		int next = position + step;
+		if(next <= n && tree[next] <= remaining)
+		{
+			position = next;
+			remaining -= tree[next];
+		}
+	}
+	return position;
+}
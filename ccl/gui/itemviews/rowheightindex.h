@@ -0,0 +1,73 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/gui/itemviews/rowheightindex.h
+// Description : Row Height Index
+//
+//************************************************************************************************
+
+#ifndef _ccl_rowheightindex_h
+#define _ccl_rowheightindex_h
+
+#include "ccl/public/gui/graphics/point.h"
+#include "ccl/public/collections/vector.h"
+#include "ccl/public/collections/bitset.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// RowHeightIndex
+/** Row heights with prefix sums in a binary indexed (Fenwick) tree.
+	Changing a row height and mapping between rows and coordinates is O(log n).
+	Rows can be initialized with an estimated height and measured later. */
+//************************************************************************************************
+
+class RowHeightIndex
+{
+public:
+	RowHeightIndex ();
+
+	/** Set number of rows, all rows get the estimated height and are marked as not measured. */
+	void reset (int count, Coord estimatedHeight);
+
+	/** Set all row heights, rows are marked as measured. */
+	void assign (const Vector<Coord>& heights);
+
+	int count () const;
+	bool isEmpty () const;
+
+	Coord getHeight (int row) const;
+	void setHeight (int row, Coord height); ///< marks row as measured
+
+	bool isMeasured (int row) const;
+	void invalidate (int row);	///< row keeps its height until measured again
+	void invalidateAll ();
+
+	Coord getTop (int row) const;		///< sum of heights of rows before given row
+	Coord getBottom (int row) const;
+	Coord getTotal () const;
+
+	/** Find row containing the given coordinate, i.e. top <= y < bottom. Returns count () if y is below the last row. */
+	int findRow (Coord y) const;
+
+protected:
+	Vector<Coord> heights;
+	Vector<Coord> tree;	///< 1-based, tree[i] holds the sum of heights (i - lowbit (i), i]
+	BitSet measured;
+
+	void build ();
+};
+
+} // namespace CCL
+
+#endif // _ccl_rowheightindex_h
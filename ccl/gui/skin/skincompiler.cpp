@@ -0,0 +1,529 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/gui/skin/skincompiler.cpp
+// Description : Compiled Skin Format
+//
+//************************************************************************************************
+
+#define DEBUG_LOG 0
+
+#include "ccl/gui/skin/skincompiler.h"
+#include "ccl/gui/skin/skinparser.h"
+#include "ccl/gui/skin/skinattributes.h"
+
+#include "ccl/base/storage/url.h"
+
+#include "ccl/public/base/streamer.h"
+#include "ccl/public/base/memorystream.h"
+#include "ccl/public/text/cstring.h"
+#include "ccl/public/text/istringdict.h"
+#include "ccl/public/text/xmlcontentparser.h"
+#include "ccl/public/system/ifileutilities.h"
+#include "ccl/public/system/inativefilesystem.h"
+#include "ccl/public/systemservices.h"
+#include "ccl/public/textservices.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// CompiledSkin::ReplayAttributes
+//************************************************************************************************
+
+class CompiledSkin::ReplayAttributes: public SkinAttributes
+{
+public:
+	ReplayAttributes (const Vector<String>& strings, const int32* pairs, int numPairs)
+	: strings (strings),
+	  pairs (pairs),
+	  numPairs (numPairs)
+	{}
+
+	// SkinAttributes
+	String getString (StringID name) const override
+	{
+		String nameString (name);
+		for(int i = 0; i < numPairs; i++)
+			if(strings[pairs[2 * i]].compare (nameString, kAttrCaseSensitive) == Text::kEqual)
+				return strings[pairs[2 * i + 1]];
+		return String ();
+	}
+
+	bool setString (StringID name, StringRef value) override
+	{
+		CCL_DEBUGGER ("Attributes are read-only!")
+		return false;
+	}
+
+	int count () const override
+	{
+		return numPairs;
+	}
+
+	MutableCString getNameAt (int index) const override
+	{
+		return MutableCString (strings[pairs[2 * index]]);
+	}
+
+	String getStringAt (int index) const override
+	{
+		return strings[pairs[2 * index + 1]];
+	}
+
+protected:
+	const Vector<String>& strings;
+	const int32* pairs;
+	int numPairs;
+};
+
+//************************************************************************************************
+// SkinCompilerParser
+/** Records XML events only, without building a skin model. */
+//************************************************************************************************
+
+class SkinCompilerParser: public XmlContentParser
+{
+public:
+	SkinCompilerParser (CompiledSkin& compiledSkin)
+	: compiledSkin (compiledSkin)
+	{}
+
+	// XmlContentParser
+	tresult CCL_API startElement (StringRef name, const IStringDictionary& attributes) override
+	{
+		compiledSkin.beginElement (name, attributes, xmlParser->getCurrentLineNumber ());
+		return kResultOk;
+	}
+
+	tresult CCL_API endElement (StringRef name) override
+	{
+		compiledSkin.endElement ();
+		return kResultOk;
+	}
+
+	tresult CCL_API processingInstruction (StringRef target, StringRef data) override
+	{
+		compiledSkin.addInstruction (target, data);
+		return kResultOk;
+	}
+
+protected:
+	CompiledSkin& compiledSkin;
+};
+
+} // namespace CCL
+
+using namespace CCL;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Format
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const DEFINE_FOURCC (kCompiledSkinID, 's', 'k', 'i', 'n');
+
+static int hashString (const String& string, int size)
+{
+	return int (string.getHashCode () % (unsigned int)size);
+}
+
+//************************************************************************************************
+// CompiledSkin::SourceKey
+//************************************************************************************************
+
+CompiledSkin::SourceKey::SourceKey (const FileInfo& xmlInfo)
+: size (xmlInfo.fileSize),
+  modifiedTime (xmlInfo.modifiedTime.toOrdinal () * 1000 + xmlInfo.modifiedTime.getTime ().getMilliseconds ())
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool CompiledSkin::SourceKey::calculateCrc (uint32& crc, IStream& xmlStream)
+{
+	AutoPtr<IMemoryStream> memory;
+	if(UnknownPtr<IMemoryStream> mapped = &xmlStream)
+		memory.share (mapped);
+	else
+		memory = System::GetFileUtilities ().createStreamCopyInMemory (xmlStream);
+	if(memory == nullptr)
+		return false;
+
+	crc = System::Crc32 (memory->getMemoryAddress (), memory->getBytesWritten (), 0);
+	return true;
+}
+
+//************************************************************************************************
+// CompiledSkin
+//************************************************************************************************
+
+StringRef CompiledSkin::getExtension ()
+{
+	static const String kExtension ("skinbin");
+	return kExtension;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CompiledSkin::CompiledSkin ()
+: stringIndex (1024, hashString, -1),
+  mappedCode (nullptr),
+  mappedCodeSize (0)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CompiledSkin::~CompiledSkin ()
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CompiledSkin::removeAll ()
+{
+	strings.removeAll ();
+	stringIndex.removeAll ();
+	recordedCode.removeAll ();
+	memory.release ();
+	mappedCode = nullptr;
+	mappedCodeSize = 0;
+	sourceKey = SourceKey ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int32 CompiledSkin::intern (StringRef string)
+{
+	int32 index = stringIndex.lookup (string);
+	if(index < 0)
+	{
+		index = strings.count ();
+		strings.add (string);
+		stringIndex.add (string, index);
+	}
+	return index;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+const int32* CompiledSkin::getCode (int32& size) const
+{
+	if(mappedCode)
+	{
+		size = mappedCodeSize;
+		return mappedCode;
+	}
+	size = recordedCode.count ();
+	return recordedCode.getItems ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CompiledSkin::beginElement (StringRef name, const IStringDictionary& attributes, int lineNumber)
+{
+	ASSERT (mappedCode == nullptr)
+	int numAttributes = attributes.countEntries ();
+	recordedCode.add (kOpBeginElement);
+	recordedCode.add (intern (name));
+	recordedCode.add (lineNumber);
+	recordedCode.add (numAttributes);
+	for(int i = 0; i < numAttributes; i++)
+	{
+		recordedCode.add (intern (String (attributes.getKeyAt (i))));
+		recordedCode.add (intern (String (attributes.getValueAt (i))));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CompiledSkin::endElement ()
+{
+	ASSERT (mappedCode == nullptr)
+	recordedCode.add (kOpEndElement);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CompiledSkin::addInstruction (StringRef target, StringRef data)
+{
+	ASSERT (mappedCode == nullptr)
+	recordedCode.add (kOpInstruction);
+	recordedCode.add (intern (target));
+	recordedCode.add (intern (data));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool CompiledSkin::validate () const
+{
+	int32 size = 0;
+	const int32* code = getCode (size);
+	int32 numStrings = strings.count ();
+	auto isString = [numStrings] (int32 index) { return index >= 0 && index < numStrings; };
+
+	int depth = 0;
+	int pc = 0;
+	while(pc < size)
+	{
+		switch(code[pc++])
+		{
+		case kOpBeginElement :
+			{
+				if(pc + 3 > size || !isString (code[pc]))
+					return false;
+				int32 numAttributes = code[pc + 2];
+				pc += 3;
+				if(numAttributes < 0 || numAttributes > (size - pc) / 2)
+					return false;
+				for(int i = 0; i < 2 * numAttributes; i++)
+					if(!isString (code[pc++]))
+						return false;
+				depth++;
+			}
+			break;
+
+		case kOpEndElement :
+			if(--depth < 0)
+				return false;
+			break;
+
+		case kOpInstruction :
+			if(pc + 2 > size || !isString (code[pc]) || !isString (code[pc + 1]))
+				return false;
+			pc += 2;
+			break;
+
+		default :
+			return false;
+		}
+	}
+	return depth == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool CompiledSkin::save (IStream& stream, const SourceKey& key) const
+{
+	int32 codeSize = 0;
+	const int32* code = getCode (codeSize);
+
+	// string table
+	AutoPtr<MemoryStream> stringData = NEW MemoryStream;
+	Streamer stringStreamer (*stringData);
+	for(auto& string : strings)
+		if(!stringStreamer.writeWithLength (string))
+			return false;
+
+	// pad so that code is aligned in mapped memory
+	static const char kPadding[4] = {0};
+	int padding = (4 - (int)(stringData->getBytesWritten () % 4)) % 4;
+	if(padding > 0 && stringData->write (kPadding, padding) != padding)
+		return false;
+
+	// code is written in native byte order to be used in place
+	Streamer s (stream);
+	return s.write (kCompiledSkinID) && s.write ((int32)kFormatVersion) && s.write ((int32)kNativeByteOrder)
+		&& s.write (key.size) && s.write (key.modifiedTime) && s.write (key.crc)
+		&& s.write ((int32)strings.count ()) && s.write ((int32)stringData->getBytesWritten ()) && s.write (codeSize)
+		&& stringData->writeTo (stream)
+		&& stream.write (code, codeSize * sizeof(int32)) == int (codeSize * sizeof(int32));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool CompiledSkin::save (UrlRef path, const SourceKey& key) const
+{
+	Url tempPath (path);
+	tempPath.setName ("tempskin");
+
+	bool result = false;
+	if(AutoPtr<IStream> file = System::GetFileSystem ().openStream (tempPath, IStream::kCreateMode))
+		result = save (*file, key);
+
+	String fileName;
+	path.getName (fileName, true);
+	if(result)
+	{
+		if(System::GetFileSystem ().fileExists (path))
+			System::GetFileSystem ().removeFile (path);
+		result = System::GetFileSystem ().renameFile (tempPath, fileName) != 0;
+	}
+	else
+		System::GetFileSystem ().removeFile (tempPath);
+
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool CompiledSkin::load (UrlRef path, const SourceKey* key)
+{
+	AutoPtr<IStream> file = System::GetFileSystem ().openStream (path, IStream::kOpenMode|IStream::kMapped);
+	return file ? load (*file, key) : false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool CompiledSkin::load (IStream& stream, const SourceKey* key)
+{
+	removeAll ();
+
+	// read directly from mapped memory if possible
+	if(UnknownPtr<IMemoryStream> mapped = &stream)
+		memory.share (mapped);
+	else
+		memory = System::GetFileUtilities ().createStreamCopyInMemory (stream);
+	if(memory == nullptr)
+		return false;
+
+	const char* base = static_cast<const char*> (memory->getMemoryAddress ());
+	uint32 totalSize = memory->getBytesWritten ();
+	if(base == nullptr)
+	{
+		removeAll ();
+		return false;
+	}
+
+	AutoPtr<MemoryStream> headerStream = NEW MemoryStream (const_cast<char*> (base), totalSize);
+	Streamer s (*headerStream);
+
+	FOURCC id = {0};
+	int32 version = 0, byteOrder = 0;
+	SourceKey savedKey;
+	int32 numStrings = 0, stringDataSize = 0, codeSize = 0;
+	bool valid = s.read (id) && id == kCompiledSkinID && s.read (version) && version == kFormatVersion
+		&& s.read (byteOrder) && byteOrder == kNativeByteOrder
+		&& s.read (savedKey.size) && s.read (savedKey.modifiedTime) && s.read (savedKey.crc)
+		&& s.read (numStrings) && s.read (stringDataSize) && s.read (codeSize)
+		&& numStrings >= 0 && stringDataSize >= 0 && codeSize >= 0;
+	if(!valid)
+	{
+		removeAll ();
+		return false;
+	}
+
+	if(key && savedKey != *key)
+	{
+		CCL_PRINTLN ("Compiled skin outdated")
+		removeAll ();
+		return false;
+	}
+
+	uint64 codeStart = (uint64)headerStream->tell () + stringDataSize;
+	if(codeStart + (uint64)codeSize * sizeof(int32) > totalSize || (codeStart % sizeof(int32)) != 0)
+	{
+		removeAll ();
+		return false;
+	}
+
+	// decode string table...
+	strings.resize (numStrings);
+	for(int i = 0; i < numStrings; i++)
+	{
+		String string;
+		if(!s.readWithLength (string))
+		{
+			removeAll ();
+			return false;
+		}
+		strings.add (string);
+	}
+
+	// ...code is used in place
+	mappedCode = reinterpret_cast<const int32*> (base + codeStart);
+	mappedCodeSize = codeSize;
+
+	if(!validate ())
+	{
+		removeAll ();
+		return false;
+	}
+
+	sourceKey = savedKey;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool CompiledSkin::replay (SkinParser& parser) const
+{
+	int32 size = 0;
+	const int32* code = getCode (size);
+	const int32* end = code + size;
+	while(code < end)
+	{
+		switch(*code++)
+		{
+		case kOpBeginElement :
+			{
+				MutableCString name (strings[code[0]]);
+				int lineNumber = code[1];
+				int numAttributes = code[2];
+				ReplayAttributes attributes (strings, code + 3, numAttributes);
+				code += 3 + 2 * numAttributes;
+
+				if(!parser.beginElement (name, attributes, lineNumber))
+					return false;
+			}
+			break;
+
+		case kOpEndElement :
+			parser.finishElement ();
+			break;
+
+		case kOpInstruction :
+			parser.handleInstruction (strings[code[0]], strings[code[1]]);
+			code += 2;
+			break;
+		}
+	}
+	return true;
+}
+
+//************************************************************************************************
+// SkinCompiler
+//************************************************************************************************
+
+bool SkinCompiler::compile (IStream& outStream, IStream& xmlStream, const CompiledSkin::SourceKey& key)
+{
+	CompiledSkin compiledSkin;
+	SkinCompilerParser parser (compiledSkin);
+	if(!parser.parse (xmlStream))
+		return false;
+
+	return compiledSkin.save (outStream, key);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SkinCompiler::compile (UrlRef xmlPath)
+{
+	FileInfo xmlInfo;
+	if(!System::GetFileSystem ().getFileInfo (xmlInfo, xmlPath))
+		return false;
+
+	AutoPtr<IStream> xmlStream = System::GetFileSystem ().openStream (xmlPath, IStream::kOpenMode);
+	if(xmlStream == nullptr)
+		return false;
+
+	// packaging may not preserve modification times, the runtime compares content if in doubt
+	CompiledSkin::SourceKey key (xmlInfo);
+	if(!CompiledSkin::SourceKey::calculateCrc (key.crc, *xmlStream) || !xmlStream->rewind ())
+		return false;
+
+	Url compiledPath (xmlPath);
+	compiledPath.setExtension (CompiledSkin::getExtension (), true);
+
+	AutoPtr<IStream> outStream = System::GetFileSystem ().openStream (compiledPath, IStream::kCreateMode);
+	if(outStream == nullptr)
+		return false;
+
+	return compile (*outStream, *xmlStream, key);
+}
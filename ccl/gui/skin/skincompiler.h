@@ -0,0 +1,150 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/gui/skin/skincompiler.h
+// Description : Compiled Skin Format
+//
+//************************************************************************************************
+
+#ifndef _ccl_skincompiler_h
+#define _ccl_skincompiler_h
+
+#include "ccl/public/base/istream.h"
+#include "ccl/public/base/smartptr.h"
+#include "ccl/public/collections/vector.h"
+#include "ccl/public/collections/hashmap.h"
+#include "ccl/public/text/cclstring.h"
+#include "ccl/public/system/ifilesystem.h"
+
+namespace CCL {
+
+class SkinParser;
+
+interface IStringDictionary;
+
+//************************************************************************************************
+// CompiledSkin
+/** Binary representation of a skin XML file, recorded while parsing and replayed by SkinParser
+	without running the XML parser again.
+
+	All tag names, attribute names and values are interned in a string table, followed by a flat
+	array of opcodes for elements and processing instructions in document order. Processing
+	instructions are kept rather than evaluated, so a file compiled at build time is valid for
+	all platforms and configurations. The file is keyed by size and modification time of the XML
+	source, so a cached file can be validated without reading the XML. Files compiled at build
+	time also store a CRC-32 of the XML content, packaging may leave both files with the same
+	time stamp. It is read from mapped memory, the opcodes are used in place. */
+//************************************************************************************************
+
+class CompiledSkin
+{
+public:
+	CompiledSkin ();
+	~CompiledSkin ();
+
+	static const int kFormatVersion = 3;
+
+	/** Identifies the XML source file a skin was compiled from. */
+	struct SourceKey
+	{
+		int64 size = 0;
+		int64 modifiedTime = 0;	///< milliseconds
+		uint32 crc = 0;			///< content of XML source, only calculated at build time
+
+		SourceKey () {}
+		SourceKey (const FileInfo& xmlInfo);
+
+		/** Calculate CRC-32 of XML source, reads the whole stream. */
+		static bool calculateCrc (uint32& crc, IStream& xmlStream);
+
+		bool operator == (const SourceKey& other) const { return size == other.size && modifiedTime == other.modifiedTime && crc == other.crc; }
+		bool operator != (const SourceKey& other) const { return !(*this == other); }
+	};
+
+	static StringRef getExtension ();
+
+	// recording
+	void beginElement (StringRef name, const IStringDictionary& attributes, int lineNumber);
+	void endElement ();
+	void addInstruction (StringRef target, StringRef data);
+	void removeAll ();
+
+	/** Write to stream, the recorded source must match the given key. */
+	bool save (IStream& stream, const SourceKey& key) const;
+
+	/** Write to file via temporary file. */
+	bool save (UrlRef path, const SourceKey& key) const;
+
+	/** Load from stream, fails if the file is invalid or was compiled from a different source than the given key. */
+	bool load (IStream& stream, const SourceKey* key = nullptr);
+
+	/** Load from file, mapped into memory if possible. */
+	bool load (UrlRef path, const SourceKey* key = nullptr);
+
+	/** Key of the source the loaded file was compiled from. */
+	const SourceKey& getSourceKey () const;
+
+	bool isEmpty () const;
+
+	/** Feed elements and processing instructions into parser. */
+	bool replay (SkinParser& parser) const;
+
+protected:
+	enum Opcodes
+	{
+		kOpBeginElement,	///< tag, line number, attribute count, [name, value] * count
+		kOpEndElement,
+		kOpInstruction		///< target, data
+	};
+
+	Vector<String> strings;
+	HashMap<String, int32> stringIndex;	///< recording only
+	Vector<int32> recordedCode;
+	AutoPtr<IMemoryStream> memory;		///< loaded file
+	const int32* mappedCode;			///< points into memory if loaded
+	int32 mappedCodeSize;
+	SourceKey sourceKey;				///< loaded file
+
+	int32 intern (StringRef string);
+	const int32* getCode (int32& size) const;
+	bool validate () const;
+
+	class ReplayAttributes;
+};
+
+//************************************************************************************************
+// SkinCompiler
+/** Compiles skin XML files without building a skin model, used to write compiled skins at
+	build time. */
+//************************************************************************************************
+
+namespace SkinCompiler
+{
+	/** Compile XML from stream, write result to given stream. */
+	bool compile (IStream& outStream, IStream& xmlStream, const CompiledSkin::SourceKey& key);
+
+	/** Compile XML file, the result is written next to it with CompiledSkin extension.
+		The key includes a CRC of the XML content. */
+	bool compile (UrlRef xmlPath);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// inline
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+inline bool CompiledSkin::isEmpty () const { int32 size = 0; getCode (size); return size == 0; }
+inline const CompiledSkin::SourceKey& CompiledSkin::getSourceKey () const { return sourceKey; }
+
+} // namespace CCL
+
+#endif // _ccl_skincompiler_h
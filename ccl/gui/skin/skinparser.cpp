@@ -22,6 +22,7 @@
 
 #include "ccl/gui/skin/skinmodel.h"
 #include "ccl/gui/skin/skinattributes.h"
+#include "ccl/gui/skin/skincompiler.h"
 
 #include "ccl/public/storage/iurl.h"
 #include "ccl/public/text/cstring.h"
@@ -63,7 +64,8 @@ using namespace SkinElements;
 //************************************************************************************************
 
 SkinParser::SkinParser (ISkinContext* context)
-: firstTag (true)
+: firstTag (true),
+  recorder (nullptr)
 {
 	current = model = NEW SkinModel (context);
 }
@@ -103,6 +105,22 @@ SkinModel* SkinParser::parseSkin (IStream& stream)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+SkinModel* SkinParser::parseSkin (const CompiledSkin& compiledSkin)
+{
+	if(compiledSkin.replay (*this) == false)
+	{
+		String message ("Invalid compiled skin");
+		message << "\nXML file: ";
+		message << fileName;
+		Alert::error (message);
+		return nullptr;
+	}
+
+	return return_shared (model);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 SkinModel* SkinParser::getModel () 
 { 
 	return model; 
@@ -125,12 +143,56 @@ void SkinParser::setFileName (CStringRef _fileName)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+void SkinParser::setRecorder (CompiledSkin* _recorder)
+{
+	recorder = _recorder;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 tresult CCL_API SkinParser::startElement (StringRef name, const IStringDictionary& attributes)
 {
+	int lineNumber = xmlParser->getCurrentLineNumber ();
+	if(recorder)
+		recorder->beginElement (name, attributes, lineNumber);
+
+	if(skipping)
+		return kResultOk;
+
+	return beginElement (MutableCString (name), SkinXmlAttributes (attributes), lineNumber) ? kResultOk : kResultFalse;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API SkinParser::endElement (StringRef name)
+{
+	if(recorder)
+		recorder->endElement ();
+
 	if(skipping)
 		return kResultOk;
 
-	MutableCString asciiName (name);
+	finishElement ();
+	return kResultOk;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API SkinParser::processingInstruction (StringRef target, StringRef data)
+{
+	if(recorder)
+		recorder->addInstruction (target, data);
+
+	XmlProcessingInstructionHandler::handleInstruction (target, data);
+	return kResultOk;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SkinParser::beginElement (CStringRef asciiName, const SkinAttributes& attributes, int lineNumber)
+{
+	if(skipping)
+		return true;
 
 	if(firstTag)
 	{
@@ -138,9 +200,9 @@ tresult CCL_API SkinParser::startElement (StringRef name, const IStringDictionar
 		bool isSkin = asciiName.compare (TAG_SKIN, MetaElement::kTagsCaseSensitive) == Text::kEqual;
 
 		if(isSkin) // set root attributes
-			model->setAttributes (SkinXmlAttributes (attributes));
+			model->setAttributes (attributes);
 		
-		return isSkin ? kResultOk : kResultFalse;
+		return isSkin;
 	}
 
 	Element* e = MetaElement::createElement (asciiName);
@@ -152,25 +214,25 @@ tresult CCL_API SkinParser::startElement (StringRef name, const IStringDictionar
 
 	ASSERT (!fileName.isEmpty ())
 	e->setFileName (fileName);
-	e->setLineNumber (xmlParser->getCurrentLineNumber ());
+	e->setLineNumber (lineNumber);
 
 	e->setParent (current);    // uplink before loading attributes
-	e->setAttributes (SkinXmlAttributes (attributes));
+	e->setAttributes (attributes);
 
 	ASSERT (current != nullptr)
 	if(current)
 		current->addChild (e); // requires name to be set because of sorting
 	current = e;
 
-	return kResultOk;
+	return true;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-tresult CCL_API SkinParser::endElement (StringRef name)
+void SkinParser::finishElement ()
 {
 	if(skipping)
-		return kResultOk;
+		return;
 
 	if(current)
 		current->loadFinished ();
@@ -178,16 +240,6 @@ tresult CCL_API SkinParser::endElement (StringRef name)
 	current = current ? current->getParent () : nullptr;
 	if(!current)
 		current = model;
-
-	return kResultOk;
-}
-
-//////////////////////////////////////////////////////////////////////////////////////////////////
-
-tresult CCL_API SkinParser::processingInstruction (StringRef target, StringRef data)
-{
-	XmlProcessingInstructionHandler::handleInstruction (target, data);
-	return kResultOk;
 }
 
 //************************************************************************************************
@@ -29,6 +29,8 @@
 namespace CCL {
 
 class SkinModel;
+class SkinAttributes;
+class CompiledSkin;
 class ISkinContext;
 
 namespace SkinElements {
@@ -47,11 +49,19 @@ public:
 
 	SkinModel* parseSkin (UrlRef url);
 	SkinModel* parseSkin (IStream& stream);
+	SkinModel* parseSkin (const CompiledSkin& compiledSkin);	///< replay compiled skin instead of parsing XML
 	SkinModel* getModel ();
 
 	bool getFirstError (String& message) const;
 	void setFileName (CStringRef fileName);
 
+	/** Record XML parsed with parseSkin () into compiled skin. */
+	void setRecorder (CompiledSkin* recorder);
+
+	// shared by XML parsing and compiled skin replay
+	bool beginElement (CStringRef name, const SkinAttributes& attributes, int lineNumber);
+	void finishElement ();
+
 	// XmlContentParser
 	tresult CCL_API startElement (StringRef name, const IStringDictionary& attributes) override;
 	tresult CCL_API endElement (StringRef name) override;
@@ -62,6 +72,7 @@ protected:
 	bool firstTag;
 	SkinElements::Element* current;
 	MutableCString fileName;   // for error reporting
+	CompiledSkin* recorder;
 };
 
 } // namespace CCL
@@ -20,6 +20,8 @@
 
 #include "ccl/gui/skin/skinregistry.h"
 #include "ccl/gui/skin/skinwizard.h"
+#include "ccl/gui/skin/skinparser.h"
+#include "ccl/gui/skin/skincompiler.h"
 
 #include "ccl/gui/views/view.h"
 
@@ -112,6 +114,7 @@ DEFINE_SINGLETON (SkinRegistry)
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 SkinRegistry::SkinRegistry ()
+: compiledSkinsEnabled (true)
 {
 	searchLocations.objectCleanup (true);
 
@@ -346,3 +349,87 @@ View* SkinRegistry::createView (const FormReference& reference, IUnknown* contro
 	return createView (path, controller, arguments);
 }
 
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SkinRegistry::getCompiledSkinCachePath (Url& path, UrlRef xmlUrl, StringID skinID) const
+{
+	String fileName (skinID);
+	if(fileName.isEmpty ())
+		fileName = CCLSTR ("skin");
+	fileName << "-" << xmlUrl.getPath ();
+	fileName.replace ("/", "_");
+	fileName.replace (":", "_");
+
+	System::GetSystem ().getLocation (path, System::kAppSettingsPlatformFolder);
+	path.descend (fileName);
+	path.setExtension (CompiledSkin::getExtension (), true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool isCompiledFrom (const CompiledSkin::SourceKey& savedKey, IFileSystem& fileSystem, UrlRef xmlUrl,
+							const FileInfo& xmlInfo, const FileInfo& compiledInfo)
+{
+	if(savedKey.size != xmlInfo.fileSize)
+		return false;
+
+	// packaging often leaves both files with the same time stamp, compare content in that case
+	if(compiledInfo.modifiedTime > xmlInfo.modifiedTime)
+		return true;
+
+	AutoPtr<IStream> xmlStream = fileSystem.openStream (xmlUrl, IStream::kOpenMode|IStream::kMapped);
+	uint32 crc = 0;
+	return xmlStream && CompiledSkin::SourceKey::calculateCrc (crc, *xmlStream) && crc == savedKey.crc;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+SkinModel* SkinRegistry::parseSkin (SkinParser& parser, IFileSystem& fileSystem, UrlRef xmlUrl, StringID skinID) const
+{
+	// compiled skins are validated by size and modification time, the XML is only read if none is valid
+	// or if a file compiled at build time has the same time stamp
+	FileInfo xmlInfo;
+	if(compiledSkinsEnabled && fileSystem.getFileInfo (xmlInfo, xmlUrl))
+	{
+		CompiledSkin::SourceKey key (xmlInfo);
+		CompiledSkin compiledSkin;
+
+		// 1) compiled at build time, next to XML file, unless the XML file was modified afterwards
+		Url compiledUrl (xmlUrl);
+		compiledUrl.setExtension (CompiledSkin::getExtension (), true);
+		FileInfo compiledInfo;
+		if(fileSystem.getFileInfo (compiledInfo, compiledUrl) && compiledInfo.modifiedTime >= xmlInfo.modifiedTime)
+			if(AutoPtr<IStream> compiledStream = fileSystem.openStream (compiledUrl, IStream::kOpenMode|IStream::kMapped))
+				if(compiledSkin.load (*compiledStream))
+				{
+					if(isCompiledFrom (compiledSkin.getSourceKey (), fileSystem, xmlUrl, xmlInfo, compiledInfo))
+						return parser.parseSkin (compiledSkin);
+					compiledSkin.removeAll ();
+				}
+
+		// 2) cached on previous run
+		Url cachePath;
+		getCompiledSkinCachePath (cachePath, xmlUrl, skinID);
+		if(compiledSkin.load (cachePath, &key))
+			return parser.parseSkin (compiledSkin);
+
+		// 3) parse XML and cache result
+		AutoPtr<IStream> xmlStream = fileSystem.openStream (xmlUrl);
+		if(xmlStream == nullptr)
+			return nullptr;
+
+		compiledSkin.removeAll ();
+		parser.setRecorder (&compiledSkin);
+		SkinModel* model = parser.parseSkin (*xmlStream);
+		parser.setRecorder (nullptr);
+
+		if(model && !compiledSkin.save (cachePath, key))
+			CCL_PRINTLN ("Failed to write compiled skin cache")
+
+		return model;
+	}
+
+	AutoPtr<IStream> xmlStream = fileSystem.openStream (xmlUrl);
+	return xmlStream ? parser.parseSkin (*xmlStream) : nullptr;
+}
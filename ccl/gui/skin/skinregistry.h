@@ -28,8 +28,11 @@ namespace CCL {
 class Url;
 class View;
 class SkinWizard;
+class SkinModel;
+class SkinParser;
 
 interface IAttributeList;
+interface IFileSystem;
 
 /** If enabled, skin paths can be overwritten by property file on GUI designer system. This is used in release build. */
 #define SKIN_DEVELOPMENT_LOCATIONS_ENABLED (RELEASE && CCL_PLATFORM_DESKTOP)
@@ -98,6 +101,15 @@ public:
 	View* createView (StringID path, IUnknown* controller, IAttributeList* arguments) const;
 	View* createView (const FormReference& reference, IUnknown* controller, IAttributeList* arguments) const;
 
+	PROPERTY_BOOL (compiledSkinsEnabled, CompiledSkinsEnabled) ///< use compiled skins instead of XML if valid
+
+	/** Parse skin XML file of package. A compiled skin next to the XML file or in the cache folder
+		is preferred if it was compiled from the same XML file, otherwise it is cached for next time. */
+	SkinModel* parseSkin (SkinParser& parser, IFileSystem& fileSystem, UrlRef xmlUrl, StringID skinID) const;
+
+	/** Get location of compiled skin cached for given XML file. */
+	void getCompiledSkinCachePath (Url& path, UrlRef xmlUrl, StringID skinID) const;
+
 protected:
 	ObjectArray skins;
 	ObjectArray overlays;
@@ -341,16 +341,13 @@ bool SkinWizard::loadSkin (UrlRef url, bool keepImages, bool loadAllImages)
 	IFileSystem* fileSys = package->getFileSystem ();
 	ASSERT (fileSys != nullptr)
 
-	AutoPtr<SkinModel> model;
 	Url xmlUrl;
 	xmlUrl.setPath (CCLSTR ("skin.xml"));
-	AutoPtr<IStream> xmlStream = fileSys->openStream (xmlUrl);
 	
 	SkinParser p (this);
 	p.setFileName (MutableCString (xmlUrl.getPath ()));
 
-	if(xmlStream)
-		model = p.parseSkin (*xmlStream);
+	AutoPtr<SkinModel> model = SkinRegistry::instance ().parseSkin (p, *fileSys, xmlUrl, skinID);
 	if(!model)
 		return false;
 
@@ -533,11 +530,10 @@ bool SkinWizard::loadIncludes (SkinModel* model, Container& resolved)
 			SkinParser p (this);
 			p.setFileName (MutableCString (incUrl.getPath ()));
 
-			AutoPtr<IStream> stream = getFileSystem ()->openStream (incUrl);
-			ASSERT (stream != nullptr)
-			if(stream)
+			ASSERT (getFileSystem () != nullptr)
+			if(getFileSystem ())
 			{
-				SkinModel* incModel = p.parseSkin (*stream);
+				SkinModel* incModel = SkinRegistry::instance ().parseSkin (p, *getFileSystem (), incUrl, skinID);
 				if(incModel)
 				{
 					CStringRef name = inc->getName ();
@@ -0,0 +1,66 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : imagecachetest.cpp
+// Description : Image Cache Unit Tests
+//
+//************************************************************************************************
+
+#include "ccl/base/unittest.h"
+
+#include "ccl/gui/graphics/imaging/imagecache.h"
+#include "ccl/gui/graphics/imaging/bitmap.h"
+
+using namespace CCL;
+
+//************************************************************************************************
+// ImageCacheTest
+//************************************************************************************************
+
+CCL_TEST (ImageCacheTest, TestEstimateMemorySize)
+{
+	AutoPtr<Bitmap> bitmap = NEW Bitmap (10, 20);
+	CCL_TEST_ASSERT_EQUAL (10 * 20 * 4, ImageCacheStatistics::estimateMemorySize (bitmap));
+	CCL_TEST_ASSERT_EQUAL (30 * 40 * 4, ImageCacheStatistics::estimateMemorySize (bitmap, 30, 40));
+
+	// 1x and 2x representation
+	AutoPtr<MultiResolutionBitmap> multiBitmap = NEW MultiResolutionBitmap (10, 20);
+	CCL_TEST_ASSERT_EQUAL (10 * 20 * 4 * 5, ImageCacheStatistics::estimateMemorySize (multiBitmap));
+	CCL_TEST_ASSERT_EQUAL (30 * 40 * 4 * 5, ImageCacheStatistics::estimateMemorySize (multiBitmap, 30, 40));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (ImageCacheTest, TestMemoryAccounting)
+{
+	AutoPtr<Bitmap> source = NEW Bitmap (10, 10);
+	ImageCache cache;
+
+	IImage* image = cache.requestImage (source, 20, 20);
+	CCL_TEST_ASSERT (image != nullptr);
+	CCL_TEST_ASSERT_EQUAL (1, cache.getStatistics ().misses);
+	CCL_TEST_ASSERT_EQUAL (1, cache.getStatistics ().count);
+	CCL_TEST_ASSERT_EQUAL (ImageCacheStatistics::estimateMemorySize (source, 20, 20), cache.getStatistics ().memoryUsage);
+
+	// same size is a hit, released images stay cached until removed
+	CCL_TEST_ASSERT (cache.requestImage (source, 20, 20) == image);
+	CCL_TEST_ASSERT_EQUAL (1, cache.getStatistics ().hits);
+	cache.releaseImage (image);
+	cache.releaseImage (image);
+	CCL_TEST_ASSERT_EQUAL (1, cache.getStatistics ().count);
+
+	cache.removeUnused ();
+	CCL_TEST_ASSERT_EQUAL (0, cache.getStatistics ().count);
+	CCL_TEST_ASSERT_EQUAL (0, cache.getStatistics ().memoryUsage);
+	CCL_TEST_ASSERT_EQUAL (1, cache.getStatistics ().evictions);
+}
@@ -0,0 +1,294 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : listviewtest.cpp
+// Description : List View Row Layout Unit Tests
+//
+//************************************************************************************************
+
+#include "ccl/base/unittest.h"
+
+#include "ccl/gui/itemviews/listview.h"
+#include "ccl/gui/itemviews/rowheightindex.h"
+
+using namespace CCL;
+
+//************************************************************************************************
+// RowHeightIndexTest
+//************************************************************************************************
+
+static Coord getTestHeight (int row)
+{
+	return 10 + (row * 7) % 13;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (RowHeightIndexTest, TestPrefixSums)
+{
+	// compare with linear sums for sizes around powers of two
+	static const int kSizes[] = {0, 1, 2, 3, 7, 8, 9, 100};
+	for(int n : kSizes)
+	{
+		Vector<Coord> heights (n);
+		for(int i = 0; i < n; i++)
+			heights.add (getTestHeight (i));
+
+		RowHeightIndex index;
+		index.assign (heights);
+		CCL_TEST_ASSERT_EQUAL (n, index.count ());
+
+		Coord top = 0;
+		for(int i = 0; i < n; i++)
+		{
+			CCL_TEST_ASSERT_EQUAL (top, index.getTop (i));
+			CCL_TEST_ASSERT_EQUAL (heights[i], index.getHeight (i));
+			CCL_TEST_ASSERT (index.isMeasured (i));
+			top += heights[i];
+			CCL_TEST_ASSERT_EQUAL (top, index.getBottom (i));
+		}
+		CCL_TEST_ASSERT_EQUAL (top, index.getTotal ());
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (RowHeightIndexTest, TestUpdate)
+{
+	static const int kNumRows = 50;
+	RowHeightIndex index;
+	index.reset (kNumRows, 20);
+	CCL_TEST_ASSERT_EQUAL (kNumRows * 20, index.getTotal ());
+	CCL_TEST_ASSERT_FALSE (index.isMeasured (0));
+
+	Vector<Coord> heights (kNumRows);
+	for(int i = 0; i < kNumRows; i++)
+		heights.add (20);
+
+	// update rows in an order unrelated to the tree structure
+	for(int i = 0; i < kNumRows; i++)
+	{
+		int row = (i * 17) % kNumRows;
+		heights[row] = getTestHeight (i);
+		index.setHeight (row, heights[row]);
+		CCL_TEST_ASSERT (index.isMeasured (row));
+	}
+
+	Coord top = 0;
+	for(int i = 0; i < kNumRows; i++)
+	{
+		CCL_TEST_ASSERT_EQUAL (top, index.getTop (i));
+		top += heights[i];
+	}
+	CCL_TEST_ASSERT_EQUAL (top, index.getTotal ());
+
+	// invalidated rows keep their height
+	index.invalidate (3);
+	CCL_TEST_ASSERT_FALSE (index.isMeasured (3));
+	CCL_TEST_ASSERT_EQUAL (heights[3], index.getHeight (3));
+	CCL_TEST_ASSERT_EQUAL (top, index.getTotal ());
+
+	index.invalidateAll ();
+	CCL_TEST_ASSERT_FALSE (index.isMeasured (kNumRows - 1));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (RowHeightIndexTest, TestFindRow)
+{
+	static const int kNumRows = 37;
+	Vector<Coord> heights (kNumRows);
+	for(int i = 0; i < kNumRows; i++)
+		heights.add (getTestHeight (i));
+	heights[5] = 0; // empty rows are never found
+
+	RowHeightIndex index;
+	index.assign (heights);
+
+	for(Coord y = 0; y < index.getTotal (); y++)
+	{
+		int row = index.findRow (y);
+		CCL_TEST_ASSERT (row >= 0 && row < kNumRows);
+		if(row >= 0 && row < kNumRows)
+		{
+			CCL_TEST_ASSERT (index.getTop (row) <= y && y < index.getBottom (row));
+		}
+	}
+
+	CCL_TEST_ASSERT_EQUAL (0, index.findRow (-10));
+	CCL_TEST_ASSERT_EQUAL (kNumRows, index.findRow (index.getTotal ()));
+
+	RowHeightIndex empty;
+	CCL_TEST_ASSERT_EQUAL (0, empty.findRow (0));
+	CCL_TEST_ASSERT_EQUAL (0, empty.getTotal ());
+}
+
+//************************************************************************************************
+// ListViewTest
+//************************************************************************************************
+
+class ListViewTestModel: public Object,
+						 public AbstractItemModel
+{
+public:
+	ListViewTestModel (int count)
+	: count (count)
+	{}
+
+	// IItemModel
+	int CCL_API countFlatItems () override { return count; }
+
+	CLASS_INTERFACE (IItemModel, Object)
+
+protected:
+	int count;
+};
+
+//************************************************************************************************
+// VirtualListView
+//************************************************************************************************
+
+class VirtualListView: public ListView
+{
+public:
+	VirtualListView (IItemModel* model, StyleRef style)
+	: ListView (Rect (0, 0, 200, 100), model, style),
+	  numMeasured (0)
+	{}
+
+	Vector<Coord> heights;
+	int numMeasured;
+
+	using ListView::SizeInfo;
+	using ListView::rowHeights;
+	using ListView::getSizeInfo;
+	using ListView::getRowRect;
+	using ListView::measureRows;
+
+	void itemModified (ItemIndexRef index)
+	{
+		modelChanged (kItemModified, index);
+	}
+
+	// ListView
+	Coord determineRowHeight (ItemIndexRef index) override
+	{
+		numMeasured++;
+		return heights[index.getIndex ()];
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ListViewTest: public Test
+{
+public:
+	static const int kNumRows = 1000;
+
+	// Test
+	void setUp () override
+	{
+		model = NEW ListViewTestModel (kNumRows);
+	}
+
+	void tearDown () override
+	{
+		model.release ();
+	}
+
+protected:
+	AutoPtr<ListViewTestModel> model;
+
+	VirtualListView* createView (int customStyle)
+	{
+		VirtualListView* view = NEW VirtualListView (model, StyleFlags (0, Styles::kListViewBehaviorVirtualLayout|customStyle));
+		for(int i = 0; i < kNumRows; i++)
+			view->heights.add (getTestHeight (i));
+		return view;
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST_F (ListViewTest, TestVirtualLayoutEstimates)
+{
+	AutoPtr<VirtualListView> view = createView (0);
+
+	// only the first row is measured up front
+	VirtualListView::SizeInfo info;
+	view->getSizeInfo (info);
+	CCL_TEST_ASSERT_EQUAL (1, view->numMeasured);
+	CCL_TEST_ASSERT_EQUAL (kNumRows, view->rowHeights.count ());
+	CCL_TEST_ASSERT_EQUAL (kNumRows * getTestHeight (0), view->rowHeights.getTotal ());
+
+	// visible rows are measured when drawn
+	view->measureRows (0, 100);
+	int numVisible = view->numMeasured;
+	CCL_TEST_ASSERT (numVisible > 1 && numVisible < 20);
+	CCL_TEST_ASSERT (view->rowHeights.isMeasured (0));
+	CCL_TEST_ASSERT_FALSE (view->rowHeights.isMeasured (100));
+
+	Rect rect;
+	view->getRowRect (rect, ItemIndex (2));
+	CCL_TEST_ASSERT_EQUAL (getTestHeight (0) + getTestHeight (1), rect.top);
+	CCL_TEST_ASSERT_EQUAL (getTestHeight (2), rect.getHeight ());
+
+	// measured rows are not measured again
+	view->measureRows (0, 100);
+	CCL_TEST_ASSERT_EQUAL (numVisible, view->numMeasured);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST_F (ListViewTest, TestVirtualLayoutModified)
+{
+	AutoPtr<VirtualListView> view = createView (0);
+	VirtualListView::SizeInfo info;
+	view->getSizeInfo (info);
+	view->measureRows (0, 100);
+
+	view->heights[1] += 5;
+	view->itemModified (ItemIndex (1));
+	CCL_TEST_ASSERT_FALSE (view->rowHeights.isMeasured (1));
+	CCL_TEST_ASSERT (view->rowHeights.isMeasured (0));
+
+	// unknown item, any row might have changed
+	view->itemModified (ItemIndex ());
+	CCL_TEST_ASSERT_FALSE (view->rowHeights.isMeasured (0));
+
+	view->measureRows (0, 100);
+	CCL_TEST_ASSERT_EQUAL (view->heights[1], view->rowHeights.getHeight (1));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST_F (ListViewTest, TestVirtualLayoutCenterRows)
+{
+	model = NEW ListViewTestModel (3);
+	AutoPtr<VirtualListView> view = createView (Styles::kListViewAppearanceCenterRows);
+	VirtualListView::SizeInfo info;
+	view->getSizeInfo (info);
+
+	// measure a range given in view coordinates, rows start below the center margin
+	view->measureRows (0, view->getHeight ());
+	Coord total = getTestHeight (0) + getTestHeight (1) + getTestHeight (2);
+	CCL_TEST_ASSERT_EQUAL (total, view->rowHeights.getTotal ());
+
+	Coord margin = (view->getHeight () - total) / 2;
+	Rect rect;
+	view->getRowRect (rect, ItemIndex (0));
+	CCL_TEST_ASSERT_EQUAL (margin, rect.top);
+	view->getRowRect (rect, ItemIndex (2));
+	CCL_TEST_ASSERT_EQUAL (margin + getTestHeight (0) + getTestHeight (1), rect.top);
+	CCL_TEST_ASSERT_EQUAL (margin + total, rect.bottom);
+}
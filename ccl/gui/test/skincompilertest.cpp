@@ -0,0 +1,315 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : skincompilertest.cpp
+// Description : Compiled Skin Unit Tests
+//
+//************************************************************************************************
+
+#include "ccl/base/unittest.h"
+
+#include "ccl/gui/skin/skincompiler.h"
+#include "ccl/gui/skin/skinparser.h"
+#include "ccl/gui/skin/skinmodel.h"
+#include "ccl/gui/skin/skinregistry.h"
+#include "ccl/gui/skin/skinattributes.h"
+
+#include "ccl/base/storage/url.h"
+
+#include "ccl/public/base/memorystream.h"
+#include "ccl/public/system/isysteminfo.h"
+#include "ccl/public/system/inativefilesystem.h"
+#include "ccl/public/text/stringbuilder.h"
+#include "ccl/public/systemservices.h"
+
+using namespace CCL;
+using namespace SkinElements;
+
+static const CStringPtr kTestSkin =
+	"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	"<Skin name=\"Test\">\n"
+	"	<Forms>\n"
+	"		<Form name=\"Second\" title=\"Second Form\">\n"
+	"			<View name=\"inner\" size=\"0,0,10,10\"/>\n"
+	"		</Form>\n"
+	"		<Form name=\"First\" title=\"First Form\"/>\n"
+	"		<?platform unknownplatform?>\n"
+	"		<Form name=\"Skipped\"/>\n"
+	"		<?platform?>\n"
+	"	</Forms>\n"
+	"</Skin>\n";
+
+static const CStringPtr kTestSkinModified =
+	"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	"<Skin name=\"Test\">\n"
+	"	<Forms>\n"
+	"		<Form name=\"Second\" title=\"Second Form\"/>\n"
+	"		<Form name=\"First\" title=\"First Form\"/>\n"
+	"		<Form name=\"Third\" title=\"Third Form\"/>\n"
+	"	</Forms>\n"
+	"</Skin>\n";
+
+// same size as kTestSkin
+static const CStringPtr kTestSkinSameSize =
+	"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	"<Skin name=\"Test\">\n"
+	"	<Forms>\n"
+	"		<Form name=\"Second\" title=\"Second Form\">\n"
+	"			<View name=\"inner\" size=\"0,0,10,10\"/>\n"
+	"		</Form>\n"
+	"		<Form name=\"First\" title=\"Other Form\"/>\n"
+	"		<?platform unknownplatform?>\n"
+	"		<Form name=\"Skipped\"/>\n"
+	"		<?platform?>\n"
+	"	</Forms>\n"
+	"</Skin>\n";
+
+//************************************************************************************************
+// SkinCompilerTest
+//************************************************************************************************
+
+static IStream* createTextStream (CStringPtr text)
+{
+	MemoryStream* stream = NEW MemoryStream;
+	stream->write (text, CString (text).length ());
+	stream->rewind ();
+	return stream;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool writeTextFile (UrlRef path, CStringPtr text)
+{
+	AutoPtr<IStream> file = System::GetFileSystem ().openStream (path, IStream::kCreateMode);
+	int length = CString (text).length ();
+	return file && file->write (text, length) == length;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static int countElements (const Element& element)
+{
+	int result = element.count ();
+	for(int i = 0; i < element.count (); i++)
+		result += countElements (*element.getElement (i));
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool isEqualTree (const Element& e1, const Element& e2)
+{
+	if(e1.getName () != e2.getName () || e1.getLineNumber () != e2.getLineNumber () || e1.count () != e2.count ())
+		return false;
+
+	MutableSkinAttributes a1, a2;
+	e1.getAttributes (a1);
+	e2.getAttributes (a2);
+	if(a1.count () != a2.count ())
+		return false;
+	for(int i = 0; i < a1.count (); i++)
+		if(a1.getNameAt (i) != a2.getNameAt (i) || a1.getStringAt (i) != a2.getStringAt (i))
+			return false;
+
+	for(int i = 0; i < e1.count (); i++)
+		if(!isEqualTree (*e1.getElement (i), *e2.getElement (i)))
+			return false;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static SkinModel* parseSkinFile (UrlRef xmlUrl)
+{
+	SkinParser parser (nullptr);
+	parser.setFileName (MutableCString (xmlUrl.getPath ()));
+	return SkinRegistry::instance ().parseSkin (parser, System::GetFileSystem (), xmlUrl, "SkinCompilerTest");
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (SkinCompilerTest, TestBinaryFormat)
+{
+	CompiledSkin::SourceKey key;
+	key.size = CString (kTestSkin).length ();
+	key.modifiedTime = 1000;
+
+	AutoPtr<IStream> xmlStream = createTextStream (kTestSkin);
+	AutoPtr<MemoryStream> compiledData = NEW MemoryStream;
+	CCL_TEST_ASSERT (SkinCompiler::compile (*compiledData, *xmlStream, key));
+
+	CompiledSkin compiledSkin;
+	CCL_TEST_ASSERT (compiledSkin.load (*compiledData, &key));
+	CCL_TEST_ASSERT_FALSE (compiledSkin.isEmpty ());
+
+	// compiled from a different source
+	CompiledSkin::SourceKey modifiedKey (key);
+	modifiedKey.modifiedTime++;
+	CCL_TEST_ASSERT_FALSE (compiledSkin.load (*compiledData, &modifiedKey));
+	CCL_TEST_ASSERT (compiledSkin.isEmpty ());
+
+	// any source is accepted without key
+	CCL_TEST_ASSERT (compiledSkin.load (*compiledData));
+
+	// truncated file
+	AutoPtr<MemoryStream> truncatedData = NEW MemoryStream;
+	truncatedData->write (compiledData->getMemoryAddress (), compiledData->getBytesWritten () - sizeof(int32));
+	CCL_TEST_ASSERT_FALSE (compiledSkin.load (*truncatedData, &key));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (SkinCompilerTest, TestReplayMatchesXml)
+{
+	AutoPtr<IStream> xmlStream = createTextStream (kTestSkin);
+	SkinParser xmlParser (nullptr);
+	xmlParser.setFileName ("skin.xml");
+	AutoPtr<SkinModel> xmlModel = xmlParser.parseSkin (*xmlStream);
+	CCL_TEST_ASSERT (xmlModel != nullptr);
+
+	xmlStream->seek (0, IStream::kSeekSet);
+	AutoPtr<MemoryStream> compiledData = NEW MemoryStream;
+	CCL_TEST_ASSERT (SkinCompiler::compile (*compiledData, *xmlStream, CompiledSkin::SourceKey ()));
+
+	CompiledSkin compiledSkin;
+	CCL_TEST_ASSERT (compiledSkin.load (*compiledData));
+
+	SkinParser replayParser (nullptr);
+	replayParser.setFileName ("skin.xml");
+	AutoPtr<SkinModel> replayModel = replayParser.parseSkin (compiledSkin);
+	CCL_TEST_ASSERT (replayModel != nullptr);
+
+	if(xmlModel && replayModel)
+	{
+		CCL_TEST_ASSERT (isEqualTree (*xmlModel, *replayModel));
+
+		// processing instructions are replayed, the skipped form is not part of the model
+		CCL_TEST_ASSERT_EQUAL (4, countElements (*replayModel));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (SkinCompilerTest, TestStartupCache)
+{
+	IFileSystem& fileSystem = System::GetFileSystem ();
+
+	Url folder;
+	System::GetSystem ().getLocation (folder, System::kTempFolder);
+	folder.descend (UIDString::generate (), IUrl::kFolder);
+	fileSystem.createFolder (folder);
+
+	Url xmlUrl (folder);
+	xmlUrl.descend ("skin.xml", IUrl::kFile);
+	CCL_TEST_ASSERT (writeTextFile (xmlUrl, kTestSkin));
+
+	Url cachePath;
+	SkinRegistry::instance ().getCompiledSkinCachePath (cachePath, xmlUrl, "SkinCompilerTest");
+	fileSystem.removeFile (cachePath);
+
+	// first run parses XML and writes cache
+	AutoPtr<SkinModel> xmlModel = parseSkinFile (xmlUrl);
+	CCL_TEST_ASSERT (xmlModel != nullptr);
+	CCL_TEST_ASSERT (fileSystem.fileExists (cachePath));
+
+	FileInfo xmlInfo;
+	CCL_TEST_ASSERT (fileSystem.getFileInfo (xmlInfo, xmlUrl));
+	CompiledSkin::SourceKey key (xmlInfo);
+	CompiledSkin cachedSkin;
+	CCL_TEST_ASSERT (cachedSkin.load (cachePath, &key));
+	cachedSkin.removeAll ();
+
+	// next run uses cache
+	AutoPtr<SkinModel> cachedModel = parseSkinFile (xmlUrl);
+	CCL_TEST_ASSERT (cachedModel != nullptr);
+	if(xmlModel && cachedModel)
+	{
+		CCL_TEST_ASSERT (isEqualTree (*xmlModel, *cachedModel));
+	}
+
+	// modified XML invalidates cache
+	CCL_TEST_ASSERT (writeTextFile (xmlUrl, kTestSkinModified));
+	AutoPtr<SkinModel> modifiedModel = parseSkinFile (xmlUrl);
+	CCL_TEST_ASSERT (modifiedModel != nullptr);
+	if(modifiedModel)
+	{
+		CCL_TEST_ASSERT_EQUAL (4, countElements (*modifiedModel));
+	}
+
+	CCL_TEST_ASSERT_FALSE (cachedSkin.load (cachePath, &key));
+	CCL_TEST_ASSERT (fileSystem.getFileInfo (xmlInfo, xmlUrl));
+	CompiledSkin::SourceKey modifiedKey (xmlInfo);
+	CCL_TEST_ASSERT (cachedSkin.load (cachePath, &modifiedKey));
+	cachedSkin.removeAll ();
+
+	fileSystem.removeFile (cachePath);
+	fileSystem.removeFolder (folder, IFileSystem::kDeleteRecursively);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (SkinCompilerTest, TestBuildTimeSkin)
+{
+	INativeFileSystem& fileSystem = System::GetFileSystem ();
+
+	Url folder;
+	System::GetSystem ().getLocation (folder, System::kTempFolder);
+	folder.descend (UIDString::generate (), IUrl::kFolder);
+	fileSystem.createFolder (folder);
+
+	Url xmlUrl (folder);
+	xmlUrl.descend ("skin.xml", IUrl::kFile);
+	CCL_TEST_ASSERT (writeTextFile (xmlUrl, kTestSkin));
+	CCL_TEST_ASSERT (SkinCompiler::compile (xmlUrl));
+
+	Url compiledUrl (xmlUrl);
+	compiledUrl.setExtension (CompiledSkin::getExtension (), true);
+	CompiledSkin compiledSkin;
+	CCL_TEST_ASSERT (compiledSkin.load (compiledUrl));
+	CCL_TEST_ASSERT (compiledSkin.getSourceKey ().crc != 0);
+	compiledSkin.removeAll ();
+
+	Url cachePath;
+	SkinRegistry::instance ().getCompiledSkinCachePath (cachePath, xmlUrl, "SkinCompilerTest");
+	fileSystem.removeFile (cachePath);
+
+	// packaged with equal time stamps, content matches
+	FileInfo xmlInfo;
+	CCL_TEST_ASSERT (fileSystem.getFileInfo (xmlInfo, xmlUrl));
+	CCL_TEST_ASSERT (fileSystem.setFileTime (compiledUrl, xmlInfo.modifiedTime));
+
+	AutoPtr<SkinModel> compiledModel = parseSkinFile (xmlUrl);
+	CCL_TEST_ASSERT (compiledModel != nullptr);
+	CCL_TEST_ASSERT_FALSE (fileSystem.fileExists (cachePath));
+
+	// XML updated with same size and time stamp, the stale compiled skin must not be used
+	CCL_TEST_ASSERT (writeTextFile (xmlUrl, kTestSkinSameSize));
+	CCL_TEST_ASSERT (fileSystem.setFileTime (xmlUrl, xmlInfo.modifiedTime));
+	CCL_TEST_ASSERT (fileSystem.setFileTime (compiledUrl, xmlInfo.modifiedTime));
+
+	AutoPtr<SkinModel> updatedModel = parseSkinFile (xmlUrl);
+	CCL_TEST_ASSERT (updatedModel != nullptr);
+	CCL_TEST_ASSERT (fileSystem.fileExists (cachePath));
+
+	AutoPtr<IStream> xmlStream = createTextStream (kTestSkinSameSize);
+	SkinParser xmlParser (nullptr);
+	xmlParser.setFileName (MutableCString (xmlUrl.getPath ()));
+	AutoPtr<SkinModel> xmlModel = xmlParser.parseSkin (*xmlStream);
+	if(updatedModel && xmlModel)
+	{
+		CCL_TEST_ASSERT (isEqualTree (*xmlModel, *updatedModel));
+	}
+
+	fileSystem.removeFile (cachePath);
+	fileSystem.removeFolder (folder, IFileSystem::kDeleteRecursively);
+}
@@ -115,7 +115,8 @@ namespace Styles {
 		kListViewAppearanceAutoCenterIcons = kLastItemViewFlag<<7, ///< (appearance) auto-center list items to fill the available horizontal space
 		kListViewBehaviorNavigateFlat = kLastItemViewFlag<<8, ///< (behavior) interpret 'Up' / 'Down' and 'Left' / 'Right' commands as 'previous / next item' (no spatial navigation, can be useful with switchable view types)
 		kListViewAppearanceDrawCustomItem = kLastItemViewFlag<<9, ///< (appearance) application model draws customized item (not the framework)
-		kListViewAppearanceCenterRows = kLastItemViewFlag<<10 ///< (appearance) center rows in list view
+		kListViewAppearanceCenterRows = kLastItemViewFlag<<10, ///< (appearance) center rows in list view
+		kListViewBehaviorVirtualLayout = kLastItemViewFlag<<11 ///< (behavior) estimate row heights and measure visible rows only, for lists with many items
 	};
 
 	/** DropBox styles */
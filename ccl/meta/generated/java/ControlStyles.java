@@ -174,6 +174,8 @@ public class ControlStyles
 	public static final int kListViewAppearanceDrawCustomItem = kLastItemViewFlag<<9;
 	/** (appearance) center rows in list view. */
 	public static final int kListViewAppearanceCenterRows = kLastItemViewFlag<<10;
+	/** (behavior) estimate row heights and measure visible rows only, for lists with many items. */
+	public static final int kListViewBehaviorVirtualLayout = kLastItemViewFlag<<11;
 
 	// ***********************************************************************************************
 	// Source: DropBoxStyles
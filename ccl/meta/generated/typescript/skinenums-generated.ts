@@ -491,6 +491,7 @@ export const LISTVIEW_OPTIONS_AUTOCENTERICONS = "autocentericons"; // (appearanc
 export const LISTVIEW_OPTIONS_DRAWCUSTOMITEM = "drawcustomitem"; // (appearance) application model draws customized item (not the framework)
 export const LISTVIEW_OPTIONS_NAVIGATEFLAT = "navigateflat"; // (behavior) interpret 'Up' / 'Down' and 'Left' / 'Right' commands as 'previous / next item' (no spatial navigation, can be useful with switchable view types)
 export const LISTVIEW_OPTIONS_CENTERROWS = "centerrows"; // (appearance) center rows in list view
+export const LISTVIEW_OPTIONS_VIRTUALLAYOUT = "virtuallayout"; // (behavior) estimate row heights and measure visible rows only, for lists with many items
 
 /////////////////////////////////////////////////////////////////////////////////////////
 // ListView.viewtype
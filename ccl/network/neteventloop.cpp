@@ -0,0 +1,195 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/network/neteventloop.cpp
+// Description : Network I/O Thread
+//
+//************************************************************************************************
+
+#include "ccl/network/neteventloop.h"
+
+#include "ccl/public/base/smartptr.h"
+#include "ccl/public/systemservices.h"
+
+namespace CCL {
+namespace Net {
+
+//************************************************************************************************
+// SocketEventLoop::Registration
+//************************************************************************************************
+
+class SocketEventLoop::Registration: public Unknown,
+									 public Core::Sockets::ISocketEventHandler
+{
+public:
+	Registration (ISocket* socket, SocketID descriptor, Net::ISocketEventHandler* handler)
+	: handler (handler),
+	  descriptor (descriptor)
+	{
+		this->socket.share (socket);
+	}
+
+	SocketID getDescriptor () const { return descriptor; }
+
+	// Core::Sockets::ISocketEventHandler
+	void onSocketEvent (SocketID, int events) override
+	{
+		retain (); // handler might remove the socket
+		handler->onSocketEvent (socket, events);
+		release ();
+	}
+
+protected:
+	AutoPtr<ISocket> socket;
+	SharedPtr<Net::ISocketEventHandler> handler;
+	SocketID descriptor;
+};
+
+} // namespace Net
+} // namespace CCL
+
+using namespace CCL;
+using namespace Net;
+
+// flags are passed through to the reactor
+static_assert (int(SocketEvent::kReadable) == int(Core::Sockets::SocketEvent::kReadable), "SocketEvent mismatch");
+static_assert (int(SocketEvent::kWritable) == int(Core::Sockets::SocketEvent::kWritable), "SocketEvent mismatch");
+static_assert (int(SocketEvent::kError) == int(Core::Sockets::SocketEvent::kError), "SocketEvent mismatch");
+static_assert (int(SocketEvent::kEdgeTriggered) == int(Core::Sockets::SocketEvent::kEdgeTriggered), "SocketEvent mismatch");
+
+//************************************************************************************************
+// SocketEventLoop
+//************************************************************************************************
+
+SocketEventLoop::SocketEventLoop ()
+: UserThread ("NetworkIO"),
+  registrations (1024)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+SocketEventLoop::~SocketEventLoop ()
+{
+	ASSERT (registrations.isEmpty ())
+	shutdown ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SocketEventLoop::startup ()
+{
+	// called with lock held
+	if(!reactor.isOpen ())
+		if(!reactor.open ())
+			return false;
+
+	if(!isThreadStarted ())
+		startThread (Threading::kPriorityAboveNormal);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SocketEventLoop::shutdown ()
+{
+	requestTerminate ();
+	reactor.wakeup ();
+	stopThread (Threading::kWaitForever);
+
+	Threading::ScopedLock scopedLock (lock);
+	for(auto registration : registrations)
+	{
+		reactor.removeSocket (registration->getDescriptor ());
+		registration->release ();
+	}
+	registrations.removeAll ();
+
+	if(reactor.isOpen ())
+		reactor.close ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult SocketEventLoop::addSocket (ISocket* socket, int events, ISocketEventHandler* handler)
+{
+	UnknownPtr<BaseSocket> baseSocket (socket);
+	ASSERT (baseSocket && handler)
+	if(!baseSocket || !handler)
+		return kResultInvalidArgument;
+
+	// register with the reactor while holding the lock, a concurrent removeSocket() either doesn't
+	// find the socket or waits until it is fully registered. Handlers might be called before this
+	// returns, the reactor doesn't hold its lock while dispatching.
+	Threading::ScopedLock scopedLock (lock);
+	ASSERT (!registrations.contains (socket))
+	if(registrations.contains (socket) || !startup ())
+		return kResultFailed;
+
+	Registration* registration = NEW Registration (socket, baseSocket->getDescriptor (), handler);
+	if(!reactor.addSocket (registration->getDescriptor (), events, registration))
+	{
+		registration->release ();
+		return kResultFailed;
+	}
+	registrations.add (socket, registration);
+	return kResultOk;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult SocketEventLoop::modifySocket (ISocket* socket, int events)
+{
+	Registration* registration = nullptr;
+	{
+		Threading::ScopedLock scopedLock (lock);
+		registration = registrations.lookup (socket);
+		if(!registration)
+			return kResultFailed;
+		registration->retain ();
+	}
+
+	bool result = reactor.modifySocket (registration->getDescriptor (), events);
+	registration->release ();
+	return result ? kResultOk : kResultFailed;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult SocketEventLoop::removeSocket (ISocket* socket)
+{
+	Registration* registration = nullptr;
+	{
+		Threading::ScopedLock scopedLock (lock);
+		registration = registrations.lookup (socket);
+		if(!registration)
+			return kResultFailed;
+		registrations.remove (socket);
+	}
+
+	// waits for a handler running on the I/O thread
+	reactor.removeSocket (registration->getDescriptor ());
+	registration->release ();
+	return kResultOk;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int SocketEventLoop::threadEntry ()
+{
+	while(!shouldTerminate ())
+	{
+		if(reactor.poll (kPollTimeout) < 0)
+			System::ThreadSleep (10); // don't spin on persistent errors
+	}
+	return 0;
+}
@@ -0,0 +1,71 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/network/neteventloop.h
+// Description : Network I/O Thread
+//
+//************************************************************************************************
+
+#ifndef _ccl_neteventloop_h
+#define _ccl_neteventloop_h
+
+#include "ccl/network/netsocket.h"
+
+#include "ccl/public/system/threadsync.h"
+#include "ccl/public/system/userthread.h"
+#include "ccl/public/collections/hashmap.h"
+
+#include "ccl/public/base/ccldefpush.h"
+#include "core/network/coresocketreactor.h"
+#include "ccl/public/base/ccldefpop.h"
+
+namespace CCL {
+namespace Net {
+
+//************************************************************************************************
+// SocketEventLoop
+/** Shared I/O thread dispatching socket events to handlers, see INetwork2::addSocketHandler().
+	The thread is started with the first registered socket. */
+//************************************************************************************************
+
+class SocketEventLoop: public Threading::UserThread
+{
+public:
+	SocketEventLoop ();
+	~SocketEventLoop ();
+
+	tresult addSocket (ISocket* socket, int events, ISocketEventHandler* handler);
+	tresult modifySocket (ISocket* socket, int events);
+	tresult removeSocket (ISocket* socket);
+
+	void shutdown ();
+
+protected:
+	class Registration;
+
+	static const int kPollTimeout = 1000;
+
+	Core::Sockets::SocketReactor reactor;
+	Threading::CriticalSection lock;
+	PointerHashMap<Registration*> registrations;
+
+	bool startup ();
+
+	// UserThread
+	int threadEntry () override;
+};
+
+} // namespace Net
+} // namespace CCL
+
+#endif // _ccl_neteventloop_h
@@ -258,6 +258,10 @@ tresult Socket::handleError (const char* debugMessage)
 // BaseSocket
 //************************************************************************************************
 
+DEFINE_IID_ (BaseSocket, 0x3e8a4d21, 0x7b0f, 0x4c65, 0xa1, 0x9c, 0x52, 0xe7, 0x06, 0xbd, 0x38, 0xf4)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 tresult BaseSocket::handleError (Core::Sockets::Socket& coreSocket, const char* debugMessage)
 {
 	int errorCode = coreSocket.getErrorCode ();
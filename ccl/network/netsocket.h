@@ -42,7 +42,12 @@ class BaseSocket: public Unknown,
 				  public ISocket
 {
 public:
-	CLASS_INTERFACE (ISocket, Unknown)
+	virtual SocketID getDescriptor () const = 0;
+
+	// for casting IUnknown to BaseSocket, only used internally
+	DECLARE_IID (BaseSocket)
+
+	CLASS_INTERFACE2 (BaseSocket, ISocket, Unknown)
 
 protected:
 	static CCL::tresult handleError (Core::Sockets::Socket& coreSocket, const char* debugMessage);
@@ -60,7 +65,8 @@ class Socket: public BaseSocket,
 public:
 	static Socket* createSocket (AddressFamily addressFamily, SocketType type, ProtocolType protocol);
 
-	SocketID getDescriptor () const;
+	// BaseSocket
+	SocketID getDescriptor () const override;
 
 	// ISocket
 	tresult CCL_API connect (const SocketAddress& address) override;
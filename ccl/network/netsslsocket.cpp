@@ -60,6 +60,13 @@ void SSLSocket::setPeerName (StringRef peerName)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+SocketID SSLSocket::getDescriptor () const
+{
+	return coreSSLSocket.getDescriptor ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 tresult CCL_API SSLSocket::connect (const SocketAddress& address)
 {
 	return connect (address, nullptr);
@@ -52,6 +52,9 @@ public:
 
 	tresult connect (const SocketAddress& address, CCL::IProgressNotify* progress);
 
+	// BaseSocket
+	SocketID getDescriptor () const override;
+
 	// ISocket
 	tresult CCL_API connect (const SocketAddress& address) override;
 	tresult CCL_API disconnect () override;
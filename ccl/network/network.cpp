@@ -51,6 +51,8 @@ bool Network::startup ()
 
 void Network::shutdown ()
 {
+	eventLoop.shutdown ();
+
 	Core::Sockets::Network::shutdown ();
 }
 
@@ -222,3 +224,24 @@ tresult CCL_API Network::selectSockets (IUnknownList* readList, IUnknownList* wr
 		state = kResultOk;
 	return state;
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API Network::addSocketHandler (ISocket* socket, int events, ISocketEventHandler* handler)
+{
+	return eventLoop.addSocket (socket, events, handler);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API Network::modifySocketHandler (ISocket* socket, int events)
+{
+	return eventLoop.modifySocket (socket, events);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API Network::removeSocketHandler (ISocket* socket)
+{
+	return eventLoop.removeSocket (socket);
+}
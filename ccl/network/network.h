@@ -19,7 +19,7 @@
 #ifndef _ccl_network_h
 #define _ccl_network_h
 
-#include "ccl/public/base/unknown.h"
+#include "ccl/network/neteventloop.h"
 
 #include "ccl/public/network/inetwork.h"
 
@@ -31,7 +31,8 @@ namespace Net {
 //************************************************************************************************
 
 class Network: public Unknown,
-			   public INetwork
+			   public INetwork,
+			   public INetwork2
 {
 public:
 	bool startup ();
@@ -49,7 +50,15 @@ public:
 	tresult CCL_API selectSockets (IUnknownList* readList, IUnknownList* writeList, IUnknownList* errorList, int timeout) override;
 	IStream* CCL_API openSSLStream (const IPAddress& address, StringRef peerName, IProgressNotify* progress = nullptr) override;
 
-	CLASS_INTERFACE (INetwork, Unknown)
+	// INetwork2
+	tresult CCL_API addSocketHandler (ISocket* socket, int events, ISocketEventHandler* handler) override;
+	tresult CCL_API modifySocketHandler (ISocket* socket, int events) override;
+	tresult CCL_API removeSocketHandler (ISocket* socket) override;
+
+	CLASS_INTERFACE2 (INetwork, INetwork2, Unknown)
+
+protected:
+	SocketEventLoop eventLoop;
 };
 
 } // namespace Net
@@ -21,8 +21,9 @@
 #include "ccl/network/web/http/server.h"
 #include "ccl/network/web/http/request.h"
 
-#include "ccl/network/netstream.h"
-
+#include "ccl/public/base/istream.h"
+#include "ccl/public/base/variant.h"
+#include "ccl/public/system/isysteminfo.h"
 #include "ccl/public/text/cclstring.h"
 #include "ccl/public/netservices.h"
 
@@ -30,6 +31,468 @@ using namespace CCL;
 using namespace Web;
 using namespace HTTP;
 
+//************************************************************************************************
+// HTTP::Server::ConnectionStream
+/** Buffered socket stream of a connection. Reading ahead allows to detect pipelined requests,
+	output is collected until flush() to send a response with as few packets as possible. */
+//************************************************************************************************
+
+class Server::ConnectionStream: public Unknown,
+								public IStream
+{
+public:
+	ConnectionStream (Net::ISocket* socket, int timeout);
+
+	bool hasPendingInput () const;
+	bool skip (int64 count);
+	bool flush ();
+	void cancel ();
+
+	// IStream
+	int CCL_API read (void* buffer, int size) override;
+	int CCL_API write (const void* buffer, int size) override;
+	int64 CCL_API tell () override;
+	tbool CCL_API isSeekable () const override;
+	int64 CCL_API seek (int64 pos, int mode) override;
+
+	CLASS_INTERFACE (IStream, Unknown)
+
+protected:
+	static const int kBufferSize = 4096;
+	static const int kWaitInterval = 100;
+
+	Net::ISocket* socket;
+	int timeout;
+	int64 position;
+	Threading::AtomicInt canceled;
+
+	char inputBuffer[kBufferSize];
+	int inputStart;
+	int inputEnd;
+	char outputBuffer[kBufferSize];
+	int outputSize;
+
+	bool fillInput ();
+	bool sendAll (const void* buffer, int size);
+};
+
+//************************************************************************************************
+// HTTP::Server::ResponseStream
+/** Response body stream handed to the application. Headers are sent with the first block that
+	doesn't fit into the buffer, using the Content-Length set by the application or chunked
+	transfer encoding. Bodies completed within the buffer are sent with their actual length. */
+//************************************************************************************************
+
+class Server::ResponseStream: public Unknown,
+							  public IStream
+{
+public:
+	ResponseStream (Response& response, ConnectionStream& stream, bool keepAlive);
+
+	PROPERTY_BOOL (keepAlive, KeepAlive)
+
+	bool finish ();
+
+	// IStream
+	int CCL_API read (void* buffer, int size) override;
+	int CCL_API write (const void* buffer, int size) override;
+	int64 CCL_API tell () override;
+	tbool CCL_API isSeekable () const override;
+	int64 CCL_API seek (int64 pos, int mode) override;
+
+	CLASS_INTERFACE (IStream, Unknown)
+
+protected:
+	static const int kBufferSize = 4096;
+
+	Response& response;
+	ConnectionStream& stream;
+	bool headersSent;
+	bool chunked;
+	int64 contentLength;
+	int64 bytesWritten;
+
+	char buffer[kBufferSize];
+	int bufferSize;
+
+	bool sendHeaders (int64 knownLength);
+	bool sendBody (const void* data, int size);
+};
+
+//************************************************************************************************
+// HTTP::Server::Connection
+//************************************************************************************************
+
+class Server::Connection: public Unknown
+{
+public:
+	Connection (Net::ISocket* socket, int timeout);
+
+	Net::ISocket* getSocket () const { return socket; }
+	ConnectionStream& getStream () const { return *stream; }
+
+	PROPERTY_VARIABLE (int64, lastActivity, LastActivity)
+	PROPERTY_VARIABLE (int, requestCount, RequestCount)
+
+protected:
+	AutoPtr<Net::ISocket> socket;
+	AutoPtr<ConnectionStream> stream;
+};
+
+//************************************************************************************************
+// HTTP::Server::ConnectionWork
+//************************************************************************************************
+
+class Server::ConnectionWork: public Unknown,
+							  public Threading::AbstractWorkItem
+{
+public:
+	ConnectionWork (Server& server, Connection* connection)
+	: server (server),
+	  connection (connection),
+	  handled (false)
+	{
+		connection->retain ();
+	}
+
+	~ConnectionWork ()
+	{
+		if(!handled) // removed from queue when server terminates
+			server.closeConnection (connection);
+		connection->release ();
+	}
+
+	// IWorkItem
+	void CCL_API work () override
+	{
+		handled = true;
+		server.handleConnection (*connection);
+	}
+
+	void CCL_API cancel () override
+	{
+		connection->getStream ().cancel ();
+	}
+
+	CLASS_INTERFACE (IWorkItem, Unknown)
+
+protected:
+	Server& server;
+	Connection* connection;
+	bool handled;
+};
+
+//************************************************************************************************
+// HTTP::Server::ConnectionStream
+//************************************************************************************************
+
+Server::ConnectionStream::ConnectionStream (Net::ISocket* socket, int timeout)
+: socket (socket),
+  timeout (timeout),
+  position (0),
+  inputStart (0),
+  inputEnd (0),
+  outputSize (0)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Server::ConnectionStream::hasPendingInput () const
+{
+	return inputStart < inputEnd || socket->isReadable (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Server::ConnectionStream::cancel ()
+{
+	canceled.assign (1);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Server::ConnectionStream::fillInput ()
+{
+	ASSERT (inputStart == inputEnd)
+
+	// wait in intervals to react on cancelation
+	int64 timeToCancel = System::GetSystemTicks () + timeout;
+	while(!socket->isReadable (kWaitInterval))
+		if(canceled || System::GetSystemTicks () > timeToCancel)
+			return false;
+
+	int result = socket->receive (inputBuffer, kBufferSize);
+	if(result <= 0) // closed by peer or error
+		return false;
+
+	inputStart = 0;
+	inputEnd = result;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int CCL_API Server::ConnectionStream::read (void* buffer, int size)
+{
+	int bytesRead = 0;
+	while(bytesRead < size)
+	{
+		if(inputStart == inputEnd && !fillInput ())
+			return bytesRead > 0 ? bytesRead : -1;
+
+		int count = ccl_min (size - bytesRead, inputEnd - inputStart);
+		::memcpy ((char*)buffer + bytesRead, inputBuffer + inputStart, count);
+		inputStart += count;
+		bytesRead += count;
+	}
+	position += bytesRead;
+	return bytesRead;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Server::ConnectionStream::skip (int64 count)
+{
+	char buffer[512];
+	while(count > 0)
+	{
+		int toRead = (int)ccl_min<int64> (count, sizeof(buffer));
+		if(read (buffer, toRead) != toRead)
+			return false;
+		count -= toRead;
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Server::ConnectionStream::sendAll (const void* buffer, int size)
+{
+	int bytesSent = 0;
+	while(bytesSent < size)
+	{
+		int result = socket->send ((const char*)buffer + bytesSent, size - bytesSent);
+		if(result <= 0 || canceled)
+			return false;
+		bytesSent += result;
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int CCL_API Server::ConnectionStream::write (const void* buffer, int size)
+{
+	if(outputSize + size > kBufferSize)
+	{
+		if(!flush ())
+			return -1;
+
+		// large blocks are sent directly
+		if(size > kBufferSize)
+			return sendAll (buffer, size) ? size : -1;
+	}
+
+	::memcpy (outputBuffer + outputSize, buffer, size);
+	outputSize += size;
+	return size;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Server::ConnectionStream::flush ()
+{
+	if(outputSize == 0)
+		return true;
+	bool result = sendAll (outputBuffer, outputSize);
+	outputSize = 0;
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int64 CCL_API Server::ConnectionStream::tell ()
+{
+	return position; // number of bytes read
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API Server::ConnectionStream::isSeekable () const
+{
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int64 CCL_API Server::ConnectionStream::seek (int64 pos, int mode)
+{
+	return -1;
+}
+
+//************************************************************************************************
+// HTTP::Server::ResponseStream
+//************************************************************************************************
+
+Server::ResponseStream::ResponseStream (Response& response, ConnectionStream& stream, bool keepAlive)
+: keepAlive (keepAlive),
+  response (response),
+  stream (stream),
+  headersSent (false),
+  chunked (false),
+  contentLength (-1),
+  bytesWritten (0),
+  bufferSize (0)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Server::ResponseStream::sendHeaders (int64 knownLength)
+{
+	ASSERT (!headersSent)
+	headersSent = true;
+
+	if(response.getStatus () == 0)
+		response.setStatus (HTTP::kOK);
+
+	HeaderList& headers = response.getHeaders ();
+	if(headers.hasContentLength ()) // provided by application
+		contentLength = headers.getContentLength ();
+	else if(knownLength >= 0)
+	{
+		contentLength = knownLength;
+		headers.setContentLength (knownLength);
+	}
+	else if(response.getVersion () >= HTTP::kV1_1)
+	{
+		chunked = true;
+		headers.setTransferEncoding ("chunked");
+	}
+	else
+		keepAlive = false; // end of body is indicated by closing the connection
+
+	headers.setConnection (keepAlive ? "keep-alive" : "close");
+
+	#if DEBUG_LOG
+	response.dump ();
+	#endif
+
+	// status line and headers go to the connection directly
+	response.setStream (&stream);
+	bool result = response.send ();
+	response.setStream (this);
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Server::ResponseStream::sendBody (const void* data, int size)
+{
+	if(size <= 0)
+		return true;
+
+	if(chunked)
+	{
+		MutableCString chunkSize;
+		chunkSize.appendFormat ("%x", size);
+		if(!Streamer (stream).writeLine (chunkSize))
+			return false;
+	}
+
+	if(stream.write (data, size) != size)
+		return false;
+	bytesWritten += size;
+
+	return chunked ? Streamer (stream).writeLine ("") : true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int CCL_API Server::ResponseStream::write (const void* data, int size)
+{
+	if(size <= 0)
+		return 0;
+
+	if(!headersSent)
+	{
+		if(bufferSize + size <= kBufferSize)
+		{
+			::memcpy (buffer + bufferSize, data, size);
+			bufferSize += size;
+			return size;
+		}
+
+		// length still unknown, start streaming
+		if(!sendHeaders (-1) || !sendBody (buffer, bufferSize))
+			return -1;
+		bufferSize = 0;
+	}
+
+	return sendBody (data, size) ? size : -1;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Server::ResponseStream::finish ()
+{
+	if(!headersSent)
+	{
+		if(!sendHeaders (bufferSize) || !sendBody (buffer, bufferSize))
+			return false;
+		bufferSize = 0;
+	}
+
+	if(chunked) // last chunk without trailer
+		if(!Streamer (stream).writeLine ("0") || !Streamer (stream).writeLine (""))
+			return false;
+
+	// body doesn't match the length announced by the application
+	if(contentLength >= 0 && bytesWritten != contentLength)
+		keepAlive = false;
+
+	return stream.flush ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int CCL_API Server::ResponseStream::read (void* buffer, int size)
+{
+	return -1;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int64 CCL_API Server::ResponseStream::tell ()
+{
+	return bytesWritten + bufferSize;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API Server::ResponseStream::isSeekable () const
+{
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int64 CCL_API Server::ResponseStream::seek (int64 pos, int mode)
+{
+	return -1;
+}
+
+//************************************************************************************************
+// HTTP::Server::Connection
+//************************************************************************************************
+
+Server::Connection::Connection (Net::ISocket* _socket, int timeout)
+: lastActivity (0),
+  requestCount (0)
+{
+	socket.share (_socket);
+	stream = NEW ConnectionStream (_socket, timeout);
+}
+
 //************************************************************************************************
 // HTTP::Server
 //************************************************************************************************
@@ -39,14 +502,20 @@ DEFINE_CLASS_HIDDEN (Server, WebServer)
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 Server::Server ()
-: socket (nullptr),
-  quitRequested (false)
+: maxConnections (256),
+  maxWorkerCount (ccl_max (System::GetSystem ().getNumberOfCPUs (), 2)),
+  idleTimeout (5000),
+  maxKeepAliveRequests (1000),
+  socket (nullptr),
+  workerPool (nullptr)
 {}
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 Server::~Server ()
 {
+	ASSERT (workerPool == nullptr)
+	ASSERT (idleConnections.isEmpty ())
 	safe_release (socket);
 }
 
@@ -69,11 +538,7 @@ tresult CCL_API Server::startup (const Net::SocketAddress& address)
 		return result;
 
 	// place into listening state
-	result = socket->listen (Net::SocketOption::kMaxConnections);
-	if(result != kResultOk)
-		return result;
-
-	return kResultOk;
+	return socket->listen (kListenBacklog);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -111,79 +576,270 @@ tresult CCL_API Server::run ()
 	if(!socket)
 		return kResultUnexpected;
 
-	MutableCString serverName;
+	serverName.empty ();
 	if(app)
 		serverName = app->getServerName ();
 	if(serverName.isEmpty ())
 		serverName = CSTR ("WebServer/1.0");
 
-	while(!quitRequested)
+	ASSERT (workerPool == nullptr)
+	workerPool = System::CreateThreadPool ({ccl_max (maxWorkerCount, 1), Threading::kPriorityNormal, "HTTPServer"});
+
+	// new connections are accepted on the network I/O thread
+	UnknownPtr<Net::INetwork2> network (&System::GetNetwork ());
+	tresult result = network ? network->addSocketHandler (socket, Net::SocketEvent::kReadable, this) : kResultNoInterface;
+	if(result == kResultOk)
 	{
-		AutoPtr<Net::ISocket> connection = socket->accept ();
-		if(connection && !quitRequested)
+		while(!quitRequested)
 		{
-			// TODO: push to thread pool...
+			quitSignal.wait (kIdleCheckInterval);
+			closeIdleConnections (System::GetSystemTicks () - idleTimeout);
+		}
 
-			AutoPtr<Net::NetworkStream> stream = NEW Net::NetworkStream (connection);
-			AutoPtr<Request> request = NEW Request (stream);
-			if(request->receive ())
+		network->removeSocketHandler (socket);
+	}
+
+	// cancel and wait for active connections, close connections parked meanwhile
+	closeIdleConnections (-1);
+	workerPool->terminate ();
+	closeIdleConnections (-1);
+	safe_release (workerPool);
+
+	ASSERT (connectionCount == 0)
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API Server::onSocketEvent (Net::ISocket* eventSocket, int events)
+{
+	if(eventSocket == socket)
+		acceptConnection ();
+	else
+		resumeConnection (eventSocket);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Server::acceptConnection ()
+{
+	AutoPtr<Net::ISocket> connectionSocket = socket->accept ();
+	if(!connectionSocket)
+		return;
+
+	if(connectionCount >= maxConnections)
+	{
+		rejectConnection (connectionSocket);
+		return;
+	}
+
+	// responses are buffered, don't delay small packets
+	connectionSocket->setOption (Net::SocketOption::kTCPNoDelay, true);
+
+	connectionCount.increment ();
+	AutoPtr<Connection> connection = NEW Connection (connectionSocket, idleTimeout);
+	workerPool->scheduleWork (NEW ConnectionWork (*this, connection));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Server::rejectConnection (Net::ISocket* connectionSocket)
+{
+	CCL_PRINTLN ("HTTP server: too many connections")
+
+	static const char kResponse[] = "HTTP/1.1 503 Service Unavailable\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+	connectionSocket->send (kResponse, sizeof(kResponse) - 1);
+	connectionSocket->disconnect ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Server::resumeConnection (Net::ISocket* connectionSocket)
+{
+	// wait for one request at a time, registered again when the connection is parked
+	UnknownPtr<Net::INetwork2> network (&System::GetNetwork ());
+	ASSERT (network)
+	if(network)
+		network->removeSocketHandler (connectionSocket);
+
+	Connection* connection = nullptr;
+	{
+		Threading::ScopedLock scopedLock (connectionLock);
+		if(quitRequested) // closed in run()
+			return;
+
+		ListForEach (idleConnections, Connection*, c)
+			if(c->getSocket () == connectionSocket)
 			{
-				#if DEBUG_LOG
-				request->dump ();
-				#endif
-
-				Response& response = request->getResponse ();
-
-				bool handled = false;
-				if(request->getHeaders ().getHost ().isEmpty ())
-				{
-					handled = true;
-					response.setStatus (HTTP::kBadRequest);
-				}
-
-				if(!handled)
-				{
-					if(app)
-						app->handleRequest (*request);
-					response.setStatus (HTTP::kOK);
-				}
-
-				// TODO: "Date" value = "Mon, 23 Nov 2009 14:58:11 GMT"
-				response.getHeaders ().setServer (serverName);
-				response.getHeaders ().setConnection ("close");
-
-				#if DEBUG_LOG
-				response.dump ();
-				#endif
-
-				bool done = response.send ();
-				ASSERT (done == true)
+				connection = c;
+				idleConnections.remove (c);
+				break;
 			}
-		}
+		EndFor
+	}
+
+	if(connection)
+	{
+		workerPool->scheduleWork (NEW ConnectionWork (*this, connection));
+		connection->release ();
 	}
-	return kResultOk;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-void CCL_API Server::quit ()
+void Server::closeIdleConnections (int64 lastActivity)
 {
-	if(quitRequested)
-		return;
+	LinkedList<Connection*> expired;
+	{
+		Threading::ScopedLock scopedLock (connectionLock);
+		ListForEach (idleConnections, Connection*, connection)
+			if(lastActivity < 0 || connection->getLastActivity () < lastActivity)
+			{
+				idleConnections.remove (connection);
+				expired.append (connection);
+			}
+		EndFor
+	}
+
+	UnknownPtr<Net::INetwork2> network (&System::GetNetwork ());
+	ListForEach (expired, Connection*, connection)
+		if(network)
+			network->removeSocketHandler (connection->getSocket ());
+		closeConnection (connection);
+		connection->release ();
+	EndFor
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
 
-	quitRequested = true;
+void Server::closeConnection (Connection* connection)
+{
+	connection->getSocket ()->disconnect ();
+	connectionCount.decrement ();
+}
 
-	// Attempt connecting to self to break the run() loop...
-	Net::IPAddress address;
-	getAddress (address);
 
-	AutoPtr<Net::ISocket> closer = System::GetNetwork ().createSocket (address.family, Net::kStream, Net::kTCP);
-	ASSERT (closer)
-	if(closer)
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Server::handleConnection (Connection& connection)
+{
+	ConnectionStream& stream = connection.getStream ();
+	AutoPtr<Request> request = NEW Request (&stream);
+
+	// handle pipelined requests in order
+	bool keepAlive = false;
+	do
 	{
-		closer->connect (address);
-		char buffer[1] = {1};
-		closer->send (buffer, 1);
-		closer->disconnect ();
+		keepAlive = handleRequest (connection, *request);
 	}
+	while(keepAlive && !quitRequested && stream.hasPendingInput ());
+
+	if(keepAlive && !quitRequested)
+	{
+		// wait for next request on the network I/O thread
+		connection.setLastActivity (System::GetSystemTicks ());
+		connection.retain ();
+		{
+			Threading::ScopedLock scopedLock (connectionLock);
+			idleConnections.append (&connection);
+		}
+
+		UnknownPtr<Net::INetwork2> network (&System::GetNetwork ());
+		if(!network || network->addSocketHandler (connection.getSocket (), Net::SocketEvent::kReadable, this) != kResultOk)
+		{
+			bool parked = false;
+			{
+				Threading::ScopedLock scopedLock (connectionLock);
+				parked = idleConnections.remove (&connection);
+			}
+			if(parked)
+			{
+				closeConnection (&connection);
+				connection.release ();
+			}
+		}
+	}
+	else
+		closeConnection (&connection);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Server::hasConnectionOption (CStringRef connectionHeader, CStringPtr option)
+{
+	// comma-separated list, e.g. "keep-alive, Upgrade"
+	ForEachCStringToken (connectionHeader.str (), ",", token)
+		if(MutableCString (token).trimWhitespace ().compare (option, false) == 0)
+			return true;
+	EndFor
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Server::handleRequest (Connection& connection, Request& request)
+{
+	ConnectionStream& stream = connection.getStream ();
+	if(!request.receive ())
+		return false;
+
+	#if DEBUG_LOG
+	request.dump ();
+	#endif
+
+	connection.setRequestCount (connection.getRequestCount () + 1);
+
+	HeaderList& requestHeaders = request.getHeaders ();
+	CStringRef connectionHeader = requestHeaders.getConnection ();
+	bool keepAlive = false;
+	if(request.getVersion () >= HTTP::kV1_1)
+		keepAlive = !hasConnectionOption (connectionHeader, "close"); // persistent by default
+	else
+		keepAlive = hasConnectionOption (connectionHeader, "keep-alive");
+	if(requestHeaders.isChunkedTransfer ()) // length of request body unknown
+		keepAlive = false;
+	if(connection.getRequestCount () >= maxKeepAliveRequests)
+		keepAlive = false;
+
+	int64 contentLength = requestHeaders.getContentLength ();
+	int64 contentEnd = stream.tell () + contentLength;
+
+	// TODO: "Date" value = "Mon, 23 Nov 2009 14:58:11 GMT"
+	Response& response = request.getResponse ();
+	response.setVersion (request.getVersion () >= HTTP::kV1_1 ? HTTP::kV1_1 : HTTP::kV1_0);
+	response.getHeaders ().setServer (serverName);
+
+	AutoPtr<ResponseStream> body = NEW ResponseStream (response, stream, keepAlive);
+	response.setStream (body);
+
+	bool handled = false;
+	if(requestHeaders.getHost ().isEmpty ())
+	{
+		handled = true;
+		response.setStatus (HTTP::kBadRequest);
+	}
+
+	if(!handled && app)
+		app->handleRequest (request);
+
+	// skip remaining request body to stay in sync with subsequent requests
+	if(body->isKeepAlive () && contentLength > 0 && stream.tell () < contentEnd)
+		if(!stream.skip (contentEnd - stream.tell ()))
+			body->setKeepAlive (false);
+
+	bool done = body->finish ();
+	response.setStream (&stream);
+
+	return done && body->isKeepAlive ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API Server::quit ()
+{
+	if(!quitRequested.testAndSet (1, 0))
+		return;
+
+	// interrupt waiting in run()
+	quitSignal.signal ();
 }
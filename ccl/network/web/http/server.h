@@ -21,15 +21,27 @@
 
 #include "ccl/network/web/webserver.h"
 
+#include "ccl/public/text/cstring.h"
+#include "ccl/public/system/threadsync.h"
+#include "ccl/public/system/ithreadpool.h"
+#include "ccl/public/collections/linkedlist.h"
+
 namespace CCL {
 namespace Web {
 namespace HTTP {
 
+class Request;
+
 //************************************************************************************************
 // HTTP::Server
+/** HTTP/1.1 server with persistent connections.
+	New connections and requests on idle connections are detected on the shared network I/O
+	thread. Requests are handled by a pool of worker threads, pipelined requests of a connection
+	are handled in order. run() blocks until quit() and closes expired idle connections. */
 //************************************************************************************************
 
-class Server: public WebServer
+class Server: public WebServer,
+			  public Net::ISocketEventHandler
 {
 public:
 	DECLARE_CLASS (Server, WebServer)
@@ -37,15 +49,53 @@ public:
 	Server ();
 	~Server ();
 
+	PROPERTY_VARIABLE (int, maxConnections, MaxConnections)
+	PROPERTY_VARIABLE (int, maxWorkerCount, MaxWorkerCount)
+	PROPERTY_VARIABLE (int, idleTimeout, IdleTimeout)
+	PROPERTY_VARIABLE (int, maxKeepAliveRequests, MaxKeepAliveRequests)
+
 	// WebServer
 	tresult CCL_API startup (const Net::SocketAddress& address) override;
 	tresult CCL_API getAddress (Net::SocketAddress& address) override;
 	tresult CCL_API run () override;
 	void CCL_API quit () override;
 
+	// ISocketEventHandler
+	void CCL_API onSocketEvent (Net::ISocket* socket, int events) override;
+
+	CLASS_INTERFACE (ISocketEventHandler, WebServer)
+
 protected:
+	class ConnectionStream;
+	class ResponseStream;
+	class Connection;
+	class ConnectionWork;
+
+	static const int kListenBacklog = 128;
+	static const int kIdleCheckInterval = 250;
+
 	Net::ISocket* socket;
-	bool quitRequested;
+	Threading::AtomicInt quitRequested;
+	Threading::Signal quitSignal;
+	MutableCString serverName;
+	Threading::IThreadPool* workerPool;
+	Threading::CriticalSection connectionLock;
+	LinkedList<Connection*> idleConnections;
+	Threading::AtomicInt connectionCount;
+
+	// called on network I/O thread
+	void acceptConnection ();
+	void rejectConnection (Net::ISocket* connection);
+	void resumeConnection (Net::ISocket* connectionSocket);
+
+	void closeIdleConnections (int64 lastActivity);
+	void closeConnection (Connection* connection);
+
+	static bool hasConnectionOption (CStringRef connectionHeader, CStringPtr option);
+
+	// called by worker threads
+	void handleConnection (Connection& connection);
+	bool handleRequest (Connection& connection, Request& request);
 };
 
 } // namespace HTTP
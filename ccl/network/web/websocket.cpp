@@ -30,8 +30,10 @@
 #include "ccl/public/base/streamer.h"
 #include "ccl/public/base/memorystream.h"
 #include "ccl/public/system/ithreadpool.h"
+#include "ccl/public/system/threadsync.h"
 #include "ccl/public/base/datetime.h"
 #include "ccl/public/systemservices.h"
+#include "ccl/public/netservices.h"
 
 namespace CCL {
 namespace Web {
@@ -298,7 +300,8 @@ DEFINE_CLASS_HIDDEN (WebSocketMessage, Object)
 //************************************************************************************************
 
 class WebSocketClient: public Object,
-					   public Threading::IPeriodicItem
+					   public Threading::IPeriodicItem,
+					   public Net::ISocketEventHandler
 {
 public:
 	WebSocketClient (IObserver* owner);
@@ -310,6 +313,13 @@ public:
 	tresult connect (UrlRef url, VariantRef protocols, IProgressNotify* progress);
 	void signalConnected (tresult result);
 	tresult process ();
+	tresult processPending ();
+	void startListening ();
+	void stopListening ();
+	void beginWork ();
+	void endWork ();
+	void waitWorkFinished ();
+	bool isListening () const { return listening.getValue () != 0; }
 	void signalReceived (WebSocketMessage* message);
 	void signalError ();
 	void queueMessage (WebSocketMessage* message);
@@ -325,11 +335,20 @@ public:
 	int64 CCL_API getExecutionTime () const override;
 	void CCL_API execute (int64 now) override;
 
-	CLASS_INTERFACE (IPeriodicItem, Object)
+	// ISocketEventHandler
+	void CCL_API onSocketEvent (Net::ISocket* socket, int events) override;
+
+	CLASS_INTERFACE2 (IPeriodicItem, ISocketEventHandler, Object)
 
 protected:
 	IObserver* owner;
 	AutoPtr<IStream> stream;
+	AutoPtr<Net::ISocket> listeningSocket;
+	Threading::AtomicInt listening;
+	Threading::AtomicInt processRequests;
+	Threading::CriticalSection workLock;
+	Threading::Signal workIdle;
+	int pendingWork;
 	int64 nextExecutionTime;
 	Threading::CriticalSection sendQueueLock;
 	ObjectList sendQueue;
@@ -361,6 +380,26 @@ protected:
 	SharedPtr<IProgressNotify> progress;
 };
 
+//************************************************************************************************
+// WebSocketProcessWork
+//************************************************************************************************
+
+class WebSocketProcessWork: public Object,
+							public Threading::AbstractWorkItem
+{
+public:
+	WebSocketProcessWork (WebSocketClient& client);
+	~WebSocketProcessWork ();
+
+	// IWorkItem
+	void CCL_API work () override;
+
+	CLASS_INTERFACE (IWorkItem, Object)
+
+protected:
+	SharedPtr<WebSocketClient> client;
+};
+
 } // naemspace Web
 } // namespace CCL
 
@@ -490,7 +529,10 @@ tresult CCL_API WebSocket::close (int code, StringRef reason)
 		else if(readyState == kOpen)
 		{
 			cancelHelper.setCanceled (true);
+			client->stopListening ();
+			System::GetThreadPool ().cancelWork (client, true);
 			System::GetThreadPool ().removePeriodic (client);
+			client->waitWorkFinished ();
 		}
 
 		setState (kClosing);
@@ -588,6 +630,7 @@ void CCL_API WebSocket::notify (ISubject* subject, MessageRef msg)
 			setState (kOpen);
 			signal (Message (kOnOpen));
 			System::GetThreadPool ().addPeriodic (client);
+			client->startListening ();
 		}
 		else
 		{
@@ -696,6 +739,36 @@ void CCL_API WebSocketConnectWork::work ()
 	client.signalConnected (result);
 }
 
+//************************************************************************************************
+// WebSocketProcessWork
+//************************************************************************************************
+
+WebSocketProcessWork::WebSocketProcessWork (WebSocketClient& client)
+: AbstractWorkItem (&client), // use client as work id for cancelation
+  client (&client)
+{
+	client.beginWork ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+WebSocketProcessWork::~WebSocketProcessWork ()
+{
+	client->endWork ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API WebSocketProcessWork::work ()
+{
+	if(!client->isListening ())
+		return;
+
+	tresult result = client->processPending ();
+	if(!(result == kResultTrue || result == kResultFalse))
+		client->signalError ();
+}
+
 //************************************************************************************************
 // WebSocketClient
 //************************************************************************************************
@@ -708,10 +781,13 @@ DEFINE_STRINGID_MEMBER_ (WebSocketClient, kMessageReceived, "messageReceived")
 
 WebSocketClient::WebSocketClient (IObserver* owner)
 : owner (owner),
+  workIdle (true),
+  pendingWork (0),
   nextExecutionTime (0),
   bufferedAmount (0)
 {
 	sendQueue.objectCleanup (true);
+	workIdle.signal ();
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -895,6 +971,100 @@ tresult WebSocketClient::process ()
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+tresult WebSocketClient::processPending ()
+{
+	// called by periodic execution and after socket events, only one thread processes at a time.
+	// Requests arriving meanwhile make the processing thread read again, an edge-triggered socket
+	// doesn't report data again that arrived after the last read.
+	if(processRequests.increment () != 0)
+		return kResultFalse;
+
+	tresult result = kResultFalse;
+	int requests = 1;
+	do
+	{
+		// read until the socket would block
+		while(stream)
+		{
+			result = process ();
+			if(result != kResultTrue)
+				break;
+		}
+
+		if(!(result == kResultTrue || result == kResultFalse))
+		{
+			processRequests.assign (0);
+			break;
+		}
+	} while((requests = processRequests.add (-requests) - requests) > 0);
+
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WebSocketClient::startListening ()
+{
+	ASSERT (listeningSocket == nullptr)
+	UnknownPtr<Net::INetworkStream> netStream (stream);
+	if(netStream == nullptr)
+		return;
+
+	// periodic execution remains as fallback if socket can't be registered
+	Net::ISocket* socket = netStream->getSocket ();
+	listening.assign (1);
+	UnknownPtr<Net::INetwork2> network (&System::GetNetwork ());
+	if(network && network->addSocketHandler (socket, Net::SocketEvent::kReadable|Net::SocketEvent::kEdgeTriggered, this) == kResultOk)
+		listeningSocket.share (socket);
+	else
+		listening.assign (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WebSocketClient::stopListening ()
+{
+	listening.assign (0);
+	if(listeningSocket)
+	{
+		// waits for a handler running on the network I/O thread, no work is scheduled afterwards
+		UnknownPtr<Net::INetwork2> network (&System::GetNetwork ());
+		ASSERT (network)
+		if(network)
+			network->removeSocketHandler (listeningSocket);
+		listeningSocket.release ();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WebSocketClient::beginWork ()
+{
+	Threading::ScopedLock scopedLock (workLock);
+	if(pendingWork++ == 0)
+		workIdle.reset ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WebSocketClient::endWork ()
+{
+	Threading::ScopedLock scopedLock (workLock);
+	ASSERT (pendingWork > 0)
+	if(--pendingWork == 0)
+		workIdle.signal ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WebSocketClient::waitWorkFinished ()
+{
+	// work items still queued return immediately after stopListening ()
+	workIdle.wait (Threading::kWaitForever);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 void WebSocketClient::signalError ()
 {
 	(NEW Message (kProcessingError))->post (owner);
@@ -962,9 +1132,18 @@ int64 CCL_API WebSocketClient::getExecutionTime () const
 
 void CCL_API WebSocketClient::execute (int64 now)
 {
-	tresult result = process ();
+	tresult result = processPending ();
 	if(!(result == kResultTrue || result == kResultFalse))
 		signalError ();
 
 	nextExecutionTime = now + 1000; // 1 second	
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API WebSocketClient::onSocketEvent (Net::ISocket* socket, int events)
+{
+	// don't block the network I/O thread, frames are read on the thread pool
+	if(isListening ())
+		System::GetThreadPool ().scheduleWork (NEW WebSocketProcessWork (*this));
+}
@@ -37,7 +37,7 @@ using namespace CCL;
 
 UnicodeString* UnicodeString::newString ()
 {
-	return NEW AndroidUnicodeString;
+	return new AndroidUnicodeString; // not NEW, string objects are pooled
 }
 
 //************************************************************************************************
@@ -46,7 +46,7 @@ UnicodeString* UnicodeString::newString ()
 
 IString* CCL_API AndroidUnicodeString::cloneString () const
 {
-	return NEW AndroidUnicodeString (*this);
+	return new AndroidUnicodeString (*this);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
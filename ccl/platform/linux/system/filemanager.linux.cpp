@@ -17,6 +17,7 @@
 //************************************************************************************************
 
 #include "filemanager.linux.h"
+#include "nativefilesearcher.linux.h"
 
 #include "ccl/base/collections/objectarray.h"
 
@@ -39,11 +40,14 @@ class LinuxFileSystemMonitorThread: public Threading::UserThread
 {
 public:
 	LinuxFileSystemMonitorThread ();
-	~LinuxFileSystemMonitorThread ();
+	virtual ~LinuxFileSystemMonitorThread ();
 
 	bool startWatching (UrlRef url, int flags);
 	void stopWatching (UrlRef url);
 
+	int addIndexWatch (CStringPtr path);
+	void removeIndexWatch (int wd);
+
 	void cancel ();
 
 protected:
@@ -62,10 +66,12 @@ protected:
 	bool scanning;
 	bool changing;
 	int handle;
+	int indexHandle;
 	int itemsChangedHandle[2];
 	
 	bool waitForItemsChanged ();
 	void scanFileChanges ();
+	void scanIndexChanges ();
 
 	// UserThread
 	int threadEntry ();
@@ -83,8 +89,16 @@ DEFINE_EXTERNAL_SINGLETON (FileManager, LinuxFileManager)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+LinuxFileManager& LinuxFileManager::getInstance ()
+{
+	return static_cast<LinuxFileManager&> (instance ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 LinuxFileManager::LinuxFileManager ()
-: thread (nullptr)
+: thread (nullptr),
+  terminated (false)
 {}
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -98,29 +112,66 @@ LinuxFileManager::~LinuxFileManager ()
 
 void LinuxFileManager::terminate ()
 {
-	if(thread)
+	LinuxFileIndex::instance ().removeAll ();
+
+	// don't hold the lock while stopping, the thread might be adding or removing index watches
+	LinuxFileSystemMonitorThread* oldThread = nullptr;
 	{
-		thread->cancel ();
-		thread->stopThread (500);
-		delete thread;
+		Threading::ScopedLock guard (threadLock);
+		terminated = true;
+		oldThread = thread;
 		thread = nullptr;
 	}
+
+	if(oldThread)
+	{
+		oldThread->cancel ();
+		oldThread->stopThread (500);
+		delete oldThread;
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-tresult LinuxFileManager::startWatching (UrlRef url, int flags)
+LinuxFileSystemMonitorThread* LinuxFileManager::getThread ()
 {
-	ASSERT (System::IsInMainThread ())
-	if(!System::IsInMainThread ())
-		return kResultWrongThread;
-
-	if(thread == nullptr)
+	Threading::ScopedLock guard (threadLock);
+	if(thread == nullptr && !terminated)
 	{
 		thread = NEW LinuxFileSystemMonitorThread;
 		thread->startThread (Threading::kPriorityBelowNormal);
 	}
+	return thread;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LinuxFileManager::addIndexWatch (CStringPtr path)
+{
+	// called by searcher and monitor thread, hold lock so the thread isn't deleted meanwhile
+	Threading::ScopedLock guard (threadLock);
+	LinuxFileSystemMonitorThread* thread = getThread ();
+	return thread ? thread->addIndexWatch (path) : -1;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxFileManager::removeIndexWatch (int wd)
+{
+	Threading::ScopedLock guard (threadLock);
+	if(thread)
+		thread->removeIndexWatch (wd);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult LinuxFileManager::startWatching (UrlRef url, int flags)
+{
+	ASSERT (System::IsInMainThread ())
+	if(!System::IsInMainThread ())
+		return kResultWrongThread;
 
+	LinuxFileSystemMonitorThread* thread = getThread ();
 	if(thread && thread->startWatching (url, flags))
 		return kResultOk;
 
@@ -150,9 +201,11 @@ LinuxFileSystemMonitorThread::LinuxFileSystemMonitorThread ()
   scanning (false),
   changing (false),
   handle (-1),
+  indexHandle (-1),
   itemsChangedHandle {-1, -1}
 {
 	handle = inotify_init1 (IN_NONBLOCK);
+	indexHandle = inotify_init1 (IN_NONBLOCK);
 	::pipe2 (itemsChangedHandle, O_NONBLOCK);
 }
 
@@ -168,6 +221,8 @@ LinuxFileSystemMonitorThread::~LinuxFileSystemMonitorThread ()
 		::close (itemsChangedHandle[1]);
 	if(handle >= 0)
 		::close (handle);
+	if(indexHandle >= 0)
+		::close (indexHandle);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -224,6 +279,21 @@ void LinuxFileSystemMonitorThread::stopWatching (UrlRef url)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+int LinuxFileSystemMonitorThread::addIndexWatch (CStringPtr path)
+{
+	// separate inotify instance, watches of the same folder would be shared otherwise
+	return inotify_add_watch (indexHandle, path, IN_CREATE | IN_DELETE | IN_MOVE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxFileSystemMonitorThread::removeIndexWatch (int wd)
+{
+	inotify_rm_watch (indexHandle, wd);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 void LinuxFileSystemMonitorThread::cancel ()
 {
 	requestTerminate ();
@@ -250,6 +320,7 @@ int LinuxFileSystemMonitorThread::threadEntry ()
 		
 		if(itemsChanged)
 			scanFileChanges ();
+		scanIndexChanges ();
 
 		if(shouldTerminate ())
 			break;
@@ -265,7 +336,8 @@ bool LinuxFileSystemMonitorThread::waitForItemsChanged ()
 	pollfd fds[] =
 	{
 		{ handle, POLLIN, 0 },
-		{ itemsChangedHandle[0], POLLIN, 0 }
+		{ itemsChangedHandle[0], POLLIN, 0 },
+		{ indexHandle, POLLIN, 0 }
 	};
 	
 	::poll (fds, ARRAY_COUNT (fds), -1);
@@ -319,6 +391,35 @@ void LinuxFileSystemMonitorThread::scanFileChanges ()
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxFileSystemMonitorThread::scanIndexChanges ()
+{
+	alignas (inotify_event) char buffer[STRING_STACK_SPACE_MAX];
+	bool changed = false;
+
+	while(true)
+	{
+		ssize_t length = ::read (indexHandle, buffer, STRING_STACK_SPACE_MAX);
+		if(length <= 0)
+			break;
+
+		inotify_event* event = nullptr;
+		for(char* current = buffer; current < buffer + length; current += sizeof(inotify_event) + event->len)
+		{
+			event = reinterpret_cast<inotify_event*> (current);
+			if(event->mask & IN_Q_OVERFLOW) // events lost, index can't be trusted anymore
+				LinuxFileIndex::instance ().removeAll ();
+			else
+				LinuxFileIndex::instance ().markChanged (event->wd, event->mask);
+			changed = true;
+		}
+	}
+
+	if(changed)
+		LinuxFileIndex::instance ().updateChanged ();
+}
+
 //************************************************************************************************
 // MonitoredDirectory
 //************************************************************************************************
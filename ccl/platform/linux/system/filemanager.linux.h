@@ -21,6 +21,8 @@
 
 #include "ccl/system/filemanager.h"
 
+#include "ccl/public/system/threadsync.h"
+
 namespace CCL {
 
 class LinuxFileSystemMonitorThread;
@@ -35,12 +37,21 @@ public:
 	LinuxFileManager ();
 	~LinuxFileManager ();
 
+	static LinuxFileManager& getInstance ();
+
+	int addIndexWatch (CStringPtr path);	///< watch folder for LinuxFileIndex, returns watch descriptor or -1
+	void removeIndexWatch (int wd);
+
 	// FileManager
 	void CCL_API terminate () override;
 	
 protected:
 	friend class LinuxFileSystemMonitorThread;
 	LinuxFileSystemMonitorThread* thread;
+	Threading::CriticalSection threadLock;
+	bool terminated;
+
+	LinuxFileSystemMonitorThread* getThread (); ///< creates thread on demand
 
 	// FileManager
 	tresult startWatching (UrlRef url, int flags) override;
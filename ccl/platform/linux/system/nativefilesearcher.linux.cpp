@@ -0,0 +1,965 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/platform/linux/system/nativefilesearcher.linux.cpp
+// Description : Linux native file searcher
+//
+//************************************************************************************************
+
+#define DEBUG_LOG 0
+
+#include "ccl/platform/linux/system/nativefilesearcher.linux.h"
+#include "ccl/platform/linux/system/nativefilesystem.linux.h"
+#include "ccl/platform/linux/system/filemanager.linux.h"
+
+#include "ccl/base/storage/url.h"
+#include "ccl/base/storage/configuration.h"
+
+#include "ccl/public/base/iprogress.h"
+#include "ccl/public/system/isearcher.h"
+#include "ccl/public/system/isysteminfo.h"
+#include "ccl/public/system/userthread.h"
+#include "ccl/public/systemservices.h"
+
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/inotify.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace CCL {
+namespace Linux {
+
+static const Configuration::BoolValue fileIndexEnabled ("CCL.Linux.FileIndex", "Enabled", false);
+static const Configuration::IntValue fileIndexMaxWatches ("CCL.Linux.FileIndex", "MaxWatches", 8192);
+
+//************************************************************************************************
+// Linux::FolderWalker
+/** Walks a folder tree with multiple threads. */
+//************************************************************************************************
+
+class FolderWalker
+{
+public:
+	FolderWalker (CStringPtr startPath, LinuxFileIndex::Folder* indexRoot);
+	~FolderWalker ();
+
+	struct Batch
+	{
+		MutableCString path;
+		LinuxFolderEntries entries;
+	};
+
+	static const int kMaxThreads = 8;
+
+	void start ();
+	void stop ();
+	void cancel ();
+	bool isDone ();
+	bool getBatches (Vector<Batch*>& batches); ///< returns false if nothing pending
+	void waitForBatches (uint32 milliseconds);
+
+protected:
+	struct Item
+	{
+		MutableCString path;
+		LinuxFileIndex::Folder* indexFolder;
+	};
+
+	class WorkerThread: public Threading::UserThread
+	{
+	public:
+		WorkerThread (FolderWalker& walker)
+		: UserThread ("FolderWalker"),
+		  walker (walker)
+		{}
+
+		virtual ~WorkerThread () {}
+
+	protected:
+		FolderWalker& walker;
+
+		// UserThread
+		int threadEntry () override { walker.work (); return 0; }
+	};
+
+	Threading::CriticalSection lock;
+	Threading::Signal workSignal;	///< items added, walk finished or canceled
+	Threading::Signal batchSignal;	///< batches added or walk finished
+	Vector<Item*> items;
+	Vector<Batch*> batches;
+	Vector<WorkerThread*> threads;
+	int numBusy;
+	bool canceled;
+
+	void work ();
+};
+
+//************************************************************************************************
+// Linux::NativeFileSearcher
+//************************************************************************************************
+
+class NativeFileSearcher: public Unknown,
+						  public AbstractSearcher
+{
+public:
+	NativeFileSearcher (ISearchDescription& description);
+
+	static ISearcher* createInstance (ISearchDescription& description);
+
+	// ISearcher
+	tresult CCL_API find (ISearchResultSink& resultSink, IProgressNotify* progress) override;
+
+	CLASS_INTERFACE (ISearcher, Unknown)
+
+protected:
+	static const int kProgressInterval = 50; ///< milliseconds
+
+	bool isIndexEnabled () const;
+	bool findInIndex (ISearchResultSink& resultSink, IProgressNotify* progress, CStringPtr startPath);
+	tresult findInFolders (ISearchResultSink& resultSink, IProgressNotify* progress, CStringPtr startPath, bool useIndex);
+	bool matchesName (CStringPtr name, bool isFolder) const;
+	static void addPath (LinuxNameList& paths, CStringPtr folderPath, CStringPtr name);
+	void addResult (ISearchResultSink& resultSink, CStringPtr folderPath, CStringPtr name, bool isFolder);
+	void addResult (ISearchResultSink& resultSink, CStringPtr path, bool isFolder);
+};
+
+} // namespace Linux
+} // namespace CCL
+
+using namespace CCL;
+using namespace Linux;
+
+//************************************************************************************************
+// LinuxNativeFileSystem
+//************************************************************************************************
+
+ISearcher* CCL_API LinuxNativeFileSystem::createSearcher (ISearchDescription& description)
+{
+	return NativeFileSearcher::createInstance (description);
+}
+
+//************************************************************************************************
+// LinuxNameList
+//************************************************************************************************
+
+LinuxNameList::LinuxNameList ()
+: numNames (0)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxNameList::add (CStringPtr name, int length)
+{
+	int offset = buffer.count ();
+	int newCount = offset + length + 1;
+	if(newCount > buffer.getCapacity ())
+		buffer.resize (ccl_max (newCount, buffer.getCapacity () * 2));
+	buffer.setCount (newCount);
+	::memcpy (buffer.getItems () + offset, name, length);
+	buffer[newCount - 1] = 0;
+	numNames++;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxNameList::removeAll ()
+{
+	buffer.removeAll ();
+	numNames = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LinuxNameList::count () const
+{
+	return numNames;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CStringPtr LinuxNameList::next (int& offset) const
+{
+	if(offset >= buffer.count ())
+		return nullptr;
+
+	CStringPtr name = buffer.getItems () + offset;
+	offset += (int)::strlen (name) + 1;
+	return name;
+}
+
+//************************************************************************************************
+// LinuxFolderEntries
+//************************************************************************************************
+
+bool LinuxFolderEntries::read (CStringPtr path)
+{
+	files.removeAll ();
+	folders.removeAll ();
+
+	int handle = ::open (path, O_RDONLY|O_DIRECTORY|O_CLOEXEC|O_NOFOLLOW);
+	if(handle == -1)
+		return false;
+
+	struct DirEntry64
+	{
+		uint64 d_ino;
+		int64 d_off;
+		unsigned short d_reclen;
+		unsigned char d_type;
+		char d_name[1];
+	};
+
+	alignas (DirEntry64) char buffer[32 * 1024];
+	while(true)
+	{
+		long length = ::syscall (SYS_getdents64, handle, buffer, sizeof(buffer));
+		if(length <= 0)
+			break;
+
+		for(long offset = 0; offset < length;)
+		{
+			DirEntry64* entry = reinterpret_cast<DirEntry64*> (buffer + offset);
+			offset += entry->d_reclen;
+
+			CStringPtr name = entry->d_name;
+			if(name[0] == '.') // skip hidden entries and pseudo-folders
+				continue;
+
+			int type = entry->d_type;
+			if(type == DT_UNKNOWN) // not supported by all file systems
+			{
+				struct stat buf;
+				if(::fstatat (handle, name, &buf, AT_SYMLINK_NOFOLLOW) == 0)
+					type = S_ISDIR (buf.st_mode) ? DT_DIR : S_ISREG (buf.st_mode) ? DT_REG : DT_UNKNOWN;
+			}
+
+			if(type == DT_DIR)
+				folders.add (name, (int)::strlen (name));
+			else if(type == DT_REG)
+				files.add (name, (int)::strlen (name));
+		}
+	}
+
+	::close (handle);
+	return true;
+}
+
+//************************************************************************************************
+// LinuxFileIndex::Folder
+//************************************************************************************************
+
+LinuxFileIndex::Folder::Folder (CStringPtr path, Folder* parent)
+: path (path),
+  parent (parent),
+  wd (-1),
+  complete (false),
+  dirty (false)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CStringPtr LinuxFileIndex::Folder::getName () const
+{
+	CStringPtr name = ::strrchr (path.str (), '/');
+	return name ? name + 1 : path.str ();
+}
+
+//************************************************************************************************
+// LinuxFileIndex
+//************************************************************************************************
+
+LinuxFileIndex& LinuxFileIndex::instance ()
+{
+	static LinuxFileIndex theInstance;
+	return theInstance;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+LinuxFileIndex::LinuxFileIndex ()
+: watches (16384),
+  numFolders (0),
+  maxFolders (0)
+{
+	// inotify watches are limited per user, leave most of them to LinuxFileManager::startWatching ()
+	maxFolders = ccl_min<int> (fileIndexMaxWatches, getMaxUserWatches () / 4);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+LinuxFileIndex::~LinuxFileIndex ()
+{
+	ASSERT (roots.isEmpty ())
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LinuxFileIndex::getMaxUserWatches ()
+{
+	static const int kDefaultMaxUserWatches = 8192; // kernel default on older systems
+
+	int handle = ::open ("/proc/sys/fs/inotify/max_user_watches", O_RDONLY|O_CLOEXEC);
+	if(handle == -1)
+		return kDefaultMaxUserWatches;
+
+	char buffer[32] = {};
+	ssize_t length = ::read (handle, buffer, sizeof(buffer) - 1);
+	::close (handle);
+
+	int value = length > 0 ? ::atoi (buffer) : 0;
+	return value > 0 ? value : kDefaultMaxUserWatches;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+LinuxFileIndex::Folder* LinuxFileIndex::getRoot (Folder* folder)
+{
+	while(folder->parent)
+		folder = folder->parent;
+	return folder;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+LinuxFileIndex::Folder* LinuxFileIndex::findFolder (CStringPtr path) const
+{
+	for(Folder* root : roots)
+	{
+		// a dirty root is out of date, searches fall back to reading the disk
+		if(!root->complete || root->dirty)
+			continue;
+
+		int rootLength = root->path.length ();
+		if(::strncmp (path, root->path, rootLength) != 0)
+			continue;
+
+		CStringPtr remainder = path + rootLength;
+		if(*remainder != 0 && *remainder != '/' && rootLength > 1)
+			continue;
+
+		// descend from root to requested subfolder
+		Folder* folder = root;
+		while(folder && *remainder)
+		{
+			while(*remainder == '/')
+				remainder++;
+			CStringPtr end = ::strchr (remainder, '/');
+			int length = end ? int(end - remainder) : (int)::strlen (remainder);
+			if(length == 0)
+				break;
+
+			Folder* subFolder = nullptr;
+			for(Folder* f : folder->folders)
+			{
+				CStringPtr name = f->getName ();
+				if(::strncmp (name, remainder, length) == 0 && name[length] == 0)
+				{
+					subFolder = f;
+					break;
+				}
+			}
+			folder = subFolder;
+			remainder += length;
+		}
+
+		if(folder)
+			return folder;
+	}
+	return nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+LinuxFileIndex::Folder* LinuxFileIndex::beginRoot (CStringPtr path)
+{
+	if(numFolders >= maxFolders)
+		return nullptr;
+
+	Folder* root = NEW Folder (path, nullptr);
+	roots.add (root);
+	numFolders++;
+	return root;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxFileIndex::setContent (Folder* folder, const LinuxFolderEntries& entries)
+{
+	ASSERT (folder->files.count () == 0 && folder->folders.isEmpty ())
+
+	Folder* root = getRoot (folder);
+	if(numFolders + entries.folders.count () > maxFolders)
+		root->dirty = true; // index would use too many watches, search without index
+	if(root->dirty)
+		return;
+
+	folder->wd = LinuxFileManager::getInstance ().addIndexWatch (folder->path);
+	if(folder->wd == -1)
+	{
+		root->dirty = true; // can't be kept up to date
+		return;
+	}
+	watches.add (folder->wd, folder);
+
+	folder->files = entries.files;
+	addSubFolders (folder, entries.folders);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxFileIndex::addSubFolders (Folder* folder, const LinuxNameList& names)
+{
+	int offset = 0;
+	while(CStringPtr name = names.next (offset))
+	{
+		MutableCString path (folder->path);
+		if(folder->parent || path.lastChar () != '/')
+			path.append ("/");
+		path.append (name);
+		folder->folders.add (NEW Folder (path, folder));
+		numFolders++;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxFileIndex::endRoot (Folder* root, bool succeeded)
+{
+	if(!succeeded || root->dirty)
+	{
+		removeRoot (root);
+		return;
+	}
+
+	// other roots inside this one are no longer needed
+	int rootLength = root->path.length ();
+	for(int i = roots.count () - 1; i >= 0; i--)
+	{
+		Folder* other = roots[i];
+		if(other != root && other->complete && ::strncmp (other->path, root->path, rootLength) == 0 && (other->path[rootLength] == '/' || other->path[rootLength] == 0))
+			removeRoot (other);
+	}
+
+	root->complete = true;
+	CCL_PRINTF ("File index: %d folders\n", numFolders)
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxFileIndex::refreshFolder (Folder* folder, const LinuxFolderEntries& entries)
+{
+	folder->files = entries.files;
+
+	// keep existing subfolders, remove deleted ones, new ones are read later
+	Vector<Folder*> oldFolders (folder->folders);
+	folder->folders.removeAll ();
+
+	int offset = 0;
+	while(CStringPtr name = entries.folders.next (offset))
+	{
+		Folder* subFolder = nullptr;
+		for(Folder* f : oldFolders)
+			if(::strcmp (f->getName (), name) == 0)
+			{
+				subFolder = f;
+				oldFolders.remove (f);
+				break;
+			}
+
+		if(subFolder == nullptr)
+		{
+			MutableCString path (folder->path);
+			if(folder->parent || path.lastChar () != '/')
+				path.append ("/");
+			path.append (name);
+			subFolder = NEW Folder (path, folder);
+			numFolders++;
+			changedFolders.addOnce (subFolder);
+		}
+		folder->folders.add (subFolder);
+	}
+
+	for(Folder* f : oldFolders)
+		removeFolder (f);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxFileIndex::removeFolder (Folder* folder)
+{
+	for(Folder* subFolder : folder->folders)
+		removeFolder (subFolder);
+
+	changedFolders.remove (folder);
+	if(folder->wd != -1)
+	{
+		watches.remove (folder->wd);
+		LinuxFileManager::getInstance ().removeIndexWatch (folder->wd);
+	}
+
+	numFolders--;
+	delete folder;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxFileIndex::removeRoot (Folder* root)
+{
+	roots.remove (root);
+	removeFolder (root);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxFileIndex::markChanged (int wd, int mask)
+{
+	Threading::ScopedLock guard (lock);
+
+	Folder* folder = watches.lookup (wd);
+	if(folder == nullptr)
+		return;
+
+	Folder* root = getRoot (folder);
+	if(!root->complete)
+		root->dirty = true; // still indexing, discarded when done
+	else if(folder == root && (mask & (IN_DELETE_SELF|IN_MOVE_SELF)))
+		removeRoot (root);
+	else
+		changedFolders.addOnce (folder);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxFileIndex::updateChanged ()
+{
+	// folders are read without holding the lock, the folder might be removed meanwhile
+	while(true)
+	{
+		Folder* folder = nullptr;
+		MutableCString path;
+		{
+			Threading::ScopedLock guard (lock);
+			if(changedFolders.isEmpty ())
+				break;
+
+			folder = changedFolders.last ();
+			path = folder->path;
+		}
+
+		LinuxFolderEntries entries;
+		bool succeeded = entries.read (path);
+
+		// removed folders are no longer in the list, more changes are handled first
+		Threading::ScopedLock guard (lock);
+		if(changedFolders.isEmpty () || changedFolders.last () != folder || folder->path != path)
+			continue;
+
+		changedFolders.removeLast ();
+		if(!succeeded)
+			continue; // folder has been removed, handled by parent
+
+		Folder* root = getRoot (folder);
+		if(folder->wd == -1) // new subfolder, start watching
+		{
+			setContent (folder, entries);
+			changedFolders.addAll (folder->folders);
+		}
+		else
+			refreshFolder (folder, entries);
+
+		if(root->complete && root->dirty)
+			removeRoot (root); // can't be kept up to date
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LinuxFileIndex::removeAll ()
+{
+	Threading::ScopedLock guard (lock);
+
+	changedFolders.removeAll ();
+	for(int i = roots.count () - 1; i >= 0; i--)
+	{
+		if(roots[i]->complete)
+			removeRoot (roots[i]);
+		else
+			roots[i]->dirty = true; // removed by searcher when done
+	}
+}
+
+//************************************************************************************************
+// Linux::FolderWalker
+//************************************************************************************************
+
+FolderWalker::FolderWalker (CStringPtr startPath, LinuxFileIndex::Folder* indexRoot)
+: workSignal (true),
+  numBusy (0),
+  canceled (false)
+{
+	Item* item = NEW Item;
+	item->path = startPath;
+	item->indexFolder = indexRoot;
+	items.add (item);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FolderWalker::~FolderWalker ()
+{
+	stop ();
+
+	for(Item* item : items)
+		delete item;
+	for(Batch* batch : batches)
+		delete batch;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FolderWalker::start ()
+{
+	int numThreads = ccl_bound (System::GetSystem ().getNumberOfCPUs (), 1, kMaxThreads);
+	for(int i = 0; i < numThreads; i++)
+	{
+		WorkerThread* thread = NEW WorkerThread (*this);
+		thread->startThread (Threading::kPriorityBelowNormal);
+		threads.add (thread);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FolderWalker::stop ()
+{
+	cancel ();
+	for(WorkerThread* thread : threads)
+	{
+		thread->stopThread (5000);
+		delete thread;
+	}
+	threads.removeAll ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FolderWalker::cancel ()
+{
+	Threading::ScopedLock guard (lock);
+	canceled = true;
+	workSignal.signal ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool FolderWalker::isDone ()
+{
+	Threading::ScopedLock guard (lock);
+	return canceled || (items.isEmpty () && numBusy == 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool FolderWalker::getBatches (Vector<Batch*>& result)
+{
+	Threading::ScopedLock guard (lock);
+	if(batches.isEmpty ())
+		return false;
+
+	result.takeVector (batches);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FolderWalker::waitForBatches (uint32 milliseconds)
+{
+	batchSignal.wait (milliseconds);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FolderWalker::work ()
+{
+	LinuxFileIndex& index = LinuxFileIndex::instance ();
+
+	while(true)
+	{
+		Item* item = nullptr;
+		{
+			Threading::ScopedLock guard (lock);
+			if(canceled)
+				break;
+
+			if(!items.isEmpty ())
+			{
+				item = items.last (); // depth first keeps the queue short
+				items.removeLast ();
+				numBusy++;
+			}
+			else if(numBusy == 0)
+				break;
+			else
+				workSignal.reset (); // wait for other threads to add items or finish
+		}
+
+		if(item == nullptr)
+		{
+			workSignal.wait (Threading::kWaitForever);
+			continue;
+		}
+
+		Batch* batch = NEW Batch;
+		batch->path = item->path;
+		Vector<Item*> subItems;
+		if(batch->entries.read (item->path))
+		{
+			if(item->indexFolder)
+			{
+				Threading::ScopedLock guard (index.getLock ());
+				index.setContent (item->indexFolder, batch->entries);
+			}
+
+			// subfolders of index folder are in the same order
+			int i = 0;
+			int offset = 0;
+			while(CStringPtr name = batch->entries.folders.next (offset))
+			{
+				Item* subItem = NEW Item;
+				subItem->path = item->path;
+				if(subItem->path.lastChar () != '/')
+					subItem->path.append ("/");
+				subItem->path.append (name);
+				subItem->indexFolder = item->indexFolder && i < item->indexFolder->folders.count () ? item->indexFolder->folders[i] : nullptr;
+				subItems.add (subItem);
+				i++;
+			}
+		}
+		delete item;
+
+		Threading::ScopedLock guard (lock);
+		items.addAll (subItems);
+		batches.add (batch);
+		numBusy--;
+		if(!subItems.isEmpty () || (items.isEmpty () && numBusy == 0))
+			workSignal.signal ();
+		batchSignal.signal ();
+	}
+}
+
+//************************************************************************************************
+// Linux::NativeFileSearcher
+//************************************************************************************************
+
+ISearcher* NativeFileSearcher::createInstance (ISearchDescription& description)
+{
+	return NEW NativeFileSearcher (description);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+NativeFileSearcher::NativeFileSearcher (ISearchDescription& description)
+: AbstractSearcher (description)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API NativeFileSearcher::find (ISearchResultSink& resultSink, IProgressNotify* progress)
+{
+	POSIXPath path (searchDescription.getStartPoint ());
+	if(!path.isValid ())
+		return kResultInvalidArgument;
+
+	MutableCString startPath (path);
+	while(startPath.length () > 1 && startPath.lastChar () == '/')
+		startPath.truncate (startPath.length () - 1);
+
+	bool useIndex = isIndexEnabled ();
+	if(useIndex && findInIndex (resultSink, progress, startPath))
+		return progress && progress->isCanceled () ? kResultAborted : kResultOk;
+
+	return findInFolders (resultSink, progress, startPath, useIndex);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool NativeFileSearcher::isIndexEnabled () const
+{
+	// each indexed folder uses an inotify watch, only index when requested
+	return (searchDescription.getOptions () & ISearchDescription::kUseFileIndex) != 0 || fileIndexEnabled;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool NativeFileSearcher::findInIndex (ISearchResultSink& resultSink, IProgressNotify* progress, CStringPtr startPath)
+{
+	// collect matches while holding the lock, the result sink is called after unlocking
+	LinuxNameList files;
+	LinuxNameList folders;
+	{
+		LinuxFileIndex& index = LinuxFileIndex::instance ();
+		Threading::ScopedLock guard (index.getLock ());
+
+		LinuxFileIndex::Folder* startFolder = index.findFolder (startPath);
+		if(startFolder == nullptr)
+			return false;
+
+		CCL_PRINTF ("Searching in file index: %s\n", startPath)
+
+		Vector<LinuxFileIndex::Folder*> pending;
+		pending.add (startFolder);
+		while(!pending.isEmpty ())
+		{
+			if(progress && progress->isCanceled ())
+				break;
+
+			LinuxFileIndex::Folder* folder = pending.last ();
+			pending.removeLast ();
+
+			int offset = 0;
+			while(CStringPtr name = folder->files.next (offset))
+				if(matchesName (name, false))
+					addPath (files, folder->path, name);
+
+			for(LinuxFileIndex::Folder* subFolder : folder->folders)
+			{
+				if(matchesName (subFolder->getName (), true))
+					addPath (folders, folder->path, subFolder->getName ());
+				pending.add (subFolder);
+			}
+		}
+	}
+
+	int offset = 0;
+	while(CStringPtr path = files.next (offset))
+		addResult (resultSink, path, false);
+
+	offset = 0;
+	while(CStringPtr path = folders.next (offset))
+		addResult (resultSink, path, true);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult NativeFileSearcher::findInFolders (ISearchResultSink& resultSink, IProgressNotify* progress, CStringPtr startPath, bool useIndex)
+{
+	LinuxFileIndex& index = LinuxFileIndex::instance ();
+	LinuxFileIndex::Folder* indexRoot = nullptr;
+	if(useIndex)
+	{
+		Threading::ScopedLock guard (index.getLock ());
+		indexRoot = index.beginRoot (startPath);
+	}
+
+	FolderWalker walker (startPath, indexRoot);
+	walker.start ();
+
+	bool canceled = false;
+	Vector<FolderWalker::Batch*> batches;
+	while(true)
+	{
+		bool done = walker.isDone ();
+		if(!walker.getBatches (batches))
+		{
+			if(done)
+				break;
+			walker.waitForBatches (kProgressInterval);
+			continue;
+		}
+
+		for(FolderWalker::Batch* batch : batches)
+		{
+			int offset = 0;
+			while(CStringPtr name = batch->entries.files.next (offset))
+				addResult (resultSink, batch->path, name, false);
+
+			offset = 0;
+			while(CStringPtr name = batch->entries.folders.next (offset))
+				addResult (resultSink, batch->path, name, true);
+
+			delete batch;
+		}
+		batches.removeAll ();
+
+		if(progress)
+		{
+			if(progress->isCanceled ())
+			{
+				canceled = true;
+				break;
+			}
+			progress->updateProgress (IProgressNotify::State (0., IProgressNotify::kIndeterminate));
+		}
+	}
+	walker.stop (); // index must not be accessed by workers anymore
+
+	if(indexRoot)
+	{
+		Threading::ScopedLock guard (index.getLock ());
+		index.endRoot (indexRoot, !canceled);
+	}
+
+	return canceled ? kResultAborted : kResultOk;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool NativeFileSearcher::matchesName (CStringPtr name, bool isFolder) const
+{
+	// match file names without extension
+	int length = -1;
+	if(!isFolder)
+		if(CStringPtr extension = ::strrchr (name, '.'))
+			length = int(extension - name);
+
+	String fileName;
+	fileName.appendCString (Text::kSystemEncoding, name, length);
+	return searchDescription.matchesName (fileName) != 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeFileSearcher::addPath (LinuxNameList& paths, CStringPtr folderPath, CStringPtr name)
+{
+	MutableCString path (folderPath);
+	if(path.lastChar () != '/')
+		path.append ("/");
+	path.append (name);
+	paths.add (path, path.length ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeFileSearcher::addResult (ISearchResultSink& resultSink, CStringPtr folderPath, CStringPtr name, bool isFolder)
+{
+	if(!matchesName (name, isFolder))
+		return;
+
+	MutableCString path (folderPath);
+	if(path.lastChar () != '/')
+		path.append ("/");
+	path.append (name);
+	addResult (resultSink, path, isFolder);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeFileSearcher::addResult (ISearchResultSink& resultSink, CStringPtr path, bool isFolder)
+{
+	AutoPtr<Url> url = NEW Url;
+	url->fromPOSIXPath (path, isFolder ? Url::kFolder : Url::kFile);
+	resultSink.addResult (static_cast<IUrl*> (url.detach ()));
+}
@@ -0,0 +1,133 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/platform/linux/system/nativefilesearcher.linux.h
+// Description : Linux native file searcher
+//
+//************************************************************************************************
+
+#ifndef _ccl_nativefilesearcher_linux_h
+#define _ccl_nativefilesearcher_linux_h
+
+#include "ccl/public/base/cclmacros.h"
+#include "ccl/public/system/threadsync.h"
+#include "ccl/public/collections/hashmap.h"
+#include "ccl/public/collections/vector.h"
+#include "ccl/public/text/cstring.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// LinuxNameList
+/** Packed list of zero-terminated names. */
+//************************************************************************************************
+
+class LinuxNameList
+{
+public:
+	LinuxNameList ();
+
+	void add (CStringPtr name, int length);
+	void removeAll ();
+	int count () const;
+
+	/** Get next name, start with offset 0. Returns null at end of list. */
+	CStringPtr next (int& offset) const;
+
+protected:
+	Vector<char> buffer;
+	int numNames;
+};
+
+//************************************************************************************************
+// LinuxFolderEntries
+/** Names of files and subfolders of a folder, hidden entries are skipped. */
+//************************************************************************************************
+
+struct LinuxFolderEntries
+{
+	LinuxNameList files;
+	LinuxNameList folders;
+
+	/** Read folder with getdents64, symbolic links are not followed. */
+	bool read (CStringPtr path);
+};
+
+//************************************************************************************************
+// LinuxFileIndex
+/** Filename index of folders searched before, kept up to date via inotify by the
+	file system monitor thread of LinuxFileManager. Only used by searches with option
+	ISearchDescription::kUseFileIndex, or for all searches if enabled via configuration
+	"CCL.Linux.FileIndex" "Enabled". */
+//************************************************************************************************
+
+class LinuxFileIndex
+{
+public:
+	LinuxFileIndex ();
+	~LinuxFileIndex ();
+
+	static LinuxFileIndex& instance ();
+
+	struct Folder
+	{
+		MutableCString path;
+		Folder* parent;
+		int wd;
+		LinuxNameList files;
+		Vector<Folder*> folders;
+		bool complete;	///< root only: all subfolders have been indexed
+		bool dirty;		///< root only: changes occurred while indexing or index can't be kept up to date
+
+		Folder (CStringPtr path, Folder* parent);
+		CStringPtr getName () const;
+	};
+
+	// used by searcher
+	Threading::CriticalSection& getLock ();
+	Folder* findFolder (CStringPtr path) const;					///< in completely indexed, clean roots, lock first!
+	Folder* beginRoot (CStringPtr path);						///< start indexing of new root
+	void setContent (Folder* folder, const LinuxFolderEntries& entries);
+	void endRoot (Folder* root, bool succeeded);
+
+	// used by file system monitor thread
+	void markChanged (int wd, int mask);
+	void updateChanged ();
+	void removeAll ();
+
+protected:
+	Threading::CriticalSection lock;
+	Vector<Folder*> roots;
+	HashMap<int, Folder*> watches;
+	Vector<Folder*> changedFolders;	///< to be read again, or for the first time if not watched yet
+	int numFolders;
+	int maxFolders;					///< limits number of inotify watches, well below the limit shared with file watching
+
+	static int getMaxUserWatches ();
+
+	static Folder* getRoot (Folder* folder);
+	void addSubFolders (Folder* folder, const LinuxNameList& names);
+	void refreshFolder (Folder* folder, const LinuxFolderEntries& entries);
+	void removeFolder (Folder* folder);
+	void removeRoot (Folder* root);
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// inline
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+inline Threading::CriticalSection& LinuxFileIndex::getLock () { return lock; }
+
+} // namespace CCL
+
+#endif // _ccl_nativefilesearcher_linux_h
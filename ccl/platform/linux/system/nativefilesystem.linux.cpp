@@ -25,10 +25,18 @@
 #include "ccl/base/storage/propertyfile.h"
 #include "ccl/base/collections/container.h"
 
+#include "ccl/public/base/iprogress.h"
+#include "ccl/public/system/ifileutilities.h"
+#include "ccl/public/systemservices.h"
+
 #include <sys/stat.h>
 #include <sys/sysmacros.h>
 #include <sys/vfs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <linux/fs.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 using namespace CCL;
@@ -122,6 +130,77 @@ IStream* LinuxNativeFileSystem::openPlatformStream (UrlRef url, int mode)
 	return NEW LinuxFileStream (this, reinterpret_cast<void*> (handle), mode);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LinuxNativeFileSystem::getFileDescriptor (IStream& stream)
+{
+	UnknownPtr<INativeFileStream> nativeStream (&stream);
+	if(!nativeStream)
+		return -1;
+	return LinuxFileStream::intFromPointer (nativeStream->getNativeFileStream ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API LinuxNativeFileSystem::copyFile (UrlRef dstPath, UrlRef srcPath, int mode, IProgressNotify* progress)
+{
+	// share data blocks on copy-on-write file systems (btrfs, xfs, ...)
+	if(!((mode & kDoNotOverwrite) && fileExists (dstPath)) && cloneFile (dstPath, srcPath))
+	{
+		if(progress)
+		{
+			progress->beginProgress ();
+			progress->updateProgress (IProgressNotify::State (1.));
+			progress->endProgress ();
+		}
+		return true;
+	}
+
+	// otherwise the kernel copies the data, see copyNativeStream ()
+	return PosixNativeFileSystem::copyFile (dstPath, srcPath, mode, progress);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool LinuxNativeFileSystem::cloneFile (UrlRef dstPath, UrlRef srcPath)
+{
+	int srcHandle = openFileDescriptor (srcPath, IStream::kOpenMode);
+	if(srcHandle == -1)
+		return false;
+
+	bool result = false;
+	int dstHandle = openFileDescriptor (dstPath, IStream::kCreateMode);
+	if(dstHandle != -1)
+	{
+		result = ::ioctl (dstHandle, FICLONE, srcHandle) == 0;
+		::close (dstHandle);
+
+		// not supported, leave destination to regular copy
+		if(!result)
+			::unlink (POSIXPath (dstPath));
+	}
+	::close (srcHandle);
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LinuxNativeFileSystem::copyNativeStream (IStream& dstStream, IStream& srcStream, int numBytes)
+{
+	int srcHandle = getFileDescriptor (srcStream);
+	int dstHandle = getFileDescriptor (dstStream);
+	if(srcHandle == -1 || dstHandle == -1)
+		return -1;
+
+	// both calls use and advance the current file offsets, no data is copied on failure
+	ssize_t numBytesCopied = ::copy_file_range (srcHandle, nullptr, dstHandle, nullptr, numBytes, 0);
+	if(numBytesCopied == -1) // not supported for this pair of files (e.g. across file systems on older kernels)
+		numBytesCopied = ::sendfile (dstHandle, srcHandle, nullptr, numBytes);
+
+	CCL_PRINTF ("Native copy %d of %d bytes\n", (int)numBytesCopied, numBytes)
+	return (int)numBytesCopied;
+}
+
 //************************************************************************************************
 // LinuxFileStream
 //************************************************************************************************
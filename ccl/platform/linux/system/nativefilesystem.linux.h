@@ -33,8 +33,16 @@ public:
 	// PosixNativeFileSystem
 	IFileIterator* CCL_API newIterator (UrlRef url, int mode = IFileIterator::kAll) override;
 	tbool CCL_API getVolumeInfo (VolumeInfo& info, UrlRef rootUrl) override;
+	tbool CCL_API copyFile (UrlRef dstPath, UrlRef srcPath, int mode = 0, IProgressNotify* progress = nullptr) override;
+	ISearcher* CCL_API createSearcher (ISearchDescription& description) override;
+
+	// NativeFileSystem
+	int copyNativeStream (IStream& dstStream, IStream& srcStream, int numBytes) override;
 
 protected:
+	static int getFileDescriptor (IStream& stream);
+	static bool cloneFile (UrlRef dstPath, UrlRef srcPath);
+
 	// PosixNativeFileSystem
 	IStream* openPlatformStream (UrlRef url, int mode) override;
 };
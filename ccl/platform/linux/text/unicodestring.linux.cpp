@@ -23,6 +23,8 @@
 #include "ccl/text/strings/unicode-cross-platform/ucharfunctions.h"
 #include "ccl/text/strings/stringstats.h"
 
+#include "core/text/coreutfcodec.h"
+
 #ifndef CCLTEXT_LIBUNISTRING_ENABLED
 #define CCLTEXT_LIBUNISTRING_ENABLED 1
 #endif 
@@ -70,6 +72,120 @@ static CStringPtr getNativeEncoding (TextEncoding encoding)
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 #if CCLTEXT_LIBUNISTRING_ENABLED
+static TextEncoding resolveEncoding (TextEncoding encoding)
+{
+	if(encoding == Text::kSystemEncoding && ::strcmp (getNativeEncoding (encoding), "UTF-8") == 0)
+		return Text::kUTF8;
+	return encoding;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool isASCII (const uchar* s, int length)
+{
+	// null characters are allowed, strings are usually passed with terminator
+	int i = 0;
+	while((i += Core::Text::UTFCodec::countASCII (s + i, length - i)) < length)
+		if(s[i++] != 0)
+			return false;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool isASCII (const char* s, int length)
+{
+	int i = 0;
+	while((i += Core::Text::UTFCodec::countASCII ((const unsigned char*)s + i, length - i)) < length)
+		if(s[i++] != 0)
+			return false;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool isLatin1 (const uchar* s, int length)
+{
+	int i = 0;
+	while((i += Core::Text::UTFCodec::countLatin1 (s + i, length - i)) < length)
+		if(s[i++] != 0)
+			return false;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static int convertToCStringFast (char* cString, int cStringSize, TextEncoding encoding, const uchar* uString, int uStringLength)
+{
+	// returns -1 if the text needs a full conversion, like the full conversion nothing is written
+	// if the result does not fit, the required length is returned instead
+	namespace UTFCodec = Core::Text::UTFCodec;
+	switch(resolveEncoding (encoding))
+	{
+	case Text::kUTF8 :
+		{
+			// a UTF-16 unit takes at most 3 bytes, measure first only if the buffer might be too small
+			if(cString && cStringSize < 3 * uStringLength)
+			{
+				int length = UTFCodec::convertUTF16ToUTF8 (nullptr, 0, uString, uStringLength);
+				if(length < 0 || length > cStringSize)
+					return length;
+			}
+			return UTFCodec::convertUTF16ToUTF8 ((unsigned char*)cString, cString ? cStringSize : 0, uString, uStringLength);
+		}
+	case Text::kASCII :
+		if(!isASCII (uString, uStringLength))
+			return -1;
+		break;
+	case Text::kISOLatin1 :
+		if(!isLatin1 (uString, uStringLength))
+			return -1;
+		break;
+	default :
+		return -1;
+	}
+
+	if(cString && uStringLength <= cStringSize)
+		UTFCodec::narrowLatin1 ((unsigned char*)cString, uString, uStringLength);
+	return uStringLength;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static int convertToUnicodeFast (uchar* uString, int uStringSize, TextEncoding encoding, const char* cString, int cStringLength)
+{
+	// returns -1 if the text needs a full conversion, see convertToCStringFast ()
+	namespace UTFCodec = Core::Text::UTFCodec;
+	switch(resolveEncoding (encoding))
+	{
+	case Text::kUTF8 :
+		{
+			// a byte results in at most one UTF-16 unit
+			if(uString && uStringSize < cStringLength)
+			{
+				int length = UTFCodec::convertUTF8ToUTF16 (nullptr, 0, (const unsigned char*)cString, cStringLength);
+				if(length < 0 || length > uStringSize)
+					return length;
+			}
+			return UTFCodec::convertUTF8ToUTF16 (uString, uString ? uStringSize : 0, (const unsigned char*)cString, cStringLength);
+		}
+	case Text::kASCII :
+		if(!isASCII (cString, cStringLength))
+			return -1;
+		break;
+	case Text::kISOLatin1 :
+		break;
+	default :
+		return -1;
+	}
+
+	if(uString && cStringLength <= uStringSize)
+		UTFCodec::widenLatin1 (uString, (const unsigned char*)cString, cStringLength);
+	return cStringLength;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 static uninorm_t getNativeNormalizationForm (NormalizationForm form)
 {
 	static const struct { NormalizationForm form; uninorm_t nativeForm; } normalizationMapping[] =
@@ -106,8 +222,11 @@ int Text::convertToCString (char* cString, int cStringSize, TextEncoding encodin
 		uStringLength = getLength (uString);
 	size_t length = cStringSize;
 	char* result = cString;
+	int fastLength = -1;
 	if(uStringLength == 0)
 		length = 0;
+	else if((fastLength = convertToCStringFast (cString, cStringSize, encoding, uString, uStringLength)) >= 0)
+		length = fastLength;
 	else
 		result = u16_conv_to_encoding (getNativeEncoding (encoding), iconveh_question_mark, uString, uStringLength, nullptr, cString, &length);
 	if(result == nullptr)
@@ -131,8 +250,11 @@ int Text::convertToUnicode (uchar* uString, int uStringSize, TextEncoding encodi
 		cStringLength = getLength (cString);
 	size_t length = uStringSize;
 	uchar* result = uString;
+	int fastLength = -1;
 	if(cStringLength == 0)
 		length = 0;
+	else if((fastLength = convertToUnicodeFast (uString, uStringSize, encoding, cString, cStringLength)) >= 0)
+		length = fastLength;
 	else
 		result = u16_conv_from_encoding (getNativeEncoding (encoding), iconveh_question_mark, cString, cStringLength, nullptr, uString, &length);
 	if(result == nullptr)
@@ -256,7 +378,7 @@ void Text::capitalize (uchar* s)
 
 UnicodeString* UnicodeString::newString ()
 {
-	return NEW LinuxUnicodeString;
+	return new LinuxUnicodeString; // not NEW, string objects are pooled
 }
 
 //************************************************************************************************
@@ -265,7 +387,7 @@ UnicodeString* UnicodeString::newString ()
 
 IString* CCL_API LinuxUnicodeString::cloneString () const
 {
-	return NEW LinuxUnicodeString (*this);
+	return new LinuxUnicodeString (*this);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -20,6 +20,7 @@
 
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/mman.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -99,6 +100,33 @@ IStream* PosixNativeFileSystem::openPlatformStream (UrlRef url, int mode)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+IStream* PosixNativeFileSystem::openMappedStream (UrlRef url, int mode)
+{
+	int handle = openFileDescriptor (url, IStream::kReadMode);
+	if(handle == -1)
+		return nullptr; // error is reported by regular stream
+
+	void* memory = MAP_FAILED;
+	int64 size = 0;
+	struct stat buf;
+	if(::fstat (handle, &buf) == 0 && S_ISREG (buf.st_mode) && buf.st_size > 0)
+	{
+		size = buf.st_size;
+		// private mapping, pages are copied if someone writes to the memory address
+		memory = ::mmap (nullptr, (size_t)size, PROT_READ|PROT_WRITE, MAP_PRIVATE, handle, 0);
+	}
+	::close (handle); // mapping stays valid
+
+	if(memory == MAP_FAILED)
+		return nullptr;
+
+	::madvise (memory, (size_t)size, size <= PosixMappedFileStream::kSequentialAccessLimit ? MADV_WILLNEED : MADV_RANDOM);
+
+	return NEW PosixMappedFileStream (memory, size);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 tbool CCL_API PosixNativeFileSystem::getFileInfo (FileInfo& info, UrlRef url)
 {
 	POSIXPath path (url);
@@ -426,6 +454,108 @@ tbool CCL_API PosixFileStream::setEndOfFile (int64 eof)
 	return result;
 }
 
+//************************************************************************************************
+// PosixMappedFileStream
+//************************************************************************************************
+
+PosixMappedFileStream::PosixMappedFileStream (void* memory, int64 size)
+: memory (memory),
+  size (size),
+  position (0)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+PosixMappedFileStream::~PosixMappedFileStream ()
+{
+	::munmap (memory, (size_t)size);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int CCL_API PosixMappedFileStream::read (void* buffer, int size)
+{
+	int64 toRead = ccl_min<int64> (size, this->size - position);
+	if(toRead <= 0)
+		return 0;
+
+	::memcpy (buffer, static_cast<char*> (memory) + position, (size_t)toRead);
+	position += toRead;
+	return (int)toRead;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int CCL_API PosixMappedFileStream::write (const void* buffer, int size)
+{
+	return -1; // read-only
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int64 CCL_API PosixMappedFileStream::tell ()
+{
+	return position;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API PosixMappedFileStream::isSeekable () const
+{
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int64 CCL_API PosixMappedFileStream::seek (int64 pos, int mode)
+{
+	switch(mode)
+	{
+	case kSeekSet :
+		position = pos;
+		break;
+
+	case kSeekEnd :
+		position = size + pos;
+		break;
+
+	case kSeekCur :
+		position += pos;
+		break;
+	}
+
+	position = ccl_bound<int64> (position, 0, size);
+	return position;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void* CCL_API PosixMappedFileStream::getMemoryAddress () const
+{
+	return memory;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint32 CCL_API PosixMappedFileStream::getBytesWritten () const
+{
+	return (uint32)ccl_min<int64> (size, NumericLimits::kMaxUnsignedInt32); // use seek () for larger files
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API PosixMappedFileStream::setBytesWritten (uint32 bytesWritten)
+{
+	return false; // read-only
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API PosixMappedFileStream::allocateMemoryForStream (uint32 size)
+{
+	return false; // read-only
+}
+
 //************************************************************************************************
 // PosixFileIterator
 //************************************************************************************************
@@ -60,6 +60,7 @@ protected:
 
 	// NativeFileSystem
 	IStream* openPlatformStream (UrlRef url, int mode) override;
+	IStream* openMappedStream (UrlRef url, int mode) override;
 	bool createPlatformFolder (UrlRef url) override;
 	bool removePlatformFolder (UrlRef url, int mode) override;
 	int translateNativeError (int nativeError) override;
@@ -91,6 +92,43 @@ protected:
 	static int intFromPointer (void* ptr);
 };
 
+//************************************************************************************************
+// PosixMappedFileStream
+/** Read-only file stream mapped into memory. */
+//************************************************************************************************
+
+class PosixMappedFileStream: public Unknown,
+							 public IMemoryStream
+{
+public:
+	// IStream
+	int CCL_API read (void* buffer, int size) override;
+	int CCL_API write (const void* buffer, int size) override;
+	int64 CCL_API tell () override;
+	tbool CCL_API isSeekable () const override;
+	int64 CCL_API seek (int64 pos, int mode) override;
+
+	// IMemoryStream
+	void* CCL_API getMemoryAddress () const override;
+	uint32 CCL_API getBytesWritten () const override;
+	tbool CCL_API setBytesWritten (uint32 bytesWritten) override;
+	tbool CCL_API allocateMemoryForStream (uint32 size) override;
+
+	CLASS_INTERFACE2 (IStream, IMemoryStream, Unknown)
+
+protected:
+	friend class PosixNativeFileSystem;
+
+	static const int64 kSequentialAccessLimit = 8 * 1024 * 1024; ///< larger files (e.g. packages) are accessed randomly
+
+	void* memory;
+	int64 size;
+	int64 position;
+
+	PosixMappedFileStream (void* memory, int64 size);
+	~PosixMappedFileStream ();
+};
+
 //************************************************************************************************
 // PosixFileIterator
 //************************************************************************************************
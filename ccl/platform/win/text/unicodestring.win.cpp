@@ -173,7 +173,7 @@ void Text::capitalize (uchar* s)
 
 UnicodeString* UnicodeString::newString ()
 {
-	return NEW WindowsUnicodeString;
+	return new WindowsUnicodeString; // not NEW, string objects are pooled
 }
 
 //************************************************************************************************
@@ -182,7 +182,7 @@ UnicodeString* UnicodeString::newString ()
 
 IString* CCL_API WindowsUnicodeString::cloneString () const
 {
-	return NEW WindowsUnicodeString (*this);
+	return new WindowsUnicodeString (*this);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -229,7 +229,13 @@ tresult CCL_API WindowsUnicodeString::normalize (NormalizationForm form)
 		return kResultFailed;
 
 	// "detach" current buffer (keep as source), then allocate a new buffer for destination string
+	uchar smallSource[kSmallTextLength + 1];
 	const uchar* sourceText = text;
+	if(pooledText)
+	{
+		sourceText = (const uchar*)::memcpy (smallSource, text, kSmallTextSize);
+		resizeInternal (0);
+	}
 	text = nullptr;
 	textByteSize = 0;
 	resizeInternal (estimatedSize);
@@ -239,7 +245,7 @@ tresult CCL_API WindowsUnicodeString::normalize (NormalizationForm form)
 	updateMetadata (newLength - 1);
 
 	// release source buffer
-	if(sourceText)
+	if(sourceText && sourceText != smallSource)
 		string_free ((void*)sourceText);
 
 	return kResultOk;
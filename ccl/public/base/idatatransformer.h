@@ -32,6 +32,12 @@ namespace ClassID
 	/** ZLib Compression. */
 	DEFINE_CID (ZlibCompression, 0xf677662, 0xcda7, 0x40b0, 0x95, 0xa, 0x88, 0xb1, 0xbf, 0xfc, 0xc6, 0xfb);
 
+	/** Zstandard Compression (optional, depends on build configuration). */
+	DEFINE_CID (ZstdCompression, 0x1c5480c3, 0xafb2, 0x4357, 0xb6, 0x23, 0x45, 0xa, 0xc2, 0x47, 0x27, 0xf6);
+
+	/** LZ4 Frame Compression (optional, depends on build configuration). */
+	DEFINE_CID (LZ4Compression, 0x1af412c4, 0xb08, 0x41cd, 0x94, 0x5a, 0x4b, 0xf0, 0xaf, 0x7a, 0x8d, 0xa5);
+
 	DEFINE_CID (Base16Encoding, 0xb460cac2, 0xc56c, 0x47e7, 0xb4, 0xbd, 0x9c, 0x11, 0x4b, 0xe4, 0xf8, 0x72);
 	DEFINE_CID (Base32Encoding, 0x6ed03060, 0xbc9e, 0x4e9d, 0x97, 0x7d, 0xfe, 0xe8, 0x80, 0xb5, 0x5, 0x41);
 	DEFINE_CID (Base64Encoding, 0x16a5be85, 0x5d6b, 0x47d0, 0xb9, 0xb6, 0x18, 0x4c, 0xa2, 0xb5, 0xf4, 0x10);
@@ -143,6 +149,22 @@ interface IZLibTransformer: IUnknown
 
 DEFINE_IID (IZLibTransformer, 0xb64e6b9c, 0xb91b, 0x461f, 0xbe, 0x56, 0xff, 0xb, 0x2c, 0x9b, 0x9, 0x57)
 
+//************************************************************************************************
+// IDictionaryTransformer
+/** Additional interface for transformation objects supporting a preset dictionary.
+	\ingroup base_io  */
+//************************************************************************************************
+
+interface IDictionaryTransformer: IUnknown
+{
+	/** Set dictionary to be used by next open/reset, data is copied. Encoder and decoder must use the same dictionary. */
+	virtual tresult CCL_API setDictionary (const void* data, int size) = 0;
+
+	DECLARE_IID (IDictionaryTransformer)
+};
+
+DEFINE_IID (IDictionaryTransformer, 0x70e5891e, 0xa8a6, 0x44dc, 0x92, 0x3d, 0x35, 0x36, 0x4, 0xda, 0xe0, 0x20)
+
 //************************************************************************************************
 // ITransformStream
 /** Interface extension for transformation stream.
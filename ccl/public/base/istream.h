@@ -49,6 +49,7 @@ interface IStream: IUnknown
 		kShareRead	= 1<<2,					///< allow shared reading
 		kShareWrite	= 1<<3,					///< allow shared writing
 		kCreate		= 1<<4,					///< create if not existing, truncate to size 0 if existing
+		kMapped		= 1<<5,					///< map file into memory for reading (stream implements IMemoryStream), ignored if not supported
 
         kOptionBits = 0xFF<<8,	///< reserved for stream options
 
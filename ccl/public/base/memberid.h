@@ -0,0 +1,72 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/public/base/memberid.h
+// Description : Member ID Hashing
+//
+//************************************************************************************************
+
+#ifndef _ccl_memberid_h
+#define _ccl_memberid_h
+
+#include "ccl/public/text/cstring.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// MemberHash
+/** FNV-1a hash of a property or method name, usable in constant expressions.
+	\ingroup ccl_base */
+//************************************************************************************************
+
+struct MemberHash
+{
+	static constexpr uint32 compute (CStringPtr name)
+	{
+		uint32 hash = 2166136261u;
+		if(name)
+			for(; *name; name++)
+			{
+				hash ^= (unsigned char)*name;
+				hash *= 16777619u;
+			}
+		return hash;
+	}
+};
+
+//************************************************************************************************
+// MemberSwitch
+/** Helper for MEMBER_SWITCH / MEMBER_CASE, see objectmacros.h.
+	Hashes the member ID once, a matching case verifies the name with a single compare.
+	\ingroup ccl_base */
+//************************************************************************************************
+
+struct MemberSwitch
+{
+	CStringPtr name;
+	uint32 hash;
+
+	MemberSwitch (CStringRef memberId)
+	: name (memberId.str ()),
+	  hash (MemberHash::compute (name))
+	{}
+
+	bool is (CStringPtr other) const
+	{
+		return ::strcmp (name, other) == 0;
+	}
+};
+
+} // namespace CCL
+
+#endif // _ccl_memberid_h
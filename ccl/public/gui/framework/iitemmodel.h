@@ -46,6 +46,7 @@ namespace ClassID
 {
 	DEFINE_CID (ColumnHeaderList, 0xE0C5B54B, 0xBAA3, 0x4DAA, 0xBE, 0x2D, 0xE1, 0x4C, 0xB5, 0x0D, 0x56, 0x13);
 	DEFINE_CID (ItemListSelection, 0x7764797A, 0xB532, 0x48E3, 0x98, 0x1A, 0x22, 0x74, 0x91, 0x70, 0x0C, 0x61);
+	DEFINE_CID (ItemRangeSelection, 0xc15a9cd7, 0xfe8a, 0x46e5, 0xb1, 0x8e, 0xc0, 0xda, 0x8e, 0xc1, 0xb2, 0x3b);
 };
 
 //************************************************************************************************
@@ -217,6 +218,48 @@ interface IItemSelection: IUnknown
 
 DEFINE_IID (IItemSelection, 0x21e9fd2, 0xfe9a, 0x4f98, 0x98, 0x41, 0xba, 0xc, 0xce, 0x2, 0x56, 0x4a)
 
+//************************************************************************************************
+// IItemRangeIterator
+/** Iterator over runs of consecutive item indices.
+	\ingroup gui_item */
+//************************************************************************************************
+
+interface IItemRangeIterator: IUnknown
+{
+	/** Get next run of selected indices [first, last]. Returns false if iteration is finished. */
+	virtual tbool CCL_API next (int& first, int& last) = 0;
+
+	DECLARE_IID (IItemRangeIterator)
+};
+
+DEFINE_IID (IItemRangeIterator, 0x51defc6b, 0x3663, 0x4e99, 0xb1, 0xee, 0x50, 0x09, 0x5f, 0x52, 0x30, 0x5b)
+
+//************************************************************************************************
+// IItemRangeSelection
+/** Optional interface of an item selection storing integer indices as ranges.
+	Selecting or unselecting a range doesn't depend on the number of items in it.
+	\ingroup gui_item */
+//************************************************************************************************
+
+interface IItemRangeSelection: IUnknown
+{
+	/** Add items [first, last] to the selection. */
+	virtual void CCL_API selectRange (int first, int last) = 0;
+
+	/** Remove items [first, last] from the selection. */
+	virtual void CCL_API unselectRange (int first, int last) = 0;
+
+	/** Get number of selected integer indices. */
+	virtual int CCL_API countIndices () const = 0;
+
+	/** Create an iterator over the runs of selected integer indices, in ascending order. */
+	virtual IItemRangeIterator* CCL_API newRangeIterator () const = 0;
+
+	DECLARE_IID (IItemRangeSelection)
+};
+
+DEFINE_IID (IItemRangeSelection, 0x89e81304, 0x9eff, 0x4404, 0xb2, 0x77, 0x33, 0x16, 0x06, 0xd3, 0xe3, 0x67)
+
 //************************************************************************************************
 // IItemModel
 /** Model interface for list and tree controls. 
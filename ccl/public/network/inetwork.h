@@ -82,6 +82,27 @@ interface INetwork: IUnknown
 
 DEFINE_IID (INetwork, 0x9bcd3ede, 0x2a33, 0x4a9e, 0x8e, 0x4f, 0x7a, 0xe0, 0x84, 0xe5, 0xa6, 0x3a)
 
+//************************************************************************************************
+// INetwork2
+/** Extension to INetwork interface, shared network I/O thread. */
+//************************************************************************************************
+
+interface INetwork2: IUnknown
+{
+	/** Register socket with the shared network I/O thread. The handler is called on socket events (SocketEvent flags). */
+	virtual tresult CCL_API addSocketHandler (ISocket* socket, int events, ISocketEventHandler* handler) = 0;
+
+	/** Change events of a registered socket. */
+	virtual tresult CCL_API modifySocketHandler (ISocket* socket, int events) = 0;
+
+	/** Unregister socket. When this method returns, the handler isn't called anymore. */
+	virtual tresult CCL_API removeSocketHandler (ISocket* socket) = 0;
+
+	DECLARE_IID (INetwork2)
+};
+
+DEFINE_IID (INetwork2, 0x54ae652f, 0x4ff5, 0x403d, 0xa7, 0xa0, 0xc2, 0x92, 0x4a, 0xbe, 0x33, 0x24)
+
 } // namespace Net
 } // namespace CCL
 
@@ -135,6 +135,33 @@ interface IMulticastSocket: IUnknown
 
 DEFINE_IID (IMulticastSocket, 0x95a59a0a, 0x5ded, 0x42ba, 0x9b, 0x67, 0x77, 0xb2, 0x57, 0x91, 0xab, 0x39)
 
+//************************************************************************************************
+// ISocketEventHandler
+/** Callback interface for sockets registered with the network I/O thread.
+	\see INetwork2::addSocketHandler */
+//************************************************************************************************
+
+namespace SocketEvent
+{
+	enum Flags
+	{
+		kReadable = 1<<0,		///< data available, incoming connection or connection closed
+		kWritable = 1<<1,		///< data can be sent, connection attempt succeeded
+		kError = 1<<2,			///< error or hang-up, always reported
+		kEdgeTriggered = 1<<3	///< registration flag: report state changes only, handler must read/write until operation would block
+	};
+}
+
+interface ISocketEventHandler: IUnknown
+{
+	/** Called on the network I/O thread with SocketEvent flags, must not block. */
+	virtual void CCL_API onSocketEvent (ISocket* socket, int events) = 0;
+
+	DECLARE_IID (ISocketEventHandler)
+};
+
+DEFINE_IID (ISocketEventHandler, 0x6f0c3b7e, 0x1d52, 0x4a8b, 0x9e, 0x27, 0x53, 0xc1, 0x8a, 0x40, 0xd9, 0x6e)
+
 //************************************************************************************************
 // INetworkStream
 /** Network stream interface (extends IStream). */
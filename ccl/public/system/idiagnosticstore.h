@@ -64,6 +64,25 @@ interface IDiagnosticResult: IUnknown
 	virtual int64 CCL_API getTimestamp (int index) const = 0;
 };
 
+//************************************************************************************************
+// IDiagnosticResult2
+/** Extension to IDiagnosticResult interface. */
+//************************************************************************************************
+
+interface IDiagnosticResult2: IUnknown
+{
+	/** Estimate value below which the given percentage (0 to 100) of values fall, 0 if not available. 
+		In long-term mode, percentiles cover values submitted since the application was started. */
+	virtual double CCL_API getPercentile (double percentile) const = 0;
+
+	/** Get number of values which were not kept in short-term mode, because too many were submitted between two queries. */
+	virtual int CCL_API getNumDroppedValues () const = 0;
+
+	DECLARE_IID (IDiagnosticResult2)
+};
+
+DEFINE_IID (IDiagnosticResult2, 0xc84e87c5, 0x6ba3, 0x493d, 0x97, 0xcf, 0xb4, 0x2c, 0x57, 0x89, 0xa0, 0xd6)
+
 //************************************************************************************************
 // IDiagnosticResultSet
 //************************************************************************************************
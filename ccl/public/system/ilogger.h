@@ -40,6 +40,58 @@ interface ILogger: Alert::IReporter
 
 DEFINE_IID (ILogger, 0x5166d278, 0x4af9, 0x4543, 0x9a, 0xf5, 0xe2, 0xb6, 0x67, 0x3c, 0x3c, 0x4c)
 
+//************************************************************************************************
+// System::AsyncLoggerStatistics
+/**	Statistics of the asynchronous logger queue.
+	\ingroup ccl_system */
+//************************************************************************************************
+
+struct AsyncLoggerStatistics
+{
+	int capacity = 0;		///< max. number of queued events
+	int queueDepth = 0;		///< number of events currently waiting
+	int maxQueueDepth = 0;	///< highest number of waiting events so far
+	int numQueued = 0;		///< number of events queued so far
+	int numDropped = 0;		///< number of events dropped because the queue was full
+	int numWaits = 0;		///< number of events delivered synchronously because the queue was full
+};
+
+//************************************************************************************************
+// System::IAsyncLogger
+/**	Optional logger interface to deliver events asynchronously.
+	In asynchronous mode, reportEvent () puts events into a bounded lock-free queue and returns
+	immediately. A logger thread delivers them to the outputs in batches.
+	\ingroup ccl_system */
+//************************************************************************************************
+
+interface IAsyncLogger: IUnknown
+{
+	/** Behavior when the queue is full. */
+	DEFINE_ENUM (OverflowPolicy)
+	{
+		kDropEvent,			///< drop the new event
+		kDropLowSeverity,	///< deliver warnings and errors synchronously, drop other events
+		kWaitForSpace		///< deliver synchronously, i.e. wait until pending events have been delivered
+	};
+
+	/** Enable or disable asynchronous mode. The capacity is fixed when enabled for the first time. 
+		When disabled, pending events are delivered before the call returns. */
+	virtual tresult CCL_API setAsyncMode (tbool state, int capacity = 4096, OverflowPolicy policy = kDropLowSeverity) = 0;
+
+	/** Check if asynchronous mode is enabled. */
+	virtual tbool CCL_API isAsyncMode () const = 0;
+
+	/** Deliver all pending events to the outputs before returning. */
+	virtual void CCL_API flush () = 0;
+
+	/** Get queue statistics. */
+	virtual void CCL_API getAsyncStatistics (AsyncLoggerStatistics& statistics) const = 0;
+
+	DECLARE_IID (IAsyncLogger)
+};
+
+DEFINE_IID (IAsyncLogger, 0x3b7e90c2, 0x5d14, 0x4a8f, 0xb6, 0x2e, 0x91, 0x0c, 0x47, 0xd3, 0xa8, 0x65)
+
 } // namespace System
 } // namespace CCL
 
@@ -59,6 +59,12 @@ namespace PackageOption
 	/** Package compression level. */
 	DEFINE_STRINGID (kCompressionLevel, "compressionLevel");
 
+	/** Package compression method [CompressionMethod], used if compression is enabled. */
+	DEFINE_STRINGID (kCompressionMethod, "compressionMethod");
+
+	/** Preset dictionary for methods supporting it [IMemoryStream], must be set for reading, too. */
+	DEFINE_STRINGID (kCompressionDictionary, "compressionDictionary");
+
 	/** Package is encrypted using a very simple (unsafe) cipher algorithm. */
 	DEFINE_STRINGID (kBasicEncrypted, "basicencrypted");
 
@@ -90,6 +96,14 @@ namespace PackageOption
 		kThreadSafetyReopen,  ///< sub-streams can be accessed by concurrent threads - implemented as separate file stream per sub-stream
 		kThreadSafetyLocked   ///< sub-streams can be accessed by concurrent threads - implemented as locked access
 	};
+
+	/** Compression Methods */
+	DEFINE_ENUM (CompressionMethod)
+	{
+		kCompressionZlib,	///< default, supported by all package formats
+		kCompressionZstd,	///< Zstandard, supports dictionary (optional, depends on build configuration)
+		kCompressionLZ4		///< LZ4 frame format (optional, depends on build configuration)
+	};
 }
 
 //************************************************************************************************
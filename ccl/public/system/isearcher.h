@@ -39,7 +39,8 @@ interface ISearchDescription: IUnknown
 		kMatchWholeWord = 1<<1,
 		kIgnoreDelimiters = 1<<2,		///< certain delimiter characters like '-' should be ignored when matching strings
 		kAllowTokenGrouping = 1<<3,		///< when a delimiter is used to tokenize the search terms, the character '"' can be used to suspend the tokenizing
-		kMatchAllTokens = 1<<4			///< all tokens must match when a delimiter is used to tokenize the search terms
+		kMatchAllTokens = 1<<4,			///< all tokens must match when a delimiter is used to tokenize the search terms
+		kUseFileIndex = 1<<5			///< file system searches may keep an index of searched folders to speed up repeated searches (platform-specific)
 	};
 
 	virtual UrlRef CCL_API getStartPoint () const = 0;
@@ -54,6 +54,13 @@ typedef void (CCL_API *ThreadLocalDestructor) (void* data);
 /** Thread function. */
 typedef int (CCL_API *ThreadFunction) (void* arg);
 
+/** Thread pool scheduling strategy. */
+DEFINE_ENUM (ThreadPoolScheduler)
+{
+	kSharedQueueScheduler,		///< one work queue shared by all threads
+	kWorkStealingScheduler		///< one work queue per thread, idle threads steal work from busy ones
+};
+
 //************************************************************************************************
 // IThread
 /** Thread interface, created via System::CreateNativeThread(). 
@@ -27,6 +27,16 @@ namespace Threading {
 /** Thread work identifier. */
 typedef void* WorkID;
 
+/** Work item priority class. */
+DEFINE_ENUM (WorkPriority)
+{
+	kWorkPriorityBackground,	///< bulk work, e.g. scanning of folders
+	kWorkPriorityNormal,		///< default priority
+	kWorkPriorityInteractive,	///< work the user is waiting for, e.g. content of visible views
+
+	kNumWorkPriorities
+};
+
 //************************************************************************************************
 // IWorkItem
 /** Work item used by thread pool. 
@@ -70,6 +80,56 @@ protected:
 	WorkID id;
 };
 
+//************************************************************************************************
+// IPrioritizedWorkItem
+/** Optional interface of a work item to control its scheduling.
+	Items of a higher priority class are executed first, items waiting too long in a lower
+	priority class are promoted to avoid starvation. Items with a deadline are executed 
+	in order of their deadlines once it comes close.
+	\ingroup ccl_system */
+//************************************************************************************************
+
+interface IPrioritizedWorkItem: IUnknown
+{
+	/** Get priority class. */
+	virtual WorkPriority CCL_API getWorkPriority () const = 0;
+
+	/** Get system time (in milliseconds) this item should be started at the latest, 0 for none. */
+	virtual int64 CCL_API getDeadline () const = 0;
+
+	DECLARE_IID (IPrioritizedWorkItem)
+};
+
+DEFINE_IID (IPrioritizedWorkItem, 0x8e51c2a4, 0x37d0, 0x4b6e, 0x9f, 0x12, 0x5a, 0xc3, 0x6e, 0xb, 0x84, 0xd7)
+
+//************************************************************************************************
+// AbstractPrioritizedWorkItem
+/** Abstract base class for work items with priority and deadline.
+	\ingroup ccl_system */
+//************************************************************************************************
+
+class AbstractPrioritizedWorkItem: public AbstractWorkItem,
+								   public IPrioritizedWorkItem
+{
+public:
+	AbstractPrioritizedWorkItem (WorkID id = nullptr, WorkPriority priority = kWorkPriorityNormal, int64 deadline = 0)
+	: AbstractWorkItem (id),
+	  priority (priority),
+	  deadline (deadline)
+	{}
+
+	void setWorkPriority (WorkPriority value) { priority = value; }
+	void setDeadline (int64 value) { deadline = value; }
+
+	// IPrioritizedWorkItem
+	WorkPriority CCL_API getWorkPriority () const override { return priority; }
+	int64 CCL_API getDeadline () const override { return deadline; }
+
+protected:
+	WorkPriority priority;
+	int64 deadline;
+};
+
 //************************************************************************************************
 // IPeriodicItem
 /** Item executed periodically by thread pool.
@@ -131,6 +191,40 @@ interface IThreadPool: IUnknown
 
 DEFINE_IID (IThreadPool, 0x1602ee99, 0x3fe, 0x4f93, 0xb3, 0xc1, 0xfc, 0x41, 0xb0, 0x55, 0xab, 0x59)
 
+//************************************************************************************************
+// WorkQueueStatistics
+/**	Statistics of a thread pool work queue for one priority class.
+	\ingroup ccl_system */
+//************************************************************************************************
+
+struct WorkQueueStatistics
+{
+	int queueDepth = 0;			///< number of items currently waiting
+	int numStarted = 0;			///< number of items started so far
+	int numDeadlinesMissed = 0;	///< number of items started after their deadline
+	int64 totalWaitTime = 0;	///< accumulated time between scheduling and start (in milliseconds)
+	int64 maxWaitTime = 0;		///< longest time between scheduling and start (in milliseconds)
+
+	/** Get average wait time in milliseconds. */
+	double getAverageWaitTime () const { return numStarted > 0 ? double(totalWaitTime) / numStarted : 0.; }
+};
+
+//************************************************************************************************
+// IThreadPoolStatistics
+/**	Optional thread pool interface reporting queue statistics.
+	\ingroup ccl_system */
+//************************************************************************************************
+
+interface IThreadPoolStatistics: IUnknown
+{
+	/** Get work queue statistics for given priority class. */
+	virtual tresult CCL_API getQueueStatistics (WorkQueueStatistics& statistics, WorkPriority priority) const = 0;
+
+	DECLARE_IID (IThreadPoolStatistics)
+};
+
+DEFINE_IID (IThreadPoolStatistics, 0x2f6a94d1, 0xc08b, 0x4e37, 0xa5, 0x5e, 0x71, 0x3d, 0xc, 0x9b, 0xe2, 0x48)
+
 } // namespace Threading
 } // namespace CCL
 
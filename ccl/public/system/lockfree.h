@@ -23,9 +23,31 @@
 #include "ccl/public/systemservices.h"
 #include "ccl/public/system/atomic.h"
 
+#include "core/public/corelockfree.h"
+
 namespace CCL {
 namespace LockFree {
 
+//************************************************************************************************
+// AtomicPrimitives
+/** Atomic primitives as policy class for Core::LockFree containers. */
+//************************************************************************************************
+
+struct AtomicPrimitives
+{
+	static INLINE int32 add (int32 volatile& variable, int32 value) { return AtomicAddInline (variable, value); }
+	static INLINE int32 get (const int32 volatile& variable) { return AtomicGetInline (variable); }
+	static INLINE bool testAndSet (int32 volatile& variable, int32 value, int32 comperand) { return AtomicTestAndSetInline (variable, value, comperand); }
+	static INLINE void* getPtr (void* const volatile& variable) { return AtomicGetPtrInline (variable); }
+	static INLINE bool testAndSetPtr (void* volatile& variable, void* value, void* comperand) { return AtomicTestAndSetPtrInline (variable, value, comperand); }
+};
+
+/** Bounded multi-producer/multi-consumer queue without allocations on push/pop. */
+template <typename T> using BoundedQueue = Core::LockFree::BoundedQueue<T, AtomicPrimitives>;
+
+/** Multi-producer/multi-consumer stack, safe against ABA. Use instead of Stack if elements are popped concurrently. */
+template <typename T> using TaggedStack = Core::LockFree::TaggedStack<T, AtomicPrimitives>;
+
 //************************************************************************************************
 // Element with aligned next pointer
 //************************************************************************************************
@@ -42,6 +64,7 @@ struct Element
 
 //************************************************************************************************
 // Lock Free Stack -> Last In First Out
+//	Not safe against ABA with concurrent pop, see TaggedStack
 //************************************************************************************************
 
 template <typename T>
@@ -56,7 +79,7 @@ public:
 	void flush ();
 
 protected:
-	CCL_ALIGN(T*) volatile head;
+	CCL_ALIGN(T* volatile) head;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -133,10 +156,10 @@ public:
 	void flush ();
 
 protected:
-	CCL_ALIGN(T*) volatile allocated;
-	CCL_ALIGN(T*) volatile first;
-	CCL_ALIGN(T*) volatile divider;
-	CCL_ALIGN(T*) volatile last;  
+	CCL_ALIGN(T* volatile) allocated;
+	CCL_ALIGN(T* volatile) first;
+	CCL_ALIGN(T* volatile) divider;
+	CCL_ALIGN(T* volatile) last;  
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -158,6 +158,7 @@ struct ThreadPoolDescription
 	Threading::ThreadPriority priority = Threading::kPriorityBelowNormal;
 	CStringPtr name = nullptr;
 	int idleTimeout = -1;
+	Threading::ThreadPoolScheduler scheduler = Threading::kSharedQueueScheduler;
 };
 
 /** Create new thread pool. */
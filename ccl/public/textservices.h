@@ -40,6 +40,20 @@ interface ITextWriter;
 interface IAttributeHandler;
 interface IRegularExpression;
 
+//************************************************************************************************
+// StringPoolStatistics
+/** Number of blocks in the memory pools for string objects and short texts. Blocks in use
+	include free blocks held in thread caches. */
+//************************************************************************************************
+
+struct StringPoolStatistics
+{
+	int objectsAllocated = 0;
+	int objectsUsed = 0;
+	int textsAllocated = 0;
+	int textsUsed = 0;
+};
+
 namespace System {
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -56,6 +70,10 @@ inline IString& GetEmptyString () { return CCL_ISOLATED (GetEmptyString) (); }
 CCL_EXPORT StringRef CCL_API CCL_ISOLATED (GetConstantString) (CStringPtr asciiString);
 inline StringRef GetConstantString (CStringPtr asciiString) { return CCL_ISOLATED (GetConstantString) (asciiString); }
 
+/** Get statistics of string memory pools */
+CCL_EXPORT void CCL_API CCL_ISOLATED (GetStringPoolStatistics) (StringPoolStatistics& statistics);
+inline void GetStringPoolStatistics (StringPoolStatistics& statistics) { CCL_ISOLATED (GetStringPoolStatistics) (statistics); }
+
 /** Returns the Unicode utilities singleton */
 CCL_EXPORT IUnicodeUtilities& CCL_API CCL_ISOLATED (GetUnicodeUtilities) ();
 inline IUnicodeUtilities& GetUnicodeUtilities () { return CCL_ISOLATED (GetUnicodeUtilities) (); }
@@ -20,6 +20,8 @@
 
 #include "ccl/public/systemservices.h"
 
+#include "core/system/coreatomic.h"
+
 using namespace CCL;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -35,16 +37,55 @@ CCL_EXPORT IAtomTable& CCL_API System::CCL_ISOLATED (GetAtomTable) ()
 // Atom
 //************************************************************************************************
 
+static inline char toLowerASCII (char c)
+{
+	return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 DEFINE_CLASS_HIDDEN (Atom, Object)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 Atom::Atom (StringID name)
-: name (name)
+: name (name),
+  hash (hashName (name)),
+  next (nullptr)
 {}
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+uint32 Atom::hashName (CStringPtr name)
+{
+	// FNV-1a of lowercase characters
+	uint32 h = 2166136261u;
+	if(name)
+		for(; *name; name++)
+		{
+			h ^= (unsigned char)toLowerASCII (*name);
+			h *= 16777619u;
+		}
+	return h;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Atom::matches (CStringPtr other, uint32 otherHash) const
+{
+	if(hash != otherHash)
+		return false;
+
+	// atom names are stored in lowercase
+	CStringPtr s = name.str ();
+	for(; *s && *other; s++, other++)
+		if(*s != toLowerASCII (*other))
+			return false;
+	return *s == *other;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 StringID CCL_API Atom::getAtomName () const
 {
 	return getName ();
@@ -89,6 +130,9 @@ DEFINE_CLASS_HIDDEN (AtomTable, Object)
 AtomTable::AtomTable ()
 {
 	atoms.objectCleanup (true);
+
+	for(int i = 0; i < kHashSize; i++)
+		buckets[i] = nullptr;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -99,22 +143,44 @@ AtomTable::~AtomTable ()
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-IAtom* CCL_API AtomTable::createAtom (StringID _name)
+Atom* AtomTable::find (CStringPtr name, uint32 hash) const
 {
-	MutableCString name (_name);
-	name.toLowercase ();
+	void* const volatile& head = reinterpret_cast<void* const volatile&> (buckets[hash % kHashSize]);
+	for(Atom* atom = static_cast<Atom*> (Core::AtomicGetPtr (head)); atom; atom = atom->next)
+		if(atom->matches (name, hash))
+			return atom;
+	return nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
 
-	Threading::ScopedLock scopedLock (lock);
+IAtom* CCL_API AtomTable::createAtom (StringID _name)
+{
+	CStringPtr name = _name.str ();
+	uint32 hash = Atom::hashName (name);
 
-	Atom* atom = (Atom*)hashTable.lookup (Atom (name));
+	// existing atoms are found without locking, atoms are never removed
+	Atom* atom = find (name, hash);
 	if(!atom)
 	{
-		atom = NEW Atom (name);
-		atoms.add (atom);
-		hashTable.add (atom);
+		Threading::ScopedLock scopedLock (lock);
+
+		atom = find (name, hash); // might have been added by another thread
+		if(!atom)
+		{
+			MutableCString lowercaseName (name);
+			lowercaseName.toLowercase ();
+
+			atom = NEW Atom (lowercaseName);
+			atoms.add (atom);
+
+			// publish after the atom is fully constructed
+			Atom*& head = buckets[hash % kHashSize];
+			atom->next = head;
+			Core::AtomicSetPtr (reinterpret_cast<void* volatile&> (head), atom);
+		}
 	}
 
-	if(atom)
-		atom->retain ();
+	atom->retain ();
 	return atom;
 }
@@ -19,7 +19,7 @@
 #ifndef _ccl_atomtable_h
 #define _ccl_atomtable_h
 
-#include "ccl/base/collections/objecthashtable.h"
+#include "ccl/base/collections/objectlist.h"
 
 #include "ccl/public/text/cstring.h"
 #include "ccl/public/system/iatomtable.h"
@@ -41,6 +41,11 @@ public:
 
 	PROPERTY_MUTABLE_CSTRING (name, Name)
 
+	/** Case-insensitive hash of the given name, equal for all atoms with the same name. */
+	static uint32 hashName (CStringPtr name);
+
+	bool matches (CStringPtr name, uint32 hash) const; ///< case-insensitive
+
 	// IAtom
 	StringID CCL_API getAtomName () const override;
 
@@ -49,10 +54,18 @@ public:
 	int getHashCode (int size) const override;
 
 	CLASS_INTERFACE (IAtom, Object)
+
+protected:
+	friend class AtomTable;
+
+	uint32 hash;
+	Atom* next;	///< next atom in hash bucket
 };
 
 //************************************************************************************************
 // AtomTable
+/** Atoms are never removed, lookups walk the hash buckets without locking.
+	Only the creation of new atoms is serialized. */
 //************************************************************************************************
 
 class AtomTable: public Object,
@@ -72,9 +85,13 @@ public:
 	CLASS_INTERFACE (IAtomTable, Object)
 
 protected:
+	static const int kHashSize = 4096;
+
 	Threading::CriticalSection lock;
 	ObjectList atoms;
-	ObjectHashTable hashTable;
+	Atom* buckets[kHashSize];
+
+	Atom* find (CStringPtr name, uint32 hash) const;
 };
 
 } // namespace CCL
@@ -0,0 +1,502 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/system/diagnosticmetrics.cpp
+// Description : Thread-safe Diagnostic Metrics
+//
+//************************************************************************************************
+
+#include "ccl/system/diagnosticmetrics.h"
+
+#include "ccl/public/base/primitives.h"
+#include "ccl/public/systemservices.h"
+
+#include <math.h>
+#include <float.h>
+
+namespace CCL {
+
+//************************************************************************************************
+// AtomicDouble
+/** Atomic operations on doubles via compare-and-swap of their bit pattern. */
+//************************************************************************************************
+
+namespace AtomicDouble
+{
+	#if CCL_PLATFORM_64BIT
+	union Bits
+	{
+		double value;
+		void* ptr;
+	};
+
+	template <typename Operation>
+	static INLINE double update (double volatile& variable, Operation operation)
+	{
+		Bits oldBits, newBits;
+		do
+		{
+			oldBits.ptr = AtomicGetPtrInline (*(void* const volatile*)&variable);
+			newBits.value = operation (oldBits.value);
+			if(newBits.ptr == oldBits.ptr)
+				break;
+		}
+		while(!AtomicTestAndSetPtrInline (*(void* volatile*)&variable, newBits.ptr, oldBits.ptr));
+		return oldBits.value;
+	}
+
+	#else
+	static Threading::CriticalSection lock; // no 64 bit compare-and-swap exported on 32 bit platforms
+
+	template <typename Operation>
+	static INLINE double update (double volatile& variable, Operation operation)
+	{
+		Threading::ScopedLock scopedLock (lock);
+		double oldValue = variable;
+		variable = operation (oldValue);
+		return oldValue;
+	}
+	#endif
+
+	static INLINE void add (double volatile& variable, double value)
+	{
+		update (variable, [value] (double v) { return v + value; });
+	}
+
+	static INLINE void minimum (double volatile& variable, double value)
+	{
+		if(value < variable)
+			update (variable, [value] (double v) { return value < v ? value : v; });
+	}
+
+	static INLINE void maximum (double volatile& variable, double value)
+	{
+		if(value > variable)
+			update (variable, [value] (double v) { return value > v ? value : v; });
+	}
+
+	static INLINE double exchange (double volatile& variable, double value)
+	{
+		return update (variable, [value] (double) { return value; });
+	}
+}
+
+} // namespace CCL
+
+using namespace CCL;
+
+//************************************************************************************************
+// DiagnosticHistogram::Snapshot
+//************************************************************************************************
+
+DiagnosticHistogram::Snapshot::Snapshot ()
+{
+	reset ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool DiagnosticHistogram::Snapshot::isEmpty () const
+{
+	return count == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DiagnosticHistogram::Snapshot::reset ()
+{
+	count = 0;
+	sum = 0.;
+	minimum = DBL_MAX;
+	maximum = -DBL_MAX;
+	for(int i = 0; i < kNumBuckets; i++)
+		buckets[i] = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DiagnosticHistogram::Snapshot::merge (const Snapshot& other)
+{
+	if(other.isEmpty ())
+		return;
+
+	count += other.count;
+	sum += other.sum;
+	minimum = ccl_min (minimum, other.minimum);
+	maximum = ccl_max (maximum, other.maximum);
+	for(int i = 0; i < kNumBuckets; i++)
+		buckets[i] += other.buckets[i];
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+double DiagnosticHistogram::Snapshot::getPercentile (double percentile) const
+{
+	int total = 0;
+	for(int i = 0; i < kNumBuckets; i++)
+		total += buckets[i];
+	if(total == 0)
+		return 0.;
+
+	double rank = ccl_bound (percentile, 0., 100.) / 100. * total;
+	int accumulated = 0;
+	for(int i = 0; i < kNumBuckets; i++)
+	{
+		accumulated += buckets[i];
+		if(buckets[i] > 0 && accumulated >= rank)
+			return ccl_bound (getBucketValue (i), minimum, maximum);
+	}
+	return maximum;
+}
+
+//************************************************************************************************
+// DiagnosticHistogram
+//************************************************************************************************
+
+DiagnosticHistogram::DiagnosticHistogram ()
+{
+	for(Shard& shard : shards)
+	{
+		shard.count = 0;
+		shard.sum = 0.;
+		shard.minimum = DBL_MAX;
+		shard.maximum = -DBL_MAX;
+		for(int i = 0; i < kNumBuckets; i++)
+			shard.buckets[i] = 0;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int DiagnosticHistogram::getBucketIndex (double value)
+{
+	if(!(value >= ::ldexp (1., kMinExponent))) // includes NaN
+		return 0;
+	if(value >= ::ldexp (1., kMaxExponent))
+		return kNumBuckets - 1;
+
+	int exponent = 0;
+	double mantissa = ::frexp (value, &exponent); // value = mantissa * 2^exponent, mantissa in [0.5, 1)
+	int octave = exponent - 1 - kMinExponent;
+	int subBucket = ccl_min ((int)((mantissa * 2. - 1.) * kSubBuckets), kSubBuckets - 1);
+	return 1 + octave * kSubBuckets + subBucket;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+double DiagnosticHistogram::getBucketValue (int index)
+{
+	if(index <= 0)
+		return 0.;
+	if(index >= kNumBuckets - 1)
+		return ::ldexp (1., kMaxExponent);
+
+	int octave = (index - 1) / kSubBuckets;
+	int subBucket = (index - 1) % kSubBuckets;
+	return ::ldexp (1. + (subBucket + .5) / kSubBuckets, octave + kMinExponent);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+DiagnosticHistogram::Shard& DiagnosticHistogram::getShard (Shard shards[])
+{
+	uint64 id = (uint64)System::GetThreadSelfID ();
+	uint32 hash = (uint32)(id ^ (id >> 32)) * 2654435761u;
+	return shards[(hash >> 16) & (kNumShards - 1)];
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DiagnosticHistogram::add (double value)
+{
+	Shard& shard = getShard (shards);
+
+	AtomicAddInline (shard.buckets[getBucketIndex (value)], 1);
+	AtomicDouble::add (shard.sum, value);
+	AtomicDouble::minimum (shard.minimum, value);
+	AtomicDouble::maximum (shard.maximum, value);
+	AtomicAddInline (shard.count, 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DiagnosticHistogram::drain (Snapshot& snapshot)
+{
+	for(Shard& shard : shards)
+	{
+		int32 count = AtomicGetInline (shard.count);
+		if(count == 0)
+			continue;
+
+		AtomicAddInline (shard.count, -count);
+		snapshot.count += count;
+		snapshot.sum += AtomicDouble::exchange (shard.sum, 0.);
+		snapshot.minimum = ccl_min (snapshot.minimum, AtomicDouble::exchange (shard.minimum, DBL_MAX));
+		snapshot.maximum = ccl_max (snapshot.maximum, AtomicDouble::exchange (shard.maximum, -DBL_MAX));
+
+		for(int i = 0; i < kNumBuckets; i++)
+		{
+			int32 n = AtomicGetInline (shard.buckets[i]);
+			if(n != 0)
+			{
+				AtomicAddInline (shard.buckets[i], -n);
+				snapshot.buckets[i] += n;
+			}
+		}
+	}
+}
+
+//************************************************************************************************
+// DiagnosticMetric
+//************************************************************************************************
+
+DiagnosticMetric::DiagnosticMetric (StringID context, StringID key, uint32 hash)
+: context (context),
+  key (key),
+  hash (hash)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+DiagnosticMetric::~DiagnosticMetric ()
+{
+	delete static_cast<SampleQueue*> (samples.getPtr ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DiagnosticMetric::addValue (double value)
+{
+	histogram.add (value);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DiagnosticMetric::addEvent ()
+{
+	eventCount.increment ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DiagnosticMetric::addSample (const Sample& sample)
+{
+	SampleQueue* queue = static_cast<SampleQueue*> (samples.getPtr ());
+	if(queue == nullptr)
+	{
+		queue = NEW SampleQueue (kMaxSamples);
+		if(!samples.testAndSet (queue, nullptr))
+		{
+			delete queue; // another thread was faster
+			queue = static_cast<SampleQueue*> (samples.getPtr ());
+		}
+	}
+	if(!queue->push (sample))
+		droppedSamples.increment (); // not collected in time
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DiagnosticMetric::setLabel (StringRef newLabel)
+{
+	if(labelSet.getValue ())
+		return; // labels don't change per key, avoid locking
+
+	Threading::ScopedLock scopedLock (labelLock);
+	if(labelSet.getValue () == 0)
+	{
+		label = newLabel;
+		labelSet = 1;
+		labelChanged = 1;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int DiagnosticMetric::takeEventCount ()
+{
+	int count = eventCount.getValue ();
+	if(count != 0)
+		eventCount.add (-count);
+	return count;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool DiagnosticMetric::takeSample (Sample& sample)
+{
+	SampleQueue* queue = static_cast<SampleQueue*> (samples.getPtr ());
+	return queue && queue->pop (sample);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int DiagnosticMetric::takeDroppedSampleCount ()
+{
+	int count = droppedSamples.getValue ();
+	if(count != 0)
+		droppedSamples.add (-count);
+	return count;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool DiagnosticMetric::getLabel (String& result)
+{
+	if(labelChanged.getValue () == 0)
+		return false;
+
+	Threading::ScopedLock scopedLock (labelLock);
+	labelChanged = 0;
+	result = label;
+	return true;
+}
+
+//************************************************************************************************
+// DiagnosticMetrics
+//************************************************************************************************
+
+DiagnosticMetrics::DiagnosticMetrics ()
+{
+	for(int i = 0; i < kMaxTables; i++)
+		tables[i] = nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+DiagnosticMetrics::~DiagnosticMetrics ()
+{
+	for(int t = 0; t < kMaxTables; t++)
+		if(void* volatile* table = static_cast<void* volatile*> (tables[t]))
+		{
+			for(int i = 0; i < getTableSize (t); i++)
+				delete static_cast<DiagnosticMetric*> (table[i]);
+			delete [] table;
+		}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int DiagnosticMetrics::getTableSize (int tableIndex)
+{
+	return kFirstTableSize << tableIndex;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void* volatile* DiagnosticMetrics::getTable (int tableIndex, bool create)
+{
+	void* volatile* table = static_cast<void* volatile*> (AtomicGetPtrInline (tables[tableIndex]));
+	if(table == nullptr && create)
+	{
+		int size = getTableSize (tableIndex);
+		void* volatile* newTable = NEW void* volatile[size];
+		for(int i = 0; i < size; i++)
+			newTable[i] = nullptr;
+
+		if(AtomicTestAndSetPtrInline (tables[tableIndex], (void*)newTable, nullptr))
+			table = newTable;
+		else
+		{
+			delete [] newTable; // another thread was faster
+			table = static_cast<void* volatile*> (AtomicGetPtrInline (tables[tableIndex]));
+		}
+	}
+	return table;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint32 DiagnosticMetrics::getHash (StringID context, StringID key)
+{
+	// FNV-1a of context and key
+	uint32 hash = 2166136261u;
+	for(CStringPtr s = context.str (); *s; s++)
+		hash = (hash ^ (unsigned char)*s) * 16777619u;
+	hash = (hash ^ '/') * 16777619u;
+	for(CStringPtr s = key.str (); *s; s++)
+		hash = (hash ^ (unsigned char)*s) * 16777619u;
+	return hash;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+DiagnosticMetric* DiagnosticMetrics::lookup (StringID context, StringID key, bool create)
+{
+	uint32 hash = getHash (context, key);
+	DiagnosticMetric* newMetric = nullptr;
+
+	// open addressing with linear probing, slots are only ever filled, so all threads
+	// follow the same probe sequence through the tables
+	for(int t = 0; t < kMaxTables; t++)
+	{
+		void* volatile* table = getTable (t, create);
+		if(table == nullptr)
+			break;
+
+		int mask = getTableSize (t) - 1;
+		for(int probe = 0; probe < kMaxProbes; probe++)
+		{
+			void* volatile& slot = table[(hash + probe) & mask];
+			DiagnosticMetric* metric = static_cast<DiagnosticMetric*> (AtomicGetPtrInline (slot));
+			if(metric == nullptr)
+			{
+				if(!create)
+					return nullptr;
+
+				if(newMetric == nullptr)
+					newMetric = NEW DiagnosticMetric (context, key, hash);
+				if(AtomicTestAndSetPtrInline (slot, newMetric, nullptr))
+					return newMetric;
+
+				metric = static_cast<DiagnosticMetric*> (AtomicGetPtrInline (slot)); // another thread was faster
+			}
+
+			if(metric->getHash () == hash && metric->getContext () == context && metric->getKey () == key)
+			{
+				delete newMetric;
+				return metric;
+			}
+		}
+	}
+
+	delete newMetric;
+	return nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int DiagnosticMetrics::getCapacity () const
+{
+	int capacity = 0;
+	for(int t = 0; t < kMaxTables && AtomicGetPtrInline (const_cast<void* volatile&> (tables[t])); t++)
+		capacity += getTableSize (t);
+	return capacity;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+DiagnosticMetric* DiagnosticMetrics::at (int index) const
+{
+	for(int t = 0; t < kMaxTables; t++)
+	{
+		int size = getTableSize (t);
+		if(index < size)
+		{
+			void* volatile* table = static_cast<void* volatile*> (AtomicGetPtrInline (const_cast<void* volatile&> (tables[t])));
+			return table ? static_cast<DiagnosticMetric*> (AtomicGetPtrInline (table[index])) : nullptr;
+		}
+		index -= size;
+	}
+	return nullptr;
+}
@@ -0,0 +1,193 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/system/diagnosticmetrics.h
+// Description : Thread-safe Diagnostic Metrics
+//
+//************************************************************************************************
+
+#ifndef _ccl_diagnosticmetrics_h
+#define _ccl_diagnosticmetrics_h
+
+#include "ccl/public/text/cstring.h"
+#include "ccl/public/text/cclstring.h"
+#include "ccl/public/system/threadsync.h"
+#include "ccl/public/system/lockfree.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// DiagnosticHistogram
+/** Histogram with log-linear buckets, values can be added from any thread without locking.
+	Each power of two is divided into kSubBuckets linear buckets. Threads are spread over
+	kNumShards shards to reduce contention on the atomic counters. */
+//************************************************************************************************
+
+class DiagnosticHistogram
+{
+public:
+	DiagnosticHistogram ();
+
+	static const int kNumShards = 4;
+	static const int kSubBuckets = 4;
+	static const int kMinExponent = -20;	///< smallest bucket starts at 2^-20 (~1 microsecond)
+	static const int kMaxExponent = 40;		///< largest bucket starts at 2^40 (~1 TB)
+	static const int kNumBuckets = (kMaxExponent - kMinExponent) * kSubBuckets + 2; ///< plus underflow and overflow
+
+	/** Statistics taken from the histogram. */
+	struct Snapshot
+	{
+		int count;
+		double sum;
+		double minimum;
+		double maximum;
+		int buckets[kNumBuckets];
+
+		Snapshot ();
+
+		bool isEmpty () const;
+		void reset ();
+		void merge (const Snapshot& other);
+
+		/** Estimate value below which the given percentage (0 to 100) of values fall. */
+		double getPercentile (double percentile) const;
+	};
+
+	/** Add value, can be called from any thread. */
+	void add (double value);
+
+	/** Move statistics to snapshot and reset them, values added concurrently are kept. */
+	void drain (Snapshot& snapshot);
+
+	static int getBucketIndex (double value);
+	static double getBucketValue (int index); ///< center of bucket
+
+protected:
+	struct Shard
+	{
+		int32 volatile count;
+		double volatile sum;
+		double volatile minimum;
+		double volatile maximum;
+		int32 volatile buckets[kNumBuckets];
+	};
+
+	Shard shards[kNumShards];
+
+	static Shard& getShard (Shard shards[]);
+};
+
+//************************************************************************************************
+// DiagnosticMetric
+/** Statistics of one context/key pair. Submitting is thread-safe, draining and the merged
+	statistics are reserved to the main thread. */
+//************************************************************************************************
+
+class DiagnosticMetric
+{
+public:
+	DiagnosticMetric (StringID context, StringID key, uint32 hash);
+	~DiagnosticMetric ();
+
+	/** Value or event kept in short-term mode. */
+	struct Sample
+	{
+		double value = 0.;
+		int64 timestamp = 0;
+		bool hasValue = false;
+	};
+
+	static const int kMaxSamples = 1024; ///< samples exceeding this number between two collections are dropped
+
+	StringID getContext () const;
+	StringID getKey () const;
+	uint32 getHash () const;
+
+	// submit from any thread
+	void addValue (double value);
+	void addEvent ();
+	void addSample (const Sample& sample);
+	void setLabel (StringRef label);	///< first label is kept
+
+	// main thread
+	DiagnosticHistogram& getHistogram ();
+	DiagnosticHistogram::Snapshot& getMerged ();	///< statistics drained so far
+	int takeEventCount ();
+	bool takeSample (Sample& sample);
+	int takeDroppedSampleCount ();
+	bool getLabel (String& label);
+
+protected:
+	MutableCString context;
+	MutableCString key;
+	uint32 hash;
+	DiagnosticHistogram histogram;
+	DiagnosticHistogram::Snapshot merged;
+	Threading::AtomicInt eventCount;
+	Threading::AtomicPtr samples;
+	Threading::AtomicInt droppedSamples;
+	Threading::AtomicInt labelSet;
+	Threading::AtomicInt labelChanged;
+	Threading::CriticalSection labelLock;
+	String label;
+
+	typedef LockFree::BoundedQueue<Sample> SampleQueue;
+};
+
+//************************************************************************************************
+// DiagnosticMetrics
+/** Table of metrics which can be looked up and added from any thread without locking.
+	Metrics are never removed. The table grows by adding tables of twice the previous size,
+	a metric goes to the first table with a free slot within kMaxProbes probes. */
+//************************************************************************************************
+
+class DiagnosticMetrics
+{
+public:
+	DiagnosticMetrics ();
+	~DiagnosticMetrics ();
+
+	static const int kFirstTableSize = 1024;
+	static const int kMaxTables = 16;		///< total capacity is kFirstTableSize * (2^kMaxTables - 1)
+	static const int kMaxProbes = 64;
+
+	/** Find metric, optionally create it. Returns null if not found or all tables are full. */
+	DiagnosticMetric* lookup (StringID context, StringID key, bool create);
+
+	/** Get number of slots in tables allocated so far. */
+	int getCapacity () const;
+
+	/** Access table slot, for iteration from 0 to getCapacity () - 1. Returns null for empty slots. */
+	DiagnosticMetric* at (int index) const;
+
+protected:
+	void* volatile tables[kMaxTables];
+
+	static uint32 getHash (StringID context, StringID key);
+	static int getTableSize (int tableIndex);
+	void* volatile* getTable (int tableIndex, bool create);
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// inline
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+inline StringID DiagnosticMetric::getContext () const { return context; }
+inline StringID DiagnosticMetric::getKey () const { return key; }
+inline uint32 DiagnosticMetric::getHash () const { return hash; }
+inline DiagnosticHistogram& DiagnosticMetric::getHistogram () { return histogram; }
+inline DiagnosticHistogram::Snapshot& DiagnosticMetric::getMerged () { return merged; }
+
+} // namespace CCL
+
+#endif // _ccl_diagnosticmetrics_h
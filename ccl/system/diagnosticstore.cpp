@@ -20,6 +20,7 @@
 
 #include "ccl/base/storage/settings.h"
 
+#include "ccl/public/collections/vector.h"
 #include "ccl/public/system/isysteminfo.h"
 #include "ccl/public/system/inativefilesystem.h"
 #include "ccl/public/systemservices.h"
@@ -36,6 +37,8 @@ class DiagnosticFilter: public Unknown,
 public:
 	DiagnosticFilter (StringID context);
 
+	virtual bool matchesContext (StringID objectContext) const;
+
 	// IObjectFilter
 	tbool CCL_API matches (IUnknown* object) const override;
 
@@ -43,7 +46,6 @@ public:
 
 protected:
 	StringID context;
-	String contextString;
 };
 
 //************************************************************************************************
@@ -56,7 +58,7 @@ public:
 	DiagnosticWildcardFilter (StringID context);
 
 	// DiagnosticFilter
-	tbool CCL_API matches (IUnknown* object) const override;
+	bool matchesContext (StringID objectContext) const override;
 };
 
 //************************************************************************************************
@@ -64,7 +66,8 @@ public:
 //************************************************************************************************
 
 class DiagnosticResult: public Attributes,
-						public IDiagnosticResult
+						public IDiagnosticResult,
+						public IDiagnosticResult2
 {
 public:
 	DECLARE_CLASS (DiagnosticResult, Attributes)
@@ -79,6 +82,12 @@ public:
 	DECLARE_STRINGID_MEMBER (kItems)
 	DECLARE_STRINGID_MEMBER (kValue)
 	DECLARE_STRINGID_MEMBER (kTimestamp)
+	DECLARE_STRINGID_MEMBER (kDropped)
+
+	DiagnosticResult ();
+	~DiagnosticResult ();
+
+	void setHistogram (const DiagnosticHistogram::Snapshot& histogram);
 
 	// IDiagnosticResult
 	StringID CCL_API getContext () const override;
@@ -94,11 +103,16 @@ public:
 	tbool CCL_API getValue (Variant& value, int index) const override;
 	int64 CCL_API getTimestamp (int index) const override;
 
-	CLASS_INTERFACE (IDiagnosticResult, Attributes)
+	// IDiagnosticResult2
+	double CCL_API getPercentile (double percentile) const override;
+	int CCL_API getNumDroppedValues () const override;
+
+	CLASS_INTERFACE2 (IDiagnosticResult, IDiagnosticResult2, Attributes)
 
 protected:
 	mutable MutableCString context;
 	mutable String label;
+	DiagnosticHistogram::Snapshot* histogram;
 };
 
 //************************************************************************************************
@@ -175,49 +189,60 @@ DiagnosticStore::~DiagnosticStore ()
 
 tresult CCL_API DiagnosticStore::submitValue (StringID context, StringID key, VariantRef value, StringRef label)
 {
-	ASSERT (System::IsInMainThread ())
-	if(!System::IsInMainThread ())
-		return kResultWrongThread;
+	if(value.isValid () && !value.isNumeric ())
+		return kResultInvalidArgument;
 
-	Attributes& keyData = getData (context, key, kLongTerm);
-	
-	AutoPtr<Attributes> item = (mode == kShortTerm) ? NEW Attributes : nullptr;
+	if(value.isNumeric () && (value.getUserFlags () & kNoStatistics))
+		return submitPlainValue (context, key, value, label);
+
+	// statistics can be submitted from any thread, they are collected on the main thread
+	DiagnosticMetric* metric = metrics.lookup (context, key, true);
+	if(metric == nullptr)
+		return kResultOutOfMemory;
 
 	if(value.isNumeric ()) //< Duration, size, etc.
-	{
-		if(item)
-			item->set (DiagnosticResult::kValue, value.asDouble ());
+		metric->addValue (value.asDouble ());
+	else //< Events without values
+		metric->addEvent ();
 
-		if(value.getUserFlags () & kNoStatistics)
-			keyData.setAttribute (DiagnosticResult::kValue, value); // only keep the last submitted value
-		else
-		{
-			int count = keyData.getInt (DiagnosticResult::kCount);
-			double average = (keyData.getFloat (DiagnosticResult::kAverage) * count + value.asDouble ()) / (count + 1);
-			double minimum = keyData.contains (DiagnosticResult::kMinimum) ? ccl_min (keyData.getFloat (DiagnosticResult::kMinimum), value.asDouble ()) : value.asDouble ();
-			double maximum = ccl_max (keyData.getFloat (DiagnosticResult::kMaximum), value.asDouble ());
-			double sum = keyData.getFloat (DiagnosticResult::kSum) + value.asDouble ();
+	if(!label.isEmpty ())
+		metric->setLabel (label);
 
-			keyData.set (DiagnosticResult::kCount, count + 1);
-			keyData.set (DiagnosticResult::kAverage, average);
-			keyData.set (DiagnosticResult::kMinimum, minimum);
-			keyData.set (DiagnosticResult::kMaximum, maximum);
-			keyData.set (DiagnosticResult::kSum, sum);
-		}
-	}
-	else if(!value.isValid ()) //< Events without values
+	if(mode == kShortTerm)
 	{
-		int count = keyData.getInt (DiagnosticResult::kCount);
-		keyData.set (DiagnosticResult::kCount, count + 1);
+		DiagnosticMetric::Sample sample;
+		sample.hasValue = value.isNumeric ();
+		sample.value = value.asDouble ();
+
+		DateTime now;
+		System::GetSystem ().getLocalTime (now);
+		sample.timestamp = now.toOrdinal ();
+
+		metric->addSample (sample);
 	}
-	else
-		return kResultInvalidArgument;
+
+	return kResultOk;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult DiagnosticStore::submitPlainValue (StringID context, StringID key, VariantRef value, StringRef label)
+{
+	ASSERT (System::IsInMainThread ())
+	if(!System::IsInMainThread ())
+		return kResultWrongThread;
+
+	Attributes& keyData = getData (context, key, kLongTerm);
+	keyData.setAttribute (DiagnosticResult::kValue, value); // only keep the last submitted value
 	
 	if(!label.isEmpty ())
 		keyData.set (DiagnosticResult::kLabel, label);
 
-	if(item)
+	if(mode == kShortTerm)
 	{
+		AutoPtr<Attributes> item = NEW Attributes;
+		item->set (DiagnosticResult::kValue, value.asDouble ());
+
 		DateTime now;
 		System::GetSystem ().getLocalTime (now);
 		item->set (DiagnosticResult::kTimestamp, now.toOrdinal ());
@@ -235,6 +260,86 @@ tresult CCL_API DiagnosticStore::submitValue (StringID context, StringID key, Va
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void DiagnosticStore::collectMetrics ()
+{
+	ASSERT (System::IsInMainThread ())
+
+	for(int i = 0, capacity = metrics.getCapacity (); i < capacity; i++)
+		if(DiagnosticMetric* metric = metrics.at (i))
+			collectMetric (*metric);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DiagnosticStore::collectMetric (DiagnosticMetric& metric)
+{
+	DiagnosticHistogram::Snapshot snapshot;
+	metric.getHistogram ().drain (snapshot);
+	int eventCount = metric.takeEventCount ();
+	String label;
+	bool labelChanged = metric.getLabel (label);
+
+	if(!snapshot.isEmpty () || eventCount > 0 || labelChanged)
+	{
+		Attributes& keyData = getData (metric.getContext (), metric.getKey (), kLongTerm);
+		int count = keyData.getInt (DiagnosticResult::kCount);
+
+		if(!snapshot.isEmpty ())
+		{
+			double average = (keyData.getFloat (DiagnosticResult::kAverage) * count + snapshot.sum) / (count + snapshot.count);
+			double minimum = keyData.contains (DiagnosticResult::kMinimum) ? ccl_min (keyData.getFloat (DiagnosticResult::kMinimum), snapshot.minimum) : snapshot.minimum;
+			double maximum = ccl_max (keyData.getFloat (DiagnosticResult::kMaximum), snapshot.maximum);
+			double sum = keyData.getFloat (DiagnosticResult::kSum) + snapshot.sum;
+
+			keyData.set (DiagnosticResult::kAverage, average);
+			keyData.set (DiagnosticResult::kMinimum, minimum);
+			keyData.set (DiagnosticResult::kMaximum, maximum);
+			keyData.set (DiagnosticResult::kSum, sum);
+
+			metric.getMerged ().merge (snapshot);
+		}
+
+		if(!snapshot.isEmpty () || eventCount > 0)
+			keyData.set (DiagnosticResult::kCount, count + snapshot.count + eventCount);
+
+		if(labelChanged)
+			keyData.set (DiagnosticResult::kLabel, label);
+	}
+
+	DiagnosticMetric::Sample sample;
+	while(metric.takeSample (sample))
+	{
+		if(mode != kShortTerm)
+			continue; // submitted before switching to long-term mode
+
+		AutoPtr<Attributes> item = NEW Attributes;
+		if(sample.hasValue)
+			item->set (DiagnosticResult::kValue, sample.value);
+		item->set (DiagnosticResult::kTimestamp, sample.timestamp);
+
+		Attributes& shortTermData = getData (metric.getContext (), metric.getKey (), kShortTerm);
+		if(labelChanged)
+			shortTermData.set (DiagnosticResult::kLabel, label);
+		else if(!shortTermData.contains (DiagnosticResult::kLabel))
+		{
+			Attributes& keyData = getData (metric.getContext (), metric.getKey (), kLongTerm);
+			if(keyData.contains (DiagnosticResult::kLabel))
+				shortTermData.set (DiagnosticResult::kLabel, keyData.getString (DiagnosticResult::kLabel));
+		}
+
+		shortTermData.queue (DiagnosticResult::kItems, item, Attributes::kShare);
+	}
+
+	int numDropped = metric.takeDroppedSampleCount ();
+	if(numDropped > 0 && mode == kShortTerm)
+	{
+		Attributes& shortTermData = getData (metric.getContext (), metric.getKey (), kShortTerm);
+		shortTermData.set (DiagnosticResult::kDropped, shortTermData.getInt (DiagnosticResult::kDropped) + numDropped);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 tresult CCL_API DiagnosticStore::clearData (StringID context, StringID key)
 {
 	ObjectArray& results = (mode == kLongTerm) ? data : shortTermData;
@@ -242,6 +347,19 @@ tresult CCL_API DiagnosticStore::clearData (StringID context, StringID key)
 	bool isWildcard = context.index ('*') != -1;
 	AutoPtr<DiagnosticFilter> contextFilter = isWildcard ? NEW DiagnosticWildcardFilter (context) : NEW DiagnosticFilter (context);
 
+	if(System::IsInMainThread ())
+	{
+		collectMetrics ();
+
+		if(mode == kLongTerm)
+			for(int i = 0, capacity = metrics.getCapacity (); i < capacity; i++)
+			{
+				DiagnosticMetric* metric = metrics.at (i);
+				if(metric && (key.isEmpty () || metric->getKey () == key) && contextFilter->matchesContext (metric->getContext ()))
+					metric->getMerged ().reset ();
+			}
+	}
+
 	ObjectList contextsToRemove;
 	for(auto contextData : iterate_as<Attributes> (results))
 		if(contextFilter->matches (ccl_as_unknown (contextData)))
@@ -270,6 +388,8 @@ IDiagnosticResultSet* CCL_API DiagnosticStore::queryResults (StringID context, S
 	if(!System::IsInMainThread ())
 		return nullptr;
 
+	const_cast<DiagnosticStore*> (this)->collectMetrics ();
+
 	AutoPtr<DiagnosticResultSet> resultSet = NEW DiagnosticResultSet;
 	queryResults (*resultSet, context, key);
 	return resultSet.detach ();
@@ -279,6 +399,9 @@ IDiagnosticResultSet* CCL_API DiagnosticStore::queryResults (StringID context, S
 
 IDiagnosticResult* CCL_API DiagnosticStore::queryResult (StringID context, StringID key) const
 {
+	if(System::IsInMainThread ())
+		const_cast<DiagnosticStore*> (this)->collectMetrics ();
+
 	DiagnosticResultSet results;
 	queryResults (results, context, key, 1);
 	return results.getCount () > 0 ? return_shared (results.at (0)) : nullptr;
@@ -288,6 +411,9 @@ IDiagnosticResult* CCL_API DiagnosticStore::queryResult (StringID context, Strin
 
 IDiagnosticResultSet* CCL_API DiagnosticStore::queryMultipleResults (StringID context, CString keys[], int keyCount) const
 {
+	if(System::IsInMainThread ())
+		const_cast<DiagnosticStore*> (this)->collectMetrics ();
+
 	AutoPtr<DiagnosticResultSet> resultSet = NEW DiagnosticResultSet;
 	queryMultipleResults (*resultSet, context, keys, keyCount);
 	return resultSet->getCount () == keyCount ? resultSet.detach () : nullptr;
@@ -308,9 +434,13 @@ void DiagnosticStore::queryResults (DiagnosticResultSet& resultSet, StringID con
 			Attributes* keyData = a->getAttributes (key);
 			if(keyData)
 			{
+				MutableCString resultContext (a->getCString (DiagnosticResult::kContext, Text::kASCII));
 				AutoPtr<DiagnosticResult> resultAttributes = NEW DiagnosticResult;
 				resultAttributes->copyFrom (*keyData);
-				resultAttributes->set (DiagnosticResult::kContext, a->getCString (DiagnosticResult::kContext, Text::kASCII));
+				resultAttributes->set (DiagnosticResult::kContext, resultContext, Text::kASCII);
+				if(mode == kLongTerm)
+					if(DiagnosticMetric* metric = const_cast<DiagnosticMetrics&> (metrics).lookup (resultContext, key, false))
+						resultAttributes->setHistogram (metric->getMerged ());
 				resultSet.add (resultAttributes.detach ());
 				if(count > 0 && resultSet.getCount () >= count)
 					break;
@@ -336,9 +466,13 @@ void DiagnosticStore::queryMultipleResults (DiagnosticResultSet& resultSet, Stri
 				Attributes* keyData = a->getAttributes (keys[i]);
 				if(keyData)
 				{
+					MutableCString resultContext (a->getCString (DiagnosticResult::kContext, Text::kASCII));
 					AutoPtr<DiagnosticResult> resultAttributes = NEW DiagnosticResult;
 					resultAttributes->copyFrom (*keyData);
-					resultAttributes->set (DiagnosticResult::kContext, a->getCString (DiagnosticResult::kContext, Text::kASCII));
+					resultAttributes->set (DiagnosticResult::kContext, resultContext, Text::kASCII);
+					if(mode == kLongTerm)
+						if(DiagnosticMetric* metric = const_cast<DiagnosticMetrics&> (metrics).lookup (resultContext, keys[i], false))
+							resultAttributes->setHistogram (metric->getMerged ());
 					resultSet.add (resultAttributes.detach ());
 				}
 				else
@@ -357,6 +491,8 @@ IDiagnosticStore::DiagnosticMode CCL_API DiagnosticStore::setMode (IDiagnosticSt
 	if(!System::IsInMainThread ())
 		return mode;
 
+	collectMetrics ();
+
 	IDiagnosticStore::DiagnosticMode oldMode = mode;
 	mode = newMode;	
 
@@ -370,6 +506,8 @@ IDiagnosticStore::DiagnosticMode CCL_API DiagnosticStore::setMode (IDiagnosticSt
 
 void DiagnosticStore::store ()
 {
+	collectMetrics ();
+
 	XmlSettings settings (kPersistentName);
 	settings.removeAll ();
 	
@@ -481,6 +619,32 @@ DEFINE_STRINGID_MEMBER_ (DiagnosticResult, kSum, "sum")
 DEFINE_STRINGID_MEMBER_ (DiagnosticResult, kItems, "items")
 DEFINE_STRINGID_MEMBER_ (DiagnosticResult, kValue, "value")
 DEFINE_STRINGID_MEMBER_ (DiagnosticResult, kTimestamp, "timestamp")
+DEFINE_STRINGID_MEMBER_ (DiagnosticResult, kDropped, "dropped")
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+DiagnosticResult::DiagnosticResult ()
+: histogram (nullptr)
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+DiagnosticResult::~DiagnosticResult ()
+{
+	delete histogram;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DiagnosticResult::setHistogram (const DiagnosticHistogram::Snapshot& _histogram)
+{
+	if(_histogram.isEmpty ())
+		return;
+
+	if(histogram == nullptr)
+		histogram = NEW DiagnosticHistogram::Snapshot;
+	*histogram = _histogram;
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -628,6 +792,38 @@ int64 DiagnosticResult::getTimestamp (int index) const
 	return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+double CCL_API DiagnosticResult::getPercentile (double percentile) const
+{
+	if(hasValues ())
+	{
+		Vector<double> values;
+		IterForEach (newQueueIterator (kItems, ccl_typeid<Attributes> ()), Attributes, item)
+			Variant value = 0.;
+			item->getAttribute (value, kValue);
+			values.add (value.asDouble ());
+		EndFor
+		if(values.isEmpty ())
+			return 0.;
+
+		values.sort ();
+		int rank = ccl_to_int (ccl_bound (percentile, 0., 100.) / 100. * values.count () + .5);
+		return values[ccl_bound (rank - 1, 0, values.count () - 1)];
+	}
+	else if(histogram)
+		return histogram->getPercentile (percentile);
+	else
+		return 0.;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int CCL_API DiagnosticResult::getNumDroppedValues () const
+{
+	return getInt (kDropped);
+}
+
 //************************************************************************************************
 // DiagnosticResultSet
 //************************************************************************************************
@@ -725,19 +921,25 @@ IUnknownIterator* CCL_API DiagnosticResultSet::createIterator () const
 //************************************************************************************************
 
 DiagnosticFilter::DiagnosticFilter (StringID context)
-: context (context),
-  contextString (Text::kASCII, context)
+: context (context)
 {}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool DiagnosticFilter::matchesContext (StringID objectContext) const
+{
+	return objectContext == context;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 tbool CCL_API DiagnosticFilter::matches (IUnknown* object) const
 {
 	Attributes* result = unknown_cast<Attributes> (object);
 	if(result == nullptr)
 		return false;
 	
-	return result->getVariant (DiagnosticResult::kContext) == contextString;
+	return matchesContext (result->getCString (DiagnosticResult::kContext, Text::kASCII));
 }
 
 //************************************************************************************************
@@ -750,14 +952,9 @@ DiagnosticWildcardFilter::DiagnosticWildcardFilter (StringID context)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-tbool CCL_API DiagnosticWildcardFilter::matches (IUnknown* object) const
+bool DiagnosticWildcardFilter::matchesContext (StringID _objectContext) const
 {
-	Attributes* result = unknown_cast<Attributes> (object);
-	if(result == nullptr)
-		return false;
-		
-	MutableCString objectContext (result->getCString (DiagnosticResult::kContext, Text::kASCII));
-	
+	MutableCString objectContext (_objectContext);
 	MutableCString filterContext (context);
 
 	while(!filterContext.isEmpty ())
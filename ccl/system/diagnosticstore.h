@@ -23,6 +23,8 @@
 #include "ccl/base/storage/attributes.h"
 #include "ccl/base/storage/url.h"
 
+#include "ccl/system/diagnosticmetrics.h"
+
 #include "ccl/public/system/idiagnosticstore.h"
 #include "ccl/public/system/idiagnosticdataprovider.h"
 
@@ -64,6 +66,7 @@ protected:
 	ObjectArray data;
 	ObjectArray shortTermData;
 	DiagnosticMode mode;
+	DiagnosticMetrics metrics; ///< statistics submitted since last collectMetrics ()
 
 	void store ();
 	void restore ();
@@ -71,6 +74,9 @@ protected:
 	Attributes* findContextData (const ObjectArray& contextContainer, StringID context) const;
 	Attributes& getData (StringID context, StringID key, DiagnosticMode mode = kLongTerm);
 	void cleanup ();
+	tresult submitPlainValue (StringID context, StringID key, VariantRef value, StringRef label);
+	void collectMetrics ();
+	void collectMetric (DiagnosticMetric& metric);
 	void queryResults (DiagnosticResultSet& results, StringID context, StringID key, int count = -1) const;
 	void queryMultipleResults (DiagnosticResultSet& results, StringID context, CString keys[], int keyCount) const;
 };
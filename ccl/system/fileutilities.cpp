@@ -19,6 +19,7 @@
 #define DEBUG_LOG 0
 
 #include "ccl/system/fileutilities.h"
+#include "ccl/system/nativefilesystem.h"
 #include "ccl/system/packaging/bufferedstream.h"
 #include "ccl/system/packaging/sectionstream.h"
 #include "ccl/system/packaging/packagehandler.h"
@@ -434,8 +435,14 @@ UrlRef CCL_API FileUtilities::makeUniqueTempFile (IUrl& tempFile, StringRef name
 
 tbool CCL_API FileUtilities::copyStream (IStream& destStream, IStream& srcStream, IProgressNotify* progress, int64 maxBytesToCopy)
 {
-	static const unsigned int kCopyBufferSize = 8192;
-	char buffer[kCopyBufferSize];
+	static const int kMinCopyBufferSize = 8192;
+	static const int kMaxCopyBufferSize = 4 * 1024 * 1024;
+	static const int kNativeCopySize = 16 * 1024 * 1024;
+
+	char stackBuffer[kMinCopyBufferSize];
+	Core::IO::Buffer heapBuffer;
+	char* buffer = stackBuffer;
+	int bufferSize = kMinCopyBufferSize;
 
 	if(progress)
 		progress->beginProgress ();
@@ -448,6 +455,9 @@ tbool CCL_API FileUtilities::copyStream (IStream& destStream, IStream& srcStream
 		srcStream.seek (oldPos, IStream::kSeekSet);
 	}
 
+	// let the file system copy between native files if possible
+	bool nativeCopy = UnknownPtr<INativeFileStream> (&srcStream).isValid () && UnknownPtr<INativeFileStream> (&destStream).isValid ();
+
 	bool result = true;
 	int64 numBytesCopied = 0;
 
@@ -455,7 +465,7 @@ tbool CCL_API FileUtilities::copyStream (IStream& destStream, IStream& srcStream
 
 	while(1)
 	{
-		int numBytesToRead = kCopyBufferSize;
+		int numBytesToRead = nativeCopy ? kNativeCopySize : bufferSize;
 
 		// check copy limit...
 		if(maxBytesToCopy >= 0 && numBytesCopied + numBytesToRead > maxBytesToCopy)
@@ -466,19 +476,47 @@ tbool CCL_API FileUtilities::copyStream (IStream& destStream, IStream& srcStream
 				break;
 		}
 
-		int numBytesRead = srcStream.read (buffer, numBytesToRead);
-		if(numBytesRead <= 0)
+		int numBytesRead = 0;
+		int numBytesWritten = 0;
+		if(nativeCopy)
 		{
-			if(numBytesRead < 0) // a reading error occurred!
-				result = false;
-			break;
+			numBytesRead = numBytesWritten = NativeFileSystem::instance ().copyNativeStream (destStream, srcStream, numBytesToRead);
+			if(numBytesRead < 0)
+			{
+				nativeCopy = false; // not supported, continue with buffered copy
+				continue;
+			}
+			if(numBytesRead == 0)
+				break;
 		}
-
-		int numBytesWritten = destStream.write (buffer, numBytesRead);
-		if(numBytesWritten != numBytesRead)
+		else
 		{
-			result = false; // a writing error occurred!
-			break;
+			numBytesRead = srcStream.read (buffer, numBytesToRead);
+			if(numBytesRead <= 0)
+			{
+				if(numBytesRead < 0) // a reading error occurred!
+					result = false;
+				break;
+			}
+
+			numBytesWritten = destStream.write (buffer, numBytesRead);
+			if(numBytesWritten != numBytesRead)
+			{
+				result = false; // a writing error occurred!
+				break;
+			}
+
+			// grow buffer while more data is to come, fewer calls for large copies
+			if(numBytesRead == bufferSize && bufferSize < kMaxCopyBufferSize)
+				if(maxBytesToCopy < 0 || maxBytesToCopy - (numBytesCopied + numBytesRead) > bufferSize)
+				{
+					int newSize = ccl_min (bufferSize * 8, kMaxCopyBufferSize);
+					if(heapBuffer.resize (newSize))
+					{
+						buffer = heapBuffer.as<char> ();
+						bufferSize = newSize;
+					}
+				}
 		}
 
 		CCL_PRINTF ("Stream %x copy rd %d wr %d\n", (int)(int64)&destStream, numBytesRead, numBytesWritten)
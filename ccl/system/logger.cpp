@@ -51,13 +51,72 @@ CCL_EXPORT System::ILogger& CCL_API System::CCL_ISOLATED (GetLogger) ()
 	return theLogger;
 }
 
+//************************************************************************************************
+// Logger::DeliveryThread
+//************************************************************************************************
+
+Logger::DeliveryThread::DeliveryThread (Logger& logger)
+: UserThread ("Logger"),
+  logger (logger)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int Logger::DeliveryThread::threadEntry ()
+{
+	logger.deliveryThreadId = System::GetThreadSelfID ();
+
+	while(!shouldTerminate ())
+	{
+		int count = 0;
+		{
+			Threading::ScopedLock scopedLock (logger.lock);
+			count = logger.deliverPending (kBatchSize);
+		}
+
+		if(count == 0)
+		{
+			// producers only signal while we are waiting
+			logger.threadWaiting.assign (1);
+			if(logger.pendingEvents->count () == 0)
+				logger.eventSignal.wait (kIdleTimeout);
+			logger.threadWaiting.assign (0);
+		}
+	}
+
+	logger.deliveryThreadId = 0;
+	return 0;
+}
+
 //************************************************************************************************
 // Logger
 //************************************************************************************************
 
+Logger::Logger ()
+: pendingEvents (nullptr),
+  freeEvents (nullptr),
+  eventPool (nullptr),
+  deliveryThread (nullptr),
+  deliveryThreadId (0)
+{
+	overflowPolicy = kDropLowSeverity;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 Logger::~Logger ()
 {
 	ASSERT (outputs.isEmpty () == true)
+
+	if(deliveryThread)
+	{
+		deliveryThread->stopThread (kStopTimeout);
+		delete deliveryThread;
+	}
+
+	delete pendingEvents;
+	delete freeEvents;
+	delete [] eventPool;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -73,6 +132,11 @@ void CCL_API Logger::addOutput (Alert::IReporter* output)
 void CCL_API Logger::removeOutput (Alert::IReporter* output)
 {
 	Threading::ScopedLock scopedLock (lock);
+	
+	// output might still be waiting for queued events
+	if(pendingEvents)
+		deliverPending (-1);
+
 	outputs.remove (output);
 }
 
@@ -84,10 +148,15 @@ void CCL_API Logger::reportEvent (const Alert::Event& _e)
 	if(e.time == DateTime ())
 		System::GetSystem ().getLocalTime (e.time);
 
+	// events reported by outputs on the delivery thread are delivered immediately
+	if(asyncEnabled.getValue () && System::GetThreadSelfID () != deliveryThreadId)
+		if(queueEvent (e))
+			return;
+
 	Threading::ScopedLock scopedLock (lock);
-	ListForEach (outputs, Alert::IReporter*, output)
-		output->reportEvent (e);
-	EndFor
+	if(pendingEvents && System::GetThreadSelfID () != deliveryThreadId)
+		deliverPending (-1); // keep order with events queued before
+	deliverEvent (e);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -99,3 +168,143 @@ void CCL_API Logger::setReportOptions (Severity minSeverity, int eventFormat)
 		output->setReportOptions (minSeverity, eventFormat);
 	EndFor
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API Logger::setAsyncMode (tbool state, int capacity, OverflowPolicy policy)
+{
+	Threading::ScopedLock scopedLock (asyncLock);
+
+	if(state)
+	{
+		if(pendingEvents == nullptr)
+		{
+			if(capacity < kBatchSize)
+				capacity = kBatchSize;
+
+			pendingEvents = NEW LockFree::BoundedQueue<Alert::Event*> (capacity);
+			capacity = pendingEvents->getCapacity ();
+			freeEvents = NEW LockFree::BoundedQueue<Alert::Event*> (capacity);
+			eventPool = NEW Alert::Event[capacity];
+			for(int i = 0; i < capacity; i++)
+				freeEvents->push (&eventPool[i]);
+		}
+
+		overflowPolicy = policy;
+
+		if(deliveryThread == nullptr)
+		{
+			deliveryThread = NEW DeliveryThread (*this);
+			deliveryThread->startThread (Threading::kPriorityBelowNormal);
+		}
+		asyncEnabled = 1;
+	}
+	else
+	{
+		asyncEnabled = 0;
+
+		if(deliveryThread)
+		{
+			deliveryThread->requestTerminate ();
+			eventSignal.signal ();
+			deliveryThread->stopThread (kStopTimeout);
+			delete deliveryThread;
+			deliveryThread = nullptr;
+		}
+
+		flush ();
+	}
+	return kResultOk;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API Logger::isAsyncMode () const
+{
+	return asyncEnabled.getValue () != 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API Logger::flush ()
+{
+	Threading::ScopedLock scopedLock (lock);
+	if(pendingEvents)
+		deliverPending (-1);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API Logger::getAsyncStatistics (System::AsyncLoggerStatistics& statistics) const
+{
+	statistics.capacity = pendingEvents ? pendingEvents->getCapacity () : 0;
+	statistics.queueDepth = pendingEvents ? pendingEvents->count () : 0;
+	statistics.maxQueueDepth = maxQueueDepth.getValue ();
+	statistics.numQueued = numQueued.getValue ();
+	statistics.numDropped = numDropped.getValue ();
+	statistics.numWaits = numWaits.getValue ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Logger::queueEvent (const Alert::Event& e)
+{
+	Alert::Event* slot = nullptr;
+	if(!freeEvents->pop (slot))
+	{
+		int policy = overflowPolicy.getValue ();
+		if(policy == kDropEvent || (policy == kDropLowSeverity && e.severity > kSeverityWarning))
+		{
+			numDropped.increment ();
+			return true;
+		}
+
+		numWaits.increment ();
+		return false; // deliver synchronously after pending events
+	}
+
+	*slot = e;
+	if(!pendingEvents->push (slot))
+	{
+		ASSERT (0) // can't fail, there are never more slots than cells
+		*slot = Alert::Event ();
+		freeEvents->push (slot);
+		numDropped.increment ();
+		return true;
+	}
+	numQueued.increment ();
+
+	int depth = pendingEvents->count ();
+	int maxDepth = maxQueueDepth.getValue ();
+	while(depth > maxDepth && !maxQueueDepth.testAndSet (depth, maxDepth))
+		maxDepth = maxQueueDepth.getValue ();
+
+	if(threadWaiting.getValue ())
+		eventSignal.signal ();
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int Logger::deliverPending (int maxCount)
+{
+	int count = 0;
+	Alert::Event* slot = nullptr;
+	while((maxCount < 0 || count < maxCount) && pendingEvents->pop (slot))
+	{
+		deliverEvent (*slot);
+		*slot = Alert::Event (); // release strings
+		freeEvents->push (slot);
+		count++;
+	}
+	return count;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Logger::deliverEvent (const Alert::Event& e)
+{
+	ListForEach (outputs, Alert::IReporter*, output)
+		output->reportEvent (e);
+	EndFor
+}
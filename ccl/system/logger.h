@@ -23,6 +23,8 @@
 #include "ccl/public/collections/linkedlist.h"
 #include "ccl/public/system/ilogger.h"
 #include "ccl/public/system/threadsync.h"
+#include "ccl/public/system/userthread.h"
+#include "ccl/public/system/lockfree.h"
 
 namespace CCL {
 
@@ -31,9 +33,11 @@ namespace CCL {
 //************************************************************************************************
 
 class Logger: public Unknown,
-			  public System::ILogger
+			  public System::ILogger,
+			  public System::IAsyncLogger
 {
 public:
+	Logger ();
 	~Logger ();
 
 	// System::ILogger
@@ -44,11 +48,55 @@ public:
 	void CCL_API reportEvent (const Alert::Event& e) override;
 	void CCL_API setReportOptions (Severity minSeverity, int eventFormat) override;
 
-	CLASS_INTERFACE2 (ILogger, IReporter, Unknown)
+	// System::IAsyncLogger
+	tresult CCL_API setAsyncMode (tbool state, int capacity = 4096, OverflowPolicy policy = kDropLowSeverity) override;
+	tbool CCL_API isAsyncMode () const override;
+	void CCL_API flush () override;
+	void CCL_API getAsyncStatistics (System::AsyncLoggerStatistics& statistics) const override;
+
+	CLASS_INTERFACE3 (ILogger, IReporter, IAsyncLogger, Unknown)
 
 protected:
+	static const int kBatchSize = 64;
+	static const int kIdleTimeout = 100;	///< milliseconds
+	static const int kStopTimeout = 5000;	///< milliseconds
+
+	class DeliveryThread final: public Threading::UserThread // UserThread has no virtual destructor
+	{
+	public:
+		DeliveryThread (Logger& logger);
+
+	protected:
+		Logger& logger;
+
+		// UserThread
+		int threadEntry () override;
+	};
+
 	Threading::CriticalSection lock;
 	LinkedList<Alert::IReporter*> outputs;
+
+	// asynchronous mode: producers take a slot from freeEvents, fill it and pass it on
+	// to pendingEvents, the delivery thread returns it after delivery
+	Threading::CriticalSection asyncLock;
+	LockFree::BoundedQueue<Alert::Event*>* pendingEvents;
+	LockFree::BoundedQueue<Alert::Event*>* freeEvents;
+	Alert::Event* eventPool;
+	DeliveryThread* deliveryThread;
+	Threading::ThreadID volatile deliveryThreadId;
+	Threading::AtomicInt asyncEnabled;
+	Threading::AtomicInt overflowPolicy;
+	Threading::AtomicInt threadWaiting;
+	Threading::Signal eventSignal;
+
+	Threading::AtomicInt numQueued;
+	Threading::AtomicInt numDropped;
+	Threading::AtomicInt numWaits;
+	Threading::AtomicInt maxQueueDepth;
+
+	bool queueEvent (const Alert::Event& e);
+	int deliverPending (int maxCount);
+	void deliverEvent (const Alert::Event& e);
 };
 
 } // namespace CCL
@@ -90,6 +90,15 @@ IStream* CCL_API NativeFileSystem::openStream (UrlRef url, int mode, IUnknown* c
 	if(mode & IStream::kWriteMode)
 		createFolder (url);
 
+	// map read-only files into memory if requested, fall back to regular file stream otherwise
+	if(mode & IStream::kMapped)
+	{
+		mode &= ~IStream::kMapped;
+		if(!(mode & IStream::kWriteMode))
+			if(IStream* stream = openMappedStream (url, mode))
+				return stream;
+	}
+
 	return openPlatformStream (url, mode);
 }
 
@@ -422,6 +431,20 @@ IStream* NativeFileSystem::openPlatformStream (UrlRef url, int mode)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+IStream* NativeFileSystem::openMappedStream (UrlRef url, int mode)
+{
+	return nullptr; // not supported by default
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int NativeFileSystem::copyNativeStream (IStream& dstStream, IStream& srcStream, int numBytes)
+{
+	return -1; // not supported by default
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 bool NativeFileSystem::createPlatformFolder (UrlRef url)
 {
 	ASSERT (false) // to be implemented by derived class!
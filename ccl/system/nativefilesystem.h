@@ -41,6 +41,10 @@ class NativeFileSystem:	public Unknown,
 public:
 	static NativeFileSystem& instance ();
 
+	/** Copy data between native file streams without user space buffers (optional).
+		Returns number of bytes copied, 0 at end of file or -1 if not supported. */
+	virtual int copyNativeStream (IStream& dstStream, IStream& srcStream, int numBytes);
+
 	// IFileSystem
 	IStream* CCL_API openStream (UrlRef url, int mode = IStream::kOpenMode, IUnknown* context = nullptr) override;
 	tbool CCL_API fileExists (UrlRef url) override;
@@ -88,6 +92,7 @@ protected:
 
 	// to be implemented by platform subclass:
 	virtual IStream* openPlatformStream (UrlRef url, int mode);
+	virtual IStream* openMappedStream (UrlRef url, int mode);	///< optional, returns null if file can't be mapped
 	virtual bool createPlatformFolder (UrlRef url);
 	virtual bool removePlatformFolder (UrlRef url, int mode);
 	virtual int translateNativeError (int nativeError);	///< translate platform error code to CCL::NativeFileSystem code
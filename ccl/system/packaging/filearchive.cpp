@@ -24,10 +24,14 @@
 #include "ccl/public/base/variant.h"
 #include "ccl/public/base/iprogress.h"
 #include "ccl/public/base/idatatransformer.h"
+#include "ccl/public/base/memorystream.h"
 
 #include "ccl/public/system/ilockable.h"
 #include "ccl/public/system/ifileutilities.h"
+#include "ccl/public/system/imultiworker.h"
 #include "ccl/public/system/inativefilesystem.h"
+#include "ccl/public/system/isysteminfo.h"
+#include "ccl/public/collections/vector.h"
 #include "ccl/public/systemservices.h"
 
 #include "ccl/base/collections/container.h"
@@ -83,6 +87,157 @@ public:
 
 DEFINE_CLASS_ABSTRACT_HIDDEN (FileArchive::ExternalArchiveReference, Object)
 
+//************************************************************************************************
+// FileArchive::PackJob
+/** Compresses (and encrypts) data of a local file into memory. */
+//************************************************************************************************
+
+class FileArchive::PackJob: public Threading::Work
+{
+public:
+	PackJob (const FileArchive& archive, FileStreamItem& item)
+	: archive (archive),
+	  item (item),
+	  sizeOnDisk (0),
+	  crc32 (0),
+	  succeeded (false)
+	{}
+
+	virtual ~PackJob () {}
+
+	FileStreamItem& getItem () const { return item; }
+	IMemoryStream* getData () const { return data; }
+	int64 getSizeOnDisk () const { return sizeOnDisk; }
+	uint32 getCrc32 () const { return crc32; }
+	bool isSucceeded () const { return succeeded; }
+
+	void releaseData () { data.release (); }
+
+	// Work
+	void work () override
+	{
+		AutoPtr<IStream> srcStream = System::GetFileSystem ().openStream (*item.getLocalPath (), IStream::kOpenMode);
+		ASSERT (srcStream != nullptr)
+		if(!srcStream)
+			return;
+
+		data = NEW MemoryStream;
+		AutoPtr<IStream> transformStream = archive.createWriteTransform (*data, item, nullptr/*no context!*/);
+		ASSERT (transformStream != nullptr)
+		if(!transformStream)
+			return;
+
+		int64 maxBytesToCopy = item.getSizeOnDisk ();
+		if(archive.isCrc32Enabled ())
+		{
+			Crc32Stream crcCalculator (transformStream, IStream::kWriteMode);
+			succeeded = System::GetFileUtilities ().copyStream (crcCalculator, *srcStream, nullptr, maxBytesToCopy) != 0;
+			crc32 = crcCalculator.getCrc32 ();
+		}
+		else
+			succeeded = System::GetFileUtilities ().copyStream (*transformStream, *srcStream, nullptr, maxBytesToCopy) != 0;
+		ASSERT (succeeded == true)
+
+		transformStream.release (); // flush compression
+		sizeOnDisk = srcStream->tell ();
+	}
+
+protected:
+	const FileArchive& archive;
+	FileStreamItem& item;
+	AutoPtr<MemoryStream> data;
+	int64 sizeOnDisk;
+	uint32 crc32;
+	bool succeeded;
+};
+
+//************************************************************************************************
+// FileArchive::PackQueue
+/** Local files to be compressed, in the order they are written by flushFolderData().
+	Files are compressed in batches of limited size on all CPUs ahead of being written,
+	the output does not depend on the number of threads. Larger files are not held in memory,
+	they are streamed to the archive by copyFileData(). */
+//************************************************************************************************
+
+class FileArchive::PackQueue
+{
+public:
+	PackQueue (FileArchive& archive)
+	: archive (archive),
+	  nextJob (0),
+	  packedEnd (0)
+	{}
+
+	~PackQueue ()
+	{
+		if(worker)
+			worker->terminate ();
+		for(PackJob* job : jobs)
+			delete job;
+	}
+
+	static const int kMinJobs = 2;
+	static const int64 kMaxBatchSize = 64 * 1024 * 1024; ///< uncompressed bytes held in memory
+	static const int64 kMaxFileSize = 16 * 1024 * 1024; ///< larger files are not packed ahead
+
+	int count () const { return jobs.count (); }
+
+	void collect (FolderItem& folder)
+	{
+		IterForEach (folder.newIterator (), FileSystemItem, item)
+			if(FileStreamItem* fileItem = ccl_cast<FileStreamItem> (item))
+			{
+				if(archive.canPackConcurrently (*fileItem))
+					jobs.add (NEW PackJob (archive, *fileItem));
+			}
+			else if(FolderItem* folderItem = ccl_cast<FolderItem> (item))
+				collect (*folderItem);
+		EndFor
+	}
+
+	PackJob* take (FileStreamItem& item)
+	{
+		if(nextJob >= jobs.count () || &jobs[nextJob]->getItem () != &item)
+			return nullptr;
+
+		if(nextJob >= packedEnd)
+			packBatch ();
+
+		if(nextJob > 0)
+			jobs[nextJob - 1]->releaseData ();
+		return jobs[nextJob++];
+	}
+
+protected:
+	FileArchive& archive;
+	Vector<PackJob*> jobs;
+	AutoPtr<Threading::IMultiWorker> worker;
+	int nextJob;
+	int packedEnd;
+
+	void packBatch ()
+	{
+		if(worker == nullptr)
+			worker = System::CreateMultiThreadWorker ({System::GetSystem ().getNumberOfCPUs (), 0, Threading::kPriorityNormal, false, "PackageFlush"});
+
+		// files are limited to kMaxFileSize, the first one always fits
+		int64 batchSize = 0;
+		while(packedEnd < jobs.count ())
+		{
+			PackJob* job = jobs[packedEnd];
+			int64 fileSize = ccl_max<int64> (job->getItem ().getSizeOnDisk (), 1);
+			if(batchSize + fileSize > kMaxBatchSize)
+				break;
+
+			batchSize += fileSize;
+			worker->push (job);
+			packedEnd++;
+		}
+		worker->work ();
+	}
+};
+
+
 } // namespace CCL
 
 using namespace CCL;
@@ -106,15 +261,19 @@ DEFINE_CLASS_NAMESPACE (FileArchive, NAMESPACE_CCL)
 
 FileArchive::FileArchive (UrlRef path)
 : FileStreamResource (path),
+  crc32Enabled (false),
+  useCount (0),
+  threadSafety (PackageOption::kThreadSafetyOff),
   tempFolder (nullptr),
-  compressionLevel (1.f),
   isCreated (false),
-  crc32Enabled (false),
+  compressionLevel (1.f),
+  compressionLevelSet (false),
+  compressionMethod (PackageOption::kCompressionZlib),
+  compressionDictionary (nullptr),
   failOnInvalidFile (false),
   detailedProgressEnabled (false),
-  useCount (0),
-  threadSafety (PackageOption::kThreadSafetyOff),
-  lock (nullptr)
+  lock (nullptr),
+  packQueue (nullptr)
 {
 	::memset (externalEncryptionKey, 0, 16);
 }
@@ -131,17 +290,33 @@ void FileArchive::destruct ()
 	if(tempFolder)
 		tempFolder->release ();
 
+	safe_release (compressionDictionary);
 	safe_release (lock);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+UIDRef FileArchive::getCompressionClass (int compressionMethod)
+{
+	switch(compressionMethod)
+	{
+	case PackageOption::kCompressionZstd :
+		return ClassID::ZstdCompression;
+	case PackageOption::kCompressionLZ4 :
+		return ClassID::LZ4Compression;
+	default :
+		return ClassID::ZlibCompression;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 tresult CCL_API FileArchive::setOption (StringID id, VariantRef value)
 {
 	if(id == PackageOption::kCompressed)
 	{
 		if(value.asBool ())
-			compressionType.assign (ClassID::ZlibCompression);
+			compressionType.assign (getCompressionClass (compressionMethod));
 		else
 			compressionType.assign (kNullUID);
 		return kResultOk;
@@ -149,6 +324,20 @@ tresult CCL_API FileArchive::setOption (StringID id, VariantRef value)
 	else if(id == PackageOption::kCompressionLevel)
 	{
 		compressionLevel = value.asFloat ();
+		compressionLevelSet = true;
+		return kResultOk;
+	}
+	else if(id == PackageOption::kCompressionMethod)
+	{
+		compressionMethod = value.asInt ();
+		if(isCompressed ())
+			compressionType.assign (getCompressionClass (compressionMethod));
+		return kResultOk;
+	}
+	else if(id == PackageOption::kCompressionDictionary)
+	{
+		UnknownPtr<IMemoryStream> dictionary (value.asUnknown ());
+		take_shared<IMemoryStream> (compressionDictionary, dictionary);
 		return kResultOk;
 	}
 	else if(id == PackageOption::kExternalEncryptionKey)
@@ -196,6 +385,11 @@ tresult CCL_API FileArchive::getOption (Variant& value, StringID id) const
 		value = compressionLevel;
 		return kResultOk;
 	}
+	else if(id == PackageOption::kCompressionMethod)
+	{
+		value = compressionMethod;
+		return kResultOk;
+	}
 	else if(id == PackageOption::kThreadSafe)
 	{
 		value = getThreadSafety ();
@@ -266,7 +460,7 @@ bool FileArchive::createWithStream (IStream& stream)
 
 bool FileArchive::openFile (int mode)
 {
-	if(!SuperClass::openFile (mode))
+	if(!SuperClass::openFile (mode | IStream::kMapped)) // read directly from mapped memory if possible
 		return false;
 
 	ASSERT (file != nullptr)
@@ -324,6 +518,9 @@ int CCL_API FileArchive::embeddToFolder (UrlRef destPath, UrlRef sourcePath, int
 
 int CCL_API FileArchive::extractAll (UrlRef path, tbool deep, IUrlFilter* filter, IProgressNotify* progress)
 {
+	// lock sub-streams to decompress in parallel
+	ScopedVar<int> scope (threadSafety, getThreadSafety () == PackageOption::kThreadSafetyOff ? int(PackageOption::kThreadSafetyLocked) : getThreadSafety ());
+
 	return extractToFolder (path, deep != 0, filter, progress);
 }
 
@@ -335,6 +532,8 @@ int CCL_API FileArchive::extractFolder (UrlRef sourcePath, UrlRef destPath, tboo
 	if(!sourcePath.isFolder ())
 		return 0;
 
+	ScopedVar<int> scope (threadSafety, getThreadSafety () == PackageOption::kThreadSafetyOff ? int(PackageOption::kThreadSafetyLocked) : getThreadSafety ());
+
 	FileSystemItem* item = lookupItem (sourcePath);
 	return item ? extractToFolder (destPath, deep != 0, filter, progress, item) : 0;
 }
@@ -454,6 +653,12 @@ tbool CCL_API FileArchive::flush (IProgressNotify* progress)
 bool FileArchive::flushAll (IStream& dstStream, IProgressNotify* progress)
 {
 	getRoot ().removeDeleted ();
+
+	// compress local files ahead on all CPUs
+	PackQueue queue (*this);
+	queue.collect (getRoot ());
+	ScopedVar<PackQueue*> scope (packQueue, queue.count () >= PackQueue::kMinJobs ? &queue : nullptr);
+
 	bool result = flushFolderData (dstStream, getRoot (), progress);
 	getRoot ().removeDeleted (); // maybe some items failed to open while flushing
 	return result;
@@ -494,6 +699,8 @@ bool FileArchive::flushFolderData (IStream& dstStream, FolderItem& folder, IProg
 
 				fileItem->setWriter (nullptr); // release writer immediately to avoid circular references or use after free
 			}
+			else if(PackJob* job = packQueue ? packQueue->take (*fileItem) : nullptr)
+				result = writePackedData (dstStream, *fileItem, *job);
 			else
 				result = copyFileData (dstStream, *fileItem, progress);
 
@@ -520,13 +727,41 @@ bool FileArchive::flushFolderData (IStream& dstStream, FolderItem& folder, IProg
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool FileArchive::canPackConcurrently (FileStreamItem& fileItem) const
+{
+	// only local files without writer, data must be compressed to be worth it
+	return fileItem.getLocalPath () && !fileItem.getWriter () && fileItem.isCompressed () &&
+		   fileItem.getSizeOnDisk () <= PackQueue::kMaxFileSize;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool FileArchive::canExtractConcurrently () const
+{
+	return getThreadSafety () != PackageOption::kThreadSafetyOff;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FileArchive::applyCompressionDictionary (IDataTransformer* transformer) const
+{
+	if(compressionDictionary == nullptr)
+		return;
+
+	UnknownPtr<IDictionaryTransformer> dictionaryTransformer (transformer);
+	if(dictionaryTransformer)
+		dictionaryTransformer->setDictionary (compressionDictionary->getMemoryAddress (), compressionDictionary->getBytesWritten ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 SectionStream* FileArchive::openSectionStream (FileStreamItem& item)
 {
 	AutoPtr<IStream> file2;
 
 	// reopen original file if thread-safety is required!
 	if(getThreadSafety () == PackageOption::kThreadSafetyReopen)
-		file2 = System::GetFileSystem ().openStream (path);
+		file2 = System::GetFileSystem ().openStream (path, IStream::kOpenMode|IStream::kMapped);
 	else
 		file2.share (file);
 
@@ -788,6 +1023,43 @@ bool FileArchive::copyFileData (IStream& dstStream, FileStreamItem& fileItem, IP
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool FileArchive::writePackedData (IStream& dstStream, FileStreamItem& fileItem, PackJob& job)
+{
+	if(!job.isSucceeded ())
+		return false;
+
+	// update modification time
+	FileInfo info;
+	if(System::GetFileSystem ().getFileInfo (info, *fileItem.getLocalPath ()))
+		fileItem.setTime (info.modifiedTime);
+
+	// file header (optional)
+	int64 fileHeaderSize = beginFile (dstStream, fileItem);
+	if(fileHeaderSize == -1) // error
+		return false;
+
+	int64 fileDataOffset = dstStream.tell ();
+	if(!job.getData ()->writeTo (dstStream))
+		return false;
+
+	int64 fileDataSize = dstStream.tell () - fileDataOffset;
+
+	// update item (if something fails later the whole tree gets messed up!)
+	fileItem.setFileDataOffset (fileDataOffset);
+	fileItem.setFileDataSize   (fileDataSize);
+	fileItem.setFileSizeOnDisk (job.getSizeOnDisk ());
+	fileItem.setFileHeaderSize (fileHeaderSize);
+	fileItem.setCrc32 (job.getCrc32 ());
+
+	// unlink from local file
+	fileItem.unlinkLocalFile ();
+
+	// finish file
+	return endFile (dstStream, fileItem);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 BEGIN_METHOD_NAMES (FileArchive)
 	DEFINE_METHOD_NAME ("setOption")
 	DEFINE_METHOD_NAME ("create")
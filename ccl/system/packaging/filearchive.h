@@ -27,6 +27,8 @@ namespace CCL {
 namespace Threading {
 interface ILockable; }
 
+interface IMemoryStream;
+interface IDataTransformer;
 class SectionStream;
 
 //************************************************************************************************
@@ -52,6 +54,8 @@ public:
 	bool openWithStream (IStream& stream); ///< open archive from existing stream (read-only, can't be used with thread-safe option!)
 	bool createWithStream (IStream& stream);
 
+	static UIDRef getCompressionClass (int compressionMethod);
+
 	// IPackageFile
 	DELEGATE_FILERESOURCE_METHODS (FileStreamResource)
 	tresult CCL_API setOption (StringID id, VariantRef value) override;
@@ -72,12 +76,18 @@ protected:
 	Url* tempFolder;
 	bool isCreated;
 	float compressionLevel;
+	bool compressionLevelSet; ///< otherwise the codec default is used
+	int compressionMethod;
+	IMemoryStream* compressionDictionary;
 	bool failOnInvalidFile;
 	bool detailedProgressEnabled;
 	uint8 externalEncryptionKey[16];
 	Threading::ILockable* lock;
 
 	class ExternalArchiveReference;
+	class PackJob;
+	class PackQueue;
+	PackQueue* packQueue; ///< compresses file data in parallel during flushAll
 
 	void destruct (); ///< to be called by dtor of derived class
 	UrlRef getTempFolder ();
@@ -89,6 +99,9 @@ protected:
 	bool copyFileData (IStream& dstStream, FileStreamItem& fileItem, IProgressNotify* progress);
 	bool copyFileDataFromPackage (IStream& dstStream, FileStreamItem& fileItem, IProgressNotify* progress);
 	bool writeFileData (IStream& dstStream, FileStreamItem& fileItem, IProgressNotify* progress);
+	bool writePackedData (IStream& dstStream, FileStreamItem& fileItem, PackJob& job);
+	bool canPackConcurrently (FileStreamItem& fileItem) const;
+	void applyCompressionDictionary (IDataTransformer* transformer) const;
 
 	// Format-specific methods:
 	virtual bool readFormat (IStream& stream) = 0;
@@ -106,6 +119,7 @@ protected:
 
 	// FileTreeFileSystem overrides:
 	IStream* openDataStream (FileStreamItem& item, int mode, IUnknown* context) override;
+	bool canExtractConcurrently () const override;
 
 	// IObject
 	tbool CCL_API invokeMethod (Variant& returnValue, MessageRef msg) override;
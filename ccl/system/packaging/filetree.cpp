@@ -28,9 +28,51 @@
 #include "ccl/public/system/isysteminfo.h"
 #include "ccl/public/system/inativefilesystem.h"
 #include "ccl/public/system/ifileutilities.h"
+#include "ccl/public/system/imultiworker.h"
+#include "ccl/public/collections/vector.h"
 
 namespace CCL {
 
+//************************************************************************************************
+// ExtractJob
+/** Copies one file to the local file system, source stream is opened on the calling thread. */
+//************************************************************************************************
+
+struct ExtractJob: Threading::Work
+{
+	FileStreamItem* item;
+	Url dstPath;
+	AutoPtr<IStream> srcStream;
+	IProgressNotify* progress;
+	bool succeeded;
+
+	ExtractJob (FileStreamItem* item, UrlRef dstPath)
+	: item (item),
+	  dstPath (dstPath),
+	  progress (nullptr),
+	  succeeded (false)
+	{}
+
+	virtual ~ExtractJob () {}
+
+	// Work
+	void work () override
+	{
+		AutoPtr<IStream> dstStream = System::GetFileSystem ().openStream (dstPath, IStream::kCreateMode, nullptr/*no context!*/);
+
+		ASSERT (srcStream != nullptr && dstStream != nullptr)
+		if(srcStream && dstStream)
+		{
+			AutoPtr<IProgressNotify> subProgress = progress ? progress->createSubProgress () : nullptr;
+			int64 maxBytesToCopy = item->getSizeOnDisk ();
+			bool copied = System::GetFileUtilities ().copyStream (*dstStream, *srcStream, subProgress, maxBytesToCopy) != 0;
+			ASSERT (copied == true)
+			succeeded = copied;
+		}
+		srcStream.release ();
+	}
+};
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 // File Tree Storage Format
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -274,12 +316,9 @@ int FileTreeFileSystem::createFromFolder (UrlRef folderPath, int fileIteratorMod
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-int FileTreeFileSystem::extractToFolder (UrlRef folderPath, bool deep, IUrlFilter* filter, IProgressNotify* progress, FileSystemItem* current)
+static void collectExtractJobs (Vector<ExtractJob*>& jobs, FileTreeFileSystem& fileSystem, UrlRef folderPath, bool deep, IUrlFilter* filter, FileSystemItem* current)
 {
-	if(!current)
-		current = &getRoot ();
-
-	int count = 0;
+	bool folderCreated = false;
 	IterForEach (current->newIterator (), FileSystemItem, item)
 		if(item->isFolder ())
 		{
@@ -288,14 +327,14 @@ int FileTreeFileSystem::extractToFolder (UrlRef folderPath, bool deep, IUrlFilte
 				if(filter)
 				{
 					Url itemPath;
-					getItemUrl (itemPath, *item);
+					fileSystem.getItemUrl (itemPath, *item);
 					if(!filter->matches (itemPath))
 						continue;
 				}
 
 				Url subFolder (folderPath);
 				subFolder.descend (item->getFileName (), Url::kFolder);
-				count += extractToFolder (subFolder, true, filter, progress, item);
+				collectExtractJobs (jobs, fileSystem, subFolder, true, filter, item);
 			}
 		}
 		else if(item->isFile ())
@@ -303,37 +342,86 @@ int FileTreeFileSystem::extractToFolder (UrlRef folderPath, bool deep, IUrlFilte
 			if(filter)
 			{
 				Url itemPath;
-				getItemUrl (itemPath, *item);
+				fileSystem.getItemUrl (itemPath, *item);
 				if(!filter->matches (itemPath))
 					continue;
 			}
 
-			if(progress)
+			// create destination folder here, concurrent jobs would race creating the same folders
+			if(!folderCreated)
 			{
-				if(progress->isCanceled ())
-					break;
-
-				progress->updateAnimated (item->getFileName ());
+				System::GetFileSystem ().createFolder (folderPath);
+				folderCreated = true;
 			}
 
 			Url dstPath (folderPath);
 			dstPath.descend (item->getFileName ());
+			jobs.add (NEW ExtractJob ((FileStreamItem*)item, dstPath));
+		}
+	EndFor
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int FileTreeFileSystem::extractToFolder (UrlRef folderPath, bool deep, IUrlFilter* filter, IProgressNotify* progress, FileSystemItem* current)
+{
+	if(!current)
+		current = &getRoot ();
 
-			AutoPtr<IStream> srcStream = openDataStream (*(FileStreamItem*)item, IStream::kOpenMode, nullptr/*no context!*/);
-			AutoPtr<IStream> dstStream = System::GetFileSystem ().openStream (dstPath, IStream::kCreateMode, nullptr/*no context!*/);
+	Vector<ExtractJob*> jobs;
+	collectExtractJobs (jobs, *this, folderPath, deep, filter, current);
 
-			ASSERT (srcStream != nullptr && dstStream != nullptr)
-			if(srcStream && dstStream)
+	// decompress in parallel if sub-streams can be read concurrently
+	static const int kExtractBatchSize = 64;
+	AutoPtr<Threading::IMultiWorker> worker;
+	if(canExtractConcurrently () && jobs.count () > 1)
+		worker = System::CreateMultiThreadWorker ({System::GetSystem ().getNumberOfCPUs (), 0, Threading::kPriorityNormal, false, "PackageExtract"});
+
+	int count = 0;
+	bool canceled = false;
+	int batchSize = worker ? kExtractBatchSize : 1;
+	for(int start = 0; start < jobs.count () && !canceled; start += batchSize)
+	{
+		int end = ccl_min (start + batchSize, jobs.count ());
+		for(int i = start; i < end; i++)
+		{
+			ExtractJob* job = jobs[i];
+			if(progress)
 			{
-				AutoPtr<IProgressNotify> subProgress = progress ? progress->createSubProgress () : nullptr;
-				int64 maxBytesToCopy = item->getSizeOnDisk ();
-				bool copied = System::GetFileUtilities ().copyStream (*dstStream, *srcStream, subProgress, maxBytesToCopy) != 0;
-				ASSERT (copied == true)
-				if(copied)
-					count++;
+				if(progress->isCanceled ())
+				{
+					canceled = true;
+					end = i;
+					break;
+				}
+
+				progress->updateAnimated (job->item->getFileName ());
+			}
+
+			job->srcStream = openDataStream (*job->item, IStream::kOpenMode, nullptr/*no context!*/);
+			if(worker)
+				worker->push (job);
+			else
+			{
+				job->progress = progress;
+				job->work ();
 			}
 		}
-	EndFor
+
+		if(worker)
+			worker->work ();
+
+		for(int i = start; i < end; i++)
+			if(jobs[i]->succeeded)
+				count++;
+	}
+
+	if(worker)
+		worker->terminate ();
+
+	for(ExtractJob* job : jobs)
+		delete job;
+
 	return count;
 }
 
@@ -854,7 +942,9 @@ DEFINE_CLASS_HIDDEN (FolderItem, FileSystemItem)
 
 FolderItem::FolderItem ()
 : folderHeaderOffset (0)
-{}
+{
+	enableChildIndex (true); // archives can have many thousands of files per folder
+}
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
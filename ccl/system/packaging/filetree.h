@@ -211,6 +211,7 @@ protected:
 	RootFolderItem* rootItem;
 
 	virtual IStream* openDataStream (FileStreamItem& item, int mode, IUnknown* context) = 0;
+	virtual bool canExtractConcurrently () const { return false; } ///< data streams can be read by concurrent threads
 };
 
 //************************************************************************************************
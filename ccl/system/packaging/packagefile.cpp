@@ -350,6 +350,8 @@ IStream* PackageFile::createReadTransform (IStream& srcStream, FileStreamItem& i
 		ASSERT (decompressor != nullptr)
 		if(decompressor)
 		{
+			applyCompressionDictionary (decompressor);
+
 			IStream* inStream = transformStream ? transformStream : &srcStream;
 			IStream* outStream = System::CreateTransformStream (inStream, decompressor, false);
 			if(transformStream)
@@ -380,10 +382,12 @@ IStream* PackageFile::createWriteTransform (IStream& dstStream, FileStreamItem&
 		ASSERT (compressor != nullptr)
 		if(compressor)
 		{
-			// configure compression level
+			// configure compression level, codecs default to a fast level
 			UnknownPtr<IDataCompressor> dataCompressor (compressor);
 			ASSERT (dataCompressor != nullptr)
-			dataCompressor->setCompressionLevel (compressionLevel);
+			if(compressionLevelSet)
+				dataCompressor->setCompressionLevel (compressionLevel);
+			applyCompressionDictionary (compressor);
 
 			transformStream = System::CreateTransformStream (&dstStream, compressor, true);
 		}
@@ -160,6 +160,12 @@ tresult CCL_API ZipFile::setOption (StringID id, VariantRef value)
 		setEncrypted (value.asBool ());
 		return kResultOk;
 	}
+	else if(id == PackageOption::kCompressionMethod)
+	{
+		// ZIP entries are always deflated
+		if(value.asInt () != PackageOption::kCompressionZlib)
+			return kResultInvalidArgument;
+	}
 	return SuperClass::setOption (id, value);
 }
 
@@ -177,6 +183,14 @@ tresult CCL_API ZipFile::getOption (Variant& value, StringID id) const
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool ZipFile::canExtractConcurrently () const
+{
+	// local headers are read from the shared file when a sub-stream is opened, without locking
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 SectionStream* ZipFile::openSectionStream (FileStreamItem& item)
 {
 	AutoPtr<SectionStream> s = SuperClass::openSectionStream (item);
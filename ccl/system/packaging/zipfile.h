@@ -51,6 +51,7 @@ protected:
 	tresult CCL_API setOption (StringID id, VariantRef value) override;
 	tresult CCL_API getOption (Variant& value, StringID id) const override;
 	SectionStream* openSectionStream (FileStreamItem& item) override;
+	bool canExtractConcurrently () const override;
 	bool readFormat (IStream& stream) override;
 	bool writeFormat (IStream& stream, IProgressNotify* progress) override;
 	int64 beginFile (IStream& dstStream, FileStreamItem& item) override;
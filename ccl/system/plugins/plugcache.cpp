@@ -0,0 +1,360 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/system/plugins/plugcache.cpp
+// Description : Plugin Class Cache
+//
+//************************************************************************************************
+
+#define DEBUG_LOG 0
+
+#include "ccl/system/plugins/plugcache.h"
+
+#include "ccl/base/storage/file.h"
+#include "ccl/base/storage/settings.h"
+#include "ccl/base/storage/binaryarchive.h"
+
+#include "ccl/public/base/streamer.h"
+#include "ccl/public/base/memorystream.h"
+#include "ccl/public/collections/vector.h"
+#include "ccl/public/system/imultiworker.h"
+#include "ccl/public/system/ifileutilities.h"
+#include "ccl/public/system/isysteminfo.h"
+#include "ccl/public/systemservices.h"
+#include "ccl/public/textservices.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// PlugInCacheRecord
+//************************************************************************************************
+
+class PlugInCacheRecord: public Threading::Work
+{
+public:
+	PlugInCacheRecord (Attributes* attributes = nullptr, const char* data = nullptr, uint32 size = 0)
+	: succeeded (false),
+	  attributes (attributes),
+	  data (data),
+	  size (size)
+	{}
+
+	static constexpr CStringPtr kRootID = "Section";
+
+	PROPERTY_BOOL (succeeded, Succeeded)
+
+	// Work
+	void work () override
+	{
+		AutoPtr<MemoryStream> stream = NEW MemoryStream (const_cast<char*> (data), size);
+		BinaryArchive archive (*stream);
+		succeeded = archive.loadAttributes (kRootID, *attributes);
+	}
+
+protected:
+	Attributes* attributes;
+	const char* data;
+	uint32 size;
+};
+
+//************************************************************************************************
+// PlugInCacheEntry
+//************************************************************************************************
+
+struct PlugInCacheEntry
+{
+	String path;	///< settings section
+	uint32 offset = 0;	///< relative to end of index
+	uint32 size = 0;
+};
+
+} // namespace CCL
+
+using namespace CCL;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Format
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const DEFINE_FOURCC (kCacheID, 'p', 'l', 'u', 'g');
+static const ByteOrder kCacheByteOrder = kLittleEndian;
+static const int kMinParallelRecords = 64; ///< decode smaller caches on calling thread
+static const int kMinEntrySize = 3 * sizeof(int32); ///< path length, offset and size of index entry
+
+//************************************************************************************************
+// PlugInClassCache
+//************************************************************************************************
+
+StringRef PlugInClassCache::getExtension ()
+{
+	static const String kExtension ("plugcache");
+	return kExtension;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PlugInClassCache::getCachePath (Url& cachePath, UrlRef settingsPath)
+{
+	cachePath.assign (settingsPath);
+	cachePath.setExtension (getExtension (), true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PlugInClassCache::remove (StringRef name, bool anyLanguage)
+{
+	Url folder;
+	System::GetSystem ().getLocation (folder, System::kAppSettingsPlatformFolder);
+
+	if(anyLanguage)
+	{
+		String searchPattern;
+		searchPattern << name << "-*." << getExtension ();
+		ForEachFile (File::findFiles (folder, searchPattern, IFileIterator::kFiles), path)
+			System::GetFileSystem ().removeFile (*path);
+		EndFor
+	}
+	else
+	{
+		Url path (folder);
+		path.descend (name);
+		path.setExtension (getExtension (), true);
+		if(System::GetFileSystem ().fileExists (path))
+			System::GetFileSystem ().removeFile (path);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+PlugInClassCache::PlugInClassCache (UrlRef _settingsPath)
+: settingsPath (_settingsPath)
+{
+	getCachePath (cachePath, settingsPath);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PlugInClassCache::getStamp (Stamp& stamp) const
+{
+	FileInfo info;
+	if(!System::GetFileSystem ().getFileInfo (info, settingsPath))
+		return false;
+
+	stamp.modifiedTime = UnixTime::fromLocal (info.modifiedTime);
+	stamp.fileSize = info.fileSize;
+
+	// reading the file is much cheaper than parsing it
+	AutoPtr<IStream> file = System::GetFileSystem ().openStream (settingsPath, IStream::kOpenMode|IStream::kMapped);
+	if(file == nullptr)
+		return false;
+
+	AutoPtr<IMemoryStream> memory;
+	if(UnknownPtr<IMemoryStream> mapped = file.as_plain ())
+		memory.share (mapped);
+	else
+		memory = System::GetFileUtilities ().createStreamCopyInMemory (*file);
+	if(memory == nullptr || memory->getBytesWritten () != stamp.fileSize)
+		return false;
+
+	stamp.crc = System::Crc32 (memory->getMemoryAddress (), memory->getBytesWritten (), 0);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PlugInClassCache::restore (Settings& settings, Statistics* statistics)
+{
+	double startTime = System::GetProfileTime ();
+
+	AutoPtr<IStream> file = System::GetFileSystem ().openStream (cachePath, IStream::kOpenMode|IStream::kMapped);
+	if(file == nullptr)
+		return false;
+
+	// read directly from mapped memory if possible
+	AutoPtr<IMemoryStream> memory;
+	if(UnknownPtr<IMemoryStream> mapped = file.as_plain ())
+		memory.share (mapped);
+	else
+		memory = System::GetFileUtilities ().createStreamCopyInMemory (*file);
+	if(memory == nullptr)
+		return false;
+
+	const char* base = static_cast<const char*> (memory->getMemoryAddress ());
+	uint32 totalSize = memory->getBytesWritten ();
+	if(base == nullptr)
+		return false;
+
+	AutoPtr<MemoryStream> indexStream = NEW MemoryStream (const_cast<char*> (base), totalSize);
+	Streamer s (*indexStream, kCacheByteOrder);
+
+	FOURCC id = {0};
+	int32 version = 0;
+	Stamp savedStamp;
+	int32 count = 0;
+	if(!(s.read (id) && id == kCacheID && s.read (version) && version == kFormatVersion))
+		return false;
+	if(!(s.read (savedStamp.modifiedTime) && s.read (savedStamp.fileSize) && s.read (savedStamp.crc) && s.read (count)))
+		return false;
+
+	// each index entry takes at least a few bytes, don't trust count before allocating
+	if(count < 0 || count > (int64)(totalSize - indexStream->tell ()) / kMinEntrySize)
+		return false;
+
+	Stamp stamp;
+	if(!getStamp (stamp) || stamp != savedStamp)
+	{
+		CCL_PRINTLN ("Plug-in cache outdated")
+		return false;
+	}
+
+	// read and validate index...
+	Vector<PlugInCacheEntry> entries (count);
+	for(int i = 0; i < count; i++)
+	{
+		PlugInCacheEntry entry;
+		if(!(s.readWithLength (entry.path) && s.read (entry.offset) && s.read (entry.size)))
+			return false;
+		entries.add (entry);
+	}
+
+	// record offsets are relative to end of index
+	uint64 dataStart = (uint64)indexStream->tell ();
+	for(auto& entry : entries)
+		if(dataStart + entry.offset + entry.size > totalSize)
+			return false;
+
+	base += dataStart;
+
+	// ...prepare sections on calling thread...
+	settings.removeAll ();
+
+	Vector<PlugInCacheRecord> records (count);
+	for(auto& entry : entries)
+	{
+		Attributes& attributes = settings.getSection (entry.path)->getAttributes ();
+		records.add (PlugInCacheRecord (&attributes, base + entry.offset, entry.size));
+	}
+
+	//...and decode records in parallel
+	if(count >= kMinParallelRecords)
+	{
+		AutoPtr<Threading::IMultiWorker> worker = System::CreateMultiThreadWorker ({System::GetSystem ().getNumberOfCPUs (), 0, Threading::kPriorityHigh, false, "PlugInCache"});
+		for(int i = 0; i < count; i++)
+			worker->push (&records[i]);
+		worker->work ();
+		worker->terminate ();
+	}
+	else
+	{
+		for(int i = 0; i < count; i++)
+			records[i].work ();
+	}
+
+	int numFailed = 0;
+	for(int i = 0; i < count; i++)
+		if(!records[i].isSucceeded ())
+			numFailed++;
+
+	if(statistics)
+	{
+		statistics->numSections = count;
+		statistics->numFailed = numFailed;
+		statistics->loadTime = System::GetProfileTime () - startTime;
+	}
+
+	if(numFailed > 0)
+	{
+		CCL_PRINTF ("Plug-in cache: %d of %d records failed\n", numFailed, count)
+		settings.removeAll ();
+		return false;
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PlugInClassCache::store (const Settings& settings)
+{
+	Stamp stamp;
+	if(!getStamp (stamp))
+		return false;
+
+	// encode records...
+	Vector<PlugInCacheEntry> entries;
+	AutoPtr<MemoryStream> data = NEW MemoryStream;
+	AutoPtr<Iterator> iterator (settings.getSections ());
+	for(auto section : iterate_as<Settings::Section> (*iterator))
+	{
+		PlugInCacheEntry entry;
+		entry.path = section->getPath ();
+		entry.offset = (uint32)data->tell ();
+
+		BinaryArchive archive (*data);
+		if(!archive.saveAttributes (PlugInCacheRecord::kRootID, section->getAttributes ()))
+			return false;
+
+		entry.size = (uint32)data->tell () - entry.offset;
+		entries.add (entry);
+	}
+
+	// ...and write to temporary file first
+	Url tempPath (cachePath);
+	tempPath.setName ("tempcache");
+
+	bool result = false;
+	if(AutoPtr<IStream> file = System::GetFileSystem ().openStream (tempPath, IStream::kCreateMode))
+	{
+		Streamer s (*file, kCacheByteOrder);
+		result = s.write (kCacheID) && s.write ((int32)kFormatVersion)
+			&& s.write (stamp.modifiedTime) && s.write (stamp.fileSize) && s.write (stamp.crc) && s.write ((int32)entries.count ());
+		for(auto& entry : entries)
+			if(result)
+				result = s.writeWithLength (entry.path) && s.write (entry.offset) && s.write (entry.size);
+
+		if(result)
+			result = data->writeTo (*file);
+	}
+
+	String fileName;
+	cachePath.getName (fileName, true);
+	if(result)
+	{
+		if(System::GetFileSystem ().fileExists (cachePath))
+			System::GetFileSystem ().removeFile (cachePath);
+		result = System::GetFileSystem ().renameFile (tempPath, fileName) != 0;
+	}
+	else
+		System::GetFileSystem ().removeFile (tempPath);
+
+	return result;
+}
+
+//************************************************************************************************
+// PlugInSettings
+//************************************************************************************************
+
+PlugInSettings::PlugInSettings (StringRef name)
+: XmlSettings (name)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PlugInSettings::flush ()
+{
+	if(!XmlSettings::flush ())
+		return false;
+
+	if(!PlugInClassCache (getPath ()).store (*this))
+		CCL_WARN ("Failed to write plug-in class cache!\n", 0)
+	return true;
+}
@@ -0,0 +1,98 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/system/plugins/plugcache.h
+// Description : Plugin Class Cache
+//
+//************************************************************************************************
+
+#ifndef _ccl_plugcache_h
+#define _ccl_plugcache_h
+
+#include "ccl/base/storage/url.h"
+#include "ccl/base/storage/settings.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// PlugInClassCache
+/** Binary copy of the plug-in settings, written next to the XML file whenever it is flushed.
+	The XML file stays authoritative: the cache is only used if it was written for the current
+	version of the XML file (same size, modification time and CRC-32 of its content).
+
+	The file starts with an index of all sections, followed by one record per section encoded
+	with BinaryArchive. It is read from mapped memory, records are decoded in parallel. */
+//************************************************************************************************
+
+class PlugInClassCache
+{
+public:
+	PlugInClassCache (UrlRef settingsPath);
+
+	static const int kFormatVersion = 2;
+
+	/** Identifies the version of the XML file a cache was written for. */
+	struct Stamp
+	{
+		int64 modifiedTime = 0;
+		int64 fileSize = 0;
+		uint32 crc = 0;		///< detects rewrites within the resolution of the modification time
+
+		bool operator == (const Stamp& other) const { return modifiedTime == other.modifiedTime && fileSize == other.fileSize && crc == other.crc; }
+		bool operator != (const Stamp& other) const { return !(*this == other); }
+	};
+
+	/** Statistics of last restore. */
+	struct Statistics
+	{
+		int numSections = 0;
+		int numFailed = 0;
+		double loadTime = 0.;	///< in seconds
+	};
+
+	/** Replace content of settings with cached sections, fails if cache is missing or outdated. */
+	bool restore (Settings& settings, Statistics* statistics = nullptr);
+
+	/** Write all sections of settings, the XML file must have been flushed before. */
+	bool store (const Settings& settings);
+
+	/** Remove cache file(s) of given settings name. */
+	static void remove (StringRef name, bool anyLanguage);
+
+	static void getCachePath (Url& cachePath, UrlRef settingsPath);
+
+protected:
+	Url settingsPath;
+	Url cachePath;
+
+	static StringRef getExtension ();
+	bool getStamp (Stamp& stamp) const;
+};
+
+//************************************************************************************************
+// PlugInSettings
+/** XML settings keeping the plug-in class cache up to date, including auto-save. */
+//************************************************************************************************
+
+class PlugInSettings: public XmlSettings
+{
+public:
+	PlugInSettings (StringRef name);
+
+	// XmlSettings
+	bool flush () override;
+};
+
+} // namespace CCL
+
+#endif // _ccl_plugcache_h
@@ -30,6 +30,8 @@
 #include "ccl/public/system/isysteminfo.h"
 #include "ccl/public/system/ilogger.h"
 #include "ccl/public/system/inativefilesystem.h"
+#include "ccl/public/system/imultiworker.h"
+#include "ccl/public/collections/vector.h"
 #include "ccl/public/text/translation.h"
 
 using namespace CCL;
@@ -42,6 +44,31 @@ BEGIN_XSTRINGS ("PlugIns")
 	XSTRING (BlockListed, "%(1) has been blocked.")
 END_XSTRINGS
 
+//************************************************************************************************
+// PlugInCollection::ModuleProbe
+/** Information about a module gathered in a worker thread. */
+//************************************************************************************************
+
+struct PlugInCollection::ModuleProbe: Threading::Work
+{
+	PlugInCollection* collection;
+	Module* module;
+	String settingsID;
+	int64 moduleTime;
+
+	ModuleProbe (PlugInCollection* collection = nullptr, Module* module = nullptr)
+	: collection (collection),
+	  module (module),
+	  moduleTime (0)
+	{}
+
+	// Work
+	void work () override
+	{
+		collection->probeModule (settingsID, moduleTime, module);
+	}
+};
+
 //************************************************************************************************
 // PlugInCollection
 //************************************************************************************************
@@ -129,23 +156,94 @@ int PlugInCollection::scanFolder (UrlRef baseUrl, bool recursive, IProgressNotif
 {
 	if(!currentFolder)
 		currentFolder = &baseUrl;
-	
+
+	// find modules first...
+	ObjectList found;
+	found.objectCleanup ();
+	collectModules (found, baseUrl, recursive, progress);
+
+	// ...gather their settings IDs and modification times in parallel...
+	double startTime = System::GetProfileTime ();
+
+	Vector<ModuleProbe> probes (found.count ());
+	ForEach (found, Module, module)
+		probes.add (ModuleProbe (this, module));
+	EndFor
+
+	if(probes.count () >= kMinParallelProbes)
+	{
+		AutoPtr<Threading::IMultiWorker> worker = System::CreateMultiThreadWorker ({System::GetSystem ().getNumberOfCPUs (), 0, Threading::kPriorityHigh, false, "PlugInScan"});
+		for(auto& probe : probes)
+			worker->push (&probe);
+		worker->work ();
+		worker->terminate ();
+	}
+	else
+	{
+		for(auto& probe : probes)
+			probe.work ();
+	}
+
+	double probeTime = System::GetProfileTime ();
+
+	// ...and restore or register them in order of discovery (loading modules stays on this thread)
 	int total = 0;
+	for(auto& probe : probes)
+	{
+		if(progress && progress->isCanceled ())
+			break;
+
+		if(modules.contains (*probe.module))
+			continue;
+
+		if(scanModule (probe.settingsID, probe.moduleTime, probe.module))
+		{
+			probe.module->retain ();
+			modules.add (probe.module);
+			total++;
+		}
+
+		if(progress)
+			progress->updateAnimated ();
+	}
+
+	scanStatistics.numModules += probes.count ();
+	scanStatistics.probeTime += probeTime - startTime;
+	scanStatistics.mergeTime += System::GetProfileTime () - probeTime;
+
+	if(currentFolder == &baseUrl)
+		currentFolder = nullptr;
+
+	return total;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PlugInCollection::collectModules (ObjectList& found, UrlRef baseUrl, bool recursive, IProgressNotify* progress)
+{
 	int mode = recursive ? (IFileIterator::kAll | IFileIterator::kBundlesAsFiles) : IFileIterator::kFiles;
 
 	if(progress)
 		progress->updateAnimated (UrlDisplayString (baseUrl));
 
-	ForEachFile (System::GetFileSystem ().newIterator (baseUrl, mode), url)		
+	ForEachFile (System::GetFileSystem ().newIterator (baseUrl, mode), url)
 		if(url->isFile () || isModule (*url)) // could be a file or a folder
 		{
-			if(scanFile (*url))
-				total++;
+			if(isModule (*url))
+			{
+				CCL_PRINT ("Found module: ")
+				CCL_PRINTLN (url->getPath ())
+
+				Module* module = createModule (*url);
+				ASSERT (module != nullptr)
+				if(module)
+					found.add (module);
+			}
 		}
 		else if(url->isFolder ())
 		{
 			if(recursive)
-				total += scanFolder (*url, true);
+				collectModules (found, *url, true, nullptr);
 		}
 
 		if(progress)
@@ -155,11 +253,6 @@ int PlugInCollection::scanFolder (UrlRef baseUrl, bool recursive, IProgressNotif
 				break;
 		}
 	EndFor
-	
-	if(currentFolder == &baseUrl)
-		currentFolder = nullptr;
-
-	return total;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -305,15 +398,31 @@ bool PlugInCollection::restoreModuleTime (int64& moduleTime, StringRef settingsI
 bool PlugInCollection::scanModule (Module* module)
 {
 	String settingsID;
-	getSettingsID (settingsID, module);
-
 	int64 moduleTime = 0;
+	probeModule (settingsID, moduleTime, module);
+
+	return scanModule (settingsID, moduleTime, module);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PlugInCollection::probeModule (String& settingsID, int64& moduleTime, Module* module)
+{
+	getSettingsID (settingsID, module);
 	getModuleTime (moduleTime, module);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool PlugInCollection::scanModule (StringRef settingsID, int64 moduleTime, Module* module)
+{
 	// try to restore module information if not modified...
 
 	if(restoreModule (settingsID, moduleTime, module))
+	{
+		scanStatistics.numRestored++;
 		return true;
+	}
 
 	//...or register module and keep time stamp...
 
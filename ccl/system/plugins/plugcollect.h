@@ -60,6 +60,17 @@ public:
 	void restoreModules ();
 	void resetBlocklist ();
 
+	/** Scan statistics, accumulated over all folder scans. */
+	struct ScanStatistics
+	{
+		int numModules = 0;		///< number of modules found
+		int numRestored = 0;	///< number of modules restored from settings without loading them
+		double probeTime = 0.;	///< time spent probing modules in parallel (seconds)
+		double mergeTime = 0.;	///< time spent restoring or registering modules (seconds)
+	};
+
+	const ScanStatistics& getScanStatistics () const;
+
 protected:
 	String name;
 	ObjectList searchPaths;
@@ -67,8 +78,15 @@ protected:
 	const IUrl* currentFolder;
 	String blocklistName;
 	Settings* blocklist;
+	ScanStatistics scanStatistics;
+
+	static const int kMinParallelProbes = 8; ///< probe fewer modules on calling thread
+
+	struct ModuleProbe;
+	void collectModules (ObjectList& found, UrlRef baseUrl, bool recursive, IProgressNotify* progress);
 
 	bool scanModule (Module* module);
+	bool scanModule (StringRef settingsID, int64 moduleTime, Module* module);
 	bool restoreModule (StringRef settingsID, int64 moduleTime, Module* module);
 	void storeModuleTime (StringRef settingsID, int64 moduleTime);
 	bool restoreModuleTime (int64& moduleTime, StringRef settingsID);
@@ -83,6 +101,7 @@ protected:
 	virtual Module* createModule (UrlRef url) const;
 
 	virtual void getModuleTime (int64& modifiedTime, Module* module);
+	virtual void probeModule (String& settingsID, int64& moduleTime, Module* module); ///< called from worker threads
 	virtual bool restoreModuleInfo (StringRef settingsID, Module* module);
 	virtual bool registerModuleInfo (StringRef settingsID, Module* module);
 	virtual void registerModuleFailed (StringRef settingsID, Module* module);
@@ -100,6 +119,12 @@ protected:
 	bool addToBlocklist (StringRef settingsID);
 };
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// inline
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+inline const PlugInCollection::ScanStatistics& PlugInCollection::getScanStatistics () const { return scanStatistics; }
+
 } // namespace CCL
 
 #endif // _ccl_plugcollect_h
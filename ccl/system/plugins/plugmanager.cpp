@@ -32,6 +32,8 @@
 
 #include "ccl/public/text/stringbuilder.h"
 #include "ccl/public/text/translation.h"
+#include "ccl/public/text/itextstreamer.h"
+#include "ccl/public/base/memorystream.h"
 #include "ccl/public/base/irecognizer.h"
 #include "ccl/public/system/isearcher.h"
 #include "ccl/public/system/ilocalemanager.h"
@@ -987,6 +989,8 @@ const String PlugInManager::kBlocklistProtocol ("blocklist");
 PlugInManager::PlugInManager ()
 : PlugInCollection (CCLSTR ("Plugins"), CCLSTR ("PluginBlocklist")),
   settings (nullptr),
+  settingsFromCache (false),
+  settingsLoadTime (0.),
   currentLoader (nullptr),
   currentPathFilter (nullptr),
   keepDiscardable (false)
@@ -1921,11 +1925,17 @@ Settings& PlugInManager::getSettings ()
 	if(settings == nullptr)
 	{
 		// Note: Class attributes are language-dependent!
-		settings = NEW XmlSettings (XmlSettings::getNameWithLanguage (name));
+		settings = NEW PlugInSettings (XmlSettings::getNameWithLanguage (name));
 		settings->isPlatformSpecific (true);
 		settings->isAutoSaveEnabled (true);
 		settings->enableSignals (true);
-		settings->restore ();
+
+		// use binary cache if it matches the XML file
+		double startTime = System::GetProfileTime ();
+		settingsFromCache = PlugInClassCache (settings->getPath ()).restore (*settings, &cacheStatistics);
+		if(!settingsFromCache)
+			settings->restore ();
+		settingsLoadTime = System::GetProfileTime () - startTime;
 
 		// make sure all legacy local times are converted to UTC unix time
 		AutoPtr<Iterator> iterator (settings->getSections ());
@@ -1953,9 +1963,15 @@ void CCL_API PlugInManager::removeSettings (tbool anyLanguage)
 {
 	ASSERT (settings == nullptr) // must be called before classes are scanned!
 	if(anyLanguage)
+	{
 		XmlSettings::removeSettings (name, true, true);
+		PlugInClassCache::remove (name, true);
+	}
 	else
+	{
 		XmlSettings::removeSettings (XmlSettings::getNameWithLanguage (name), false, true);
+		PlugInClassCache::remove (XmlSettings::getNameWithLanguage (name), false);
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2314,7 +2330,7 @@ tresult CCL_API PlugInManager::setClassAttribute (const IClassDescription& descr
 
 int CCL_API PlugInManager::countDiagnosticData () const
 {
-	return 2;
+	return 3;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2335,6 +2351,13 @@ tbool CCL_API PlugInManager::getDiagnosticDescription (DiagnosticDescription& de
 		description.fileType = FileTypes::Xml ();
 		return true;
 	}
+	else if(index == 2)
+	{
+		description.categoryFlags = DiagnosticDescription::kPlugInInformation;
+		description.fileName = String () << name << "-Startup";
+		description.fileType = FileTypes::Text ();
+		return true;
+	}
 	return false;
 }
 
@@ -2354,6 +2377,30 @@ IStream* CCL_API PlugInManager::createDiagnosticData (int index)
 		blockList.isPlatformSpecific (true);
 		return System::GetFileSystem ().openStream (blockList.getPath (), IStream::kOpenMode | IStream::kShareWrite);
 	}
+	else if(index == 2)
+	{
+		AutoPtr<IStream> stream = NEW MemoryStream;
+		AutoPtr<ITextStreamer> streamer = System::CreateTextStreamer (*stream, {Text::kUTF8, Text::kSystemLineFormat});
+		if(streamer == nullptr)
+			return nullptr;
+
+		auto toMilliseconds = [] (double seconds) { return String ().appendFloatValue (seconds * 1000., 1) << " ms"; };
+
+		streamer->writeLine (String () << "Settings loaded from: " << (settingsFromCache ? "binary cache" : "XML"));
+		streamer->writeLine (String () << "Settings load time: " << toMilliseconds (settingsLoadTime));
+		if(settingsFromCache)
+		{
+			streamer->writeLine (String () << "Cached sections: " << cacheStatistics.numSections);
+			streamer->writeLine (String () << "Cache decode time: " << toMilliseconds (cacheStatistics.loadTime));
+		}
+
+		const ScanStatistics& statistics = getScanStatistics ();
+		streamer->writeLine (String () << "Modules found: " << statistics.numModules);
+		streamer->writeLine (String () << "Modules restored: " << statistics.numRestored);
+		streamer->writeLine (String () << "Module probe time: " << toMilliseconds (statistics.probeTime));
+		streamer->writeLine (String () << "Module register time: " << toMilliseconds (statistics.mergeTime));
+		return stream.detach ();
+	}
 	return nullptr;
 }
 
@@ -24,6 +24,7 @@
 #include "ccl/base/collections/objecthashtable.h"
 
 #include "ccl/system/plugins/plugcollect.h"
+#include "ccl/system/plugins/plugcache.h"
 
 #include "ccl/public/base/iextensible.h"
 #include "ccl/public/system/idiagnosticdataprovider.h"
@@ -265,7 +266,10 @@ protected:
 	ObjectList altClassMisses;
 	ObjectHashTable altClassMissTable;
 	ObjectHashTable instances;
-	Settings* settings;
+	PlugInSettings* settings;
+	bool settingsFromCache;
+	double settingsLoadTime;
+	PlugInClassCache::Statistics cacheStatistics;
 	ObjectList runtimeList;
 	ICodeResourceLoader* currentLoader;
 	IUrlFilter* currentPathFilter;
@@ -214,7 +214,12 @@ SignalHandler::CallbackMsg::CallbackMsg (CallbackFunction _callback, CallbackID
   id (_id),
   msg (_msg),
   time (_time),
-  waitable (waitable)
+  waitable (waitable),
+  sequence (0),
+  timerIndex (-1),
+  indexed (false),
+  deferredFlush (0),
+  pendingLink (this)
 {
 #if DEBUG_OBSERVERS
 	if(callback == changedCallback)
@@ -244,9 +249,11 @@ SignalHandler::CallbackMsg::~CallbackMsg ()
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-bool SignalHandler::CallbackMsg::isEqual (IMessage* other) const
-{ 
-	return msg && other ? msg->getID ().compare (other->getID ()) == 0 : msg == other;
+bool SignalHandler::CallbackMsg::isDueBefore (const CallbackMsg& other) const
+{
+	if(time != other.time)
+		return time < other.time;
+	return (int32)(sequence - other.sequence) < 0; // sequence numbers may wrap around
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -259,29 +266,31 @@ void SignalHandler::CallbackMsg::replace (IMessage* other)
 }
 
 //************************************************************************************************
-// SignalHandler::DelayMessageGuard - used in SignalHandler::flush to ensure cleanup in case of exceptions
+// SignalHandler::CallbackKey
 //************************************************************************************************
 
-struct SignalHandler::DelayMessageGuard
+SignalHandler::CallbackKey::CallbackKey (CallbackFunction callback, CallbackID id, IMessage* msg)
+: callback (callback),
+  id (id),
+  messageId (msg ? msg->getID ().str () : nullptr),
+  messageHash (CString (messageId).getHashCode ())
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SignalHandler::CallbackKey::operator == (const CallbackKey& other) const
 {
-	DelayMessageGuard (SignalHandler& signalHandler)
-	: signalHandler (signalHandler)
-	{
-		Threading::ScopedLock scopedLock (signalHandler.lock);
-		signalHandler.currentDelayedMessages.append (&delayedMessages);	
-	}
-	~DelayMessageGuard ()
-	{
-		Threading::ScopedLock scopedLock (signalHandler.lock);
-		while(!delayedMessages.isEmpty ())
-			signalHandler.callbackQueue.append (delayedMessages.removeFirst ());
-	
-		signalHandler.currentDelayedMessages.remove (&delayedMessages);
-	}
+	return callback == other.callback && id == other.id &&
+		   messageHash == other.messageHash && CString (messageId) == other.messageId;
+}
 
-	SignalHandler& signalHandler;
-	CallbackQueue delayedMessages;
-};
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int SignalHandler::CallbackKey::hash (const CallbackKey& key, int size)
+{
+	unsigned int h = key.messageHash * 31 + (unsigned int)ccl_hash_pointer (key.id, 0x7FFFFFFF);
+	return (int)(h % (unsigned int)size);
+}
 
 //************************************************************************************************
 // SignalHandler
@@ -320,7 +329,12 @@ void SignalHandler::messageCallback (CallbackID id, IMessage* msg)
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 SignalHandler::SignalHandler ()
-: currentMessage (nullptr)
+: timers (64, 64),
+  callbackIndex (kCallbackHashSize, CallbackKey::hash),
+  pendingMessages (kHashSize),
+  nextSequence (0),
+  currentFlush (0),
+  currentMessage (nullptr)
 {}
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -347,12 +361,25 @@ SignalHandler::~SignalHandler ()
 		}
 	}
 
-	ASSERT (callbackQueue.isEmpty () == true)
-	if(!callbackQueue.isEmpty ())
+	ASSERT (callbackQueue.isEmpty () == true && timers.isEmpty () == true)
+	if(!callbackQueue.isEmpty () || !timers.isEmpty ())
 	{
 		CCL_DEBUGGER ("[Signals] Callback queue not empty!\n")
 	}
 	#endif
+
+	#if DEBUG_LOG
+	CCL_PRINTF ("[Signals] max. queue length %d, %d callbacks coalesced, max. flush time %.3f ms\n",
+				statistics.maxQueueLength, (int)statistics.coalesced, statistics.maxFlushTime * 1000.)
+	#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+SignalHandler::Statistics SignalHandler::getStatistics ()
+{
+	Threading::ScopedLock scopedLock (lock);
+	return statistics;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -382,32 +409,230 @@ void SignalHandler::queueCallback (CallbackFunction callback, CallbackID id, IMe
 	CallbackMsg* msg = NEW CallbackMsg (callback, id, _msg, time, waitable);
 
 	Threading::ScopedLock scopedLock (lock);
-	callbackQueue.append (msg);
+	enqueue (msg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-void SignalHandler::cancelCallback (CallbackID id)
+void SignalHandler::enqueue (CallbackMsg* msg)
 {
-	Threading::ScopedLock scopedLock (lock);
+	// blocking messages are never coalesced, for other keys the first queued callback is used
+	if(!msg->waitable)
+	{
+		CallbackKey key (msg->getKey ());
+		if(!callbackIndex.contains (key))
+		{
+			callbackIndex.add (key, msg);
+			msg->indexed = true;
+		}
+	}
+
+	msg->sequence = nextSequence++;
+	if(msg->time > 0)
+		addTimer (msg);
+	else
+		callbackQueue.append (msg);
+
+	PendingList* pending = pendingMessages.lookup (msg->id);
+	if(pending == nullptr)
+	{
+		pending = NEW PendingList;
+		pendingMessages.add (msg->id, pending);
+	}
+	pending->append (&msg->pendingLink);
+
+	statistics.queueLength++;
+	if(statistics.queueLength > statistics.maxQueueLength)
+		statistics.maxQueueLength = statistics.queueLength;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SignalHandler::dequeue (CallbackMsg* msg)
+{
+	if(msg->timerIndex >= 0)
+		removeTimer (msg);
+	else
+		callbackQueue.remove (msg);
+
+	unregister (msg);
+}
 
-	ListForEach (callbackQueue, CallbackMsg*, msg)
-		if(msg->id == id)
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SignalHandler::unregister (CallbackMsg* msg)
+{
+	if(msg->indexed)
+	{
+		callbackIndex.remove (msg->getKey ());
+		msg->indexed = false;
+	}
+
+	PendingList* pending = pendingMessages.lookup (msg->id);
+	ASSERT (pending != nullptr)
+	if(pending)
+	{
+		pending->remove (&msg->pendingLink);
+		if(pending->isEmpty ())
 		{
-			callbackQueue.remove (msg);
-			delete msg;
+			pendingMessages.remove (msg->id);
+			delete pending;
 		}
+	}
+
+	statistics.queueLength--;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+SignalHandler::CallbackMsg* SignalHandler::findCallback (CallbackFunction callback, CallbackID id, IMessage* msg) const
+{
+	return callbackIndex.lookup (CallbackKey (callback, id, msg));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SignalHandler::replaceMessage (CallbackMsg* cbMsg, IMessage* msg)
+{
+	// the key refers to the message id, re-register it with the new message
+	ASSERT (cbMsg->indexed)
+	callbackIndex.remove (cbMsg->getKey ());
+	cbMsg->replace (msg);
+	callbackIndex.add (cbMsg->getKey (), cbMsg);
+
+	statistics.coalesced++;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SignalHandler::addTimer (CallbackMsg* msg)
+{
+	timers.add (msg);
+	setTimer (timers.count () - 1, msg);
+	moveTimer (msg->timerIndex);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SignalHandler::removeTimer (CallbackMsg* msg)
+{
+	int index = msg->timerIndex;
+	ASSERT (index >= 0 && index < timers.count () && timers[index] == msg)
+
+	CallbackMsg* last = timers.last ();
+	timers.removeLast ();
+	msg->timerIndex = -1;
+
+	if(last != msg)
+	{
+		setTimer (index, last);
+		moveTimer (index);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SignalHandler::setTimer (int index, CallbackMsg* msg)
+{
+	timers[index] = msg;
+	msg->timerIndex = index;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SignalHandler::moveTimer (int index)
+{
+	// restore heap order after the timer at index was added or its time has changed
+	CallbackMsg* msg = timers[index];
+	while(index > 0)
+	{
+		int parent = (index - 1) / 2;
+		if(!msg->isDueBefore (*timers[parent]))
+			break;
+		setTimer (index, timers[parent]);
+		index = parent;
+	}
+
+	int count = timers.count ();
+	while(1)
+	{
+		int child = 2 * index + 1;
+		if(child >= count)
+			break;
+		if(child + 1 < count && timers[child + 1]->isDueBefore (*timers[child]))
+			child++;
+		if(!timers[child]->isDueBefore (*msg))
+			break;
+		setTimer (index, timers[child]);
+		index = child;
+	}
+
+	setTimer (index, msg);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SignalHandler::queueDueTimers (int64 now)
+{
+	// messages deferred by the running flush stay in the heap
+	Vector<CallbackMsg*> deferred;
+	while(!timers.isEmpty () && timers[0]->time <= now)
+	{
+		CallbackMsg* msg = timers[0];
+		removeTimer (msg);
+		if(msg->deferredFlush == currentFlush)
+			deferred.add (msg);
+		else
+			callbackQueue.append (msg);
+	}
+
+	VectorForEach (deferred, CallbackMsg*, msg)
+		addTimer (msg);
 	EndFor
+}
 
-	ListForEach (currentDelayedMessages, CallbackQueue*, queue)
-		ListForEach (*queue, CallbackMsg*, msg)
-			if(msg->id == id)
-			{
-				queue->remove (msg);
-				delete msg;
-			}
-		EndFor
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+SignalHandler::CallbackMsg* SignalHandler::takeCallback (CallbackID id)
+{
+	PendingList* pending = pendingMessages.lookup (id);
+	if(pending == nullptr)
+		return nullptr;
+
+	IntrusiveListForEach (*pending, PendingLink, link)
+		if(link->msg->deferredFlush != currentFlush)
+		{
+			CallbackMsg* msg = link->msg;
+			dequeue (msg);
+			return msg;
+		}
 	EndFor
+	return nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SignalHandler::cancelCallback (CallbackID id)
+{
+	Threading::ScopedLock scopedLock (lock);
+
+	while(PendingList* pending = pendingMessages.lookup (id))
+	{
+		CallbackMsg* msg = pending->getFirst ()->msg;
+		dequeue (msg);
+		delete msg;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SignalHandler::deliver (CallbackMsg* msg)
+{
+	{
+		ScopedVar<CallbackMsg*> scope (currentMessage, msg);
+		msg->execute ();
+	}
+	delete msg;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -416,11 +641,7 @@ tbool CCL_API SignalHandler::messagesPending (IObserver* observer)
 {
 	Threading::ScopedLock scopedLock (lock);
 
-	ListForEach (callbackQueue, CallbackMsg*, msg)
-		if(msg->id == observer)
-			return true;
-	EndFor
-	return false;
+	return pendingMessages.lookup (observer) != nullptr;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -433,43 +654,68 @@ tresult CCL_API SignalHandler::flush (IObserver* observer)
 		return kResultWrongThread;
 	#endif
 
-	if(callbackQueue.isEmpty ())
+	if(statistics.queueLength == 0)
 		return kResultOk;
 
-	DelayMessageGuard guard (*this);
+	double startTime = System::GetProfileTime ();
 
-	while(1)
+	// messages posted while flushing are delivered in the same pass, except for delayed messages
+	// replacing the one being delivered, which would be delivered again and again otherwise
+	{
+		Threading::ScopedLock scopedLock (lock);
+		currentFlush++;
+	}
+
+	if(observer)
+	{
+		// deliver all messages for the observer regardless of their delay, in order of posting
+		while(1)
+		{
+			CallbackMsg* msg = nullptr;
+			{
+				Threading::ScopedLock scopedLock (lock);
+				msg = takeCallback (observer);
+			}
+			if(msg == nullptr)
+				break;
+
+			deliver (msg);
+		}
+	}
+	else
 	{
-		CallbackMsg* msg = nullptr;
+		// due timers are queued first and again when the queue runs empty
 		{
 			Threading::ScopedLock scopedLock (lock);
-			msg = callbackQueue.removeFirst ();
+			queueDueTimers (System::GetSystemTicks ());
 		}
-		if(msg == nullptr)
-			break;
 
-		if(observer && msg->id != observer)
-			guard.delayedMessages.append (msg);
-		else if(msg->time > 0)
+		while(1)
 		{
-			if(observer != nullptr || System::GetSystemTicks () >= msg->time)
+			CallbackMsg* msg = nullptr;
 			{
-				{
-					ScopedVar<CallbackMsg*> scope (currentMessage, msg);
-					msg->execute ();
-				}
-				delete msg;
+				Threading::ScopedLock scopedLock (lock);
+				if(callbackQueue.isEmpty ())
+					queueDueTimers (System::GetSystemTicks ());
+				msg = callbackQueue.removeFirst ();
+				if(msg)
+					unregister (msg);
 			}
-			else
-				guard.delayedMessages.append (msg);
-		}
-		else
-		{
-			msg->execute ();
-			delete msg;
+			if(msg == nullptr)
+				break;
+
+			deliver (msg);
 		}
 	}
 
+	double flushTime = System::GetProfileTime () - startTime;
+
+	Threading::ScopedLock scopedLock (lock);
+	statistics.flushCount++;
+	statistics.lastFlushTime = flushTime;
+	if(flushTime > statistics.maxFlushTime)
+		statistics.maxFlushTime = flushTime;
+
 	return kResultOk;
 }
 
@@ -567,15 +813,11 @@ tresult CCL_API SignalHandler::queueSignal (ISubject* subject, IMessage* msg)
 	if(list)
 	{
 		// check if message already exists...
-		ListForEach (callbackQueue, CallbackMsg*, cbMsg)
-			if(cbMsg->callback == signalCallback &&
-			   cbMsg->id == list && 
-			   cbMsg->isEqual (msg))
-			{
-				cbMsg->replace (msg);
-				return kResultOk;
-			}
-		EndFor
+		if(CallbackMsg* cbMsg = findCallback (signalCallback, list, msg))
+		{
+			replaceMessage (cbMsg, msg);
+			return kResultOk;
+		}
 	
 		queueCallback (signalCallback, list, msg);
 	}
@@ -606,7 +848,7 @@ tresult CCL_API SignalHandler::queueChanged (ISubject* subject)
 		if(shouldDumpQueue && !callbackQueue.isEmpty ())
 		{
 			Debugger::println ("*** Begin Callback Queue ***");
-			ListForEach (callbackQueue, CallbackMsg*, cbMsg)
+			IntrusiveListForEach (callbackQueue, CallbackMsg, cbMsg)
 				Debugger::print ("Observer: ");
 				Debugger::print (cbMsg->observerClass);
 				Debugger::print (" Message: ");
@@ -617,13 +859,11 @@ tresult CCL_API SignalHandler::queueChanged (ISubject* subject)
 		#endif
 
 		// check if message already exists...
-		ListForEach (callbackQueue, CallbackMsg*, cbMsg)
-			if(cbMsg->callback == changedCallback)
-			{
-				if(cbMsg->id == list)
-					return kResultOk;
-			}
-		EndFor
+		if(findCallback (changedCallback, list, nullptr))
+		{
+			statistics.coalesced++;
+			return kResultOk;
+		}
 	
 		queueCallback (changedCallback, list, nullptr);
 	}
@@ -667,42 +907,30 @@ tresult CCL_API SignalHandler::postMessage (IObserver* observer, IMessage* msg,
 		Threading::ScopedLock scopedLock (lock);
 
 		// check if message already exists...
-		ListForEach (callbackQueue, CallbackMsg*, cbMsg)
-			if(cbMsg->callback == messageCallback &&
-			   cbMsg->id == observer && 
-			   cbMsg->isEqual (msg))
+		if(CallbackMsg* cbMsg = findCallback (messageCallback, observer, msg))
+		{
+			replaceMessage (cbMsg, msg);
+
+			// update time, the message keeps its position in the pending list of the observer
+			cbMsg->time = time;
+			cbMsg->sequence = nextSequence++;
+			if(cbMsg->timerIndex >= 0)
+				moveTimer (cbMsg->timerIndex);
+			else
 			{
-				cbMsg->time = time; // <--- update time!!!
-				cbMsg->replace (msg);
-				return kResultOk;
+				callbackQueue.remove (cbMsg);
+				addTimer (cbMsg);
 			}
-		EndFor
-
-		ListForEach (currentDelayedMessages, CallbackQueue*, queue)
-			ListForEach (*queue, CallbackMsg*, cbMsg)
-				if(cbMsg->callback == messageCallback &&
-					cbMsg->id == observer && 
-					cbMsg->isEqual (msg))
-				{
-					cbMsg->time = time; // <--- update time!!!
-					cbMsg->replace (msg);
-					return kResultOk;
-				}
-			EndFor
-		EndFor
+			return kResultOk;
+		}
 
-		// when a delayed message is posted while flush () delivers a message with same ID and observer, avoid delivering the new message in the running loop
-		if(currentMessage && System::IsInMainThread () &&
-			currentMessage->id == observer &&
-			currentMessage->isEqual (msg))
+		// when a delayed message is posted while flush () delivers a message with same ID and observer, defer it to the next flush
+		if(System::IsInMainThread () && currentMessage && currentMessage->getKey () == CallbackKey (messageCallback, observer, msg))
 		{
-			if(CallbackQueue* currentDelayedQueue = currentDelayedMessages.getLast ())
-			{
-				// add the new message to the local list in DelayMessageGuard, so it will be appended after the flush loop
-				CallbackMsg* callbackMsg = NEW CallbackMsg (messageCallback, observer, msg, time, nullptr);
-				currentDelayedQueue->append (callbackMsg);
-				return kResultOk;
-			}
+			CallbackMsg* cbMsg = NEW CallbackMsg (messageCallback, observer, msg, time, nullptr);
+			cbMsg->deferredFlush = currentFlush;
+			enqueue (cbMsg);
+			return kResultOk;
 		}
 	}
 
@@ -27,6 +27,9 @@
 #include "ccl/public/system/threadsync.h"
 #include "ccl/public/system/isignalhandler.h"
 #include "ccl/public/collections/linkedlist.h"
+#include "ccl/public/collections/intrusivelist.h"
+#include "ccl/public/collections/hashmap.h"
+#include "ccl/public/collections/vector.h"
 
 namespace CCL {
 
@@ -83,6 +86,9 @@ protected:
 
 //************************************************************************************************
 // SignalHandler
+/** Queued callbacks are kept in a FIFO, delayed messages in a timer heap.
+	Coalescing signals and messages by (target, message id) is a hash lookup. In addition, pending
+	callbacks are listed per target in order of posting, for flushing and cancelling a single target. */
 //************************************************************************************************
 
 class SignalHandler: public Unknown,
@@ -92,6 +98,27 @@ public:
 	SignalHandler ();
 	~SignalHandler ();
 
+	struct Statistics
+	{
+		int queueLength;		///< queued and delayed callbacks
+		int maxQueueLength;
+		int64 coalesced;		///< callbacks merged into a queued one
+		int64 flushCount;
+		double lastFlushTime;	///< seconds
+		double maxFlushTime;
+
+		Statistics ()
+		: queueLength (0),
+		  maxQueueLength (0),
+		  coalesced (0),
+		  flushCount (0),
+		  lastFlushTime (0),
+		  maxFlushTime (0)
+		{}
+	};
+
+	Statistics getStatistics ();
+
 	// ISignalHandler
 	tresult CCL_API advise (ISubject* subject, IObserver* observer) override;
 	tresult CCL_API unadvise (ISubject* subject, IObserver* observer) override;
@@ -108,7 +135,7 @@ public:
 	CLASS_INTERFACE (ISignalHandler, Unknown)
 
 protected:
-	enum Constants { kHashSize = 512 };
+	enum Constants { kHashSize = 512, kCallbackHashSize = 4096 };
 
 	typedef void* CallbackID;
 	typedef void (*CallbackFunction) (CallbackID id, IMessage* msg);
@@ -122,13 +149,45 @@ protected:
 		{}
 	};
 
-	struct CallbackMsg
+	struct CallbackKey
+	{
+		CallbackFunction callback;
+		CallbackID id;
+		CStringPtr messageId;	///< owned by the queued message
+		unsigned int messageHash;
+
+		CallbackKey (CallbackFunction callback = nullptr, CallbackID id = nullptr, IMessage* msg = nullptr);
+
+		bool operator == (const CallbackKey& other) const;
+
+		static int hash (const CallbackKey& key, int size);
+	};
+
+	struct CallbackMsg;
+
+	struct PendingLink: IntrusiveLink<PendingLink>
+	{
+		CallbackMsg* msg;
+
+		PendingLink (CallbackMsg* msg)
+		: msg (msg)
+		{}
+	};
+
+	typedef IntrusiveLinkedList<PendingLink> PendingList;
+
+	struct CallbackMsg: IntrusiveLink<CallbackMsg>
 	{
 		CallbackFunction callback;
 		CallbackID id;
 		IMessage* msg;
 		int64 time;
 		SharedPtr<Waitable> waitable;
+		uint32 sequence;	///< orders timers with equal time
+		int timerIndex;		///< position in timer heap, -1 if in queue
+		bool indexed;		///< registered for coalescing
+		uint32 deferredFlush;	///< flush pass that must not deliver the message
+		PendingLink pendingLink;
 
 		#if DEBUG_OBSERVERS
 		MutableCString observerClass;
@@ -138,18 +197,22 @@ protected:
 		CallbackMsg (CallbackFunction callback, CallbackID id, IMessage* msg, int64 time, Waitable* waitable);
 		~CallbackMsg ();
 
-		bool isEqual (IMessage* other) const;
+		CallbackKey getKey () const { return CallbackKey (callback, id, msg); }
+		bool isDueBefore (const CallbackMsg& other) const;
 		void replace (IMessage* other);
 		void execute () { callback (id, msg); }
 	};
 
 	Threading::CriticalSection lock;
 	LinkedList<ObserverList*> buckets[kHashSize];
-	typedef LinkedList<CallbackMsg*> CallbackQueue;
-	CallbackQueue callbackQueue;
-	LinkedList<CallbackQueue*> currentDelayedMessages;  ///< points to local variables in flush ()
-	CallbackMsg* currentMessage;
-	struct DelayMessageGuard;
+	IntrusiveLinkedList<CallbackMsg> callbackQueue;
+	Vector<CallbackMsg*> timers;						///< binary min-heap of delayed messages
+	HashMap<CallbackKey, CallbackMsg*> callbackIndex;	///< coalescing index
+	PointerHashMap<PendingList*> pendingMessages;		///< queued callbacks per id, in order of posting
+	uint32 nextSequence;
+	uint32 currentFlush;
+	CallbackMsg* currentMessage;						///< delivered by flush (), main thread only
+	Statistics statistics;
 
 	int hash (ISubject* subject) const;
 	ObserverList* lookup (ISubject* subject) const;
@@ -157,6 +220,21 @@ protected:
 	void cancelCallback (CallbackID id);
 	tbool CCL_API messagesPending (IObserver* observer) override;
 
+	// called with lock held
+	CallbackMsg* findCallback (CallbackFunction callback, CallbackID id, IMessage* msg) const;
+	void enqueue (CallbackMsg* msg);
+	void dequeue (CallbackMsg* msg);
+	void unregister (CallbackMsg* msg);
+	void replaceMessage (CallbackMsg* msg, IMessage* other);
+	void addTimer (CallbackMsg* msg);
+	void removeTimer (CallbackMsg* msg);
+	void moveTimer (int index);
+	void setTimer (int index, CallbackMsg* msg);
+	void queueDueTimers (int64 now);
+	CallbackMsg* takeCallback (CallbackID id);
+
+	void deliver (CallbackMsg* msg);
+
 	static void signalCallback (CallbackID id, IMessage* msg);
 	static void changedCallback (CallbackID id, IMessage* msg);
 	static void messageCallback (CallbackID id, IMessage* msg);
@@ -0,0 +1,101 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : loggertest.cpp
+// Description : Logger Unit Tests
+//
+//************************************************************************************************
+
+#include "ccl/base/unittest.h"
+
+#include "ccl/system/logger.h"
+
+#include "ccl/public/system/logging.h"
+#include "ccl/public/systemservices.h"
+
+using namespace CCL;
+
+//************************************************************************************************
+// SlowReporter
+//************************************************************************************************
+
+class SlowReporter: public Unknown,
+					public Alert::IReporter
+{
+public:
+	Threading::AtomicInt count;
+
+	// Alert::IReporter
+	void CCL_API reportEvent (const Alert::Event& e) override
+	{
+		System::ThreadSleep (1);
+		count.increment ();
+	}
+
+	void CCL_API setReportOptions (Severity minSeverity, int eventFormat) override {}
+
+	CLASS_INTERFACE (IReporter, Unknown)
+};
+
+//************************************************************************************************
+// LoggerTest
+//************************************************************************************************
+
+CCL_TEST (LoggerTest, TestAsyncMode)
+{
+	static const int kNumEvents = 200;
+
+	// private instance, events reported to the global logger must not interfere
+	AutoPtr<Logger> logger = NEW Logger;
+	SlowReporter reporter;
+	logger->addOutput (&reporter);
+	CCL_TEST_ASSERT (logger->setAsyncMode (true, 64, System::IAsyncLogger::kDropEvent) == kResultOk);
+	CCL_TEST_ASSERT (logger->isAsyncMode ());
+
+	double startTime = System::GetProfileTime ();
+	for(int i = 0; i < kNumEvents; i++)
+		logger->reportEvent (Alert::Event (kSeverityTrace, String ().appendFormat ("AsyncLoggerTest %(1)", i)));
+	double duration = System::GetProfileTime () - startTime;
+
+	logger->flush ();
+
+	System::AsyncLoggerStatistics statistics;
+	logger->getAsyncStatistics (statistics);
+
+	CCL_TEST_ASSERT_EQUAL (0, statistics.queueDepth);
+	CCL_TEST_ASSERT_EQUAL (kNumEvents, statistics.numQueued + statistics.numDropped);
+	CCL_TEST_ASSERT_EQUAL (statistics.numQueued, reporter.count.getValue ());
+
+	logger->setAsyncMode (false);
+	CCL_TEST_ASSERT_FALSE (logger->isAsyncMode ());
+	logger->removeOutput (&reporter);
+
+	Logging::debugf ("AsyncLogger: %d events in %.2f ms, %d dropped, max. queue depth %d\n", kNumEvents, duration * 1000., statistics.numDropped, statistics.maxQueueDepth);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (LoggerTest, TestSyncMode)
+{
+	AutoPtr<Logger> logger = NEW Logger;
+	SlowReporter reporter;
+	logger->addOutput (&reporter);
+	CCL_TEST_ASSERT_FALSE (logger->isAsyncMode ());
+
+	// events are delivered before reportEvent returns
+	for(int i = 0; i < 10; i++)
+		logger->reportEvent (Alert::Event (kSeverityTrace, "LoggerTest"));
+	CCL_TEST_ASSERT_EQUAL (10, reporter.count.getValue ());
+
+	logger->removeOutput (&reporter);
+}
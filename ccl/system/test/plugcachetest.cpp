@@ -0,0 +1,176 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : plugcachetest.cpp
+// Description : Plug-in Class Cache Unit Tests
+//
+//************************************************************************************************
+
+#include "ccl/base/unittest.h"
+
+#include "ccl/system/plugins/plugcache.h"
+
+#include "ccl/base/storage/url.h"
+#include "ccl/base/storage/attributes.h"
+
+#include "ccl/public/base/memorystream.h"
+#include "ccl/public/system/isysteminfo.h"
+#include "ccl/public/system/ifileutilities.h"
+#include "ccl/public/system/inativefilesystem.h"
+#include "ccl/public/text/stringbuilder.h"
+#include "ccl/public/systemservices.h"
+
+using namespace CCL;
+
+//************************************************************************************************
+// PlugInCacheTest
+//************************************************************************************************
+
+class PlugInCacheTest: public Test
+{
+public:
+	static const int kNumSections = 100;
+
+	// Test
+	void setUp () override
+	{
+		System::GetSystem ().getLocation (folder, System::kTempFolder);
+		folder.descend (UIDString::generate (), IUrl::kFolder);
+		System::GetFileSystem ().createFolder (folder);
+
+		settingsPath = folder;
+		settingsPath.descend ("plugins.xml", IUrl::kFile);
+		PlugInClassCache::getCachePath (cachePath, settingsPath);
+	}
+
+	void tearDown () override
+	{
+		System::GetFileSystem ().removeFolder (folder, IFileSystem::kDeleteRecursively);
+	}
+
+protected:
+	Url folder;
+	Url settingsPath;
+	Url cachePath;
+
+	void fillSettings (Settings& settings, StringRef name)
+	{
+		for(int i = 0; i < kNumSections; i++)
+		{
+			String path;
+			path << "Classes/" << i;
+			Attributes& a = settings.getAttributes (path);
+			a.setAttribute ("name", name);
+			a.setAttribute ("index", i);
+		}
+	}
+
+	bool isEqualSettings (const Settings& s1, const Settings& s2)
+	{
+		for(int i = 0; i < kNumSections; i++)
+		{
+			String path;
+			path << "Classes/" << i;
+			Settings::Section* section1 = const_cast<Settings&> (s1).getSection (path, false);
+			Settings::Section* section2 = const_cast<Settings&> (s2).getSection (path, false);
+			if(section1 == nullptr || section2 == nullptr)
+				return false;
+			if(section1->getAttributes ().getString ("name") != section2->getAttributes ().getString ("name"))
+				return false;
+			if(section1->getAttributes ().getInt ("index") != section2->getAttributes ().getInt ("index"))
+				return false;
+		}
+		return true;
+	}
+
+	bool restoreFromCache ()
+	{
+		XmlSettings restored;
+		restored.setPath (settingsPath);
+		return PlugInClassCache (settingsPath).restore (restored);
+	}
+
+	bool patchCache (int offset, int32 value)
+	{
+		AutoPtr<IStream> file = System::GetFileSystem ().openStream (cachePath, IStream::kOpenMode);
+		AutoPtr<IMemoryStream> memory = file ? System::GetFileUtilities ().createStreamCopyInMemory (*file) : nullptr;
+		file.release ();
+		if(memory == nullptr || (int)memory->getBytesWritten () < offset + (int)sizeof(int32))
+			return false;
+
+		char* data = static_cast<char*> (memory->getMemoryAddress ());
+		for(int i = 0; i < (int)sizeof(int32); i++)
+			data[offset + i] = (char)((value >> (8 * i)) & 0xFF); // little endian
+
+		file = System::GetFileSystem ().openStream (cachePath, IStream::kCreateMode);
+		return file && file->write (data, memory->getBytesWritten ()) == (int)memory->getBytesWritten ();
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST_F (PlugInCacheTest, TestRoundTrip)
+{
+	PlugInSettings settings (nullptr);
+	settings.setPath (settingsPath);
+	fillSettings (settings, "First");
+
+	// flushing the XML file writes the cache
+	CCL_TEST_ASSERT (settings.flush ());
+	CCL_TEST_ASSERT (System::GetFileSystem ().fileExists (cachePath));
+
+	XmlSettings restored;
+	restored.setPath (settingsPath);
+	PlugInClassCache::Statistics statistics;
+	CCL_TEST_ASSERT (PlugInClassCache (settingsPath).restore (restored, &statistics));
+	CCL_TEST_ASSERT_EQUAL (0, statistics.numFailed);
+	CCL_TEST_ASSERT (statistics.numSections >= kNumSections);
+	CCL_TEST_ASSERT (isEqualSettings (settings, restored));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST_F (PlugInCacheTest, TestInvalidation)
+{
+	PlugInSettings settings (nullptr);
+	settings.setPath (settingsPath);
+	fillSettings (settings, "First");
+	CCL_TEST_ASSERT (settings.flush ());
+	CCL_TEST_ASSERT (restoreFromCache ());
+
+	// XML rewritten without updating the cache, same size and possibly within the same second
+	XmlSettings other;
+	other.setPath (settingsPath);
+	fillSettings (other, "Other");
+	CCL_TEST_ASSERT (other.flush ());
+	CCL_TEST_ASSERT_FALSE (restoreFromCache ());
+
+	// auto-save refreshes the cache
+	CCL_TEST_ASSERT (settings.flush ());
+	CCL_TEST_ASSERT (restoreFromCache ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST_F (PlugInCacheTest, TestCorruptCount)
+{
+	PlugInSettings settings (nullptr);
+	settings.setPath (settingsPath);
+	fillSettings (settings, "First");
+	CCL_TEST_ASSERT (settings.flush ());
+
+	// id, version, modified time, file size, crc
+	static const int kCountOffset = 4 + 4 + 8 + 8 + 4;
+	CCL_TEST_ASSERT (patchCache (kCountOffset, 0x7FFFFFFF));
+	CCL_TEST_ASSERT_FALSE (restoreFromCache ());
+}
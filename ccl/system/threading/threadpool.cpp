@@ -24,6 +24,7 @@
 
 #include "ccl/public/systemservices.h"
 #include "ccl/public/system/isysteminfo.h"
+#include "ccl/public/base/smartptr.h"
 
 using namespace CCL;
 using namespace Threading;
@@ -44,10 +45,198 @@ CCL_EXPORT IThreadPool& System::CCL_ISOLATED (GetThreadPool) ()
 
 CCL_EXPORT IThreadPool* System::CCL_ISOLATED (CreateThreadPool) (const ThreadPoolDescription& description)
 {
+	int idleTimeout = description.idleTimeout >= 0 ? description.idleTimeout : ThreadPool::kDefaultTimeout;
+	if(description.scheduler == kWorkStealingScheduler)
+		return NEW WorkStealingThreadPool (description.maxThreadCount, description.priority, description.name, idleTimeout);
+
 	return NEW ThreadPool (description.maxThreadCount,
 						   description.priority, 
 						   description.name,
-						   description.idleTimeout >= 0 ? description.idleTimeout : ThreadPool::kDefaultTimeout);
+						   idleTimeout);
+}
+
+//************************************************************************************************
+// WorkItemQueue
+//************************************************************************************************
+
+WorkItemQueue::WorkItemQueue ()
+: numItems (0)
+{
+	for(int p = 0; p < kNumWorkPriorities; p++)
+		numDeadlineItems[p] = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int WorkItemQueue::count (WorkPriority priority) const
+{
+	return items[priority].count () + numDeadlineItems[priority];
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int WorkItemQueue::getTopPriority () const
+{
+	// deadline items are sorted by deadline, not by priority class
+	for(int p = kNumWorkPriorities - 1; p >= 0; p--)
+		if(!items[p].isEmpty () || numDeadlineItems[p] > 0)
+			return p;
+	return -1;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+WorkPriority WorkItemQueue::add (IWorkItem* item, int64 now)
+{
+	Entry entry;
+	entry.item = item;
+	entry.enqueueTime = now;
+
+	UnknownPtr<IPrioritizedWorkItem> prioritizedItem (item);
+	if(prioritizedItem)
+	{
+		entry.priority = ccl_bound<WorkPriority> (prioritizedItem->getWorkPriority (), 0, kNumWorkPriorities - 1);
+		entry.deadline = prioritizedItem->getDeadline ();
+	}
+
+	if(entry.deadline != 0)
+	{
+		deadlineItems.addSorted (entry);
+		numDeadlineItems[entry.priority]++;
+	}
+	else
+		items[entry.priority].append (entry);
+	numItems++;
+	return entry.priority;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IWorkItem* WorkItemQueue::take (const Entry& entry, int64 now, WorkPriority* priority)
+{
+	Counters& c = counters[entry.priority];
+	int64 waitTime = now - entry.enqueueTime;
+	c.numStarted++;
+	c.totalWaitTime += waitTime;
+	if(waitTime > c.maxWaitTime)
+		c.maxWaitTime = waitTime;
+	if(entry.deadline != 0)
+	{
+		numDeadlineItems[entry.priority]--;
+		if(now > entry.deadline)
+			c.numDeadlinesMissed++;
+	}
+
+	if(priority)
+		*priority = entry.priority;
+	numItems--;
+	return entry.item;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IWorkItem* WorkItemQueue::takeNext (int64 now, bool newest, WorkPriority* priority)
+{
+	if(numItems == 0)
+		return nullptr;
+
+	// items close to their deadline first
+	if(!deadlineItems.isEmpty () && deadlineItems.getFirst ().deadline - now <= kDeadlineLeadTime)
+		return take (deadlineItems.removeFirst (), now, priority);
+
+	int topPriority = getTopPriority ();
+
+	// promote items waiting too long in a lower priority class, oldest first
+	int starvingPriority = -1;
+	for(int p = 0; p < topPriority; p++)
+	{
+		if(items[p].isEmpty ())
+			continue;
+
+		const Entry& oldest = items[p].getFirst ();
+		if(now - oldest.enqueueTime < kStarvationTimeout * (topPriority - p))
+			continue;
+
+		if(starvingPriority == -1 || oldest.enqueueTime < items[starvingPriority].getFirst ().enqueueTime)
+			starvingPriority = p;
+	}
+	if(starvingPriority != -1)
+		return take (items[starvingPriority].removeFirst (), now, priority);
+
+	// items with a deadline compete with others of the same priority class, earliest deadline first
+	if(numDeadlineItems[topPriority] > 0)
+	{
+		ListForEach (deadlineItems, Entry, entry)
+			if(entry.priority == topPriority)
+			{
+				deadlineItems.remove (entry);
+				return take (entry, now, priority);
+			}
+		EndFor
+	}
+
+	LinkedList<Entry>& list = items[topPriority];
+	return take (newest ? list.removeLast () : list.removeFirst (), now, priority);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IWorkItem* WorkItemQueue::remove (WorkID id, WorkPriority* priority)
+{
+	auto removeFrom = [&] (LinkedList<Entry>& list) -> IWorkItem*
+	{
+		ListForEach (list, Entry, entry)
+			if(entry.item->getID () == id)
+			{
+				list.remove (entry);
+				numItems--;
+				if(entry.deadline != 0)
+					numDeadlineItems[entry.priority]--;
+				if(priority)
+					*priority = entry.priority;
+				return entry.item;
+			}
+		EndFor
+		return nullptr;
+	};
+
+	for(int p = 0; p < kNumWorkPriorities; p++)
+		if(IWorkItem* item = removeFrom (items[p]))
+			return item;
+	return removeFrom (deadlineItems);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WorkItemQueue::removeAll ()
+{
+	auto releaseAll = [] (LinkedList<Entry>& list)
+	{
+		ListForEach (list, Entry, entry)
+			entry.item->release ();
+		EndFor
+		list.removeAll ();
+	};
+
+	for(int p = 0; p < kNumWorkPriorities; p++)
+		releaseAll (items[p]);
+	releaseAll (deadlineItems);
+	for(int p = 0; p < kNumWorkPriorities; p++)
+		numDeadlineItems[p] = 0;
+	numItems = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WorkItemQueue::addStatistics (WorkQueueStatistics& statistics, WorkPriority priority) const
+{
+	const Counters& c = counters[priority];
+	statistics.queueDepth += count (priority);
+	statistics.numStarted += c.numStarted;
+	statistics.numDeadlinesMissed += c.numDeadlinesMissed;
+	statistics.totalWaitTime += c.totalWaitTime;
+	if(c.maxWaitTime > statistics.maxWaitTime)
+		statistics.maxWaitTime = c.maxWaitTime;
 }
 
 //************************************************************************************************
@@ -86,9 +275,7 @@ void CCL_API ThreadPool::terminate ()
 
 		// there shouldn't be items queued any more, but anyway...
 		ASSERT (workItems.isEmpty () == true)
-		ListForEach (workItems, IWorkItem*, item)
-			item->release ();
-		EndFor
+		workItems.removeAll ();
 	}
 
 	// ensure that all threads are ready to exit
@@ -171,7 +358,7 @@ void CCL_API ThreadPool::scheduleWork (IWorkItem* item)
 		return;
 	
 	// add item to queue
-	workItems.append (item);
+	workItems.add (item, System::GetSystemTicks ());
 
 	// try to find a free worker
 	ListForEach (workerThreads, WorkerThread*, thread)
@@ -214,14 +401,11 @@ void CCL_API ThreadPool::cancelWork (WorkID id, tbool force)
 		return;
 
 	// check if item is still in work queue
-	ListForEach (workItems, IWorkItem*, item)
-		if(item->getID () == id)
-		{
-			workItems.remove (item);
-			item->release ();
-			return;
-		}
-	EndFor
+	if(IWorkItem* item = workItems.remove (id))
+	{
+		item->release ();
+		return;
+	}
 
 	if(force)
 	{
@@ -248,11 +432,8 @@ void CCL_API ThreadPool::cancelAll ()
 	if(poolTerminated)
 		return;
 
-	// check if item is still in work queue
-	ListForEach (workItems, IWorkItem*, item)
-		workItems.remove (item);
-		item->release ();
-	EndFor
+	// remove items still in work queue
+	workItems.removeAll ();
 
 	// check if item is currently handled by a thread
 	ListForEach (workerThreads, WorkerThread*, thread)
@@ -357,11 +538,24 @@ void CCL_API ThreadPool::reduceThreads (tbool force)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+tresult CCL_API ThreadPool::getQueueStatistics (WorkQueueStatistics& statistics, WorkPriority priority) const
+{
+	if(priority < 0 || priority >= kNumWorkPriorities)
+		return kResultInvalidArgument;
+
+	ScopedLock scopedLock (theLock);
+	statistics = WorkQueueStatistics ();
+	workItems.addStatistics (statistics, priority);
+	return kResultOk;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 bool ThreadPool::beginWork (WorkerThread& thread)
 {
 	ScopedLock scopedLock (theLock);
 
-	IWorkItem* item = workItems.removeFirst ();
+	IWorkItem* item = workItems.takeNext (System::GetSystemTicks ());
 	thread.setCurrentWork (item);
 	return item != nullptr;
 }
@@ -387,6 +581,476 @@ void ThreadPool::executePeriodic (int64 now)
 	EndFor
 }
 
+//************************************************************************************************
+// WorkStealingThreadPool
+//************************************************************************************************
+
+WorkStealingThreadPool::WorkStealingThreadPool (int maxThreadCount, ThreadPriority priority, StringID name, int idleTimeout)
+: ThreadPool (maxThreadCount, priority, name, idleTimeout),
+  queues (nullptr),
+  idleThreads (maxThreadCount)
+{
+	if(this->maxThreadCount < 1)
+		this->maxThreadCount = 1;
+	queues = NEW WorkQueue[this->maxThreadCount];
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+WorkStealingThreadPool::~WorkStealingThreadPool ()
+{
+	terminate ();
+	delete [] queues;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API WorkStealingThreadPool::terminate ()
+{
+	{
+		ScopedLock scopedLock (theLock);
+		if(poolTerminated) // already terminated
+			return;
+
+		poolTerminated = 1;
+
+		// there shouldn't be items queued any more, but anyway...
+		ASSERT (pendingCount == 0)
+		for(int i = 0; i < maxThreadCount; i++)
+			removeQueuedItems (queues[i]);
+
+		// cancel work in progress, workers block in endWork() until we are done
+		for(int i = 0; i < maxThreadCount; i++)
+		{
+			WorkQueue& queue = queues[i];
+			ScopedLock workerLock (queue.workerLock);
+			if(queue.worker && queue.worker->getCurrentWork ())
+			{
+				queue.worker->getCurrentWork ()->cancel ();
+				queue.worker->waitWorkFinished ();
+			}
+		}
+	}
+
+	// now we can exit our worker threads safely
+	ListForEach (workerThreads, WorkerThread*, thread)
+		{
+			ScopedLock workerLock (queues[thread->getQueueIndex ()].workerLock);
+			queues[thread->getQueueIndex ()].worker = nullptr;
+		}
+		thread->exit ();
+	EndFor
+	workerThreads.removeAll ();
+	threadCount = 0;
+
+	{
+		ScopedLock scopedLock (idleLock);
+		idleThreads.removeAll ();
+		idleCount = 0;
+	}
+
+	// exit timer thread
+	if(timerThread)
+		timerThread->exit (),
+		timerThread = nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API WorkStealingThreadPool::getQueueStatistics (WorkQueueStatistics& statistics, WorkPriority priority) const
+{
+	if(priority < 0 || priority >= kNumWorkPriorities)
+		return kResultInvalidArgument;
+
+	statistics = WorkQueueStatistics ();
+	for(int i = 0; i < maxThreadCount; i++)
+	{
+		ScopedLock scopedLock (queues[i].lock);
+		queues[i].items.addStatistics (statistics, priority);
+	}
+	return kResultOk;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+WorkerThread* WorkStealingThreadPool::spawnThread ()
+{
+	ASSERT (threadCount < maxThreadCount)
+
+	int queueIndex = -1;
+	for(int i = 0; i < maxThreadCount; i++)
+		if(queues[i].worker == nullptr)
+		{
+			queueIndex = i;
+			break;
+		}
+
+	ASSERT (queueIndex != -1)
+	if(queueIndex == -1)
+		return nullptr;
+
+	int cpuIndex = threadCount % cpuCount;
+	WorkerThread* thread = NEW WorkerThread (*this, name, cpuIndex);
+	thread->setQueueIndex (queueIndex);
+	{
+		ScopedLock workerLock (queues[queueIndex].workerLock);
+		queues[queueIndex].worker = thread;
+	}
+	workerThreads.append (thread);
+	++threadCount;
+	return thread;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API WorkStealingThreadPool::allocateThreads (int minCount)
+{
+	ScopedLock scopedLock (theLock);
+
+	minThreadCount = ccl_min (minCount, maxThreadCount);
+	while(threadCount < minThreadCount)
+	{
+		WorkerThread* thread = spawnThread ();
+		if(thread == nullptr)
+			break;
+		thread->start ();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+WorkerThread* WorkStealingThreadPool::popIdleThread ()
+{
+	if(idleCount == 0)
+		return nullptr;
+
+	ScopedLock scopedLock (idleLock);
+	if(idleThreads.isEmpty ())
+		return nullptr;
+
+	// most recently idle thread first, its cache is still warm
+	WorkerThread* thread = idleThreads.last ();
+	idleThreads.removeLast ();
+	thread->setIdle (false);
+	thread->setIdleTime (0);
+	--idleCount;
+	return thread;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingThreadPool::pushWork (int queueIndex, IWorkItem* item)
+{
+	int64 now = System::GetSystemTicks ();
+	WorkQueue& queue = queues[queueIndex];
+	ScopedLock scopedLock (queue.lock);
+	WorkPriority priority = queue.items.add (item, now);
+	++queue.count;
+	++pendingCountByPriority[priority];
+	++pendingCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingThreadPool::removeQueuedItems (WorkQueue& queue)
+{
+	ScopedLock scopedLock (queue.lock);
+	for(int p = 0; p < kNumWorkPriorities; p++)
+		pendingCountByPriority[p] -= queue.items.count (p);
+	pendingCount -= queue.items.count ();
+	queue.items.removeAll ();
+	queue.count = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API WorkStealingThreadPool::scheduleWork (IWorkItem* item)
+{
+	ASSERT (!poolTerminated) // should not happen, we are already in dtor!
+	if(poolTerminated)
+	{
+		item->release ();
+		return;
+	}
+
+	// hand item directly to an idle thread
+	if(WorkerThread* thread = popIdleThread ())
+	{
+		pushWork (thread->getQueueIndex (), item);
+		thread->signal ();
+		return;
+	}
+
+	// spawn new thread if limit not reached yet
+	if(threadCount < maxThreadCount)
+	{
+		ScopedLock scopedLock (theLock);
+		if(threadCount < maxThreadCount && !poolTerminated)
+		{
+			WorkerThread* thread = spawnThread ();
+			if(thread)
+			{
+				pushWork (thread->getQueueIndex (), item);
+				thread->start ();
+				return;
+			}
+		}
+	}
+
+	// all threads busy, distribute round-robin, the first thread running out of work will grab it
+	int queueIndex = (unsigned int)nextQueue.increment () % (unsigned int)maxThreadCount;
+	pushWork (queueIndex, item);
+
+	// a thread might have become idle in the meantime
+	if(WorkerThread* thread = popIdleThread ())
+		thread->signal ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool WorkStealingThreadPool::takeWork (WorkerThread& thread)
+{
+	if(pendingCount == 0)
+		return false;
+
+	// prefer queues holding the highest priority class pending in the whole pool
+	int topPriority = kNumWorkPriorities - 1;
+	while(topPriority > 0 && pendingCountByPriority[topPriority] == 0)
+		topPriority--;
+
+	int64 now = System::GetSystemTicks ();
+	int ownIndex = thread.getQueueIndex ();
+	for(int minPriority : {topPriority, 0})
+	{
+		for(int i = 0; i < maxThreadCount; i++)
+			if(takeWork (thread, (ownIndex + i) % maxThreadCount, minPriority, now))
+				return true;
+
+		if(minPriority == 0)
+			break;
+	}
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool WorkStealingThreadPool::takeWork (WorkerThread& thread, int queueIndex, int minPriority, int64 now)
+{
+	int ownIndex = thread.getQueueIndex ();
+	WorkQueue& queue = queues[queueIndex];
+	if(queue.count == 0)
+		return false;
+
+	ScopedLock scopedLock (queue.lock);
+	if(queue.items.getTopPriority () < minPriority)
+		return false;
+
+	ScopedLock workerLock (queues[ownIndex].workerLock);
+	if(queues[ownIndex].worker != &thread) // thread is about to exit, leave item to others
+		return false;
+
+	// take oldest item from own queue, steal newest item from other queues
+	WorkPriority priority = kWorkPriorityNormal;
+	IWorkItem* item = queue.items.takeNext (now, queueIndex != ownIndex, &priority);
+	if(item == nullptr)
+		return false;
+
+	--queue.count;
+	--pendingCountByPriority[priority];
+	--pendingCount;
+	thread.setCurrentWork (item);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool WorkStealingThreadPool::beginWork (WorkerThread& thread)
+{
+	// leave the idle set before picking up work, a thread woken by a stale signal might still be
+	// registered and must not be stopped by reduceThreads() while running an item
+	{
+		ScopedLock scopedLock (idleLock);
+		if(thread.isIdle () && idleThreads.remove (&thread))
+		{
+			thread.setIdle (false);
+			--idleCount;
+		}
+	}
+
+	if(takeWork (thread))
+		return true;
+
+	// register as idle before checking again, scheduleWork() either sees us or we see its item
+	{
+		ScopedLock scopedLock (idleLock);
+		if(!thread.isIdle ())
+		{
+			// stopped by reduceThreads() in the meantime
+			ScopedLock workerLock (queues[thread.getQueueIndex ()].workerLock);
+			if(queues[thread.getQueueIndex ()].worker != &thread)
+				return false;
+
+			thread.setIdle (true);
+			idleThreads.add (&thread);
+			++idleCount;
+		}
+	}
+
+	if(takeWork (thread))
+	{
+		ScopedLock scopedLock (idleLock);
+		if(thread.isIdle () && idleThreads.remove (&thread))
+		{
+			thread.setIdle (false);
+			--idleCount;
+		}
+		return true;
+	}
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingThreadPool::endWork (WorkerThread& thread)
+{
+	ScopedLock scopedLock (queues[thread.getQueueIndex ()].workerLock);
+
+	thread.setCurrentWork (nullptr);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API WorkStealingThreadPool::cancelWork (WorkID id, tbool force)
+{
+	ASSERT (!poolTerminated) // should not happen, we are already in dtor!
+	if(poolTerminated)
+		return;
+
+	// check if item is still in a work queue
+	for(int i = 0; i < maxThreadCount; i++)
+	{
+		WorkQueue& queue = queues[i];
+		if(queue.count == 0)
+			continue;
+
+		ScopedLock scopedLock (queue.lock);
+		WorkPriority priority = kWorkPriorityNormal;
+		if(IWorkItem* item = queue.items.remove (id, &priority))
+		{
+			--queue.count;
+			--pendingCountByPriority[priority];
+			--pendingCount;
+			item->release ();
+			return;
+		}
+	}
+
+	// items leave a queue and become current work atomically, so we can't miss it here
+	if(force)
+	{
+		for(int i = 0; i < maxThreadCount; i++)
+		{
+			WorkQueue& queue = queues[i];
+			ScopedLock workerLock (queue.workerLock);
+			IWorkItem* item = queue.worker ? queue.worker->getCurrentWork () : nullptr;
+			if(item && item->getID () == id)
+			{
+				item->cancel ();
+				queue.worker->waitWorkFinished ();
+				return;
+			}
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API WorkStealingThreadPool::cancelAll ()
+{
+	ASSERT (!poolTerminated) // should not happen, we are already in dtor!
+	if(poolTerminated)
+		return;
+
+	for(int i = 0; i < maxThreadCount; i++)
+	{
+		WorkQueue& queue = queues[i];
+		removeQueuedItems (queue);
+
+		ScopedLock workerLock (queue.workerLock);
+		IWorkItem* item = queue.worker ? queue.worker->getCurrentWork () : nullptr;
+		if(item)
+		{
+			item->cancel ();
+			queue.worker->waitWorkFinished ();
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API WorkStealingThreadPool::reduceThreads (tbool force)
+{
+	// don't check that often
+	int64 now = System::GetSystemTicks ();
+	if(!force && lastReduceTime && (now - lastReduceTime < 5000))
+		return;
+
+	ScopedLock scopedLock (theLock);
+	lastReduceTime = now = System::GetSystemTicks (); // update after entering lock
+
+	// don't stop anything as long as there's work to do
+	if(!force && pendingCount > 0)
+		return;
+
+	// only threads registered as idle can be stopped, they can't be picked by scheduleWork() afterwards
+	LinkedList<WorkerThread*> exitThreads;
+	{
+		ScopedLock idleScope (idleLock);
+		for(int i = idleThreads.count () - 1; i >= 0; i--)
+		{
+			WorkerThread* thread = idleThreads[i];
+			if(!force && thread->getIdleTime () == 0)
+			{
+				thread->setIdleTime (now);
+				continue;
+			}
+
+			if(force || now - thread->getIdleTime () >= threadIdleTimeout)
+			{
+				// detach from queue while holding the idle lock, the thread can't take work afterwards
+				WorkQueue& queue = queues[thread->getQueueIndex ()];
+				ScopedLock workerLock (queue.workerLock);
+				if(thread->getCurrentWork ()) // took an item after registering as idle
+					continue;
+
+				queue.worker = nullptr;
+				idleThreads.removeAt (i);
+				thread->setIdle (false);
+				--idleCount;
+				exitThreads.append (thread);
+			}
+		}
+	}
+
+	ListForEach (exitThreads, WorkerThread*, thread)
+		workerThreads.remove (thread);
+		thread->exit ();
+		--threadCount;
+	EndFor
+
+	// work might have been queued for a stopped thread in the meantime
+	if(pendingCount > 0)
+	{
+		if(WorkerThread* thread = popIdleThread ())
+			thread->signal ();
+		else if(threadCount == 0)
+		{
+			if(WorkerThread* thread = spawnThread ())
+				thread->start ();
+		}
+	}
+}
+
 //************************************************************************************************
 // WorkerThread
 //************************************************************************************************
@@ -399,11 +1063,13 @@ int CCL_API WorkerThread::run (void* arg)
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 WorkerThread::WorkerThread (ThreadPool& pool, StringID name, int cpuIndex)
-: pool (pool),
-  cpuIndex (cpuIndex),
+: started (false),
   currentWork (nullptr),
   idleTime (0),
-  started (false)
+  queueIndex (-1),
+  idle (false),
+  pool (pool),
+  cpuIndex (cpuIndex)
 {
 	thread = System::CreateNativeThread ({run, name.isEmpty () ? "WorkerThread" : name.str (), this});
 	thread->setPriority (pool.getThreadPriority ());
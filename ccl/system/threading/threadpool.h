@@ -24,6 +24,7 @@
 #include "ccl/public/system/threadsync.h"
 #include "ccl/public/system/ithreadpool.h"
 #include "ccl/public/collections/linkedlist.h"
+#include "ccl/public/collections/vector.h"
 
 namespace CCL {
 namespace Threading {
@@ -31,12 +32,80 @@ namespace Threading {
 class WorkerThread;
 class TimerThread;
 
+//************************************************************************************************
+// WorkItemQueue
+/** Work items ordered by priority class and deadline (not thread-safe). */
+//************************************************************************************************
+
+class WorkItemQueue
+{
+public:
+	WorkItemQueue ();
+
+	enum Timing
+	{
+		kDeadlineLeadTime = 5,			///< items with a deadline closer than this (in ms) are urgent
+		kStarvationTimeout = 1000		///< items waiting longer than this (in ms per priority class below top) are promoted
+	};
+
+	bool isEmpty () const { return numItems == 0; }
+	int count () const { return numItems; }
+	int count (WorkPriority priority) const;
+
+	/** Get highest priority class of queued items, -1 if empty. */
+	int getTopPriority () const;
+
+	/** Add item, queue takes ownership. Returns priority class of item. */
+	WorkPriority add (IWorkItem* item, int64 now);
+	
+	/** Take next item to be executed, 'newest' selects the most recent item of the chosen priority class. */
+	IWorkItem* takeNext (int64 now, bool newest = false, WorkPriority* priority = nullptr);
+	
+	/** Remove item with given identifier, caller takes ownership. */
+	IWorkItem* remove (WorkID id, WorkPriority* priority = nullptr);
+	
+	/** Release all items. */
+	void removeAll ();
+
+	/** Accumulate statistics for given priority class. */
+	void addStatistics (WorkQueueStatistics& statistics, WorkPriority priority) const;
+
+protected:
+	struct Entry
+	{
+		IWorkItem* item = nullptr;
+		WorkPriority priority = kWorkPriorityNormal;
+		int64 enqueueTime = 0;
+		int64 deadline = 0;
+
+		bool operator == (const Entry& other) const { return item == other.item; }
+		bool operator > (const Entry& other) const { return deadline > other.deadline; }
+	};
+
+	struct Counters
+	{
+		int numStarted = 0;
+		int numDeadlinesMissed = 0;
+		int64 totalWaitTime = 0;
+		int64 maxWaitTime = 0;
+	};
+
+	LinkedList<Entry> items[kNumWorkPriorities];
+	LinkedList<Entry> deadlineItems; ///< sorted by deadline
+	int numDeadlineItems[kNumWorkPriorities]; ///< deadline items per priority class
+	Counters counters[kNumWorkPriorities];
+	int numItems;
+
+	IWorkItem* take (const Entry& entry, int64 now, WorkPriority* priority);
+};
+
 //************************************************************************************************
 // ThreadPool
 //************************************************************************************************
 
 class ThreadPool: public Unknown,
-				  public IThreadPool
+				  public IThreadPool,
+				  public IThreadPoolStatistics
 {
 public:
 	enum Defaults { kDefaultTimeout = 10 * 1000 };
@@ -61,14 +130,17 @@ public:
 	void CCL_API reduceThreads (tbool force) override;
 	void CCL_API terminate () override;
 
+	// IThreadPoolStatistics
+	tresult CCL_API getQueueStatistics (WorkQueueStatistics& statistics, WorkPriority priority) const override;
+
 	// internal methods used by WorkerThread
-	bool beginWork (WorkerThread& thread);
-	void endWork (WorkerThread& thread);
+	virtual bool beginWork (WorkerThread& thread);
+	virtual void endWork (WorkerThread& thread);
 
 	// called by TimerThread
 	void executePeriodic (int64 now);
 
-	CLASS_INTERFACE (IThreadPool, Unknown)
+	CLASS_INTERFACE2 (IThreadPool, IThreadPoolStatistics, Unknown)
 
 protected:
 	int cpuCount;
@@ -78,9 +150,9 @@ protected:
 	int64 lastReduceTime;
 	AtomicInt threadCount;
 	AtomicInt poolTerminated;
-	CriticalSection theLock;
+	mutable CriticalSection theLock;
 	MutableCString name;
-	LinkedList<IWorkItem*> workItems;
+	WorkItemQueue workItems;
 	LinkedList<WorkerThread*> workerThreads;
 
 	CriticalSection periodicLock;
@@ -88,6 +160,58 @@ protected:
 	TimerThread* timerThread;
 };
 
+//************************************************************************************************
+// WorkStealingThreadPool
+/** Thread pool with one work queue per worker thread. 
+	Idle threads steal work from the queues of busy threads, new work wakes a single idle thread. */
+//************************************************************************************************
+
+class WorkStealingThreadPool: public ThreadPool
+{
+public:
+	WorkStealingThreadPool (int maxThreadCount = 5, 
+							ThreadPriority priority = kPriorityBelowNormal,
+							StringID name = "ThreadPool",
+							int idleTimeout = kDefaultTimeout);
+	~WorkStealingThreadPool ();
+
+	// ThreadPool
+	void CCL_API allocateThreads (int minCount) override;
+	void CCL_API scheduleWork (IWorkItem* item) override;
+	void CCL_API cancelWork (WorkID id, tbool force = false) override;
+	void CCL_API cancelAll () override;
+	void CCL_API reduceThreads (tbool force) override;
+	void CCL_API terminate () override;
+	tresult CCL_API getQueueStatistics (WorkQueueStatistics& statistics, WorkPriority priority) const override;
+	bool beginWork (WorkerThread& thread) override;
+	void endWork (WorkerThread& thread) override;
+
+protected:
+	struct WorkQueue
+	{
+		mutable CriticalSection lock;
+		WorkItemQueue items;
+		AtomicInt count;
+		CriticalSection workerLock; ///< guards worker and its current work item
+		WorkerThread* worker = nullptr;
+	};
+
+	WorkQueue* queues;
+	AtomicInt nextQueue;
+	AtomicInt pendingCount;
+	AtomicInt pendingCountByPriority[kNumWorkPriorities];
+	AtomicInt idleCount;
+	CriticalSection idleLock;
+	Vector<WorkerThread*> idleThreads;
+
+	WorkerThread* spawnThread (); ///< theLock must be held
+	WorkerThread* popIdleThread ();
+	void pushWork (int queueIndex, IWorkItem* item);
+	bool takeWork (WorkerThread& thread);
+	bool takeWork (WorkerThread& thread, int queueIndex, int minPriority, int64 now);
+	void removeQueuedItems (WorkQueue& queue);
+};
+
 //************************************************************************************************
 // WorkerThread
 //************************************************************************************************
@@ -101,6 +225,8 @@ public:
 	PROPERTY_BOOL (started, Started)
 	PROPERTY_POINTER (IWorkItem, currentWork, CurrentWork)
 	PROPERTY_VARIABLE (int64, idleTime, IdleTime)
+	PROPERTY_VARIABLE (int, queueIndex, QueueIndex) ///< used by WorkStealingThreadPool
+	PROPERTY_BOOL (idle, Idle) ///< used by WorkStealingThreadPool
 
 	void start ();
 	void signal ();
@@ -17,6 +17,7 @@
 //************************************************************************************************
 
 #include "ccl/base/unittest.h"
+#include "ccl/base/message.h"
 
 #include "ccl/app/params.h"
 #include "ccl/app/controls/usercontrol.h"
@@ -25,6 +26,7 @@
 #include "ccl/public/gui/framework/idialogbuilder.h"
 #include "ccl/public/gui/framework/isprite.h"
 #include "ccl/public/gui/framework/iclipboard.h"
+#include "ccl/public/gui/framework/iitemmodel.h"
 #include "ccl/public/gui/framework/iprogressdialog.h"
 #include "ccl/public/gui/graphics/dpiscale.h"
 #include "ccl/public/gui/graphics/igraphics.h"
@@ -87,6 +89,37 @@ CCL_TEST (GUITestSuite, TestParam)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+CCL_TEST (GUITestSuite, TestParamMemberPerformance)
+{
+	static const int kNumCalls = 1000000;
+	static CStringPtr propertyNames[] = {"type", "value", "min", "max", "default", "enabled", "signalAlways", "reverse", "unknown"};
+	static const int kNumNames = ARRAY_COUNT (propertyNames);
+
+	AutoPtr<IntParam> param = NEW IntParam (0, 100, "test");
+	IObject* object = param;
+
+	Variant value;
+	int found = 0;
+	double startTime = System::GetProfileTime ();
+	for(int i = 0; i < kNumCalls; i++)
+		if(object->getProperty (value, propertyNames[i % kNumNames]))
+			found++;
+	double duration = System::GetProfileTime () - startTime;
+	CCL_TEST_ASSERT_EQUAL (found, kNumCalls - kNumCalls / kNumNames);
+	Logging::debugf ("Parameter::getProperty: %.0f calls/s\n", kNumCalls / duration);
+
+	startTime = System::GetProfileTime ();
+	for(int i = 0; i < kNumCalls; i++)
+		object->invokeMethod (value, Message ("getNormalized"));
+	duration = System::GetProfileTime () - startTime;
+	Logging::debugf ("Parameter::invokeMethod: %.0f calls/s\n", kNumCalls / duration);
+
+	CCL_TEST_ASSERT (object->setProperty ("value", 42));
+	CCL_TEST_ASSERT (object->getProperty (value, "value") && value.asInt () == 42);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 CCL_TEST (GUITestSuite, TestDpiScale)
 {
 	Rect r1, r2, r3;
@@ -138,3 +171,48 @@ CCL_TEST (GUITestSuite, TestDpiScale)
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (GUITestSuite, TestItemRangeSelection)
+{
+	AutoPtr<IItemSelection> selection = ccl_new<IItemSelection> (ClassID::ItemRangeSelection);
+	UnknownPtr<IItemRangeSelection> rangeSelection (selection);
+	CCL_TEST_ASSERT (rangeSelection.isValid ());
+	if(!rangeSelection)
+		return;
+
+	rangeSelection->selectRange (0, 199999);
+	CCL_TEST_ASSERT_EQUAL (rangeSelection->countIndices (), 200000);
+	CCL_TEST_ASSERT (selection->isSelected (ItemIndex (123456)));
+	CCL_TEST_ASSERT (!selection->isSelected (ItemIndex (200000)));
+
+	// split and merge
+	rangeSelection->unselectRange (10, 19);
+	CCL_TEST_ASSERT (!selection->isSelected (ItemIndex (15)));
+	CCL_TEST_ASSERT_EQUAL (rangeSelection->countIndices (), 199990);
+	CCL_TEST_ASSERT (selection->unselect (ItemIndex (5)));
+	CCL_TEST_ASSERT (!selection->unselect (ItemIndex (5)));
+	selection->select (ItemIndex (5));
+	rangeSelection->selectRange (19, 10);
+	CCL_TEST_ASSERT_EQUAL (rangeSelection->countIndices (), 200000);
+
+	int numRuns = 0;
+	AutoPtr<IItemRangeIterator> iter = rangeSelection->newRangeIterator ();
+	int first = 0, last = 0;
+	while(iter->next (first, last))
+		numRuns++;
+	CCL_TEST_ASSERT_EQUAL (numRuns, 1);
+	CCL_TEST_ASSERT (first == 0 && last == 199999);
+
+	// item iteration
+	selection->unselectAll ();
+	CCL_TEST_ASSERT (selection->isEmpty ());
+	rangeSelection->selectRange (3, 4);
+	selection->select (ItemIndex (8));
+	int sum = 0;
+	ForEachItem (*selection, idx)
+		sum += idx.getIndex ();
+	EndFor
+	CCL_TEST_ASSERT_EQUAL (sum, 15);
+	CCL_TEST_ASSERT (selection->isMultiple ());
+}
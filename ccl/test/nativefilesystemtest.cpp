@@ -24,7 +24,10 @@
 #include "ccl/public/collections/linkedlist.h"
 #include "ccl/public/gui/framework/ifileselector.h"
 #include "ccl/public/base/buffer.h"
+#include "ccl/public/base/memorystream.h"
 #include "ccl/public/system/isysteminfo.h"
+#include "ccl/public/system/ifileutilities.h"
+#include "ccl/public/system/isearcher.h"
 #include "ccl/public/system/logging.h"
 #include "ccl/public/text/stringbuilder.h"
 #include "ccl/public/plugservices.h"
@@ -183,6 +186,54 @@ CCL_TEST_F (NativeFileSystemTest, SeekFile)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+CCL_TEST_F (NativeFileSystemTest, ReadMappedFile)
+{
+	Url tempFile;
+	System::GetSystem ().getLocation (tempFile, System::kTempFolder);
+	String folderName = UIDString::generate ();
+	tempFile.descend (folderName, IUrl::kFolder);
+	fs->createFolder (tempFile);
+	tempFile.descend ("dummy.temp", IUrl::kFile);
+	Logging::debug ("Writing to file: %(1)", tempFile.getPath ());
+	IStream* stream = fs->openStream (tempFile, IStream::kCreateMode);
+	const unsigned int blockSize = 1024 * 120;
+	char buffer[blockSize];
+	for(int i = 0; i < blockSize; i++)
+		buffer[i] = (i % CHAR_MAX);
+	stream->write (buffer, blockSize);
+	stream->release ();
+
+	Logging::debug ("Reading mapped file: %(1)", tempFile.getPath ());
+	stream = fs->openStream (tempFile, IStream::kOpenMode | IStream::kMapped);
+	CCL_TEST_ASSERT (stream != nullptr);
+	if(UnknownPtr<IMemoryStream> memoryStream = stream) // not supported on all platforms
+	{
+		CCL_TEST_ASSERT (memoryStream->getBytesWritten () == blockSize);
+		const char* memory = static_cast<const char*> (memoryStream->getMemoryAddress ());
+		for(int i = 0; i < blockSize; i++)
+			CCL_TEST_ASSERT (memory[i] == (i % CHAR_MAX));
+		CCL_TEST_ASSERT (stream->write (buffer, 1) == -1);
+	}
+
+	::memset (buffer, 0, blockSize);
+	CCL_TEST_ASSERT (stream->read (buffer, blockSize) == blockSize);
+	for(int i = 0; i < blockSize; i++)
+		CCL_TEST_ASSERT (buffer[i] == (i % CHAR_MAX));
+	CCL_TEST_ASSERT (stream->read (buffer, 1) == 0);
+
+	int64 position = blockSize / 2;
+	CCL_TEST_ASSERT (stream->seek (position, IStream::kSeekSet) == position);
+	stream->read (buffer, 1);
+	CCL_TEST_ASSERT (buffer[0] == (position % CHAR_MAX));
+	CCL_TEST_ASSERT (stream->seek (0, IStream::kSeekEnd) == blockSize);
+
+	stream->release ();
+	tempFile.ascend ();
+	fs->removeFolder (tempFile);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 CCL_TEST_F (NativeFileSystemTest, RemoveFile)
 {
 	Url tempFile;
@@ -253,6 +304,67 @@ CCL_TEST_F (NativeFileSystemTest, CopyFile)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+CCL_TEST_F (NativeFileSystemTest, CopyFilePerformance)
+{
+	Url tempFolder;
+	System::GetSystem ().getLocation (tempFolder, System::kTempFolder);
+	tempFolder.descend (UIDString::generate (), IUrl::kFolder);
+	fs->createFolder (tempFolder);
+
+	const unsigned int blockSize = 1024 * 64;
+	char buffer[blockSize];
+	for(int i = 0; i < blockSize; i++)
+		buffer[i] = (i % CHAR_MAX);
+
+	static const int kBlockCounts[] = { 1, 16, 256, 1024 }; // 64 KB to 64 MB
+	for(int blocks : kBlockCounts)
+	{
+		Url srcFile (tempFolder);
+		srcFile.descend ("source.temp", IUrl::kFile);
+		Url dstFile (tempFolder);
+		dstFile.descend ("copy.temp", IUrl::kFile);
+
+		IStream* stream = fs->openStream (srcFile, IStream::kCreateMode);
+		for(int i = 0; i < blocks; i++)
+			stream->write (buffer, blockSize);
+		stream->release ();
+
+		double startTime = System::GetProfileTime ();
+		CCL_TEST_ASSERT (fs->copyFile (dstFile, srcFile, 0, nullptr));
+		double duration = System::GetProfileTime () - startTime;
+		Logging::debugf ("Copy file %d KB: %.3f ms", blocks * blockSize / 1024, duration * 1000.);
+
+		// buffered copy via memory stream for comparison
+		stream = fs->openStream (srcFile, IStream::kOpenMode);
+		MemoryStream memoryStream;
+		startTime = System::GetProfileTime ();
+		CCL_TEST_ASSERT (System::GetFileUtilities ().copyStream (memoryStream, *stream, nullptr));
+		duration = System::GetProfileTime () - startTime;
+		Logging::debugf ("Copy stream %d KB to memory: %.3f ms", blocks * blockSize / 1024, duration * 1000.);
+		stream->release ();
+		CCL_TEST_ASSERT (memoryStream.getBytesWritten () == blocks * blockSize);
+
+		FileInfo info;
+		CCL_TEST_ASSERT (fs->getFileInfo (info, dstFile));
+		CCL_TEST_ASSERT (info.fileSize == blocks * blockSize);
+
+		stream = fs->openStream (dstFile, IStream::kOpenMode);
+		stream->seek (-(int64)blockSize, IStream::kSeekEnd);
+		::memset (buffer, 0, blockSize);
+		CCL_TEST_ASSERT (stream->read (buffer, blockSize) == blockSize);
+		for(int i = 0; i < blockSize; i++)
+			CCL_TEST_ASSERT (buffer[i] == (i % CHAR_MAX));
+		stream->release ();
+
+		fs->removeFile (srcFile);
+		fs->removeFile (dstFile);
+	}
+
+	fs->removeFolder (tempFolder);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 CCL_TEST_F (NativeFileSystemTest, MoveFile)
 {
 	Url tempFile1;
@@ -339,6 +451,148 @@ CCL_TEST_F (NativeFileSystemTest, GetFileInfo)
 	fs->removeFolder (tempFile);
 }
 
+#if CCL_PLATFORM_LINUX
+//************************************************************************************************
+// SearchResultCounter
+//************************************************************************************************
+
+struct SearchResultCounter: public Unknown,
+							public ISearchResultSink
+{
+	int numResults = 0;
+
+	static int search (INativeFileSystem& fs, UrlRef folder, StringRef pattern)
+	{
+		AutoPtr<SearchDescription> description = SearchDescription::create (folder, pattern, ISearchDescription::kUseFileIndex);
+		AutoPtr<ISearcher> searcher = fs.createSearcher (*description);
+		if(searcher == nullptr)
+			return -1;
+
+		AutoPtr<SearchResultCounter> counter = NEW SearchResultCounter;
+		if(searcher->find (*counter, nullptr) != kResultOk)
+			return -1;
+		return counter->numResults;
+	}
+
+	tresult CCL_API addResult (IUnknown* item) override { numResults++; item->release (); return kResultOk; }
+	tresult CCL_API addResults (const IUnknownList& items) override { return kResultNotImplemented; }
+	void CCL_API setPaginationNeeded (tbool state) override {}
+
+	CLASS_INTERFACE (ISearchResultSink, Unknown)
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST_F (NativeFileSystemTest, SearchFiles)
+{
+	Url tempFolder;
+	System::GetSystem ().getLocation (tempFolder, System::kTempFolder);
+	tempFolder.descend (UIDString::generate (), IUrl::kFolder);
+
+	// 10 folders with 100 files each, every 10th file matches
+	for(int i = 0; i < 10; i++)
+	{
+		Url folder (tempFolder);
+		folder.descend (String () << "folder" << i, IUrl::kFolder);
+		fs->createFolder (folder);
+		for(int j = 0; j < 100; j++)
+		{
+			Url file (folder);
+			file.descend (String () << (j % 10 == 0 ? "needle" : "hay") << j << ".temp", IUrl::kFile);
+			AutoPtr<IStream> stream = fs->openStream (file, IStream::kCreateMode);
+		}
+	}
+
+	// first search walks the folders, second one can use the file index, third one doesn't ask for it
+	for(int pass = 0; pass < 3; pass++)
+	{
+		int options = pass < 2 ? ISearchDescription::kUseFileIndex : 0;
+		AutoPtr<SearchDescription> description = SearchDescription::create (tempFolder, "needle", options);
+		AutoPtr<ISearcher> searcher = fs->createSearcher (*description);
+		CCL_TEST_ASSERT (searcher != nullptr);
+
+		AutoPtr<SearchResultCounter> sink = NEW SearchResultCounter;
+		double startTime = System::GetProfileTime ();
+		CCL_TEST_ASSERT (searcher->find (*sink, nullptr) == kResultOk);
+		double duration = System::GetProfileTime () - startTime;
+		Logging::debugf ("Search pass %d: %d results, %.3f ms", pass, sink->numResults, duration * 1000.);
+		CCL_TEST_ASSERT (sink->numResults == 100);
+	}
+
+	fs->removeFolder (tempFolder, INativeFileSystem::kDeleteRecursively);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST_F (NativeFileSystemTest, SearchFilesAfterChanges)
+{
+	Url tempFolder;
+	System::GetSystem ().getLocation (tempFolder, System::kTempFolder);
+	tempFolder.descend (UIDString::generate (), IUrl::kFolder);
+
+	auto createFile = [&] (UrlRef folder, StringRef name)
+	{
+		Url file (folder);
+		file.descend (name, IUrl::kFile);
+		AutoPtr<IStream> stream = fs->openStream (file, IStream::kCreateMode);
+	};
+
+	for(int i = 0; i < 4; i++)
+	{
+		Url folder (tempFolder);
+		folder.descend (String () << "folder" << i, IUrl::kFolder);
+		fs->createFolder (folder);
+		createFile (folder, String () << "needle" << i << ".temp");
+		createFile (folder, String () << "hay" << i << ".temp");
+	}
+
+	// first search builds the index
+	CCL_TEST_ASSERT_EQUAL (4, SearchResultCounter::search (*fs, tempFolder, "needle"));
+
+	// index is updated asynchronously by the file system monitor thread
+	auto waitForResults = [&] (int expected)
+	{
+		int numResults = -1;
+		for(int i = 0; i < 100; i++)
+		{
+			numResults = SearchResultCounter::search (*fs, tempFolder, "needle");
+			if(numResults == expected)
+				break;
+			System::ThreadSleep (20);
+		}
+		return numResults;
+	};
+
+	Url folder0 (tempFolder);
+	folder0.descend ("folder0", IUrl::kFolder);
+
+	// create
+	createFile (folder0, "needle_new.temp");
+	CCL_TEST_ASSERT_EQUAL (5, waitForResults (5));
+
+	// delete
+	Url deletedFile (folder0);
+	deletedFile.descend ("needle0.temp", IUrl::kFile);
+	CCL_TEST_ASSERT (fs->removeFile (deletedFile));
+	CCL_TEST_ASSERT_EQUAL (4, waitForResults (4));
+
+	// rename
+	Url renamedFile (folder0);
+	renamedFile.descend ("hay0.temp", IUrl::kFile);
+	CCL_TEST_ASSERT (fs->renameFile (renamedFile, "needle_renamed.temp"));
+	CCL_TEST_ASSERT_EQUAL (5, waitForResults (5));
+
+	// new subtree
+	Url newFolder (tempFolder);
+	newFolder.descend ("newFolder/sub", IUrl::kFolder);
+	fs->createFolder (newFolder);
+	createFile (newFolder, "needle_sub.temp");
+	CCL_TEST_ASSERT_EQUAL (6, waitForResults (6));
+
+	fs->removeFolder (tempFolder, INativeFileSystem::kDeleteRecursively);
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 CCL_TEST_F (NativeFileSystemTest, WriteReadLargeFile)
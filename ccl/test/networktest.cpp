@@ -21,6 +21,7 @@
 #include "ccl/base/storage/file.h"
 
 #include "ccl/public/text/cstring.h"
+#include "ccl/public/text/istringdict.h"
 #include "ccl/public/base/memorystream.h"
 #include "ccl/public/system/logging.h"
 #include "ccl/public/systemservices.h"
@@ -28,12 +29,16 @@
 #include "ccl/public/network/web/iwebservice.h"
 #include "ccl/public/network/web/iwebclient.h"
 #include "ccl/public/network/web/iwebnewsreader.h"
+#include "ccl/public/network/web/iwebserver.h"
+#include "ccl/public/network/web/iwebrequest.h"
+#include "ccl/public/collections/vector.h"
 #include "ccl/public/network/inetdiscovery.h"
 #include "ccl/public/netservices.h"
 
 using namespace CCL;
 using namespace Net;
 using namespace Web;
+using namespace Threading;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -118,6 +123,413 @@ CCL_TEST (WebSuite, TestSSL)
 	CCL_TEST_ASSERT (System::GetWebService ().downloadData (url, *tempStream) == kResultOk);
 }
 
+//************************************************************************************************
+// TestWebServerApp
+//************************************************************************************************
+
+class TestWebServerApp: public Unknown,
+						public IWebServerApp
+{
+public:
+	TestWebServerApp ()
+	: serverName ("TestServer/1.0")
+	{}
+
+	// IWebServerApp
+	StringRef CCL_API getServerName () const override
+	{
+		return serverName;
+	}
+
+	tresult CCL_API handleRequest (IWebRequest& request) override
+	{
+		IWebResponse* response = request.getWebResponse ();
+		IStream* stream = response ? response->getStream () : nullptr;
+		if(!stream)
+			return kResultFailed;
+
+		// larger responses are requested via custom header
+		int64 size = 0;
+		if(IWebHeaderCollection* headers = request.getWebHeaders ())
+			headers->getEntries ().lookupValue ("X-Response-Size").getIntValue (size);
+		if(size == 0)
+			stream->write ("OK", 2);
+
+		char block[1000];
+		::memset (block, 'x', sizeof(block));
+		for(int64 i = 0; i < size; i += sizeof(block))
+			stream->write (block, (int)ccl_min<int64> (size - i, sizeof(block)));
+		return kResultOk;
+	}
+
+	CLASS_INTERFACE (IWebServerApp, Unknown)
+
+protected:
+	String serverName;
+};
+
+//************************************************************************************************
+// TestWebServer
+//************************************************************************************************
+
+struct TestWebServer
+{
+	TestWebServerApp app;
+	AutoPtr<IWebServer> server;
+	IThread* thread = nullptr;
+	IPAddress address;
+
+	~TestWebServer ()
+	{
+		stop ();
+	}
+
+	bool start ()
+	{
+		server = System::GetWebService ().createServer (Web::Meta::kHTTP);
+		if(!server)
+			return false;
+
+		server->setApp (&app);
+		address.setIP (127, 0, 0, 1);
+		if(server->startup (address) != kResultOk || server->getAddress (address) != kResultOk)
+			return false;
+
+		thread = System::CreateNativeThread ({run, "TestWebServer", server.as_plain ()});
+		thread->start ();
+		return true;
+	}
+
+	void stop ()
+	{
+		if(!thread)
+			return;
+
+		server->quit ();
+		thread->join (kWaitForever);
+		thread->release ();
+		thread = nullptr;
+	}
+
+	static int CCL_API run (void* arg)
+	{
+		((IWebServer*)arg)->run ();
+		return 0;
+	}
+};
+
+//************************************************************************************************
+// TestHTTPConnection
+//************************************************************************************************
+
+struct TestHTTPConnection
+{
+	AutoPtr<ISocket> socket;
+	MutableCString input;
+	MutableCString header;
+	MutableCString body;
+
+	bool connect (const IPAddress& address)
+	{
+		socket = System::GetNetwork ().createSocket (address.family, kStream, kTCP);
+		return socket && socket->connect (address) == kResultOk;
+	}
+
+	bool send (CStringRef request)
+	{
+		return socket->send (request.str (), request.length ()) == request.length ();
+	}
+
+	bool receive ()
+	{
+		char buffer[4096];
+		int result = socket->receive (buffer, sizeof(buffer));
+		if(result <= 0)
+			return false;
+		input.append (buffer, result);
+		return true;
+	}
+
+	bool read (MutableCString& result, int count)
+	{
+		while(input.length () < count)
+			if(!receive ())
+				return false;
+		result.append (input.str (), count);
+		input = input.subString (count);
+		return true;
+	}
+
+	bool readLine (MutableCString& line)
+	{
+		int end = -1;
+		while((end = input.index ("\r\n")) < 0)
+			if(!receive ())
+				return false;
+		line = input.subString (0, end);
+		input = input.subString (end + 2);
+		return true;
+	}
+
+	bool receiveResponse ()
+	{
+		header.empty ();
+		body.empty ();
+
+		MutableCString line;
+		do
+		{
+			if(!readLine (line))
+				return false;
+			header.append (line.str ()).append ("\r\n");
+		}
+		while(!line.isEmpty ());
+
+		if(hasHeader ("Transfer-Encoding: chunked"))
+		{
+			while(readLine (line))
+			{
+				int size = (int)::strtol (line.str (), nullptr, 16);
+				if(size == 0) // last chunk, empty trailer
+					return readLine (line) && line.isEmpty ();
+				if(!read (body, size) || !readLine (line))
+					return false;
+			}
+			return false;
+		}
+
+		int index = header.index ("Content-Length: ");
+		if(index >= 0)
+			return read (body, ::atoi (header.str () + index + 16));
+
+		// body ends when the connection is closed
+		while(receive ())
+			;
+		body = input;
+		input.empty ();
+		return true;
+	}
+
+	bool hasHeader (CStringPtr entry) const
+	{
+		return header.contains (entry);
+	}
+
+	bool isClosed ()
+	{
+		return input.isEmpty () && !receive ();
+	}
+};
+
+//************************************************************************************************
+// TestWebClient
+//************************************************************************************************
+
+struct TestWebClient
+{
+	IPAddress address;
+	double* latencies = nullptr;
+	int requestCount = 0;
+	int pipelineDepth = 1;
+	int failures = 0;
+
+	char buffer[4096];
+	int bufferSize = 0;
+
+	static int CCL_API run (void* arg)
+	{
+		TestWebClient* client = (TestWebClient*)arg;
+		AutoPtr<ISocket> socket = System::GetNetwork ().createSocket (client->address.family, kStream, kTCP);
+		if(!socket || socket->connect (client->address) != kResultOk)
+		{
+			client->failures = client->requestCount;
+			return 0;
+		}
+
+		static const char kRequest[] = "GET /test HTTP/1.1\r\nHost: localhost\r\n\r\n";
+		for(int i = 0; i < client->requestCount; i += client->pipelineDepth)
+		{
+			double startTime = System::GetProfileTime ();
+
+			// send several requests at once to test pipelining
+			int count = ccl_min (client->pipelineDepth, client->requestCount - i);
+			for(int j = 0; j < count; j++)
+				socket->send (kRequest, sizeof(kRequest) - 1);
+
+			for(int j = 0; j < count; j++)
+			{
+				if(!client->receiveResponse (*socket))
+				{
+					client->failures += client->requestCount - i - j;
+					return 0;
+				}
+				client->latencies[i + j] = System::GetProfileTime () - startTime;
+			}
+		}
+		socket->disconnect ();
+		return 0;
+	}
+
+	bool receiveResponse (ISocket& socket)
+	{
+		// receive header
+		const char* headerEnd = nullptr;
+		while(true)
+		{
+			buffer[bufferSize] = 0;
+			if((headerEnd = ::strstr (buffer, "\r\n\r\n")))
+				break;
+			if(!receive (socket))
+				return false;
+		}
+
+		if(::strncmp (buffer, "HTTP/1.1 200", 12) != 0)
+			return false;
+
+		int contentLength = 0;
+		if(const char* lengthHeader = ::strstr (buffer, "Content-Length: "))
+			contentLength = ::atoi (lengthHeader + 16);
+
+		// receive content and keep data of next response
+		int responseSize = int(headerEnd - buffer) + 4 + contentLength;
+		while(bufferSize < responseSize)
+			if(!receive (socket))
+				return false;
+
+		bufferSize -= responseSize;
+		::memmove (buffer, buffer + responseSize, bufferSize);
+		return true;
+	}
+
+	bool receive (ISocket& socket)
+	{
+		int result = socket.receive (buffer + bufferSize, sizeof(buffer) - 1 - bufferSize);
+		if(result <= 0)
+			return false;
+		bufferSize += result;
+		return true;
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static int benchmarkWebServer (IPAddress address, int numClients, int pipelineDepth)
+{
+	static const int kRequestsPerClient = 1000;
+
+	Vector<double> latencies (numClients * kRequestsPerClient);
+	latencies.setCount (numClients * kRequestsPerClient);
+	latencies.zeroFill ();
+
+	Vector<TestWebClient> clients (numClients);
+	for(int i = 0; i < numClients; i++)
+	{
+		TestWebClient client;
+		client.address = address;
+		client.latencies = latencies.getItems () + i * kRequestsPerClient;
+		client.requestCount = kRequestsPerClient;
+		client.pipelineDepth = pipelineDepth;
+		clients.add (client);
+	}
+
+	double startTime = System::GetProfileTime ();
+
+	Vector<IThread*> threads;
+	for(int i = 0; i < numClients; i++)
+	{
+		IThread* thread = System::CreateNativeThread ({TestWebClient::run, "TestWebClient", &clients[i]});
+		thread->start ();
+		threads.add (thread);
+	}
+	for(IThread* thread : threads)
+	{
+		thread->join (kWaitForever);
+		thread->release ();
+	}
+
+	double duration = System::GetProfileTime () - startTime;
+
+	int failures = 0;
+	for(const TestWebClient& client : clients)
+		failures += client.failures;
+
+	int numRequests = latencies.count ();
+	latencies.sort ();
+	Logging::debugf ("HTTP server (%d clients, pipeline depth %d): %.0f requests/s, latency p50 %.3f ms, p99 %.3f ms\n", numClients, pipelineDepth,
+					 numRequests / duration, 1000. * latencies[numRequests / 2], 1000. * latencies[numRequests * 99 / 100]);
+	return failures;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (WebSuite, TestWebServerKeepAlive)
+{
+	TestWebServer server;
+	CCL_TEST_ASSERT (server.start ());
+	if(!server.thread)
+		return;
+
+	TestHTTPConnection connection;
+	CCL_TEST_ASSERT (connection.connect (server.address));
+
+	// small body is sent with its length
+	CCL_TEST_ASSERT (connection.send ("GET /a HTTP/1.1\r\nHost: localhost\r\n\r\n"));
+	CCL_TEST_ASSERT (connection.receiveResponse ());
+	CCL_TEST_ASSERT (connection.header.startsWith ("HTTP/1.1 200"));
+	CCL_TEST_ASSERT (connection.hasHeader ("Connection: keep-alive"));
+	CCL_TEST_ASSERT (connection.hasHeader ("Content-Length: 2"));
+	CCL_TEST_ASSERT (connection.body == "OK");
+
+	// large body is streamed in chunks on the same connection
+	CCL_TEST_ASSERT (connection.send ("GET /b HTTP/1.1\r\nHost: localhost\r\nX-Response-Size: 100000\r\n\r\n"));
+	CCL_TEST_ASSERT (connection.receiveResponse ());
+	CCL_TEST_ASSERT (connection.hasHeader ("Connection: keep-alive"));
+	CCL_TEST_ASSERT (connection.hasHeader ("Transfer-Encoding: chunked"));
+	CCL_TEST_ASSERT_FALSE (connection.hasHeader ("Content-Length"));
+	CCL_TEST_ASSERT_EQUAL (100000, connection.body.length ());
+
+	// pipelined requests, unread request body is skipped, "close" among other connection options
+	CCL_TEST_ASSERT (connection.send ("POST /c HTTP/1.1\r\nHost: localhost\r\nContent-Length: 5\r\n\r\nhello"
+									  "GET /d HTTP/1.1\r\nHost: localhost\r\nConnection: TE, close\r\n\r\n"));
+	CCL_TEST_ASSERT (connection.receiveResponse ());
+	CCL_TEST_ASSERT (connection.hasHeader ("Connection: keep-alive"));
+	CCL_TEST_ASSERT (connection.body == "OK");
+	CCL_TEST_ASSERT (connection.receiveResponse ());
+	CCL_TEST_ASSERT (connection.hasHeader ("Connection: close"));
+	CCL_TEST_ASSERT (connection.body == "OK");
+	CCL_TEST_ASSERT (connection.isClosed ());
+
+	// HTTP/1.0 is persistent only if requested
+	TestHTTPConnection connection10;
+	CCL_TEST_ASSERT (connection10.connect (server.address));
+	CCL_TEST_ASSERT (connection10.send ("GET /e HTTP/1.0\r\nHost: localhost\r\nConnection: Keep-Alive, foo\r\n\r\n"));
+	CCL_TEST_ASSERT (connection10.receiveResponse ());
+	CCL_TEST_ASSERT (connection10.header.startsWith ("HTTP/1.0 200"));
+	CCL_TEST_ASSERT (connection10.hasHeader ("Connection: keep-alive"));
+	CCL_TEST_ASSERT (connection10.body == "OK");
+
+	// no chunked encoding for HTTP/1.0, body of unknown length ends with the connection
+	CCL_TEST_ASSERT (connection10.send ("GET /f HTTP/1.0\r\nHost: localhost\r\nConnection: keep-alive\r\nX-Response-Size: 100000\r\n\r\n"));
+	CCL_TEST_ASSERT (connection10.receiveResponse ());
+	CCL_TEST_ASSERT (connection10.hasHeader ("Connection: close"));
+	CCL_TEST_ASSERT_FALSE (connection10.hasHeader ("Transfer-Encoding"));
+	CCL_TEST_ASSERT_EQUAL (100000, connection10.body.length ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (WebSuite, TestWebServerLoad)
+{
+	TestWebServer server;
+	CCL_TEST_ASSERT (server.start ());
+	if(!server.thread)
+		return;
+
+	for(int numClients : {1, 8, 32})
+		CCL_TEST_ASSERT_EQUAL (0, benchmarkWebServer (server.address, numClients, 1));
+	CCL_TEST_ASSERT_EQUAL (0, benchmarkWebServer (server.address, 8, 8));
+}
+
 //************************************************************************************************
 // NetworkSuite
 //************************************************************************************************
@@ -23,6 +23,9 @@
 
 #include "ccl/public/base/variant.h"
 #include "ccl/public/base/streamer.h"
+#include "ccl/public/base/memorystream.h"
+#include "ccl/public/base/idatatransformer.h"
+#include "ccl/public/system/ifileutilities.h"
 #include "ccl/public/system/ipackagefile.h"
 #include "ccl/public/system/ipackagehandler.h"
 #include "ccl/public/system/logging.h"
@@ -166,3 +169,309 @@ CCL_TEST (PackageFileTest, TestXTEAEncryption)
 		}
 	}
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (PackageFileTest, TestManyEntries)
+{
+	TempFile packageUrl ("test many entries");
+	const int kNumEntries = 100000;
+
+	auto getItemUrl = [] (Url& url, int i)
+	{
+		url.setPath (String () << "/folder/item" << i << ".txt");
+	};
+
+	Logging::debugf ("Writing package with %d entries:", kNumEntries);
+	{
+		AutoPtr<IPackageFile> packageFile = System::GetPackageHandler ().createPackage (packageUrl.getPath (), CCL::ClassID::PackageFile);
+		packageFile->create ();
+
+		IPackageFile::Closer packageFileCloser (*packageFile);
+
+		double startTime = System::GetProfileTime ();
+		for(int i = 0; i < kNumEntries; i++)
+		{
+			Url dataUrl;
+			getItemUrl (dataUrl, i);
+			packageFile->createItem (dataUrl, NEW SaveTask (MutableCString ().appendFormat ("%d", i)));
+		}
+		Logging::debugf ("createItem: %.1f ms\n", (System::GetProfileTime () - startTime) * 1000.);
+
+		packageFile->flush ();
+	}
+
+	Logging::debug ("Looking up all entries:");
+	{
+		AutoPtr<IPackageFile> packageFile = System::GetPackageHandler ().openPackage (packageUrl.getPath ());
+		packageFile->open ();
+
+		IPackageFile::Closer packageFileCloser (*packageFile);
+		IFileSystem* fileSystem = packageFile->getFileSystem ();
+
+		double startTime = System::GetProfileTime ();
+		int found = 0;
+		for(int i = 0; i < kNumEntries; i++)
+		{
+			Url dataUrl;
+			getItemUrl (dataUrl, i);
+			if(fileSystem->fileExists (dataUrl))
+				found++;
+		}
+		Logging::debugf ("fileExists: %.1f ms\n", (System::GetProfileTime () - startTime) * 1000.);
+		CCL_TEST_ASSERT_EQUAL (kNumEntries, found);
+
+		Url dataUrl;
+		getItemUrl (dataUrl, kNumEntries - 1);
+		AutoPtr<IStream> dataFile = fileSystem->openStream (dataUrl, IStream::kReadMode);
+		CCL_TEST_ASSERT (dataFile != nullptr);
+		if(dataFile)
+		{
+			char string[32] = {0};
+			dataFile->read (string, sizeof(string) - 1);
+			CCL_TEST_ASSERT (MutableCString ().appendFormat ("%d", kNumEntries - 1) == string);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (PackageFileTest, TestCompressionMethods)
+{
+	const int kNumFiles = 64;
+	const int kFileSize = 1024 * 1024;
+
+	IFileSystem& fileSystem = System::GetFileSystem ();
+	Url sourceFolder;
+	System::GetFileUtilities ().makeUniqueTempFolder (sourceFolder);
+
+	// moderately compressible text
+	MutableCString content;
+	uint32 random = 12345;
+	for(int i = 0; i < kNumFiles; i++)
+	{
+		content.empty ();
+		while(content.length () < kFileSize)
+		{
+			random = random * 1664525 + 1013904223;
+			content.appendFormat ("entry %d value %u\n", i, (random >> 16) % 1000);
+		}
+
+		Url path (sourceFolder);
+		path.descend (String () << "file" << i << ".txt");
+		AutoPtr<IStream> stream = fileSystem.openStream (path, IStream::kCreateMode);
+		CCL_TEST_ASSERT (stream != nullptr);
+		if(stream)
+			stream->write (content.str (), content.length ());
+	}
+
+	struct Method
+	{
+		int method;
+		UIDRef cid;
+		CStringPtr name;
+	};
+
+	Method methods[] =
+	{
+		{PackageOption::kCompressionZlib, ClassID::ZlibCompression, "zlib"},
+		{PackageOption::kCompressionZstd, ClassID::ZstdCompression, "zstd"},
+		{PackageOption::kCompressionLZ4, ClassID::LZ4Compression, "lz4"}
+	};
+
+	for(const Method& method : methods)
+	{
+		AutoPtr<IDataTransformer> transformer = System::CreateDataTransformer (method.cid, IDataTransformer::kEncode);
+		if(transformer == nullptr)
+		{
+			Logging::debugf ("%s: not available", method.name);
+			continue;
+		}
+
+		TempFile packageUrl (String () << "test " << method.name);
+		double packTime = 0.;
+		{
+			AutoPtr<IPackageFile> packageFile = System::GetPackageHandler ().createPackage (packageUrl.getPath (), CCL::ClassID::PackageFile);
+			packageFile->setOption (PackageOption::kCompressed, true);
+			packageFile->setOption (PackageOption::kCompressionMethod, method.method);
+			packageFile->setOption (PackageOption::kCompressionLevel, 0.3f);
+			packageFile->create ();
+
+			IPackageFile::Closer packageFileCloser (*packageFile);
+			CCL_TEST_ASSERT_EQUAL (kNumFiles, packageFile->embedd (sourceFolder));
+
+			double startTime = System::GetProfileTime ();
+			CCL_TEST_ASSERT (packageFile->flush ());
+			packTime = System::GetProfileTime () - startTime;
+		}
+
+		FileInfo info;
+		fileSystem.getFileInfo (info, packageUrl.getPath ());
+
+		Url extractFolder;
+		System::GetFileUtilities ().makeUniqueTempFolder (extractFolder);
+		double extractTime = 0.;
+		{
+			AutoPtr<IPackageFile> packageFile = System::GetPackageHandler ().openPackage (packageUrl.getPath ());
+			packageFile->open ();
+
+			IPackageFile::Closer packageFileCloser (*packageFile);
+
+			double startTime = System::GetProfileTime ();
+			CCL_TEST_ASSERT_EQUAL (kNumFiles, packageFile->extractAll (extractFolder));
+			extractTime = System::GetProfileTime () - startTime;
+		}
+
+		// compare last file
+		Url path (extractFolder);
+		path.descend (String () << "file" << (kNumFiles - 1) << ".txt");
+		AutoPtr<IStream> stream = fileSystem.openStream (path, IStream::kOpenMode);
+		CCL_TEST_ASSERT (stream != nullptr);
+		if(stream)
+		{
+			MutableCString extracted;
+			char buffer[4096];
+			int numRead = 0;
+			while((numRead = stream->read (buffer, sizeof(buffer))) > 0)
+				extracted.append (buffer, numRead);
+			CCL_TEST_ASSERT (extracted == content);
+		}
+		stream.release ();
+		fileSystem.removeFolder (extractFolder, IFileSystem::kDeleteRecursively);
+
+		Logging::debugf ("%s: ratio %.2f, flush %.1f ms, extractAll %.1f ms", method.name,
+						 double(kNumFiles) * kFileSize / double(info.fileSize), packTime * 1000., extractTime * 1000.);
+	}
+
+	fileSystem.removeFolder (sourceFolder, IFileSystem::kDeleteRecursively);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (PackageFileTest, TestCompressionDictionary)
+{
+	AutoPtr<IDataTransformer> transformer = System::CreateDataTransformer (ClassID::ZstdCompression, IDataTransformer::kEncode);
+	if(transformer == nullptr)
+	{
+		Logging::debug ("zstd: not available");
+		return;
+	}
+
+	const int kNumFolders = 8;
+	const int kFilesPerFolder = 16;
+	const int kNumFiles = kNumFolders * kFilesPerFolder;
+
+	IFileSystem& fileSystem = System::GetFileSystem ();
+	Url sourceFolder;
+	System::GetFileUtilities ().makeUniqueTempFolder (sourceFolder);
+
+	auto getFilePath = [] (Url& path, UrlRef folder, int i)
+	{
+		path = folder;
+		path.descend (String () << "folder" << (i / kFilesPerFolder) << "/sub/file" << i << ".json");
+	};
+
+	auto getContent = [] (MutableCString& content, int i)
+	{
+		content.empty ();
+		content.appendFormat ("{\"name\": \"file%d\", \"type\": \"preset\", \"version\": 1, \"parameters\": {\"gain\": %d, \"pan\": 0, \"mute\": false, \"solo\": false}}\n", i, i * 7);
+	};
+
+	auto readFile = [&] (MutableCString& content, UrlRef path)
+	{
+		content.empty ();
+		AutoPtr<IStream> stream = fileSystem.openStream (path, IStream::kOpenMode);
+		if(!stream)
+			return false;
+		char buffer[1024];
+		int numRead = 0;
+		while((numRead = stream->read (buffer, sizeof(buffer))) > 0)
+			content.append (buffer, numRead);
+		return true;
+	};
+
+	MutableCString content;
+	for(int i = 0; i < kNumFiles; i++)
+	{
+		Url path;
+		getFilePath (path, sourceFolder, i);
+		getContent (content, i);
+		AutoPtr<IStream> stream = fileSystem.openStream (path, IStream::kCreateMode);
+		CCL_TEST_ASSERT (stream != nullptr);
+		if(stream)
+			stream->write (content.str (), content.length ());
+	}
+
+	// raw content dictionary with the common structure of all files
+	AutoPtr<IMemoryStream> dictionary = NEW MemoryStream;
+	for(int i = 0; i < 4; i++)
+	{
+		getContent (content, i);
+		dictionary->write (content.str (), content.length ());
+	}
+
+	auto createPackage = [&] (UrlRef packagePath, IMemoryStream* dictionary)
+	{
+		AutoPtr<IPackageFile> packageFile = System::GetPackageHandler ().createPackage (packagePath, CCL::ClassID::PackageFile);
+		packageFile->setOption (PackageOption::kCompressed, true);
+		packageFile->setOption (PackageOption::kCompressionMethod, PackageOption::kCompressionZstd);
+		if(dictionary)
+			packageFile->setOption (PackageOption::kCompressionDictionary, dictionary);
+		packageFile->create ();
+
+		IPackageFile::Closer packageFileCloser (*packageFile);
+		CCL_TEST_ASSERT_EQUAL (kNumFiles, packageFile->embedd (sourceFolder));
+		CCL_TEST_ASSERT (packageFile->flush ());
+	};
+
+	TempFile plainPackage ("test zstd");
+	TempFile dictionaryPackage ("test zstd dictionary");
+	createPackage (plainPackage.getPath (), nullptr);
+	createPackage (dictionaryPackage.getPath (), dictionary);
+
+	FileInfo plainInfo, dictionaryInfo;
+	fileSystem.getFileInfo (plainInfo, plainPackage.getPath ());
+	fileSystem.getFileInfo (dictionaryInfo, dictionaryPackage.getPath ());
+	CCL_TEST_ASSERT (dictionaryInfo.fileSize < plainInfo.fileSize);
+
+	// extract with dictionary, files in nested folders are created by concurrent jobs
+	Url extractFolder;
+	System::GetFileUtilities ().makeUniqueTempFolder (extractFolder);
+	{
+		AutoPtr<IPackageFile> packageFile = System::GetPackageHandler ().openPackage (dictionaryPackage.getPath ());
+		packageFile->setOption (PackageOption::kCompressionDictionary, dictionary);
+		packageFile->open ();
+
+		IPackageFile::Closer packageFileCloser (*packageFile);
+		CCL_TEST_ASSERT_EQUAL (kNumFiles, packageFile->extractAll (extractFolder));
+	}
+
+	MutableCString expected;
+	for(int i = 0; i < kNumFiles; i++)
+	{
+		Url path;
+		getFilePath (path, extractFolder, i);
+		getContent (expected, i);
+		CCL_TEST_ASSERT (readFile (content, path));
+		CCL_TEST_ASSERT (content == expected);
+	}
+	fileSystem.removeFolder (extractFolder, IFileSystem::kDeleteRecursively);
+
+	// data can't be restored without dictionary
+	System::GetFileUtilities ().makeUniqueTempFolder (extractFolder);
+	{
+		AutoPtr<IPackageFile> packageFile = System::GetPackageHandler ().openPackage (dictionaryPackage.getPath ());
+		packageFile->open ();
+
+		IPackageFile::Closer packageFileCloser (*packageFile);
+		packageFile->extractAll (extractFolder);
+	}
+
+	Url path;
+	getFilePath (path, extractFolder, 0);
+	getContent (expected, 0);
+	CCL_TEST_ASSERT (!readFile (content, path) || content != expected);
+	fileSystem.removeFolder (extractFolder, IFileSystem::kDeleteRecursively);
+
+	fileSystem.removeFolder (sourceFolder, IFileSystem::kDeleteRecursively);
+}
@@ -21,6 +21,8 @@
 #include "ccl/public/text/cstring.h"
 #include "ccl/public/text/iregexp.h"
 #include "ccl/public/system/logging.h"
+#include "ccl/public/systemservices.h"
+#include "ccl/public/textservices.h"
 
 using namespace CCL;
 
@@ -476,3 +478,82 @@ CCL_TEST (StringTest, TestAppendFloatValue)
 	negative.appendFloatValue (value, -1);
 	CCL_TEST_ASSERT_EQUAL (String ("1234567.12345678894780576229095458984375"), negative);
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (StringTest, TestSmallStrings)
+{
+	// grow across the small text capacity and shrink again
+	String s;
+	String expected;
+	for(int i = 0; i < 40; i++)
+	{
+		uchar c = uchar ('a' + i % 26);
+		s.append (&c, 1);
+		CCL_TEST_ASSERT (s.length () == i + 1);
+		CCL_TEST_ASSERT (s.at (i) == c);
+		CCL_TEST_ASSERT (s.at (0) == 'a');
+	}
+	expected = s;
+	s.truncate (3);
+	CCL_TEST_ASSERT_EQUAL (String ("abc"), s);
+	s.append (expected.subString (3));
+	CCL_TEST_ASSERT_EQUAL (expected, s);
+
+	String shortCopy (String ("short"));
+	String copy = shortCopy;
+	copy.append ("er");
+	CCL_TEST_ASSERT_EQUAL (String ("short"), shortCopy);
+	CCL_TEST_ASSERT_EQUAL (String ("shorter"), copy);
+	CCL_TEST_ASSERT (copy.startsWith (shortCopy));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (StringTest, TestSmallStringPool)
+{
+	static const int kNumStrings = 1000;
+	static const int kNumIterations = 100;
+
+	String* strings = NEW String[kNumStrings];
+	StringPoolStatistics firstRun;
+	bool contentValid = true;
+	double startTime = System::GetProfileTime ();
+	for(int n = 0; n < kNumIterations; n++)
+	{
+		for(int i = 0; i < kNumStrings; i++)
+		{
+			strings[i] = String ("id");
+			strings[i].appendIntValue (i);
+		}
+
+		String expected;
+		for(int i = 0; i < kNumStrings; i += 97)
+		{
+			expected = "id";
+			expected.appendIntValue (i);
+			if(strings[i] != expected)
+				contentValid = false;
+		}
+
+		if(n == 0) // all strings alive, objects and texts come from the pools
+			System::GetStringPoolStatistics (firstRun);
+
+		for(int i = 0; i < kNumStrings; i++)
+			strings[i].empty ();
+	}
+	double duration = System::GetProfileTime () - startTime;
+	delete[] strings;
+
+	Logging::debugf ("Small strings: %.0f strings/s\n", kNumStrings * kNumIterations / duration);
+
+	CCL_TEST_ASSERT (contentValid);
+	CCL_TEST_ASSERT (firstRun.objectsAllocated >= kNumStrings);
+	CCL_TEST_ASSERT (firstRun.textsAllocated >= kNumStrings);
+
+	// later iterations reuse pool blocks, pools don't grow any further
+	StringPoolStatistics lastRun;
+	System::GetStringPoolStatistics (lastRun);
+	CCL_TEST_ASSERT_EQUAL (firstRun.objectsAllocated, lastRun.objectsAllocated);
+	CCL_TEST_ASSERT_EQUAL (firstRun.textsAllocated, lastRun.textsAllocated);
+}
@@ -19,9 +19,15 @@
 #include "ccl/base/unittest.h"
 
 #include "ccl/base/storage/url.h"
+#include "ccl/base/message.h"
+#include "ccl/public/system/iatomtable.h"
 #include "ccl/public/system/isysteminfo.h"
+#include "ccl/public/system/isignalhandler.h"
 #include "ccl/public/system/inativefilesystem.h"
 #include "ccl/public/system/logging.h"
+#include "ccl/public/system/ithreading.h"
+#include "ccl/public/system/idiagnosticstore.h"
+#include "ccl/public/collections/vector.h"
 #include "ccl/public/systemservices.h"
 
 using namespace CCL;
@@ -70,3 +76,324 @@ CCL_TEST (SystemTest, TestSystemInformation)
 	Logging::debug ("Username is ");
 	Logging::debug (userName);
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (SystemTest, TestAtomTable)
+{
+	IAtomTable& atomTable = System::GetAtomTable ();
+
+	AutoPtr<IAtom> a1 = atomTable.createAtom ("TestAtom");
+	AutoPtr<IAtom> a2 = atomTable.createAtom ("testatom");
+	AutoPtr<IAtom> a3 = atomTable.createAtom ("testAtom2");
+	CCL_TEST_ASSERT (a1 == a2);
+	CCL_TEST_ASSERT (a1 != a3);
+	CCL_TEST_ASSERT (a1->getAtomName () == "testatom");
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (SystemTest, TestAtomTableContention)
+{
+	static const int kNumThreads = 8;
+	static const int kNumNames = 256;
+	static const int kNumIterations = 200;
+
+	struct Worker
+	{
+		IAtom* atoms[kNumNames];
+
+		static int CCL_API run (void* arg)
+		{
+			Worker* worker = (Worker*)arg;
+			for(int n = 0; n < kNumIterations; n++)
+				for(int i = 0; i < kNumNames; i++)
+				{
+					MutableCString name;
+					name.appendFormat ("ContentionAtom%d", i);
+					IAtom* atom = System::GetAtomTable ().createAtom (name);
+					if(n == 0)
+						worker->atoms[i] = atom;
+					else
+						atom->release ();
+				}
+			return 0;
+		}
+	};
+
+	Worker workers[kNumThreads];
+	Vector<Threading::IThread*> threads;
+
+	double startTime = System::GetProfileTime ();
+	for(int t = 0; t < kNumThreads; t++)
+	{
+		Threading::IThread* thread = System::CreateNativeThread ({Worker::run, "AtomTableTest", &workers[t]});
+		thread->start ();
+		threads.add (thread);
+	}
+	for(Threading::IThread* thread : threads)
+	{
+		thread->join (Threading::kWaitForever);
+		thread->release ();
+	}
+	double duration = System::GetProfileTime () - startTime;
+
+	// all threads must have received the same atoms
+	for(int i = 0; i < kNumNames; i++)
+		for(int t = 0; t < kNumThreads; t++)
+		{
+			CCL_TEST_ASSERT (workers[t].atoms[i] == workers[0].atoms[i]);
+			workers[t].atoms[i]->release ();
+		}
+
+	Logging::debugf ("AtomTable (%d threads): %.0f lookups/s\n", kNumThreads, kNumThreads * kNumNames * kNumIterations / duration);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (SystemTest, TestDiagnosticStoreThreads)
+{
+	static const int kNumThreads = 4;
+	static const int kNumValues = 10000;
+	static const CStringPtr kContext = "test/diagnosticstore";
+	static const CStringPtr kKey = "Value";
+
+	struct Worker
+	{
+		static int CCL_API run (void*)
+		{
+			for(int i = 1; i <= kNumValues; i++)
+				System::GetDiagnosticStore ().submitValue (kContext, kKey, i, "Test");
+			return 0;
+		}
+	};
+
+	IDiagnosticStore& store = System::GetDiagnosticStore ();
+	store.clearData (kContext, nullptr);
+
+	Vector<Threading::IThread*> threads;
+	double startTime = System::GetProfileTime ();
+	for(int t = 0; t < kNumThreads; t++)
+	{
+		Threading::IThread* thread = System::CreateNativeThread ({Worker::run, "DiagnosticStoreTest", nullptr});
+		thread->start ();
+		threads.add (thread);
+	}
+	for(Threading::IThread* thread : threads)
+	{
+		thread->join (Threading::kWaitForever);
+		thread->release ();
+	}
+	double duration = System::GetProfileTime () - startTime;
+
+	AutoPtr<IDiagnosticResult> result (store.queryResult (kContext, kKey));
+	CCL_TEST_ASSERT (result != nullptr);
+	if(result)
+	{
+		CCL_TEST_ASSERT_EQUAL (result->getCount (), kNumThreads * kNumValues);
+		CCL_TEST_ASSERT_EQUAL (result->getMinimum (), 1.);
+		CCL_TEST_ASSERT_EQUAL (result->getMaximum (), double(kNumValues));
+		CCL_TEST_ASSERT_EQUAL (result->getSum (), kNumThreads * (kNumValues * (kNumValues + 1) / 2.));
+		CCL_TEST_ASSERT (result->getLabel () == "Test");
+
+		// log-linear buckets are accurate to a few percent
+		UnknownPtr<IDiagnosticResult2> result2 (result.as_plain ());
+		CCL_TEST_ASSERT (result2.isValid ());
+		if(result2)
+		{
+			double median = result2->getPercentile (50);
+			CCL_TEST_ASSERT (median > kNumValues * 0.4 && median < kNumValues * 0.6);
+			double p99 = result2->getPercentile (99);
+			CCL_TEST_ASSERT (p99 > kNumValues * 0.9 && p99 <= kNumValues);
+		}
+	}
+
+	store.clearData (kContext, nullptr);
+	AutoPtr<IDiagnosticResult> cleared (store.queryResult (kContext, kKey));
+	CCL_TEST_ASSERT (cleared == nullptr);
+
+	Logging::debugf ("DiagnosticStore (%d threads): %.0f submits/s\n", kNumThreads, kNumThreads * kNumValues / duration);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (SystemTest, TestDiagnosticStoreManyContexts)
+{
+	static const int kNumContexts = 5000; // more than the first metrics table holds
+	static const CStringPtr kKey = "Value";
+
+	IDiagnosticStore& store = System::GetDiagnosticStore ();
+	store.clearData ("test/diagnosticcontexts/*", nullptr);
+
+	for(int i = 0; i < kNumContexts; i++)
+	{
+		MutableCString context ("test/diagnosticcontexts/");
+		context.appendFormat ("%d", i);
+		CCL_TEST_ASSERT (store.submitValue (context, kKey, i) == kResultOk);
+	}
+
+	for(int i = 0; i < kNumContexts; i += 499)
+	{
+		MutableCString context ("test/diagnosticcontexts/");
+		context.appendFormat ("%d", i);
+		AutoPtr<IDiagnosticResult> result (store.queryResult (context, kKey));
+		CCL_TEST_ASSERT (result != nullptr);
+		if(result)
+		{
+			CCL_TEST_ASSERT_EQUAL (1, result->getCount ());
+			CCL_TEST_ASSERT_EQUAL (double(i), result->getSum ());
+		}
+	}
+
+	store.clearData ("test/diagnosticcontexts/*", nullptr);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (SystemTest, TestDiagnosticStoreDroppedValues)
+{
+	static const int kNumValues = 1500; // more than kept between two queries
+	static const CStringPtr kContext = "test/diagnosticdropped";
+	static const CStringPtr kKey = "Value";
+
+	IDiagnosticStore& store = System::GetDiagnosticStore ();
+	IDiagnosticStore::DiagnosticMode oldMode = store.setMode (IDiagnosticStore::kShortTerm);
+	store.clearData (kContext, nullptr);
+
+	for(int i = 0; i < kNumValues; i++)
+		store.submitValue (kContext, kKey, i);
+
+	AutoPtr<IDiagnosticResult> result (store.queryResult (kContext, kKey));
+	CCL_TEST_ASSERT (result != nullptr);
+	UnknownPtr<IDiagnosticResult2> result2 (result.as_plain ());
+	CCL_TEST_ASSERT (result2.isValid ());
+	if(result && result2)
+	{
+		int numDropped = result2->getNumDroppedValues ();
+		CCL_TEST_ASSERT (numDropped > 0);
+		CCL_TEST_ASSERT_EQUAL (kNumValues, result->getCount () + numDropped);
+	}
+
+	store.clearData (kContext, nullptr);
+	store.setMode (oldMode);
+}
+
+//************************************************************************************************
+// SignalHandlerTestObserver
+//************************************************************************************************
+
+class SignalHandlerTestObserver: public Object
+{
+public:
+	Vector<int> received;
+	bool repost = false;
+
+	void CCL_API notify (ISubject* subject, MessageRef msg) override
+	{
+		int value = msg[0].asInt ();
+		received.add (value);
+
+		// an immediate message and a delayed one replacing the message being delivered
+		if(repost && msg == "Repost")
+		{
+			System::GetSignalHandler ().postMessage (this, NEW Message ("Immediate", value + 1));
+			System::GetSignalHandler ().postMessage (this, NEW Message ("Repost", value + 10), -1);
+		}
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (SystemTest, TestSignalHandlerOrdering)
+{
+	ISignalHandler& signalHandler = System::GetSignalHandler ();
+	AutoPtr<SignalHandlerTestObserver> observer = NEW SignalHandlerTestObserver;
+
+	for(int i = 0; i < 3; i++)
+		signalHandler.postMessage (observer, NEW Message ("Immediate", i));
+
+	// delayed messages with same ID are coalesced, the last one wins
+	signalHandler.postMessage (observer, NEW Message ("Delayed", 10), -1);
+	signalHandler.postMessage (observer, NEW Message ("Delayed", 11), -1);
+
+	signalHandler.flush ();
+
+	CCL_TEST_ASSERT_EQUAL (4, observer->received.count ());
+	if(observer->received.count () == 4)
+	{
+		CCL_TEST_ASSERT_EQUAL (0, observer->received[0]);
+		CCL_TEST_ASSERT_EQUAL (1, observer->received[1]);
+		CCL_TEST_ASSERT_EQUAL (2, observer->received[2]);
+		CCL_TEST_ASSERT_EQUAL (11, observer->received[3]);
+	}
+	CCL_TEST_ASSERT_FALSE (signalHandler.messagesPending (observer));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (SystemTest, TestSignalHandlerFlushObserver)
+{
+	ISignalHandler& signalHandler = System::GetSignalHandler ();
+	AutoPtr<SignalHandlerTestObserver> observer1 = NEW SignalHandlerTestObserver;
+	AutoPtr<SignalHandlerTestObserver> observer2 = NEW SignalHandlerTestObserver;
+
+	signalHandler.postMessage (observer1, NEW Message ("Immediate", 0));
+	signalHandler.postMessage (observer2, NEW Message ("Immediate", 100));
+	signalHandler.postMessage (observer1, NEW Message ("Delayed", 1), 60 * 1000);
+	signalHandler.postMessage (observer1, NEW Message ("Immediate", 2));
+
+	// messages for the observer are delivered regardless of their delay, in order of posting
+	signalHandler.flush (observer1);
+
+	CCL_TEST_ASSERT_EQUAL (3, observer1->received.count ());
+	if(observer1->received.count () == 3)
+	{
+		CCL_TEST_ASSERT_EQUAL (0, observer1->received[0]);
+		CCL_TEST_ASSERT_EQUAL (1, observer1->received[1]);
+		CCL_TEST_ASSERT_EQUAL (2, observer1->received[2]);
+	}
+	CCL_TEST_ASSERT_FALSE (signalHandler.messagesPending (observer1));
+
+	CCL_TEST_ASSERT_EQUAL (0, observer2->received.count ());
+	CCL_TEST_ASSERT (signalHandler.messagesPending (observer2));
+
+	signalHandler.cancelMessages (observer2);
+	CCL_TEST_ASSERT_FALSE (signalHandler.messagesPending (observer2));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (SystemTest, TestSignalHandlerPostWhileFlushing)
+{
+	ISignalHandler& signalHandler = System::GetSignalHandler ();
+
+	for(bool flushObserver : {false, true})
+	{
+		AutoPtr<SignalHandlerTestObserver> observer = NEW SignalHandlerTestObserver;
+		observer->repost = true;
+		signalHandler.postMessage (observer, NEW Message ("Repost", 0));
+
+		// the immediate message is delivered in the same pass, the replacement waits for the next flush
+		signalHandler.flush (flushObserver ? observer.as_plain () : nullptr);
+
+		CCL_TEST_ASSERT_EQUAL (2, observer->received.count ());
+		if(observer->received.count () == 2)
+		{
+			CCL_TEST_ASSERT_EQUAL (0, observer->received[0]);
+			CCL_TEST_ASSERT_EQUAL (1, observer->received[1]);
+		}
+		CCL_TEST_ASSERT (signalHandler.messagesPending (observer));
+
+		observer->repost = false;
+		signalHandler.flush (flushObserver ? observer.as_plain () : nullptr);
+
+		CCL_TEST_ASSERT_EQUAL (3, observer->received.count ());
+		if(observer->received.count () == 3)
+		{
+			CCL_TEST_ASSERT_EQUAL (10, observer->received[2]);
+		}
+		CCL_TEST_ASSERT_FALSE (signalHandler.messagesPending (observer));
+
+		signalHandler.cancelMessages (observer);
+	}
+}
@@ -227,3 +227,88 @@ CCL_TEST (TextConvertTest, TestTextStreamer)
 
 	Logging::debug ("Done %(1)", ":-)");
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (TextConvertTest, TestTranscoding)
+{
+	// ASCII blocks mixed with two- to four-byte sequences and text lengths around the block size
+	static const uchar kMixed[] = {'a', 0xE4, 'b', 0x20AC, 0xD83D, 0xDE00, 'c', 0};
+	for(int count = 1; count < 40; count++)
+	{
+		String prototype;
+		for(int i = 0; i < count; i++)
+			prototype.appendIntValue (i % 10);
+		prototype.append (kMixed);
+
+		MutableCString utf8 (prototype, Text::kUTF8);
+		String decoded;
+		CCL_TEST_ASSERT (decoded.appendCString (Text::kUTF8, utf8) == true);
+		CCL_TEST_ASSERT_EQUAL (prototype, decoded);
+
+		String latin1;
+		latin1.appendCString (Text::kISOLatin1, "caf\xE9");
+		MutableCString encoded (latin1, Text::kISOLatin1);
+		CCL_TEST_ASSERT (encoded == "caf\xE9");
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (TextConvertTest, TestTranscodingBufferTooSmall)
+{
+	static const uchar kText[] = {'H', 0xE9, 'l', 'l', 'o', ' ', 0x20AC, 0};
+	String text (kText);
+
+	// the text must not be truncated silently, the conversion fails or reports the required size
+	char buffer[4] = {0};
+	int bytesWritten = 0;
+	bool succeeded = text.toCString (Text::kUTF8, buffer, sizeof(buffer), &bytesWritten);
+	CCL_TEST_ASSERT (!succeeded || bytesWritten > (int)sizeof(buffer));
+	CCL_TEST_ASSERT (CString (buffer) != "H\xC3\xA9");
+
+	// fits with terminator
+	char largeBuffer[11] = {0};
+	CCL_TEST_ASSERT (text.toCString (Text::kUTF8, largeBuffer, sizeof(largeBuffer), &bytesWritten));
+	CCL_TEST_ASSERT (CString (largeBuffer) == "H\xC3\xA9llo \xE2\x82\xAC");
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (TextConvertTest, TestTranscodingPerformance)
+{
+	// large text, mostly ASCII with a few non-ASCII characters per line
+	static const int kNumLines = 100000;
+	static const uchar kLineEnd[] = {' ', 0xFC, 0x20AC, '\n', 0};
+
+	String text;
+	for(int i = 0; i < kNumLines; i++)
+	{
+		text.append ("The quick brown fox jumps over the lazy dog ");
+		text.appendIntValue (i);
+		text.append (kLineEnd);
+	}
+
+	static const int kNumRuns = 10;
+	MutableCString utf8;
+	double startTime = System::GetProfileTime ();
+	for(int i = 0; i < kNumRuns; i++)
+		utf8 = MutableCString (text, Text::kUTF8);
+	double encodeTime = System::GetProfileTime () - startTime;
+
+	startTime = System::GetProfileTime ();
+	for(int i = 0; i < kNumRuns; i++)
+	{
+		String decoded;
+		decoded.appendCString (Text::kUTF8, utf8, utf8.length ());
+		if(i == 0)
+		{
+			CCL_TEST_ASSERT_EQUAL (text, decoded);
+		}
+	}
+	double decodeTime = System::GetProfileTime () - startTime;
+
+	double megaBytes = (double)utf8.length () * kNumRuns / (1024. * 1024.);
+	Logging::debugf ("UTF-16 to UTF-8: %.1f MB/s\n", megaBytes / encodeTime);
+	Logging::debugf ("UTF-8 to UTF-16: %.1f MB/s\n", megaBytes / decodeTime);
+}
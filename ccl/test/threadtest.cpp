@@ -113,3 +113,241 @@ CCL_TEST (ThreadTest, TestThreadLocalStorage)
 
 	threadPool.reduceThreads (true);
 }
+
+//************************************************************************************************
+// TestLatencyWork
+//************************************************************************************************
+
+class TestLatencyWork: public Unknown,
+					   public AbstractWorkItem
+{
+public:
+	static AtomicInt workCount;
+
+	TestLatencyWork (double* latency, AtomicInt* runCount)
+	: latency (latency),
+	  runCount (runCount),
+	  scheduleTime (System::GetProfileTime ())
+	{}
+
+	void CCL_API work () override
+	{
+		*latency = System::GetProfileTime () - scheduleTime;
+		++*runCount;
+		++workCount;
+	}
+
+	CLASS_INTERFACE (IWorkItem, Unknown)
+
+protected:
+	double* latency;
+	AtomicInt* runCount;
+	double scheduleTime;
+};
+
+AtomicInt TestLatencyWork::workCount;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Returns the number of items that did not run exactly once. */
+static int benchmarkThreadPool (CStringPtr title, ThreadPoolScheduler scheduler, int numProducers)
+{
+	static const int kNumItems = 20000;
+	static const int kNumThreads = 4;
+	static const int kTimeout = 30000;
+
+	struct Producer
+	{
+		IThreadPool* threadPool;
+		double* latencies;
+		AtomicInt* runCounts;
+		int count;
+
+		static int CCL_API run (void* arg)
+		{
+			Producer* producer = (Producer*)arg;
+			for(int i = 0; i < producer->count; i++)
+				producer->threadPool->scheduleWork (NEW TestLatencyWork (producer->latencies + i, producer->runCounts + i));
+			return 0;
+		}
+	};
+
+	AutoPtr<IThreadPool> threadPool = System::CreateThreadPool ({kNumThreads, kPriorityNormal, "BenchmarkPool", -1, scheduler});
+	threadPool->allocateThreads (kNumThreads);
+
+	Vector<double> latencies (kNumItems);
+	latencies.setCount (kNumItems);
+	latencies.zeroFill ();
+	Vector<AtomicInt> runCounts (kNumItems);
+	runCounts.setCount (kNumItems);
+
+	TestLatencyWork::workCount = 0;
+	double startTime = System::GetProfileTime ();
+
+	Vector<IThread*> threads;
+	Vector<Producer> producers (numProducers);
+	int itemsPerProducer = kNumItems / numProducers;
+	for(int i = 0; i < numProducers; i++)
+		producers.add ({threadPool, latencies.getItems () + i * itemsPerProducer, runCounts.getItems () + i * itemsPerProducer, itemsPerProducer});
+	for(int i = 0; i < numProducers; i++)
+	{
+		IThread* thread = System::CreateNativeThread ({Producer::run, "BenchmarkProducer", &producers[i]});
+		thread->start ();
+		threads.add (thread);
+	}
+
+	int numItems = itemsPerProducer * numProducers;
+	while(TestLatencyWork::workCount < numItems && System::GetProfileTime () - startTime < kTimeout / 1000.)
+		System::ThreadSleep (1);
+
+	double duration = System::GetProfileTime () - startTime;
+
+	for(IThread* thread : threads)
+	{
+		thread->join (kWaitForever);
+		thread->release ();
+	}
+	threadPool->terminate ();
+
+	int failedCount = 0;
+	for(int i = 0; i < numItems; i++)
+		if(runCounts[i] != 1)
+			failedCount++;
+
+	latencies.setCount (numItems);
+	latencies.sort ();
+	Logging::debugf ("%s (%d producers): %.0f items/s, latency p50 %.3f ms, p99 %.3f ms, max %.3f ms\n", title, numProducers,
+					 numItems / duration, 1000. * latencies[numItems / 2], 1000. * latencies[numItems * 99 / 100], 1000. * latencies.last ());
+	return failedCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (ThreadTest, TestThreadPoolSchedulerPerformance)
+{
+	for(int numProducers : {1, 4})
+	{
+		CCL_TEST_ASSERT_EQUAL (0, benchmarkThreadPool ("Shared queue", kSharedQueueScheduler, numProducers));
+		CCL_TEST_ASSERT_EQUAL (0, benchmarkThreadPool ("Work stealing", kWorkStealingScheduler, numProducers));
+	}
+}
+
+//************************************************************************************************
+// TestPriorityWork
+//************************************************************************************************
+
+class TestPriorityWork: public Unknown,
+						public AbstractPrioritizedWorkItem
+{
+public:
+	static AtomicInt workCount;
+	static Vector<int> executionOrder;
+
+	TestPriorityWork (int index, WorkPriority priority, int64 deadline = 0, Signal* gate = nullptr)
+	: AbstractPrioritizedWorkItem (nullptr, priority, deadline),
+	  index (index),
+	  gate (gate)
+	{}
+
+	void CCL_API work () override
+	{
+		if(gate)
+			gate->wait (kWaitForever);
+		else
+			executionOrder.add (index); // single worker thread
+		++workCount;
+	}
+
+	CLASS_INTERFACE2 (IWorkItem, IPrioritizedWorkItem, Unknown)
+
+protected:
+	int index;
+	Signal* gate;
+};
+
+AtomicInt TestPriorityWork::workCount;
+Vector<int> TestPriorityWork::executionOrder;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (ThreadTest, TestThreadPoolPriorities)
+{
+	for(ThreadPoolScheduler scheduler : {kSharedQueueScheduler, kWorkStealingScheduler})
+	{
+		AutoPtr<IThreadPool> threadPool = System::CreateThreadPool ({1, kPriorityNormal, "PriorityPool", -1, scheduler});
+
+		TestPriorityWork::workCount = 0;
+		TestPriorityWork::executionOrder.removeAll ();
+
+		// block the only worker thread while queueing
+		Signal gate;
+		threadPool->scheduleWork (NEW TestPriorityWork (-1, kWorkPriorityNormal, 0, &gate));
+		while(threadPool->getActiveThreadCount () == 0)
+			System::ThreadSleep (1);
+		System::ThreadSleep (10);
+
+		threadPool->scheduleWork (NEW TestPriorityWork (0, kWorkPriorityBackground));
+		threadPool->scheduleWork (NEW TestPriorityWork (1, kWorkPriorityNormal));
+		threadPool->scheduleWork (NEW TestPriorityWork (2, kWorkPriorityInteractive));
+		threadPool->scheduleWork (NEW TestPriorityWork (3, kWorkPriorityBackground, System::GetSystemTicks ()));
+
+		gate.signal ();
+		while(TestPriorityWork::workCount < 5)
+			System::ThreadSleep (1);
+
+		// the deadline is due already, followed by priority classes
+		CCL_TEST_ASSERT_EQUAL (4, TestPriorityWork::executionOrder.count ());
+		CCL_TEST_ASSERT_EQUAL (3, TestPriorityWork::executionOrder[0]);
+		CCL_TEST_ASSERT_EQUAL (2, TestPriorityWork::executionOrder[1]);
+		CCL_TEST_ASSERT_EQUAL (1, TestPriorityWork::executionOrder[2]);
+		CCL_TEST_ASSERT_EQUAL (0, TestPriorityWork::executionOrder[3]);
+
+		UnknownPtr<IThreadPoolStatistics> statistics (threadPool);
+		CCL_TEST_ASSERT (statistics.isValid ());
+		if(statistics)
+		{
+			WorkQueueStatistics background;
+			statistics->getQueueStatistics (background, kWorkPriorityBackground);
+			CCL_TEST_ASSERT_EQUAL (2, background.numStarted);
+			CCL_TEST_ASSERT_EQUAL (0, background.queueDepth);
+		}
+
+		threadPool->terminate ();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST (ThreadTest, TestThreadPoolDeadlinePriorities)
+{
+	for(ThreadPoolScheduler scheduler : {kSharedQueueScheduler, kWorkStealingScheduler})
+	{
+		AutoPtr<IThreadPool> threadPool = System::CreateThreadPool ({1, kPriorityNormal, "PriorityPool", -1, scheduler});
+
+		TestPriorityWork::workCount = 0;
+		TestPriorityWork::executionOrder.removeAll ();
+
+		Signal gate;
+		threadPool->scheduleWork (NEW TestPriorityWork (-1, kWorkPriorityNormal, 0, &gate));
+		while(threadPool->getActiveThreadCount () == 0)
+			System::ThreadSleep (1);
+		System::ThreadSleep (10);
+
+		// deadlines are far enough away to not be urgent, the earlier one has a lower priority class
+		int64 now = System::GetSystemTicks ();
+		threadPool->scheduleWork (NEW TestPriorityWork (0, kWorkPriorityBackground, now + 10000));
+		threadPool->scheduleWork (NEW TestPriorityWork (1, kWorkPriorityNormal));
+		threadPool->scheduleWork (NEW TestPriorityWork (2, kWorkPriorityInteractive, now + 20000));
+
+		gate.signal ();
+		while(TestPriorityWork::workCount < 4)
+			System::ThreadSleep (1);
+
+		CCL_TEST_ASSERT_EQUAL (3, TestPriorityWork::executionOrder.count ());
+		CCL_TEST_ASSERT_EQUAL (2, TestPriorityWork::executionOrder[0]);
+		CCL_TEST_ASSERT_EQUAL (1, TestPriorityWork::executionOrder[1]);
+		CCL_TEST_ASSERT_EQUAL (0, TestPriorityWork::executionOrder[2]);
+
+		threadPool->terminate ();
+	}
+}
@@ -31,6 +31,56 @@
 
 using namespace CCL;
 
+//************************************************************************************************
+// JsonHandler::SourceStream
+/** Reads directly from memory if the source is a memory-based stream (e.g. a mapped file). */
+//************************************************************************************************
+
+class JsonHandler::SourceStream
+{
+public:
+	SourceStream (IStream& srcStream)
+	: srcStream (srcStream),
+	  coreStream (srcStream),
+	  memoryStream (nullptr),
+	  startPosition (0)
+	{
+		UnknownPtr<IMemoryStream> memStream (&srcStream);
+		if(memStream && memStream->getMemoryAddress ())
+		{
+			startPosition = srcStream.tell ();
+			int64 endPosition = srcStream.seek (0, IStream::kSeekEnd);
+			srcStream.seek (startPosition, IStream::kSeekSet);
+
+			int64 available = endPosition - startPosition;
+			if(available >= 0 && available <= NumericLimits::kMaxInt32)
+				memoryStream = NEW Core::IO::MemoryStream ((char*)memStream->getMemoryAddress () + startPosition, (uint32)available);
+		}
+	}
+
+	~SourceStream ()
+	{
+		if(memoryStream)
+		{
+			srcStream.seek (startPosition + memoryStream->getPosition (), IStream::kSeekSet);
+			delete memoryStream;
+		}
+	}
+
+	Core::IO::Stream* getStream ()
+	{
+		if(memoryStream)
+			return memoryStream;
+		return &coreStream;
+	}
+
+protected:
+	IStream& srcStream;
+	CoreStream coreStream;
+	Core::IO::MemoryStream* memoryStream;
+	int64 startPosition;
+};
+
 //************************************************************************************************
 // JsonHandler::HandlerDelegate
 //************************************************************************************************
@@ -196,9 +246,9 @@ protected:
 
 tresult JsonHandler::parse (IStream& srcStream, IAttributeHandler& handler)
 {
-	CoreStream streamReader (srcStream);
+	SourceStream streamReader (srcStream);
 	HandlerDelegate handlerDelegate (handler);
-	Core::Text::Json::Parser parser (&streamReader, &handlerDelegate, &handlerDelegate);
+	Core::Text::Json::Parser parser (streamReader.getStream (), &handlerDelegate, &handlerDelegate);
 	if(!parser.parse ())
 		return kResultFailed;
 	return kResultOk;
@@ -215,9 +265,9 @@ IAttributeHandler* JsonHandler::stringify (IStream& dstStream, int options)
 
 tresult JsonHandler::parseBinary (IStream& srcStream, IAttributeHandler& handler)
 {
-	CoreStream streamReader (srcStream);
+	SourceStream streamReader (srcStream);
 	HandlerDelegate handlerDelegate (handler);
-	Core::Text::Json::BinaryParser parser (&streamReader, &handlerDelegate, &handlerDelegate);
+	Core::Text::Json::BinaryParser parser (streamReader.getStream (), &handlerDelegate, &handlerDelegate);
 	if(!parser.parse ())
 		return kResultFailed;
 	return kResultOk;
@@ -236,9 +286,9 @@ IAttributeHandler* JsonHandler::writeBinary (IStream& dstStream, int options)
 
 tresult Json5Handler::parse (IStream& srcStream, IAttributeHandler& handler)
 {
-	CoreStream streamReader (srcStream);
+	SourceStream streamReader (srcStream);
 	HandlerDelegate handlerDelegate (handler);
-	Core::Text::Json::Parser parser (&streamReader, &handlerDelegate, &handlerDelegate, true);
+	Core::Text::Json::Parser parser (streamReader.getStream (), &handlerDelegate, &handlerDelegate, true);
 	if(!parser.parse ())
 		return kResultFailed;
 	return kResultOk;
@@ -39,6 +39,7 @@ public:
 	static IAttributeHandler* writeBinary (IStream& dstStream, int options = 0);
 
 protected:
+	class SourceStream;
 	class HandlerDelegate;
 	class BaseWriter;
 	class TextWriter;
@@ -50,10 +50,14 @@
 	#define STRING_ADDED						theStats.stringAdded ();
 	#define STRING_REMOVED						theStats.stringRemoved ();
 	#define STRING_RESIZED(oldSize, newSize)	theStats.stringResized (oldSize, newSize);
+	#define STRING_SMALLTEXT(isNew)				theStats.smallTextAllocated (isNew);
+	#define STRING_ALLOCATED(isNew)				theStats.stringAllocated (isNew);
 #else
 	#define STRING_ADDED
 	#define STRING_REMOVED
 	#define STRING_RESIZED(oldSize, newSize)
+	#define STRING_SMALLTEXT(isNew)
+	#define STRING_ALLOCATED(isNew)
 #endif
 
 namespace CCL {
@@ -72,6 +76,8 @@ struct StringStatistics
 	int maxStringCount;
 	int maxByteCount;
 	int maxLength;
+	int smallTextCount;	///< number of texts allocated from the small text pool
+	int heapCount;		///< number of heap buffers allocated
 
 	StringStatistics (const char* title)
 	: title (title),
@@ -79,7 +85,9 @@ struct StringStatistics
 	  byteCount (0),
 	  maxStringCount (0),
 	  maxByteCount (0),
-	  maxLength (0)
+	  maxLength (0),
+	  smallTextCount (0),
+	  heapCount (0)
 	{}
 
 	~StringStatistics ()
@@ -89,6 +97,8 @@ struct StringStatistics
 		Debugger::printf  ("maxByteCount = %d Bytes (%.2lf KB)\n", maxByteCount, (double)maxByteCount / 1024.);
 		Debugger::printf  ("maxLength = %d\n", maxLength);
 		Debugger::printf  ("averageLength = %.2lf\n", (double)maxByteCount / (double)maxStringCount / sizeof(CharType)); // nonsense
+		if(smallTextCount + heapCount > 0)
+			Debugger::printf ("smallTextCount = %d, heapCount = %d\n", smallTextCount, heapCount);
 		Debugger::println ("=================================");
 	}
 
@@ -115,6 +125,18 @@ struct StringStatistics
 		if(length > maxLength)
 			maxLength = length;
 	}
+
+	void smallTextAllocated (bool isNew)
+	{
+		if(isNew)
+			smallTextCount++;
+	}
+
+	void stringAllocated (bool isNew)
+	{
+		if(isNew)
+			heapCount++;
+	}
 };
 #endif // STRING_STATS
 
@@ -21,16 +21,110 @@
 #include "ccl/text/strings/unicodestringbuffer.h"
 #include "ccl/text/strings/stringstats.h"
 
+#include "ccl/public/textservices.h"
+
+#include "core/portable/corepool.h"
+
 using namespace CCL;
 
 #if STRING_STATS
 static StringStatistics<uchar> theStats ("Unicode String Statistics");
 #endif
 
+//************************************************************************************************
+// StringPool
+/** Memory pool growing on demand. Buckets are never released, so blocks of all sizes up to the
+	block size can be told apart by the size passed to operator delete. */
+//************************************************************************************************
+
+class StringPool
+{
+public:
+	StringPool (uint32 blockSize, CStringPtr name)
+	: pool (blockSize, UnicodeStringBuffer::kPoolGrowCount, name, true)
+	{}
+
+	void* newBlock ()
+	{
+		void* block = pool.newBlock ();
+		if(block == nullptr)
+		{
+			// another thread might have grown the pool in the meantime
+			Core::Threads::ScopedLock scopedLock (growLock);
+			block = pool.newBlock ();
+			if(block == nullptr && pool.grow (UnicodeStringBuffer::kPoolGrowCount))
+				block = pool.newBlock ();
+		}
+		return block;
+	}
+
+	void deleteBlock (void* block)
+	{
+		pool.deleteBlock (block);
+	}
+
+	void getStatistics (int& allocated, int& used)
+	{
+		Core::Threads::ScopedLock scopedLock (growLock);
+		allocated = int(pool.getNumBlocksAllocated ());
+		used = int(pool.getNumBlocksUsed ());
+	}
+
+protected:
+	Core::Portable::CoreMemoryPool pool;
+	Core::Threads::Lock growLock;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Intentionally never destroyed, static strings might be released after static destructors have run.
+static StringPool& getObjectPool ()
+{
+	static StringPool* thePool = new StringPool (sizeof(UnicodeStringBuffer), "UnicodeString");
+	return *thePool;
+}
+
+static StringPool& getTextPool ()
+{
+	static StringPool* thePool = new StringPool (UnicodeStringBuffer::kSmallTextSize, "UnicodeStringText");
+	return *thePool;
+}
+
 //************************************************************************************************
 // UnicodeStringBuffer
 //************************************************************************************************
 
+void* UnicodeStringBuffer::operator new (size_t size)
+{
+	// objects of derived classes with additional members are allocated on the heap
+	if(size > sizeof(UnicodeStringBuffer))
+		return ::operator new (size);
+
+	void* block = getObjectPool ().newBlock ();
+	ASSERT (block != nullptr)
+	return block;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UnicodeStringBuffer::operator delete (void* ptr, size_t size)
+{
+	if(size > sizeof(UnicodeStringBuffer))
+		::operator delete (ptr);
+	else
+		getObjectPool ().deleteBlock (ptr);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UnicodeStringBuffer::getPoolStatistics (StringPoolStatistics& statistics)
+{
+	getObjectPool ().getStatistics (statistics.objectsAllocated, statistics.objectsUsed);
+	getTextPool ().getStatistics (statistics.textsAllocated, statistics.textsUsed);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 static const uchar emptyString[1] = {0};
 const uchar* UnicodeStringBuffer::kEmpty = emptyString;
 
@@ -40,7 +134,8 @@ UnicodeStringBuffer::UnicodeStringBuffer ()
 : text (nullptr),
   textByteSize (0),
   textLength (0),
-  hashCode (kInvalidHashCode)
+  hashCode (kInvalidHashCode),
+  pooledText (false)
 {
 	STRING_ADDED
 }
@@ -51,7 +146,8 @@ UnicodeStringBuffer::UnicodeStringBuffer (const UnicodeStringBuffer& other)
 : text (nullptr),
   textByteSize (0),
   textLength (0),
-  hashCode (kInvalidHashCode)
+  hashCode (kInvalidHashCode),
+  pooledText (false)
 {
 	STRING_ADDED
 
@@ -360,6 +456,22 @@ bool UnicodeStringBuffer::resizeInternal (int newLength, bool fixed)
 {
 	unsigned int byteSize = newLength > 0 ? (newLength + 1) * sizeof(uchar) : 0;
 
+	// short texts use pool blocks, once allocated a heap buffer is kept until the string is released
+	if(byteSize > 0 && byteSize <= kSmallTextSize && (text == nullptr || pooledText))
+	{
+		if(text == nullptr)
+		{
+			text = (uchar*)getTextPool ().newBlock ();
+			if(text == nullptr)
+				return false;
+
+			pooledText = true;
+			textByteSize = kSmallTextSize;
+			STRING_SMALLTEXT (true)
+		}
+		return true;
+	}
+
 	#if OPTIMIZE_STRING
 	if(byteSize > 0 && fixed == false)
 	{
@@ -371,11 +483,27 @@ bool UnicodeStringBuffer::resizeInternal (int newLength, bool fixed)
 	}
 	#endif
 
+	unsigned int heapByteSize = text && !pooledText ? textByteSize : 0;
 	if(byteSize == 0)
 	{
-		if(text)
+		if(pooledText)
+			getTextPool ().deleteBlock (text);
+		else if(heapByteSize > 0)
 			string_free ((void*)text);
 		text = nullptr;
+		pooledText = false;
+	}
+	else if(pooledText)
+	{
+		void* temp = string_malloc (byteSize);
+		if(temp == nullptr)
+			return false;
+
+		::memcpy (temp, text, kSmallTextSize);
+		getTextPool ().deleteBlock (text);
+		text = (uchar*)temp;
+		pooledText = false;
+		STRING_ALLOCATED (true)
 	}
 	else
 	{
@@ -383,10 +511,11 @@ bool UnicodeStringBuffer::resizeInternal (int newLength, bool fixed)
 		if(temp == nullptr)
 			return false;
 
+		STRING_ALLOCATED (text == nullptr)
 		text = (uchar*)temp;
 	}
 
-	STRING_RESIZED (textByteSize, byteSize)
+	STRING_RESIZED (heapByteSize, byteSize)
 
 	textByteSize = byteSize;
 	return true;
@@ -23,6 +23,8 @@
 
 namespace CCL {
 
+struct StringPoolStatistics;
+
 //************************************************************************************************
 // Text functions
 //************************************************************************************************
@@ -41,6 +43,9 @@ namespace Text
 
 //************************************************************************************************
 // UnicodeStringBuffer
+/** Texts up to kSmallTextLength characters are allocated from a pool of fixed-size blocks, longer
+	texts on the heap. String objects are pooled as well, instances have to be created with new,
+	not NEW. Both pools grow on demand. */
 //************************************************************************************************
 
 class UnicodeStringBuffer: public UnicodeString
@@ -52,6 +57,15 @@ public:
 
 	UnicodeStringBuffer& operator = (const UnicodeStringBuffer& other);
 
+	static constexpr int kSmallTextLength = 15;	///< max. length of pooled texts, excluding null terminator
+	static constexpr unsigned int kSmallTextSize = (kSmallTextLength + 1) * sizeof(uchar);
+	static constexpr int kPoolGrowCount = 1024;	///< number of blocks added when a pool runs empty
+
+	void* operator new (size_t size);
+	void operator delete (void* ptr, size_t size);
+
+	static void getPoolStatistics (StringPoolStatistics& statistics);
+
 	tresult assign (const UnicodeStringBuffer& other);
 
 	// UnicodeString
@@ -96,6 +110,7 @@ protected:
 	int textByteSize;
 	int textLength;
 	mutable unsigned int hashCode;
+	bool pooledText;	///< text is a block of the small text pool
 
 	bool resizeInternal (int newLength, bool fixed = false);
 	tresult assignInternal (const uchar* charBuffer, int count); ///< assign from buffer with known text length
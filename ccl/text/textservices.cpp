@@ -31,6 +31,7 @@
 #endif
 
 #include "ccl/text/strings/unicodestring.h"
+#include "ccl/text/strings/unicodestringbuffer.h"
 #include "ccl/text/strings/stringtable.h"
 #include "ccl/text/strings/translationtable.h"
 #include "ccl/text/strings/formatparser.h"
@@ -43,6 +44,12 @@
 #include "ccl/text/xml/xmlstringdict.h"
 
 #include "ccl/text/transform/zlibcompression.h"
+#if CCL_ZSTD_COMPRESSION_ENABLED
+#include "ccl/text/transform/zstdcompression.h"
+#endif
+#if CCL_LZ4_COMPRESSION_ENABLED
+#include "ccl/text/transform/lz4compression.h"
+#endif
 #include "ccl/text/transform/encodings/baseencoding.h"
 #include "ccl/text/transform/transformstreams.h"
 #include "ccl/text/transform/textstreamer.h"
@@ -99,6 +106,13 @@ CCL_EXPORT StringRef CCL_API CCL_ISOLATED (GetConstantString) (CStringPtr asciiS
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+CCL_EXPORT void CCL_API CCL_ISOLATED (GetStringPoolStatistics) (StringPoolStatistics& statistics)
+{
+	UnicodeStringBuffer::getPoolStatistics (statistics);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 CCL_EXPORT IUnicodeUtilities& CCL_API CCL_ISOLATED (GetUnicodeUtilities) ()
 {
 	return UnicodeUtilities::getInstance ();
@@ -243,6 +257,24 @@ CCL_EXPORT IDataTransformer* CCL_API CCL_ISOLATED (CreateDataTransformer) (UIDRe
 		else if(mode == IDataTransformer::kDecode)
 			transformer = NEW ZlibDecoder;
 	}
+	#if CCL_ZSTD_COMPRESSION_ENABLED
+	else if(cid.equals (ClassID::ZstdCompression))
+	{
+		if(mode == IDataTransformer::kEncode)
+			transformer = NEW ZstdEncoder;
+		else if(mode == IDataTransformer::kDecode)
+			transformer = NEW ZstdDecoder;
+	}
+	#endif
+	#if CCL_LZ4_COMPRESSION_ENABLED
+	else if(cid.equals (ClassID::LZ4Compression))
+	{
+		if(mode == IDataTransformer::kEncode)
+			transformer = NEW LZ4Encoder;
+		else if(mode == IDataTransformer::kDecode)
+			transformer = NEW LZ4Decoder;
+	}
+	#endif
 
 	if(transformer == nullptr)
 	{
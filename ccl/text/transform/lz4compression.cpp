@@ -0,0 +1,243 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+// 
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/text/transform/lz4compression.cpp
+// Description : LZ4 compression: encoder & decoder classes
+//
+//************************************************************************************************
+
+#include "ccl/text/transform/lz4compression.h"
+
+#include "lz4hc.h"
+
+namespace CCL {
+
+//************************************************************************************************
+//	LZ4Encoder
+//************************************************************************************************
+
+LZ4Encoder::LZ4Encoder ()
+: context (nullptr),
+  level (kDefaultLevel),
+  pendingSize (0),
+  pendingOffset (0),
+  started (false),
+  finished (false)
+{
+	::memset (&preferences, 0, sizeof(LZ4F_preferences_t));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+LZ4Encoder::~LZ4Encoder ()
+{
+	close ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API LZ4Encoder::setCompressionLevel (float level)
+{
+	this->level = ccl_bound (level, 0.f, 1.f);
+
+	return kResultTrue;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API LZ4Encoder::suggestBufferSizes (int& sourceSize, int& destSize)
+{
+	sourceSize = IDataTransformer::kLargerBufferSize;
+	destSize   = IDataTransformer::kLargerBufferSize;
+	return kResultTrue;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API LZ4Encoder::open (int sourceSize, int destSize)
+{
+	if(context == nullptr)
+		if(LZ4F_isError (LZ4F_createCompressionContext (&context, LZ4F_VERSION)))
+			context = nullptr;
+	if(context == nullptr)
+		return kResultFalse;
+
+	// levels below LZ4HC_CLEVEL_MIN use the fast compressor
+	::memset (&preferences, 0, sizeof(LZ4F_preferences_t));
+	preferences.compressionLevel = level == kDefaultLevel ? 0 : ccl_to_int (level * float(LZ4HC_CLEVEL_MAX));
+	preferences.frameInfo.blockSizeID = LZ4F_max256KB;
+	preferences.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+
+	size_t bound = ccl_max<size_t> (LZ4F_compressBound (kMaxChunkSize, &preferences), LZ4F_HEADER_SIZE_MAX);
+	if(!pending.resize ((uint32)bound))
+		return kResultFalse;
+
+	reset ();
+	return kResultTrue;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API LZ4Encoder::close ()
+{
+	if(context)
+	{
+		LZ4F_freeCompressionContext (context);
+		context = nullptr;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API LZ4Encoder::reset ()
+{
+	pendingSize = pendingOffset = 0;
+	started = finished = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LZ4Encoder::drainPending (void* dest, int size)
+{
+	int toCopy = ccl_min (size, pendingSize - pendingOffset);
+	if(toCopy > 0)
+	{
+		::memcpy (dest, (const char*)pending.getAddress () + pendingOffset, toCopy);
+		pendingOffset += toCopy;
+	}
+	return toCopy;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API LZ4Encoder::transform (const TransformData& data, int& sourceUsed, int& destUsed)
+{
+	sourceUsed = destUsed = 0;
+	if(context == nullptr)
+		return kResultFailed;
+
+	// hand out staged data first
+	if(pendingOffset < pendingSize)
+	{
+		destUsed = drainPending (data.destBuffer, data.destSize);
+		return kResultTrue;
+	}
+
+	pendingSize = pendingOffset = 0;
+	size_t result = 0;
+	if(!started)
+	{
+		result = LZ4F_compressBegin (context, pending.getAddress (), pending.getSize (), &preferences);
+		started = true;
+	}
+	else if(data.sourceSize > 0)
+	{
+		int chunkSize = ccl_min (data.sourceSize, (int)kMaxChunkSize);
+		result = LZ4F_compressUpdate (context, pending.getAddress (), pending.getSize (), data.sourceBuffer, chunkSize, nullptr);
+		sourceUsed = chunkSize;
+	}
+	else if(data.flush && !finished)
+	{
+		result = LZ4F_compressEnd (context, pending.getAddress (), pending.getSize (), nullptr);
+		finished = true;
+	}
+
+	ASSERT (!LZ4F_isError (result))
+	if(LZ4F_isError (result))
+		return kResultFailed;
+
+	pendingSize = int(result);
+	destUsed = drainPending (data.destBuffer, data.destSize);
+	return kResultTrue;
+}
+
+//************************************************************************************************
+//	LZ4Decoder
+//************************************************************************************************
+
+LZ4Decoder::LZ4Decoder ()
+: context (nullptr)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+LZ4Decoder::~LZ4Decoder ()
+{
+	close ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API LZ4Decoder::suggestBufferSizes (int& sourceSize, int& destSize)
+{
+	sourceSize = IDataTransformer::kLargerBufferSize;
+	destSize   = IDataTransformer::kLargerBufferSize;
+	return kResultTrue;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API LZ4Decoder::open (int sourceSize, int destSize)
+{
+	if(context == nullptr)
+		if(LZ4F_isError (LZ4F_createDecompressionContext (&context, LZ4F_VERSION)))
+			context = nullptr;
+	if(context == nullptr)
+		return kResultFalse;
+
+	reset ();
+	return kResultTrue;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API LZ4Decoder::close ()
+{
+	if(context)
+	{
+		LZ4F_freeDecompressionContext (context);
+		context = nullptr;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API LZ4Decoder::reset ()
+{
+	if(context)
+		LZ4F_resetDecompressionContext (context);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API LZ4Decoder::transform (const TransformData& data, int& sourceUsed, int& destUsed)
+{
+	sourceUsed = destUsed = 0;
+	if(context == nullptr)
+		return kResultFailed;
+
+	size_t sourceSize = data.sourceSize;
+	size_t destSize = data.destSize;
+	size_t result = LZ4F_decompress (context, data.destBuffer, &destSize, data.sourceBuffer, &sourceSize, nullptr);
+	if(LZ4F_isError (result))
+	{
+		CCL_WARN ("LZ4: %s\n", LZ4F_getErrorName (result))
+		return kResultFalse;
+	}
+
+	sourceUsed = int(sourceSize);
+	destUsed   = int(destSize);
+	return kResultTrue;
+}
+
+} // namespace CCL
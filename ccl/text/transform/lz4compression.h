@@ -0,0 +1,98 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+// 
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/text/transform/lz4compression.h
+// Description : LZ4 compression: encoder & decoder classes
+//
+//************************************************************************************************
+
+#ifndef _ccl_lz4compression_h
+#define _ccl_lz4compression_h
+
+#include "ccl/public/base/unknown.h"
+#include "ccl/public/base/buffer.h"
+#include "ccl/public/base/idatatransformer.h"
+
+#include "lz4frame.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// LZ4Encoder
+/** Writes LZ4 frame format. LZ4F_compressUpdate() needs a worst-case output buffer,
+	so compressed data is staged in an internal buffer and handed out in portions. */
+//************************************************************************************************
+
+class LZ4Encoder: public Unknown,
+				  public IDataTransformer,
+				  public IDataCompressor
+{
+public:
+	LZ4Encoder ();
+	~LZ4Encoder ();
+
+	static const int kMaxChunkSize = IDataTransformer::kLargerBufferSize; ///< source bytes per compressUpdate
+	static constexpr float kDefaultLevel = -1.f; ///< fast compressor until set explicitly
+
+	// IDataTransformer
+	tresult CCL_API suggestBufferSizes (int& sourceSize, int& destSize) override;
+	tresult CCL_API open (int sourceSize, int destSize) override;
+	tresult CCL_API transform (const TransformData& data, int& sourceUsed, int& destUsed) override;
+	void CCL_API close () override;
+	void CCL_API reset () override;
+
+	// IDataCompressor
+	tresult CCL_API setCompressionLevel (float level) override;
+
+	CLASS_INTERFACE2 (IDataTransformer, IDataCompressor, Unknown)
+
+private:
+	LZ4F_cctx* context;
+	LZ4F_preferences_t preferences;
+	float level;
+	Buffer pending;
+	int pendingSize;
+	int pendingOffset;
+	bool started;
+	bool finished;
+
+	int drainPending (void* dest, int size);
+};
+
+//************************************************************************************************
+// LZ4Decoder
+//************************************************************************************************
+
+class LZ4Decoder: public Unknown,
+				  public IDataTransformer
+{
+public:
+	LZ4Decoder ();
+	~LZ4Decoder ();
+	
+	// IDataTransformer
+	tresult CCL_API suggestBufferSizes (int& sourceSize, int& destSize) override;
+	tresult CCL_API open (int sourceSize, int destSize) override;
+	tresult CCL_API transform (const TransformData& data, int& sourceUsed, int& destUsed) override;
+	void CCL_API close () override;
+	void CCL_API reset () override;
+
+	CLASS_INTERFACE (IDataTransformer, Unknown)
+
+private:
+	LZ4F_dctx* context;
+};
+
+} // namespace CCL
+
+#endif // _ccl_lz4compression_h
@@ -0,0 +1,258 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+// 
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/text/transform/zstdcompression.cpp
+// Description : Zstandard compression: encoder & decoder classes
+//
+//************************************************************************************************
+
+#include "ccl/text/transform/zstdcompression.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// ZstdTransformer
+//************************************************************************************************
+
+ZstdTransformer::ZstdTransformer ()
+: isOpen (false),
+  dictionarySize (0)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API ZstdTransformer::setDictionary (const void* data, int size)
+{
+	if(size <= 0 || data == nullptr)
+	{
+		dictionarySize = 0;
+		return kResultTrue;
+	}
+
+	if(!dictionary.resize (size))
+		return kResultOutOfMemory;
+
+	dictionary.copyFrom (data, size);
+	dictionarySize = size;
+	return kResultTrue;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API ZstdTransformer::suggestBufferSizes (int& sourceSize, int& destSize)
+{
+	sourceSize = IDataTransformer::kLargerBufferSize;
+	destSize   = IDataTransformer::kLargerBufferSize;
+	return kResultTrue;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API ZstdTransformer::open (int sourceSize, int destSize)
+{
+	if(isOpen)
+		close ();
+
+	isOpen = initStream ();
+	return isOpen ? kResultTrue : kResultFalse;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API ZstdTransformer::close ()
+{
+	exitStream ();
+	isOpen = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API ZstdTransformer::reset ()
+{
+	resetStream ();
+}
+
+//************************************************************************************************
+//	ZstdEncoder
+//************************************************************************************************
+
+ZstdEncoder::ZstdEncoder ()
+: context (nullptr),
+  level (kDefaultLevel),
+  finished (false)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ZstdEncoder::~ZstdEncoder ()
+{
+	exitStream ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API ZstdEncoder::setCompressionLevel (float level)
+{
+	this->level = ccl_bound (level, 0.f, 1.f);
+
+	return kResultTrue;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ZstdEncoder::initStream ()
+{
+	if(context == nullptr)
+		context = ZSTD_createCCtx ();
+	if(context == nullptr)
+		return false;
+
+	resetStream ();
+
+	// zstd has no uncompressed mode, level 0 means default level
+	int zstdLevel = level == kDefaultLevel ? ZSTD_CLEVEL_DEFAULT : ccl_max (1, ccl_to_int (level * float(kMaxLevel)));
+	if(ZSTD_isError (ZSTD_CCtx_setParameter (context, ZSTD_c_compressionLevel, zstdLevel)))
+		return false;
+	if(ZSTD_isError (ZSTD_CCtx_setParameter (context, ZSTD_c_checksumFlag, 1)))
+		return false;
+
+	// dictionary is kept for all frames until parameters are reset
+	if(ZSTD_isError (ZSTD_CCtx_loadDictionary (context, dictionarySize > 0 ? dictionary.getAddress () : nullptr, dictionarySize)))
+		return false;
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ZstdEncoder::exitStream ()
+{
+	if(context)
+	{
+		ZSTD_freeCCtx (context);
+		context = nullptr;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ZstdEncoder::resetStream ()
+{
+	if(context)
+		ZSTD_CCtx_reset (context, ZSTD_reset_session_only);
+	finished = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API ZstdEncoder::transform (const TransformData& data, int& sourceUsed, int& destUsed)
+{
+	sourceUsed = destUsed = 0;
+	if(context == nullptr)
+		return kResultFailed;
+
+	// ZSTD_e_end would start a new (empty) frame after the last one has been completed
+	if(finished)
+		return kResultTrue;
+
+	ZSTD_inBuffer input = {data.sourceBuffer, size_t(data.sourceSize), 0};
+	ZSTD_outBuffer output = {data.destBuffer, size_t(data.destSize), 0};
+
+	size_t result = ZSTD_compressStream2 (context, &output, &input, data.flush ? ZSTD_e_end : ZSTD_e_continue);
+	ASSERT (!ZSTD_isError (result))
+	if(ZSTD_isError (result))
+		return kResultFailed;
+
+	if(data.flush && result == 0)
+		finished = true;
+
+	sourceUsed = int(input.pos);
+	destUsed   = int(output.pos);
+	return kResultTrue;
+}
+
+//************************************************************************************************
+//	ZstdDecoder
+//************************************************************************************************
+
+ZstdDecoder::ZstdDecoder ()
+: context (nullptr)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ZstdDecoder::~ZstdDecoder ()
+{
+	exitStream ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ZstdDecoder::initStream ()
+{
+	if(context == nullptr)
+		context = ZSTD_createDCtx ();
+	if(context == nullptr)
+		return false;
+
+	resetStream ();
+
+	if(ZSTD_isError (ZSTD_DCtx_loadDictionary (context, dictionarySize > 0 ? dictionary.getAddress () : nullptr, dictionarySize)))
+		return false;
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ZstdDecoder::exitStream ()
+{
+	if(context)
+	{
+		ZSTD_freeDCtx (context);
+		context = nullptr;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ZstdDecoder::resetStream ()
+{
+	if(context)
+		ZSTD_DCtx_reset (context, ZSTD_reset_session_only);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API ZstdDecoder::transform (const TransformData& data, int& sourceUsed, int& destUsed)
+{
+	sourceUsed = destUsed = 0;
+	if(context == nullptr)
+		return kResultFailed;
+
+	ZSTD_inBuffer input = {data.sourceBuffer, size_t(data.sourceSize), 0};
+	ZSTD_outBuffer output = {data.destBuffer, size_t(data.destSize), 0};
+
+	size_t result = ZSTD_decompressStream (context, &output, &input);
+	if(ZSTD_isError (result))
+	{
+		CCL_WARN ("Zstd: %s\n", ZSTD_getErrorName (result))
+		return kResultFalse;
+	}
+
+	sourceUsed = int(input.pos);
+	destUsed   = int(output.pos);
+	return kResultTrue;
+}
+
+} // namespace CCL
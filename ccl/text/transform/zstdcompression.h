@@ -0,0 +1,118 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+// 
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : ccl/text/transform/zstdcompression.h
+// Description : Zstandard compression: encoder & decoder classes
+//
+//************************************************************************************************
+
+#ifndef _ccl_zstdcompression_h
+#define _ccl_zstdcompression_h
+
+#include "ccl/public/base/unknown.h"
+#include "ccl/public/base/buffer.h"
+#include "ccl/public/base/idatatransformer.h"
+
+#include "zstd.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// ZstdTransformer
+/** Common base class for encoder and decoder */
+//************************************************************************************************
+
+class ZstdTransformer: public Unknown,
+					   public IDictionaryTransformer,
+					   public IDataTransformer
+{
+public:
+	// IDictionaryTransformer
+	tresult CCL_API setDictionary (const void* data, int size) override;
+
+	// IDataTransformer
+	tresult CCL_API suggestBufferSizes (int& sourceSize, int& destSize) override;
+	tresult CCL_API open (int sourceSize, int destSize) override;
+	void CCL_API close () override;
+	void CCL_API reset () override;
+
+	CLASS_INTERFACE2 (IDictionaryTransformer, IDataTransformer, Unknown)
+
+protected:
+	ZstdTransformer ();
+
+	virtual bool initStream () = 0;
+	virtual void exitStream () = 0;
+	virtual void resetStream () = 0;
+
+	bool isOpen;
+	Buffer dictionary;
+	int dictionarySize;
+};
+
+//************************************************************************************************
+// ZstdEncoder
+//************************************************************************************************
+
+class ZstdEncoder: public ZstdTransformer, 
+				   public IDataCompressor
+{
+public:
+	ZstdEncoder ();
+	~ZstdEncoder ();
+
+	static const int kMaxLevel = 19; ///< higher levels need excessive memory
+	static constexpr float kDefaultLevel = -1.f; ///< fast zstd default level until set explicitly
+	
+	// IDataTransformer
+	tresult CCL_API transform (const TransformData& data, int& sourceUsed, int& destUsed) override;
+
+	// IDataCompressor
+	tresult CCL_API setCompressionLevel (float level) override;
+
+	CLASS_INTERFACE (IDataCompressor, ZstdTransformer)
+
+private:
+	bool initStream () override;
+	void exitStream () override;
+	void resetStream () override;
+
+	ZSTD_CCtx* context;
+	float level;
+	bool finished;
+};
+
+//************************************************************************************************
+// ZstdDecoder
+//************************************************************************************************
+
+class ZstdDecoder: public ZstdTransformer
+{
+public:
+	ZstdDecoder ();
+	~ZstdDecoder ();
+	
+	// IDataTransformer
+	tresult CCL_API transform (const TransformData& data, int& sourceUsed, int& destUsed) override;
+
+private:
+	bool initStream () override;
+	void exitStream () override;
+	void resetStream () override;
+
+	ZSTD_DCtx* context;
+};
+
+} // namespace CCL
+
+#endif // _ccl_zstdcompression_h
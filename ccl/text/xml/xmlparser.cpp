@@ -272,17 +272,37 @@ tresult CCL_API XmlParser::parse (IStream& stream)
 	XML_Status status = XML_STATUS_OK;
 
 	#define XML_BUFFER_SIZE 8192
-	char buffer[XML_BUFFER_SIZE];
-
-	while(!isAborted ())
+	UnknownPtr<IMemoryStream> memoryStream (&stream);
+	if(memoryStream && memoryStream->getMemoryAddress ())
+	{
+		// feed memory-based streams (e.g. mapped files) without copying
+		const char* memory = static_cast<const char*> (memoryStream->getMemoryAddress ());
+		int64 position = stream.tell ();
+		int64 endPosition = stream.seek (0, IStream::kSeekEnd);
+		while(position < endPosition && !isAborted ())
+		{
+			int toParse = (int)ccl_min<int64> (endPosition - position, XML_BUFFER_SIZE * 16);
+			status = ::XML_Parse (myParser, memory + position, toParse, 0);
+			position += toParse;
+			if(status != XML_STATUS_OK)
+				break;
+		}
+		stream.seek (position, IStream::kSeekSet);
+	}
+	else
 	{
-		int numRead = stream.read (buffer, XML_BUFFER_SIZE);
-		if(numRead <= 0)
-			break;
+		char buffer[XML_BUFFER_SIZE];
 
-		status = ::XML_Parse (myParser, buffer, numRead, 0);
-		if(status != XML_STATUS_OK)
-			break;
+		while(!isAborted ())
+		{
+			int numRead = stream.read (buffer, XML_BUFFER_SIZE);
+			if(numRead <= 0)
+				break;
+
+			status = ::XML_Parse (myParser, buffer, numRead, 0);
+			if(status != XML_STATUS_OK)
+				break;
+		}
 	}
 	#undef XML_BUFFER_SIZE
 
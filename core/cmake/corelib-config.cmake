@@ -62,6 +62,7 @@ ccl_list_append_once (corelib_public_headers
 	${corelib_DIR}/public/coreintrusivelist.h
 	${corelib_DIR}/public/corejsonsecurity.h
 	${corelib_DIR}/public/corelinkedlist.h
+	${corelib_DIR}/public/corelockfree.h
 	${corelib_DIR}/public/coremacros.h
 	${corelib_DIR}/public/coremalloc.h
 	${corelib_DIR}/public/coremath.h
@@ -123,6 +124,7 @@ ccl_list_append_once (corelib_api_headers
 	${corelib_DIR}/network/corenetstream.h
 	${corelib_DIR}/network/corenetwork.h
 	${corelib_DIR}/network/coresocket.h
+	${corelib_DIR}/network/coresocketreactor.h
 	${corelib_DIR}/network/coresslsocket.h
 	${corelib_DIR}/network/coreudpconnection.h
 	
@@ -199,6 +201,7 @@ ccl_list_append_once (corelib_api_headers
 
 ccl_list_append_once (corelib_network_sources
 	${corelib_DIR}/network/corenetwork.cpp
+	${corelib_DIR}/network/coresocketreactor.cpp
 	${corelib_DIR}/network/coresslsocket.cpp
 	${corelib_DIR}/network/coreudpconnection.cpp
 	${corelib_DIR}/network/coreudpconnection.h
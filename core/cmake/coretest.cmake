@@ -16,6 +16,7 @@ ccl_list_append_once (coretestcase_sources
 	${corelib_DIR}/test/corestorabletest.h
 	${corelib_DIR}/test/corestringtest.cpp
 	${corelib_DIR}/test/corestringtest.h
+	${corelib_DIR}/test/corestresstest.h
 	${corelib_DIR}/test/corethreadtest.cpp
 	${corelib_DIR}/test/corethreadtest.h
 	${corelib_DIR}/test/coretimetest.cpp
@@ -26,6 +27,13 @@ ccl_list_append_once (coretestcase_sources
 	${corelib_DIR}/test/corevectortest.h
 )
 
+if (corelib_ENABLE_GUI)
+	ccl_list_append_once (coretestcase_sources
+		${corelib_DIR}/test/corebitmaptest.cpp
+		${corelib_DIR}/test/corebitmaptest.h
+	)
+endif ()
+
 if (corelib_ENABLE_NETWORK)
 	ccl_list_append_once (coretestcase_sources 
 		${corelib_DIR}/test/corenetworktest.cpp
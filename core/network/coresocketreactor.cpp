@@ -0,0 +1,411 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : core/network/coresocketreactor.cpp
+// Description : Socket Event Reactor
+//
+//************************************************************************************************
+
+#include "core/network/coresocketreactor.h"
+
+#if CORE_SOCKET_REACTOR_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+using namespace Core;
+using namespace Sockets;
+
+//************************************************************************************************
+// SocketReactor
+//************************************************************************************************
+
+#if CORE_SOCKET_REACTOR_EPOLL
+static uint32 toEpollEvents (int events)
+{
+	uint32 result = 0;
+	if(events & SocketEvent::kReadable)
+		result |= EPOLLIN;
+	if(events & SocketEvent::kWritable)
+		result |= EPOLLOUT;
+	if(events & SocketEvent::kEdgeTriggered)
+		result |= EPOLLET;
+	return result; // EPOLLERR and EPOLLHUP are always reported
+}
+
+static int fromEpollEvents (uint32 events)
+{
+	int result = 0;
+	if(events & EPOLLIN)
+		result |= SocketEvent::kReadable;
+	if(events & EPOLLOUT)
+		result |= SocketEvent::kWritable;
+	if(events & (EPOLLERR|EPOLLHUP))
+		result |= SocketEvent::kError|SocketEvent::kReadable; // let handler see end of stream
+	return result;
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SocketReactor::isScalable ()
+{
+	return CORE_SOCKET_REACTOR_EPOLL != 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+SocketReactor::SocketReactor ()
+: opened (false),
+  dispatchingSocket (INVALID_SOCKET),
+  dispatchThread (0),
+  dispatchFinished (true),
+  #if CORE_SOCKET_REACTOR_EPOLL
+  epollHandle (-1),
+  wakeupHandle (-1)
+  #else
+  wakeupSocket (nullptr)
+  #endif
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+SocketReactor::~SocketReactor ()
+{
+	ASSERT (opened == false) // close must be called!
+	close ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SocketReactor::open ()
+{
+	ASSERT (opened == false)
+	if(opened)
+		return false;
+
+	#if CORE_SOCKET_REACTOR_EPOLL
+	epollHandle = ::epoll_create1 (EPOLL_CLOEXEC);
+	if(epollHandle < 0)
+		return false;
+
+	wakeupHandle = ::eventfd (0, EFD_NONBLOCK|EFD_CLOEXEC);
+	if(wakeupHandle < 0)
+	{
+		close ();
+		return false;
+	}
+
+	epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.fd = wakeupHandle;
+	if(::epoll_ctl (epollHandle, EPOLL_CTL_ADD, wakeupHandle, &event) != 0)
+	{
+		close ();
+		return false;
+	}
+	#else
+	// datagram socket sending to itself to interrupt select()
+	wakeupSocket = NEW Socket (kInternet, kDatagram, kUDP);
+	wakeupSocket->setOption (SocketOption::kNonBlocking, 1);
+	wakeupAddress.setIP (127, 0, 0, 1);
+	wakeupAddress.port = 0;
+	if(!wakeupSocket->bind (wakeupAddress) || !wakeupSocket->getLocalAddress (wakeupAddress))
+	{
+		close ();
+		return false;
+	}
+	#endif
+
+	opened = true;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SocketReactor::close ()
+{
+	Threads::ScopedLock scopedLock (lock);
+
+	#if CORE_SOCKET_REACTOR_EPOLL
+	if(wakeupHandle >= 0)
+		::close (wakeupHandle);
+	wakeupHandle = -1;
+	if(epollHandle >= 0)
+		::close (epollHandle);
+	epollHandle = -1;
+	#else
+	delete wakeupSocket;
+	wakeupSocket = nullptr;
+	#endif
+
+	registrations.removeAll ();
+	opened = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SocketReactor::isOpen () const
+{
+	return opened;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int SocketReactor::findRegistration (SocketID socket) const
+{
+	int low = 0;
+	int high = registrations.count () - 1;
+	while(low <= high)
+	{
+		int mid = (low + high) / 2;
+		SocketID s = registrations.at (mid).socket;
+		if(s == socket)
+			return mid;
+		if(s < socket)
+			low = mid + 1;
+		else
+			high = mid - 1;
+	}
+	return -(low + 1); // insert position
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SocketReactor::addSocket (SocketID socket, int events, ISocketEventHandler* handler)
+{
+	ASSERT (handler != nullptr)
+	Threads::ScopedLock scopedLock (lock);
+	if(!opened || handler == nullptr)
+		return false;
+
+	int index = findRegistration (socket);
+	ASSERT (index < 0) // already added
+	if(index >= 0)
+		return false;
+
+	#if CORE_SOCKET_REACTOR_EPOLL
+	epoll_event event = {};
+	event.events = toEpollEvents (events);
+	event.data.fd = static_cast<int> (socket);
+	if(::epoll_ctl (epollHandle, EPOLL_CTL_ADD, static_cast<int> (socket), &event) != 0)
+		return false;
+	#else
+	if(registrations.count () >= FD_SETSIZE - 1) // one slot used by wakeup socket
+		return false;
+	#endif
+
+	registrations.insertAt (-index - 1, Registration (socket, events, handler));
+
+	#if !CORE_SOCKET_REACTOR_EPOLL
+	wakeup (); // include in next select() call
+	#endif
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SocketReactor::modifySocket (SocketID socket, int events)
+{
+	Threads::ScopedLock scopedLock (lock);
+	int index = findRegistration (socket);
+	if(index < 0)
+		return false;
+
+	#if CORE_SOCKET_REACTOR_EPOLL
+	epoll_event event = {};
+	event.events = toEpollEvents (events);
+	event.data.fd = static_cast<int> (socket);
+	if(::epoll_ctl (epollHandle, EPOLL_CTL_MOD, static_cast<int> (socket), &event) != 0)
+		return false;
+	#endif
+
+	registrations.at (index).events = events;
+
+	#if !CORE_SOCKET_REACTOR_EPOLL
+	wakeup ();
+	#endif
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SocketReactor::removeSocket (SocketID socket)
+{
+	Threads::ScopedLock scopedLock (lock);
+	int index = findRegistration (socket);
+	if(index < 0)
+		return false;
+
+	#if CORE_SOCKET_REACTOR_EPOLL
+	epoll_event event = {}; // non-null for kernels before 2.6.9
+	::epoll_ctl (epollHandle, EPOLL_CTL_DEL, static_cast<int> (socket), &event); // fails if socket has been closed already
+	#endif
+
+	registrations.removeAt (index);
+
+	// wait for a running handler unless called by it
+	while(dispatchingSocket == socket && dispatchThread != Threads::CurrentThread::getID ())
+	{
+		lock.unlock ();
+		dispatchFinished.wait (Threads::kWaitForever);
+		lock.lock ();
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int SocketReactor::countSockets () const
+{
+	Threads::ScopedLock scopedLock (lock);
+	return registrations.count ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int SocketReactor::dispatch (SocketID socket, int events)
+{
+	Registration registration;
+	{
+		Threads::ScopedLock scopedLock (lock);
+		int index = findRegistration (socket);
+		if(index < 0) // removed by a previous handler
+			return 0;
+
+		registration = registrations.at (index);
+		events &= (registration.events|SocketEvent::kError) & ~SocketEvent::kEdgeTriggered;
+		if(events == 0)
+			return 0;
+
+		// removeSocket() from other threads waits until the handler returns
+		dispatchingSocket = socket;
+		dispatchThread = Threads::CurrentThread::getID ();
+		dispatchFinished.reset ();
+	}
+
+	// don't hold the lock while the handler runs, it might add or remove sockets or block
+	registration.handler->onSocketEvent (socket, events);
+
+	Threads::ScopedLock scopedLock (lock);
+	dispatchingSocket = INVALID_SOCKET;
+	dispatchThread = 0;
+	dispatchFinished.signal ();
+	return 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int SocketReactor::poll (int timeout)
+{
+	ASSERT (opened)
+	if(!opened)
+		return -1;
+
+	int handlerCalls = 0;
+
+	#if CORE_SOCKET_REACTOR_EPOLL
+	epoll_event events[kMaxEvents];
+	int count = ::epoll_wait (epollHandle, events, kMaxEvents, timeout);
+	if(count < 0)
+		return errno == EINTR ? 0 : -1;
+
+	for(int i = 0; i < count; i++)
+	{
+		if(events[i].data.fd == wakeupHandle)
+		{
+			uint64 value = 0;
+			while(::read (wakeupHandle, &value, sizeof(value)) > 0)
+				;
+			continue;
+		}
+
+		handlerCalls += dispatch (static_cast<SocketID> (events[i].data.fd), fromEpollEvents (events[i].events));
+	}
+	#else
+	Vector<Registration> snapshot;
+	{
+		Threads::ScopedLock scopedLock (lock);
+		snapshot.copyVector (registrations);
+	}
+
+	SocketIDSet readSet = { {0} }, writeSet = { {0} }, errorSet = { {0} };
+	readSet.zero ();
+	writeSet.zero ();
+	errorSet.zero ();
+
+	SocketID highestSocket = wakeupSocket->getDescriptor ();
+	readSet.set (highestSocket);
+	for(int i = 0; i < snapshot.count (); i++)
+	{
+		const Registration& r = snapshot.at (i);
+		if(r.events & SocketEvent::kReadable)
+			readSet.set (r.socket);
+		if(r.events & SocketEvent::kWritable)
+			writeSet.set (r.socket);
+		errorSet.set (r.socket);
+		if(r.socket > highestSocket)
+			highestSocket = r.socket;
+	}
+
+	int result = Socket::select (highestSocket, &readSet, &writeSet, &errorSet, timeout);
+	if(result < 0)
+		return -1;
+	if(result == 0)
+		return 0;
+
+	if(readSet.isSet (wakeupSocket->getDescriptor ()))
+	{
+		char buffer[16];
+		while(wakeupSocket->receive (buffer, sizeof(buffer)) > 0)
+			;
+	}
+
+	for(int i = 0; i < snapshot.count (); i++)
+	{
+		SocketID socket = snapshot.at (i).socket;
+		int events = 0;
+		if(readSet.isSet (socket))
+			events |= SocketEvent::kReadable;
+		if(writeSet.isSet (socket))
+			events |= SocketEvent::kWritable;
+		if(errorSet.isSet (socket))
+			events |= SocketEvent::kError;
+		if(events != 0)
+			handlerCalls += dispatch (socket, events);
+	}
+	#endif
+
+	return handlerCalls;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SocketReactor::wakeup ()
+{
+	#if CORE_SOCKET_REACTOR_EPOLL
+	uint64 value = 1;
+	if(wakeupHandle >= 0)
+		if(::write (wakeupHandle, &value, sizeof(value)) != sizeof(value))
+		{
+			// EAGAIN: counter is saturated, poll() is woken up anyway
+			ASSERT (errno == EAGAIN)
+		}
+	#else
+	char buffer[1] = {1};
+	if(wakeupSocket)
+		wakeupSocket->sendTo (buffer, 1, wakeupAddress);
+	#endif
+}
@@ -0,0 +1,140 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : core/network/coresocketreactor.h
+// Description : Socket Event Reactor
+//
+//************************************************************************************************
+
+#ifndef _coresocketreactor_h
+#define _coresocketreactor_h
+
+#include "core/network/coresocket.h"
+
+#include "core/system/corethread.h"
+#include "core/public/corevector.h"
+
+/** Use epoll() instead of select() for socket multiplexing. */
+#ifndef CORE_SOCKET_REACTOR_EPOLL
+	#if CORE_PLATFORM_LINUX || CORE_PLATFORM_ANDROID
+		#define CORE_SOCKET_REACTOR_EPOLL 1
+	#else
+		#define CORE_SOCKET_REACTOR_EPOLL 0
+	#endif
+#endif
+
+namespace Core {
+namespace Sockets {
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Socket events
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace SocketEvent
+{
+	enum Flags
+	{
+		kReadable = 1<<0,		///< data available, incoming connection or connection closed
+		kWritable = 1<<1,		///< data can be sent, connection attempt succeeded
+		kError = 1<<2,			///< error or hang-up, always reported
+		kEdgeTriggered = 1<<3	///< registration flag: report state changes only
+	};
+}
+
+//************************************************************************************************
+// ISocketEventHandler
+//************************************************************************************************
+
+struct ISocketEventHandler
+{
+	virtual ~ISocketEventHandler () {}
+
+	virtual void onSocketEvent (SocketID socket, int events) = 0;
+};
+
+//************************************************************************************************
+// SocketReactor
+/** Waits for events on a set of sockets and dispatches them to handlers.
+	Uses epoll() where available, select() otherwise. The select() backend is limited to
+	FD_SETSIZE sockets and treats edge-triggered registrations as level-triggered, i.e. handlers
+	of edge-triggered sockets have to read or write until the operation would block, but must
+	tolerate repeated notifications.
+	Handlers are called from the thread calling poll() without holding the internal lock. Sockets
+	can be added and removed from any thread, including from a handler. Once removeSocket()
+	returns, the handler of that socket won't be called anymore, called from another thread it
+	waits for a running handler of that socket. */
+//************************************************************************************************
+
+class SocketReactor
+{
+public:
+	SocketReactor ();
+	~SocketReactor ();
+
+	bool open ();
+	void close ();
+	bool isOpen () const;
+
+	/** Check if epoll() is used, i.e. the number of sockets is not limited by select(). */
+	static bool isScalable ();
+
+	bool addSocket (SocketID socket, int events, ISocketEventHandler* handler);
+	bool modifySocket (SocketID socket, int events);
+	bool removeSocket (SocketID socket);
+	int countSockets () const;
+
+	/** Wait for events and call handlers. Returns number of handler calls, -1 on error. */
+	int poll (int timeout);
+
+	/** Interrupt poll() from another thread. */
+	void wakeup ();
+
+protected:
+	struct Registration
+	{
+		SocketID socket;
+		int events;
+		ISocketEventHandler* handler;
+
+		Registration (SocketID socket = INVALID_SOCKET, int events = 0, ISocketEventHandler* handler = nullptr)
+		: socket (socket),
+		  events (events),
+		  handler (handler)
+		{}
+	};
+
+	mutable Threads::Lock lock;
+	Vector<Registration> registrations; ///< sorted by socket
+	bool opened;
+	SocketID dispatchingSocket;			///< socket of running handler
+	Threads::ThreadID dispatchThread;
+	Threads::Signal dispatchFinished;
+
+	#if CORE_SOCKET_REACTOR_EPOLL
+	int epollHandle;
+	int wakeupHandle;
+
+	static const int kMaxEvents = 64;
+	#else
+	Socket* wakeupSocket;
+	IPAddress wakeupAddress;
+	#endif
+
+	int findRegistration (SocketID socket) const;
+	int dispatch (SocketID socket, int events);
+};
+
+} // namespace Sockets
+} // namespace Core
+
+#endif // _coresocketreactor_h
@@ -33,10 +33,51 @@ struct ListEntry
 	ListEntry* volatile next;
 };
 	
+#if CORE_ATOMIC_STACK_DOUBLE_CAS
+
 //************************************************************************************************
 // ListHeader
 //************************************************************************************************
 
+struct ListHeader
+{
+	union
+	{
+		struct
+		{
+			ListEntry* head;
+			uint32 depth;
+			uint32 sequence; // incremented with every modification to avoid the ABA problem
+		};
+		LockFree::DoubleWord value;
+	};
+};
+
+static_assert (sizeof(ListHeader) == 16, "Unexpected list header size");
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+INLINE void readHeader (ListHeader& result, const ListHeader& header)
+{
+	// depth and sequence are in the second word, which is read first
+	LockFree::readDoubleWord (result.value, header.value);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+INLINE bool compareAndSwap (ListHeader& header, ListHeader& comparand, const ListHeader& value)
+{
+	// on failure, comparand receives the current value
+	return LockFree::testAndSetDoubleWord (header.value, comparand.value, value.value);
+}
+
+#else
+
+//************************************************************************************************
+// ListHeader
+/** Fallback for architectures without a 128 bit compare-and-swap. */
+//************************************************************************************************
+
 struct ListHeader
 {
 	// Want a volatile pointer to non-volatile data so place after all type info
@@ -89,12 +130,15 @@ private:
 	sched_param originalSchedParam;
 };
 
+#endif // CORE_ATOMIC_STACK_DOUBLE_CAS
+
 } // namespace Platform
 } // namespace Core
 
 using namespace Core;
 using namespace Platform;
 
+
 //************************************************************************************************
 // PosixAtomicStack
 //************************************************************************************************
@@ -107,7 +151,11 @@ PosixAtomicStack::PosixAtomicStack ()
 	ASSERT (head != nullptr)
 	head->head = nullptr;
 	head->depth = 0;
+	#if CORE_ATOMIC_STACK_DOUBLE_CAS
+	head->sequence = 0;
+	#else
 	head->mutex = 0;
+	#endif
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -117,6 +165,84 @@ PosixAtomicStack::~PosixAtomicStack ()
 	(::free) (head);
 }
 
+#if CORE_ATOMIC_STACK_DOUBLE_CAS
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+PosixAtomicStack::Element* PosixAtomicStack::pop ()
+{
+	ASSERT (head != nullptr)
+	ListHeader oldHeader;
+	ListHeader newHeader;
+	readHeader (oldHeader, *head);
+	do
+	{
+		if(oldHeader.head == nullptr)
+			return nullptr;
+
+		// the entry might have been popped by another thread meanwhile, but its memory is still
+		// accessible and the sequence number lets the compare-and-swap fail in that case
+		newHeader.head = oldHeader.head->next;
+		newHeader.depth = oldHeader.depth - 1;
+		newHeader.sequence = oldHeader.sequence + 1;
+	}
+	while(!compareAndSwap (*head, oldHeader, newHeader));
+
+	Element* e = reinterpret_cast<Element*> (oldHeader.head);
+	return e;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PosixAtomicStack::push (Element* e)
+{
+	ASSERT(((int64)e & 0x7) == 0)
+	ListEntry* newEntry = reinterpret_cast<ListEntry*> (e);
+	ASSERT (head != nullptr)
+
+	ListHeader oldHeader;
+	ListHeader newHeader;
+	readHeader (oldHeader, *head);
+	do
+	{
+		newEntry->next = oldHeader.head;
+		newHeader.head = newEntry;
+		newHeader.depth = oldHeader.depth + 1;
+		newHeader.sequence = oldHeader.sequence + 1;
+	}
+	while(!compareAndSwap (*head, oldHeader, newHeader));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PosixAtomicStack::flush ()
+{
+	ASSERT (head != nullptr)
+
+	ListHeader oldHeader;
+	ListHeader newHeader;
+	readHeader (oldHeader, *head);
+	do
+	{
+		newHeader.head = nullptr;
+		newHeader.depth = 0;
+		newHeader.sequence = oldHeader.sequence + 1;
+	}
+	while(!compareAndSwap (*head, oldHeader, newHeader));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int PosixAtomicStack::depth ()
+{
+	ASSERT (head != nullptr)
+	ListHeader header;
+	readHeader (header, *head);
+	return static_cast<int> (header.depth);
+}
+
+#else
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 PosixAtomicStack::Element* PosixAtomicStack::pop ()
@@ -184,3 +310,5 @@ int PosixAtomicStack::depth ()
 	ASSERT (head != nullptr)
 	return static_cast<int> (head->depth);
 }
+
+#endif // CORE_ATOMIC_STACK_DOUBLE_CAS
@@ -22,6 +22,17 @@
 
 #include "core/platform/shared/coreplatformatomicstack.h"
 #include "core/system/coreatomic.h"
+#include "core/public/corelockfree.h"
+
+/** Use a lock-free implementation based on a 128 bit compare-and-swap (see Core::LockFree::DoubleWord),
+	otherwise push and pop are guarded by a spin lock. */
+#ifndef CORE_ATOMIC_STACK_DOUBLE_CAS
+	#if CORE_PLATFORM_LINUX && CORE_PLATFORM_64BIT && CORE_LOCKFREE_DOUBLE_CAS
+		#define CORE_ATOMIC_STACK_DOUBLE_CAS 1
+	#else
+		#define CORE_ATOMIC_STACK_DOUBLE_CAS 0
+	#endif
+#endif
 
 namespace Core {
 namespace Platform {
@@ -87,11 +87,12 @@ static const int kAttrMediumPoolSize = 4000;
 static const int kAttrLargePoolSize = 10000;
 static const int kAttrSmallStringSize = 32;
 
-DEFINE_OBJECTPOOL_SIZE (Attribute2, CoreMemoryPool, kAttrLargePoolSize)
-DEFINE_OBJECTPOOL_SIZE (AttributeValue2, CoreMemoryPool, kAttrPoolSize)
-DEFINE_OBJECTPOOL_SIZE (Attributes2, CoreMemoryPool, kAttrMediumPoolSize)
-DEFINE_OBJECTPOOL_SIZE (AttributeQueue2, CoreMemoryPool, kAttrPoolSize)
-static CoreMemoryPool gSmallStringPool (kAttrSmallStringSize, kAttrPoolSize, "SmallStringPool");
+// attributes are created and released by many threads concurrently
+DEFINE_OBJECTPOOL_CACHED (Attribute2, CoreMemoryPool, kAttrLargePoolSize)
+DEFINE_OBJECTPOOL_CACHED (AttributeValue2, CoreMemoryPool, kAttrPoolSize)
+DEFINE_OBJECTPOOL_CACHED (Attributes2, CoreMemoryPool, kAttrMediumPoolSize)
+DEFINE_OBJECTPOOL_CACHED (AttributeQueue2, CoreMemoryPool, kAttrPoolSize)
+static CoreMemoryPool gSmallStringPool (kAttrSmallStringSize, kAttrPoolSize, "SmallStringPool", true);
 
 #endif // ATTRIBUTE_POOL_ENABLED
 
@@ -56,6 +56,19 @@ public:
 			return temp;
 		#endif
 	}
+	static INLINE bool testAndSet (int32 volatile& variable, int32 value, int32 comperand)
+	{
+		#if CORE_HAS_ATOMICS
+			return AtomicTestAndSet (variable, value, comperand);
+		#else
+			// This is not thread-safe!
+			if(variable != comperand)
+				return false;
+			variable = value;
+			return true;
+		#endif
+	}
+	static INLINE Threads::ThreadID getThreadID () { return Threads::CurrentThread::getID (); }
 };
 
 //************************************************************************************************
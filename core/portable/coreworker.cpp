@@ -153,16 +153,22 @@ void BackgroundWorker::setCurrentTask (BackgroundTask* task)
 
 void BackgroundWorker::terminate ()
 {
-	Threads::ScopedLock scopedLock (lock);
-	shouldTerminate = true;
-	if(thread)
+	WorkerThread* oldThread = nullptr;
 	{
-		if(!thread->join (5000))
-			thread->terminate ();
-		delete thread;
-		thread = nullptr;			
+		// remove pending tasks, the current task is finished by the thread
+		Threads::ScopedLock scopedLock (lock);
+		shouldTerminate = true;
+		oldThread = thread;
+		thread = nullptr;
+		while(BackgroundTask* t = tasks.removeFirst ())
+			delete t;
+	}
+
+	// don't hold the lock while joining, the thread needs it to finish the current task
+	if(oldThread)
+	{
+		if(!oldThread->join (5000))
+			oldThread->terminate ();
+		delete oldThread;
 	}
-		
-	while(BackgroundTask* t = tasks.removeFirst ())
-		delete t;
 }
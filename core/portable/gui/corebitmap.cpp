@@ -29,6 +29,10 @@
 #include "core/text/coretexthelper.h"
 #include "core/portable/corepersistence.h"
 #include "core/portable/coreprofiling.h"
+#include "core/portable/coreworker.h"
+#include "core/portable/corefile.h"
+#include "core/portable/corecrc.h"
+#include "core/system/coreatomic.h"
 
 #define LOG_TOTAL_BITMAP_MEMORY \
 	CORE_PRINTF ("Total bitmap memory used: %.2f MB\n", (float)Bitmap::getTotalBitmapMemory () / 1024.f / 1024.f)
@@ -84,17 +88,34 @@ public:
 		if(!readInfo (width, height, hasAlpha))
 			return nullptr;
 
+		Bitmap* bitmap = createBitmap (width, height, hasAlpha, Bitmap::kUninitialized);
+		BitmapData& bitmapData = bitmap->accessForWrite ();
+		readBitmapData (bitmapData);
+		return bitmap;
+	}
+
+	/** Read header only and allocate bitmap in the format readImage () would use. */
+	Bitmap* readPlaceholder ()
+	{
+		int width = 0, height = 0;
+		bool hasAlpha = false;
+		if(!readInfo (width, height, hasAlpha))
+			return nullptr;
+
+		return createBitmap (width, height, hasAlpha, 0); // cleared
+	}
+
+	Bitmap* createBitmap (int width, int height, bool hasAlpha, int options) const
+	{
 		Bitmap* bitmap = nullptr;
 		if(requestedFormat == kBitmapMonochrome)
-			bitmap = NEW Bitmap (width, height, kBitmapMonochrome, Bitmap::kUninitialized);
+			bitmap = NEW Bitmap (width, height, kBitmapMonochrome, options);
 		else if(requestedFormat == kBitmapRGB565 && (explicitFormat || !hasAlpha))
-			bitmap = NEW Bitmap (width, height, kBitmapRGB565, Bitmap::kUninitialized);
+			bitmap = NEW Bitmap (width, height, kBitmapRGB565, options);
 		else
-			bitmap = NEW Bitmap (width, height, kBitmapRGBAlpha, Bitmap::kUninitialized);
+			bitmap = NEW Bitmap (width, height, kBitmapRGBAlpha, options);
 
 		bitmap->setAlphaChannelUsed (hasAlpha);
-		BitmapData& bitmapData = bitmap->accessForWrite ();
-		readBitmapData (bitmapData);
 		return bitmap;
 	}
 
@@ -199,6 +220,156 @@ public:
 	}
 };
 
+//************************************************************************************************
+// DecodedBitmapCache
+/** Raw pixels of decoded bitmaps, one file per bitmap. The file name is built from CRC and size
+	of the encoded file data, scale factor and pixel format. */
+//************************************************************************************************
+
+class DecodedBitmapCache
+{
+public:
+	static void getPath (FileName& path, CStringPtr folder, const IO::MemoryStream& fileData, float scaleFactor, BitmapPixelFormat format)
+	{
+		Crc32 crc;
+		crc.update (fileData.getBuffer ().getAddress (), fileData.getBytesWritten ());
+
+		CString64 name;
+		name.appendFormat ("%08x-%x-%d-%d.pixels", crc.get (), fileData.getBytesWritten (),
+						   (int)(scaleFactor * 100.f), (int)format);
+		path = folder;
+		path.descend (name);
+	}
+
+	static bool restore (Bitmap& bitmap, CStringPtr path)
+	{
+		FileStream file;
+		if(!file.open (path, IO::kReadMode))
+			return false;
+
+		Header header = {};
+		if(file.readBytes (&header, sizeof(Header)) != sizeof(Header) || !header.matches (bitmap))
+			return false;
+
+		int size = (int)header.bufferSize;
+		return file.readBytes (bitmap.getBufferAddress (), size) == size;
+	}
+
+	static bool store (const Bitmap& bitmap, CStringPtr path)
+	{
+		FileName tempPath (path);
+		tempPath.appendFormat (".%x.tmp", (uint32)Threads::CurrentThread::getID ()); // bitmaps with equal content might be stored concurrently
+
+		bool result = false;
+		{
+			FileStream file;
+			if(file.create (tempPath))
+			{
+				Header header (bitmap);
+				int size = (int)header.bufferSize;
+				result = file.writeBytes (&header, sizeof(Header)) == sizeof(Header) &&
+						 file.writeBytes (bitmap.getBufferAddress (), size) == size;
+			}
+		}
+
+		if(result)
+			result = FileUtils::renameFile (tempPath, path);
+		if(!result)
+			FileUtils::deleteFile (tempPath);
+		return result;
+	}
+
+protected:
+	static const uint32 kFormatVersion = 1;
+
+	struct Header
+	{
+		uint32 version;
+		int32 width;
+		int32 height;
+		int32 format;
+		uint32 bufferSize;
+
+		Header () {}
+		Header (const Bitmap& bitmap)
+		: version (kFormatVersion),
+		  width (bitmap.getWidth ()),
+		  height (bitmap.getHeight ()),
+		  format (bitmap.getFormat ()),
+		  bufferSize (bitmap.getBufferSize ())
+		{}
+
+		bool matches (const Bitmap& bitmap) const
+		{
+			return version == kFormatVersion && width == bitmap.getWidth () && height == bitmap.getHeight ()
+				&& format == bitmap.getFormat () && bufferSize == bitmap.getBufferSize ();
+		}
+	};
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Decode state transitions (background decoding requires atomics)
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static INLINE bool testAndSetState (int32 volatile& state, int32 value, int32 comperand)
+{
+	#if CORE_HAS_ATOMICS
+		return AtomicTestAndSet (state, value, comperand);
+	#else
+		if(state != comperand)
+			return false;
+		state = value;
+		return true;
+	#endif
+}
+
+static INLINE void setState (int32 volatile& state, int32 value)
+{
+	#if CORE_HAS_ATOMICS
+		AtomicSet (state, value);
+	#else
+		state = value;
+	#endif
+}
+
+static INLINE int32 getState (const int32 volatile& state)
+{
+	#if CORE_HAS_ATOMICS
+		return AtomicGet (state);
+	#else
+		return state;
+	#endif
+}
+
+//************************************************************************************************
+// BitmapManager::DecodeTask
+//************************************************************************************************
+
+class BitmapManager::DecodeTask: public BackgroundTask
+{
+public:
+	DecodeTask (BitmapManager& manager, BitmapDescriptor& descriptor)
+	: manager (manager),
+	  descriptor (descriptor)
+	{}
+
+	// BackgroundTask
+	void work () override
+	{
+		// skip if main thread was faster or decoding is canceled
+		if(getState (manager.decodeCanceled) == 0 && testAndSetState (descriptor.decodeState, BitmapDescriptor::kDecoding, BitmapDescriptor::kDecodePending))
+		{
+			manager.decodeBitmap (descriptor);
+			setState (descriptor.decodeState, BitmapDescriptor::kDecodeFinished);
+			manager.decodeSignal.signal ();
+		}
+	}
+
+protected:
+	BitmapManager& manager;
+	BitmapDescriptor& descriptor;
+};
+
 } // namespace Portable
 } // namespace Core
 
@@ -355,6 +526,18 @@ uint32 Bitmap::getTotalBitmapMemory ()
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+void Bitmap::addTotalBitmapMemory (int32 delta)
+{
+	// bitmaps are also allocated by background decoding threads
+	#if CORE_HAS_ATOMICS
+	AtomicAdd ((int32 volatile&)totalBitmapMemory, delta);
+	#else
+	totalBitmapMemory += delta;
+	#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 void Bitmap::construct (int width, int height, BitmapPixelFormat format, int options, 
 						const uint8* externalBuffer,  uint32 externalBufferSize)
 {
@@ -383,7 +566,7 @@ void Bitmap::construct (int width, int height, BitmapPixelFormat format, int opt
 	if(!(options & kUninitialized))
 		BitmapPrimitives::clear (data);
 
-	totalBitmapMemory += pixelBuffer.getSize () + pixelBuffer.getAlignment ();
+	addTotalBitmapMemory (pixelBuffer.getSize () + pixelBuffer.getAlignment ());
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -427,7 +610,7 @@ Bitmap::Bitmap (const uint8* bitmapFileData, uint32 bitmapFileLength)
 
 Bitmap::~Bitmap ()
 {
-	totalBitmapMemory -= pixelBuffer.getSize () + pixelBuffer.getAlignment ();
+	addTotalBitmapMemory (-int32(pixelBuffer.getSize () + pixelBuffer.getAlignment ()));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -459,6 +642,25 @@ bool Bitmap::copyFrom (const Bitmap& bitmap)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool Bitmap::swapPixels (Bitmap& bitmap)
+{
+	if(bitmap.data.width != data.width || bitmap.data.height != data.height || bitmap.data.format != data.format
+		|| bitmap.data.rowBytes != data.rowBytes || bitmap.getBufferSize () != getBufferSize ())
+		return false;
+
+	IO::Buffer temp;
+	temp.take (pixelBuffer);
+	pixelBuffer.take (bitmap.pixelBuffer);
+	bitmap.pixelBuffer.take (temp);
+
+	BitmapData tempData (data);
+	data = bitmap.data;
+	bitmap.data = tempData;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 bool Bitmap::copyFrom (const Bitmap& bitmap, RectRef rect)
 {
 	const BitmapData& srcData = bitmap.accessForRead ();
@@ -530,6 +732,7 @@ BitmapManager::InternalStore::~InternalStore ()
 {
 	hashMap.removeAll ();
 	toDecode.removeAll ();
+	decoding.removeAll ();
 
 	BitmapDescriptor* descriptor = nullptr;
 	while((descriptor = descriptors.removeFirst ()) != nullptr)
@@ -547,18 +750,37 @@ DEFINE_STATIC_SINGLETON (BitmapManager)
 BitmapManager::BitmapManager ()
 : defaultFormat (kBitmapRGBAlpha),
   memoryLimit (0),
-  store (nullptr)
+  numDecodeThreads (0),
+  placeholdersEnabled (false),
+  store (nullptr),
+  nextDecodeWorker (0),
+  decodeCanceled (0)
 {}
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 BitmapManager::~BitmapManager ()
 {
+	terminate (); // workers access descriptors
 	delete store;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+void BitmapManager::terminate ()
+{
+	// workers skip their remaining tasks, bitmaps in progress are finished before the threads exit
+	setState (decodeCanceled, 1);
+	VectorForEach (decodeWorkers, BackgroundWorker*, worker)
+		worker->terminate ();
+		delete worker;
+	EndFor
+	decodeWorkers.removeAll ();
+	setState (decodeCanceled, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 BitmapManager::InternalStore& BitmapManager::getStore ()
 {
 	// allocate on demand, might not be used on low-end platforms
@@ -623,7 +845,8 @@ int BitmapManager::loadBitmaps (FilePackage& package, bool delayDecoding)
 						addBitmap (name, descriptor);
 						if(delayDecoding == true)
 						{
-							s.toDecode.add (descriptor);
+							if(!scheduleDecoding (*descriptor))
+								s.toDecode.add (descriptor);
 							observers.notify (&BitmapManagerObserver::onDelayLoadingBitmap, descriptor->getFileName ().str ());
 						}
 						else if(isAboveMemoryLimit () == false)
@@ -695,6 +918,146 @@ bool BitmapManager::loadBitmap (BitmapDescriptor& descriptor)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool BitmapManager::scheduleDecoding (BitmapDescriptor& descriptor)
+{
+	#if CORE_HAS_ATOMICS
+	if(numDecodeThreads <= 0 || isAboveMemoryLimit ())
+		return false;
+	if(BitmapFileFormat::detectFormat (descriptor.getFileName ()) != BitmapFileFormat::kPNG)
+		return false; // nothing to gain for BMP files
+
+	FilePackage* package = descriptor.getPackage ();
+	IO::Stream* stream = package ? package->openStream (descriptor.getFileName ()) : nullptr;
+	if(stream == nullptr)
+		return false;
+
+	// read file on calling thread, package access is not thread-safe
+	DecodeJob* job = NEW DecodeJob;
+	char buffer[8192];
+	int numRead = 0;
+	while((numRead = stream->readBytes (buffer, sizeof(buffer))) > 0)
+		job->fileData.writeBytes (buffer, numRead);
+	delete stream;
+
+	// allocate bitmap with final size and format, stays cleared until decoded
+	job->fileData.setPosition (0, IO::kSeekSet);
+	BitmapPixelFormat requestedFormat = descriptor.isMonochrome () ? kBitmapMonochrome : defaultFormat;
+	Bitmap* bitmap = nullptr;
+	PNGReader reader (job->fileData, requestedFormat, false);
+	if(reader.construct ())
+		bitmap = reader.readPlaceholder ();
+	if(bitmap == nullptr)
+	{
+		delete job;
+		return false;
+	}
+
+	bitmap->setFrameCount (descriptor.getFrameCount ());
+	if(!cacheFolder.isEmpty ())
+		DecodedBitmapCache::getPath (job->cachePath, cacheFolder, job->fileData, DpiSetting::instance ().getScaleFactor (), bitmap->getFormat ());
+
+	descriptor.setBitmap (bitmap);
+	descriptor.setDecodeJob (job);
+	descriptor.decodeState = BitmapDescriptor::kDecodePending;
+	getStore ().decoding.add (&descriptor);
+
+	if(decodeWorkers.isEmpty ())
+	{
+		if(!cacheFolder.isEmpty () && !FileUtils::dirExists (cacheFolder))
+			FileUtils::makeDirectory (cacheFolder);
+
+		for(int i = 0; i < numDecodeThreads; i++)
+		{
+			BackgroundWorker* worker = NEW BackgroundWorker;
+			worker->setPriority (Threads::kPriorityBelowNormal);
+			decodeWorkers.add (worker);
+		}
+	}
+	decodeWorkers[nextDecodeWorker++ % decodeWorkers.count ()]->addTask (NEW DecodeTask (*this, descriptor));
+	return true;
+	#else
+	return false;
+	#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void BitmapManager::decodeBitmap (BitmapDescriptor& descriptor)
+{
+	// exclusive access to job while in kDecoding state, the placeholder might be drawn meanwhile
+	DecodeJob* job = descriptor.getDecodeJob ();
+	const Bitmap* placeholder = descriptor.getBitmap ();
+	ASSERT (job != nullptr && placeholder != nullptr)
+	if(job == nullptr || placeholder == nullptr)
+		return;
+
+	Bitmap* bitmap = NEW Bitmap (placeholder->getWidth (), placeholder->getHeight (), placeholder->getFormat (), Bitmap::kUninitialized);
+	bool decoded = false;
+	bool cached = !job->cachePath.isEmpty ();
+	if(cached && DecodedBitmapCache::restore (*bitmap, job->cachePath))
+		decoded = true;
+	else
+	{
+		job->fileData.setPosition (0, IO::kSeekSet);
+		PNGReader reader (job->fileData, bitmap->getFormat (), true);
+		int width = 0, height = 0;
+		bool hasAlpha = false;
+		if(reader.construct () && reader.readInfo (width, height, hasAlpha) && width == bitmap->getWidth () && height == bitmap->getHeight ())
+		{
+			reader.readBitmapData (bitmap->accessForWrite ());
+			decoded = true;
+			if(cached)
+				DecodedBitmapCache::store (*bitmap, job->cachePath);
+		}
+	}
+
+	if(decoded)
+		job->decodedBitmap = bitmap;
+	else
+		delete bitmap; // placeholder stays cleared
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool BitmapManager::isDecodePending (const BitmapDescriptor& descriptor)
+{
+	return getState (descriptor.decodeState) != BitmapDescriptor::kDecoded;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool BitmapManager::finishDecoding (BitmapDescriptor& descriptor, bool decodeNow)
+{
+	if(decodeNow)
+	{
+		// decode on calling thread if no worker picked it up yet, otherwise wait for worker
+		if(testAndSetState (descriptor.decodeState, BitmapDescriptor::kDecoding, BitmapDescriptor::kDecodePending))
+		{
+			decodeBitmap (descriptor);
+			setState (descriptor.decodeState, BitmapDescriptor::kDecodeFinished);
+		}
+		else while(getState (descriptor.decodeState) == BitmapDescriptor::kDecoding)
+			decodeSignal.wait (Threads::kWaitForever);
+	}
+
+	if(getState (descriptor.decodeState) != BitmapDescriptor::kDecodeFinished)
+		return false;
+
+	// swap decoded pixels in on the thread drawing the bitmap
+	DecodeJob* job = descriptor.getDecodeJob ();
+	if(job && job->decodedBitmap)
+		descriptor.getBitmap ()->swapPixels (*job->decodedBitmap);
+	descriptor.setDecodeJob (nullptr);
+	delete job;
+
+	setState (descriptor.decodeState, BitmapDescriptor::kDecoded);
+	getStore ().decoding.remove (&descriptor);
+	observers.notify (&BitmapManagerObserver::onBitmapLoaded, descriptor.getFileName ().str ());
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 bool BitmapManager::isAboveMemoryLimit () const
 {
 	return memoryLimit > 0 && Bitmap::getTotalBitmapMemory () >= memoryLimit;
@@ -710,7 +1073,7 @@ void BitmapManager::reduceBitmaps ()
 	InternalStore& s = getStore ();
 	IntrusiveListForEachReverse (s.descriptors, BitmapDescriptor, descriptor)
 		const Bitmap* bitmap = descriptor->getBitmap ();
-		if(bitmap && !bitmap->isReferenced () && !descriptor->isAlwaysCached ())
+		if(bitmap && !bitmap->isReferenced () && !descriptor->isAlwaysCached () && !isDecodePending (*descriptor))
 		{
 			CORE_PRINTF ("Unloading bitmap %s\n", descriptor->getFileName ().str ())
 			descriptor->unload ();
@@ -749,7 +1112,12 @@ BitmapReference BitmapManager::getBitmap (CStringPtr name)
 		return BitmapReference ();
 	}
 
-	if(descriptor->getBitmap () == nullptr)
+	if(isDecodePending (*descriptor))
+	{
+		// decode on first use, unless a placeholder is acceptable and a worker will decode it
+		finishDecoding (*descriptor, placeholdersEnabled == false || decodeWorkers.isEmpty ());
+	}
+	else if(descriptor->getBitmap () == nullptr)
 	{
 		// reduce bitmaps before loading new ones
 		if(isAboveMemoryLimit ())
@@ -777,6 +1145,15 @@ BitmapReference BitmapManager::getBitmap (CStringPtr name)
 void BitmapManager::idle ()
 {
 	InternalStore& s = getStore ();
+
+	// announce bitmaps decoded in background
+	for(int i = s.decoding.count () - 1; i >= 0; i--)
+		finishDecoding (*s.decoding[i], false);
+
+	// decode remaining ones one by one after workers have been terminated
+	if(decodeWorkers.isEmpty () && !s.decoding.isEmpty ())
+		finishDecoding (*s.decoding.last (), true);
+
 	if(!s.toDecode.isEmpty ())
 	{
 		//CORE_PRINTF ("%d encoded bitmaps remaining...\n", s.toDecode.count ())		
@@ -32,11 +32,15 @@
 
 #include "core/portable/coreattributes.h"
 #include "core/portable/coresingleton.h"
+#include "core/portable/corefilename.h"
+#include "core/public/corememstream.h"
+#include "core/system/corethread.h"
 
 namespace Core {
 namespace Portable {
 
 class FilePackage;
+class BackgroundWorker;
 
 //************************************************************************************************
 // ResourceAttributes
@@ -127,6 +131,9 @@ public:
 	bool copyFrom (const Bitmap& bitmap);
 	bool copyFrom (const Bitmap& bitmap, RectRef rect);
 
+	/** Exchange pixel buffers with bitmap of same size and format, no pixels are copied. */
+	bool swapPixels (Bitmap& bitmap);
+
 	void* getBufferAddress () { return pixelBuffer.getAddressAligned (); }
 	const void* getBufferAddress () const { return pixelBuffer.getAddressAligned (); }
 	uint32 getBufferSize () const { return pixelBuffer.getSize (); }
@@ -139,6 +146,7 @@ public:
 protected:
 	static const int kAlignment = 8;
 	static uint32 totalBitmapMemory;
+	static void addTotalBitmapMemory (int32 delta);
 
 	BitmapData data;
 	IO::Buffer pixelBuffer;
@@ -234,6 +242,16 @@ public:
 	/** Set bitmap memory limit for caching (in bytes, default is 0 - no limit). */
 	PROPERTY_VARIABLE (uint32, memoryLimit, MemoryLimit)
 
+	/** Number of threads for delayed decoding of PNG files (default is 0 - decode in idle ()). 
+		Bitmaps are allocated with their final size when loaded and decoded in the background. */
+	PROPERTY_VARIABLE (int, numDecodeThreads, NumDecodeThreads)
+
+	/** Return cleared placeholders for bitmaps still decoded in the background, otherwise they are decoded on first use. */
+	PROPERTY_BOOL (placeholdersEnabled, PlaceholdersEnabled)
+
+	/** Folder for caching decoded pixels of delayed bitmaps, keyed by CRC of file data and scale factor (default is empty - no cache). */
+	PROPERTY_CSTRING_BUFFER (256, cacheFolder, CacheFolder)
+
 	/** Load bitmaps from package defined in 'bitmaps.json/.ubj' file. */
 	int loadBitmaps (FilePackage& package, bool delayDecoding = false);
 	
@@ -242,10 +260,29 @@ public:
 
 	/** Give idle time for delayed bitmap decoding (optional). */
 	void idle ();
+
+	/** Stop decoding threads, remaining bitmaps are decoded on first use (or in idle () if placeholders are enabled). */
+	void terminate ();
 	
 	DEFINE_OBSERVER (BitmapManagerObserver)
 
 protected:
+	struct DecodeJob
+	{
+		IO::MemoryStream fileData;	///< encoded file
+		FileName cachePath;			///< empty if not cached
+		Bitmap* decodedBitmap;		///< decoded by worker, swapped into placeholder by main thread
+
+		DecodeJob ()
+		: decodedBitmap (nullptr)
+		{}
+
+		~DecodeJob ()
+		{
+			delete decodedBitmap;
+		}
+	};
+
 	class BitmapDescriptor: public IntrusiveLink<BitmapDescriptor>
 	{
 	public:
@@ -254,14 +291,25 @@ protected:
 		  monochrome (false),
 		  frameCount (1),
 		  alwaysCached (false),
-		  bitmap (nullptr)
+		  bitmap (nullptr),
+		  decodeJob (nullptr),
+		  decodeState (kDecoded)
 		{}
 
 		~BitmapDescriptor ()
 		{
+			delete decodeJob;
 			delete bitmap;
 		}
 
+		enum DecodeStates
+		{
+			kDecoded,			///< bitmap (if any) can be used
+			kDecodePending,		///< bitmap is a placeholder, waiting for worker
+			kDecoding,			///< claimed by worker or main thread
+			kDecodeFinished		///< decoded into separate bitmap, not yet swapped in by main thread
+		};
+
 		PROPERTY_POINTER (FilePackage, package, Package)
 		PROPERTY_CSTRING_BUFFER (128, fileName, FileName)
 		PROPERTY_BOOL (monochrome, Monochrome)
@@ -274,6 +322,9 @@ protected:
 			delete bitmap;
 			bitmap = nullptr;
 		}
+
+		PROPERTY_POINTER (DecodeJob, decodeJob, DecodeJob)
+		int32 volatile decodeState;
 	};
 
 	struct InternalStore
@@ -281,16 +332,28 @@ protected:
 		IntrusiveLinkedList<BitmapDescriptor> descriptors;
 		HashMap<uint32, BitmapDescriptor*> hashMap;
 		Vector<BitmapDescriptor*> toDecode;
+		Vector<BitmapDescriptor*> decoding;	///< decoded in background
 
 		InternalStore ();
 		~InternalStore ();
 	};
 
+	class DecodeTask;
+
 	InternalStore* store;
+	Vector<BackgroundWorker*> decodeWorkers;
+	int nextDecodeWorker;
+	Threads::Signal decodeSignal; ///< signaled by workers when a bitmap has been decoded
+	int32 volatile decodeCanceled; ///< set while terminating, workers skip remaining tasks
+
 	InternalStore& getStore ();
 
 	void addBitmap (CStringPtr name, BitmapDescriptor* descriptor);
 	bool loadBitmap (BitmapDescriptor& descriptor);
+	bool scheduleDecoding (BitmapDescriptor& descriptor);
+	void decodeBitmap (BitmapDescriptor& descriptor); // called from any thread
+	bool finishDecoding (BitmapDescriptor& descriptor, bool decodeNow);
+	static bool isDecodePending (const BitmapDescriptor& descriptor);
 	bool isAboveMemoryLimit () const;
 	void reduceBitmaps ();
 };
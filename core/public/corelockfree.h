@@ -0,0 +1,502 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : core/public/corelockfree.h
+// Description : Lock-free Containers
+//
+//************************************************************************************************
+
+#ifndef _corelockfree_h
+#define _corelockfree_h
+
+#include "core/public/coretypes.h"
+
+/** Two pointer-sized words can be swapped atomically (cmpxchg16b, ldaxp/stlxp or a 64 bit
+	compare-and-swap on 32 bit platforms). */
+#ifndef CORE_LOCKFREE_DOUBLE_CAS
+	#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64) || defined(_M_IX86))
+		#define CORE_LOCKFREE_DOUBLE_CAS 1
+	#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__aarch64__))
+		#define CORE_LOCKFREE_DOUBLE_CAS 1
+	#elif defined(__GNUC__) && (defined(__i386__) || defined(__arm__)) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+		#define CORE_LOCKFREE_DOUBLE_CAS 1
+	#else
+		#define CORE_LOCKFREE_DOUBLE_CAS 0
+	#endif
+#endif
+
+#if CORE_LOCKFREE_DOUBLE_CAS && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Core {
+namespace LockFree {
+
+/*
+	The containers in this file need an outside implementation of atomic primitives:
+
+	struct AtomicPolicy
+	{
+		static int32 add (int32 volatile& variable, int32 value);	// returns old value
+		static int32 get (const int32 volatile& variable);
+		static bool testAndSet (int32 volatile& variable, int32 value, int32 comperand);
+		static void* getPtr (void* const volatile& variable);
+		static bool testAndSetPtr (void* volatile& variable, void* value, void* comperand);
+	};
+
+	All operations are expected to act as full memory barriers.
+*/
+
+static const int kCacheLineSize = 64;
+
+#if CORE_LOCKFREE_DOUBLE_CAS
+//************************************************************************************************
+// DoubleWord
+/**	Two pointer-sized words that are compared and swapped as a unit. The second word is
+	expected to be a modification counter, see readDoubleWord ().
+	\ingroup core_collect */
+//************************************************************************************************
+
+struct alignas(2 * sizeof(void*)) DoubleWord
+{
+	UIntPtr words[2];
+};
+
+/** Compare variable with comperand and assign value if equal, comperand receives the current
+	value otherwise. Acts as full memory barrier. */
+INLINE bool testAndSetDoubleWord (DoubleWord& variable, DoubleWord& comperand, const DoubleWord& value);
+
+/** Read variable, the words are read separately. The counter is read first: if it is unchanged at
+	the time of a subsequent testAndSetDoubleWord (), the first word is unchanged, too. A torn read
+	makes the compare-and-swap fail. */
+INLINE void readDoubleWord (DoubleWord& result, const DoubleWord& variable);
+#endif // CORE_LOCKFREE_DOUBLE_CAS
+
+//************************************************************************************************
+// BoundedQueue
+/**	Bounded multi-producer/multi-consumer queue -> First In First Out.
+	Ring buffer with a sequence counter per cell, the capacity is rounded up to a power of two.
+	Memory is allocated once in the constructor, push() and pop() don't allocate.
+	\ingroup core_collect */
+//************************************************************************************************
+
+template <typename T, class AtomicPolicy>
+class BoundedQueue
+{
+public:
+	BoundedQueue (int capacity);
+	~BoundedQueue ();
+
+	/** Get capacity, i.e. max. number of elements. */
+	int getCapacity () const;
+
+	/** Approximate number of elements, might be outdated when returned. */
+	int count () const;
+
+	/** Add element to back, returns false if queue is full. */
+	bool push (const T& data);
+
+	/** Remove element from front, returns false if queue is empty. */
+	bool pop (T& data);
+
+protected:
+	struct Cell
+	{
+		int32 volatile sequence;
+		T data;
+	};
+
+	Cell* cells;
+	int32 mask;
+	char padding1[kCacheLineSize];
+	int32 volatile enqueuePosition;
+	char padding2[kCacheLineSize - sizeof(int32)];
+	int32 volatile dequeuePosition;
+	char padding3[kCacheLineSize - sizeof(int32)];
+
+	// positions wrap around, compare as signed distance
+	static INLINE int32 distance (int32 a, int32 b) { return (int32)((uint32)a - (uint32)b); }
+	static INLINE int32 advance (int32 position, int32 delta) { return (int32)((uint32)position + (uint32)delta); }
+};
+
+//************************************************************************************************
+// TaggedStack
+/**	Multi-producer/multi-consumer stack -> Last In First Out.
+	The head pointer is stored together with a modification count and updated with a double-width
+	compare-and-swap to avoid the ABA problem of a plain CAS stack. No pointer bits are used
+	for the count, so any address layout (5-level paging, top byte tags) is supported.
+	Without CORE_LOCKFREE_DOUBLE_CAS, pop() and flush() are serialized by a spin lock, push()
+	stays lock-free.
+	T must have a 'next' pointer member. Memory of popped elements must stay accessible while
+	other threads might still use the stack (e.g. elements from a pool).
+	\ingroup core_collect */
+//************************************************************************************************
+
+template <typename T, class AtomicPolicy>
+class TaggedStack
+{
+public:
+	TaggedStack ();
+
+	/** Check if stack is empty. */
+	bool isEmpty () const;
+
+	/** Push element. */
+	void push (T* e);
+
+	/** Pop element, returns null if stack is empty. */
+	T* pop ();
+
+	/** Remove all elements. */
+	void flush ();
+
+protected:
+	#if CORE_LOCKFREE_DOUBLE_CAS
+	DoubleWord head;		///< top element and modification count
+	#else
+	void* volatile head;
+	int32 volatile popLock;	///< no element can be popped and pushed back while another thread pops
+	#endif
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// BoundedQueue implementation
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+BoundedQueue<T, AtomicPolicy>::BoundedQueue (int capacity)
+: cells (nullptr),
+  mask (0),
+  enqueuePosition (0),
+  dequeuePosition (0)
+{
+	int size = 2;
+	while(size < capacity)
+		size <<= 1;
+
+	cells = NEW Cell[size];
+	for(int i = 0; i < size; i++)
+		cells[i].sequence = i;
+	mask = size - 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+BoundedQueue<T, AtomicPolicy>::~BoundedQueue ()
+{
+	delete [] cells;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+int BoundedQueue<T, AtomicPolicy>::getCapacity () const
+{
+	return mask + 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+int BoundedQueue<T, AtomicPolicy>::count () const
+{
+	int result = distance (AtomicPolicy::get (enqueuePosition), AtomicPolicy::get (dequeuePosition));
+	return result < 0 ? 0 : result > mask + 1 ? mask + 1 : result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+bool BoundedQueue<T, AtomicPolicy>::push (const T& data)
+{
+	Cell* cell = nullptr;
+	int32 position = AtomicPolicy::get (enqueuePosition);
+	while(true)
+	{
+		cell = &cells[position & mask];
+		int32 diff = distance (AtomicPolicy::get (cell->sequence), position);
+		if(diff == 0)
+		{
+			// cell is free, try to claim it
+			if(AtomicPolicy::testAndSet (enqueuePosition, advance (position, 1), position))
+				break;
+			position = AtomicPolicy::get (enqueuePosition);
+		}
+		else if(diff < 0)
+			return false; // full
+		else
+			position = AtomicPolicy::get (enqueuePosition); // another producer was faster
+	}
+
+	cell->data = data;
+	AtomicPolicy::add (cell->sequence, 1); // publish to consumers
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+bool BoundedQueue<T, AtomicPolicy>::pop (T& data)
+{
+	Cell* cell = nullptr;
+	int32 position = AtomicPolicy::get (dequeuePosition);
+	while(true)
+	{
+		cell = &cells[position & mask];
+		int32 diff = distance (AtomicPolicy::get (cell->sequence), advance (position, 1));
+		if(diff == 0)
+		{
+			// cell is filled, try to claim it
+			if(AtomicPolicy::testAndSet (dequeuePosition, advance (position, 1), position))
+				break;
+			position = AtomicPolicy::get (dequeuePosition);
+		}
+		else if(diff < 0)
+			return false; // empty
+		else
+			position = AtomicPolicy::get (dequeuePosition); // another consumer was faster
+	}
+
+	data = cell->data;
+	AtomicPolicy::add (cell->sequence, mask); // free cell for next round of producers
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// DoubleWord implementation
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if CORE_LOCKFREE_DOUBLE_CAS
+INLINE bool testAndSetDoubleWord (DoubleWord& variable, DoubleWord& comperand, const DoubleWord& value)
+{
+	#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	return _InterlockedCompareExchange128 ((__int64 volatile*)variable.words, (__int64)value.words[1], (__int64)value.words[0], (__int64*)comperand.words) != 0;
+
+	#elif defined(_MSC_VER)
+	__int64 expected = *(__int64*)comperand.words;
+	__int64 old = _InterlockedCompareExchange64 ((__int64 volatile*)variable.words, *(const __int64*)value.words, expected);
+	*(__int64*)comperand.words = old;
+	return old == expected;
+
+	#elif defined(__x86_64__)
+	bool result = false;
+	__asm__ __volatile__
+	(
+		"lock cmpxchg16b %1\n\t"
+		"sete %0"
+		: "=q" (result), "+m" (variable.words[0]), "+a" (comperand.words[0]), "+d" (comperand.words[1])
+		: "b" (value.words[0]), "c" (value.words[1])
+		: "cc", "memory"
+	);
+	return result;
+
+	#elif defined(__aarch64__)
+	UIntPtr oldLow = 0;
+	UIntPtr oldHigh = 0;
+	uint32 status = 0;
+	__asm__ __volatile__
+	(
+		"1:	ldaxp	%0, %1, %3\n\t"
+		"	cmp		%0, %4\n\t"
+		"	ccmp	%1, %5, #0, eq\n\t"
+		"	b.ne	2f\n\t"
+		"	stlxp	%w2, %6, %7, %3\n\t"
+		"	cbnz	%w2, 1b\n"
+		"2:"
+		: "=&r" (oldLow), "=&r" (oldHigh), "+&r" (status), "+Q" (variable.words[0])
+		: "r" (comperand.words[0]), "r" (comperand.words[1]), "r" (value.words[0]), "r" (value.words[1])
+		: "cc", "memory"
+	);
+	bool result = oldLow == comperand.words[0] && oldHigh == comperand.words[1];
+	comperand.words[0] = oldLow;
+	comperand.words[1] = oldHigh;
+	return result;
+
+	#else
+	// 32 bit platforms, lock-free according to __GCC_HAVE_SYNC_COMPARE_AND_SWAP_8
+	return __atomic_compare_exchange (&variable, &comperand, const_cast<DoubleWord*> (&value), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+INLINE void readDoubleWord (DoubleWord& result, const DoubleWord& variable)
+{
+	#if defined(_MSC_VER)
+	// no atomic loads with acquire semantics here, exchange the current value with itself
+	result.words[0] = result.words[1] = 0;
+	DoubleWord zero = result;
+	testAndSetDoubleWord (const_cast<DoubleWord&> (variable), result, zero);
+	#else
+	result.words[1] = __atomic_load_n (&variable.words[1], __ATOMIC_ACQUIRE);
+	result.words[0] = __atomic_load_n (&variable.words[0], __ATOMIC_ACQUIRE);
+	#endif
+}
+#endif // CORE_LOCKFREE_DOUBLE_CAS
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// TaggedStack implementation
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if CORE_LOCKFREE_DOUBLE_CAS
+template <typename T, class AtomicPolicy>
+TaggedStack<T, AtomicPolicy>::TaggedStack ()
+{
+	head.words[0] = 0;
+	head.words[1] = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+bool TaggedStack<T, AtomicPolicy>::isEmpty () const
+{
+	DoubleWord current;
+	readDoubleWord (current, head);
+	return current.words[0] == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+void TaggedStack<T, AtomicPolicy>::push (T* e)
+{
+	DoubleWord oldHead;
+	DoubleWord newHead;
+	readDoubleWord (oldHead, head);
+	do
+	{
+		e->next = reinterpret_cast<T*> (oldHead.words[0]);
+		newHead.words[0] = reinterpret_cast<UIntPtr> (e);
+		newHead.words[1] = oldHead.words[1] + 1;
+	}
+	while(!testAndSetDoubleWord (head, oldHead, newHead));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+T* TaggedStack<T, AtomicPolicy>::pop ()
+{
+	DoubleWord oldHead;
+	DoubleWord newHead;
+	T* e = nullptr;
+	readDoubleWord (oldHead, head);
+	do
+	{
+		e = reinterpret_cast<T*> (oldHead.words[0]);
+		if(e == nullptr)
+			return nullptr;
+		newHead.words[0] = reinterpret_cast<UIntPtr> (e->next);
+		newHead.words[1] = oldHead.words[1] + 1;
+	}
+	while(!testAndSetDoubleWord (head, oldHead, newHead));
+
+	e->next = nullptr;
+	return e;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+void TaggedStack<T, AtomicPolicy>::flush ()
+{
+	DoubleWord oldHead;
+	DoubleWord newHead;
+	readDoubleWord (oldHead, head);
+	do
+	{
+		newHead.words[0] = 0;
+		newHead.words[1] = oldHead.words[1] + 1;
+	}
+	while(!testAndSetDoubleWord (head, oldHead, newHead));
+}
+
+#else
+
+template <typename T, class AtomicPolicy>
+TaggedStack<T, AtomicPolicy>::TaggedStack ()
+: head (nullptr),
+  popLock (0)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+bool TaggedStack<T, AtomicPolicy>::isEmpty () const
+{
+	return AtomicPolicy::getPtr (head) == nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+void TaggedStack<T, AtomicPolicy>::push (T* e)
+{
+	void* oldHead = nullptr;
+	do
+	{
+		oldHead = AtomicPolicy::getPtr (head);
+		e->next = static_cast<T*> (oldHead);
+	}
+	while(!AtomicPolicy::testAndSetPtr (head, e, oldHead));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+T* TaggedStack<T, AtomicPolicy>::pop ()
+{
+	while(!AtomicPolicy::testAndSet (popLock, 1, 0))
+		;
+
+	void* oldHead = nullptr;
+	T* e = nullptr;
+	do
+	{
+		oldHead = AtomicPolicy::getPtr (head);
+		e = static_cast<T*> (oldHead);
+	}
+	while(e && !AtomicPolicy::testAndSetPtr (head, e->next, oldHead));
+
+	AtomicPolicy::testAndSet (popLock, 0, 1);
+
+	if(e)
+		e->next = nullptr;
+	return e;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, class AtomicPolicy>
+void TaggedStack<T, AtomicPolicy>::flush ()
+{
+	while(!AtomicPolicy::testAndSet (popLock, 1, 0))
+		;
+
+	void* oldHead = nullptr;
+	do
+	{
+		oldHead = AtomicPolicy::getPtr (head);
+	}
+	while(!AtomicPolicy::testAndSetPtr (head, nullptr, oldHead));
+
+	AtomicPolicy::testAndSet (popLock, 0, 1);
+}
+#endif // CORE_LOCKFREE_DOUBLE_CAS
+
+} // namespace LockFree
+} // namespace Core
+
+#endif // _corelockfree_h
@@ -39,6 +39,10 @@ DEFINE_OBJECTPOOL_SIZE (Class, Pool, 0)
 #define DEFINE_OBJECTPOOL_SIZE(Class, Pool, count) \
 namespace Core { template<> Pool Core::PooledObject<Class, Pool>::__pool (sizeof(Class), count, #Class); }
 
+/** Object pool with per-thread block cache, for objects allocated and freed by many threads concurrently. */
+#define DEFINE_OBJECTPOOL_CACHED(Class, Pool, count) \
+namespace Core { template<> Pool Core::PooledObject<Class, Pool>::__pool (sizeof(Class), count, #Class, true); }
+
 //************************************************************************************************
 // MemoryPoolInitializer
 /** Helper for lazy memory pool initialization. */
@@ -93,6 +97,15 @@ public:
 //************************************************************************************************
 // MemoryPool
 /**	Memory pool template class, needs an outside atomic stack implementation.
+
+	With the thread cache enabled, blocks are kept in per-thread magazines, which are exchanged
+	with the shared stack in batches of kMagazineSize blocks. Threads are mapped to a fixed number
+	of cache slots, a thread falls back to the shared stack if its slot is busy.
+	Note that blocks held in other threads' caches are not available to the current thread.
+
+	The policy class has to provide:
+	- typedefs Stack and Element
+	- createStack (), releaseStack (), add (), testAndSet (), getThreadID ()
 	\ingroup core */
 //************************************************************************************************
 
@@ -100,12 +113,15 @@ template <class AtomicPolicy>
 class MemoryPool
 {
 public:
-	MemoryPool (uint32 blockSize, uint32 count = 0, CStringPtr name = nullptr);
+	MemoryPool (uint32 blockSize, uint32 count = 0, CStringPtr name = nullptr, bool threadCacheEnabled = false);
 	~MemoryPool ();
 	
 	/** Get memory pool name. */
 	CStringPtr getName () const;
 
+	/** Check if blocks are cached per thread. */
+	bool isThreadCacheEnabled () const;
+
 	/** Allocate pool memory blocks. */
 	bool allocate (uint32 count);
 	
@@ -126,7 +142,13 @@ public:
 	
 	/** Get number of bytes allocated. */
 	uint32 getBytesAllocated () const;
+
+	/** Get number of blocks allocated. */
+	uint32 getNumBlocksAllocated () const;
 	
+	/** Get number of blocks in use, excluding blocks held in thread caches. */
+	uint32 getNumBlocksUsed () const;
+
 	/** Get relation between used/free memory blocks (0..1). */
 	float getBlockUtilization () const;
 
@@ -142,12 +164,29 @@ protected:
 	static const int kBlockHeader = 'MEMB';	
 	#endif
 
+	static const int kNumCacheSlots = 16;
+	static const int kCacheSlotBits = 4;
+	static const int kMagazineSize = 32;
+	static const int kCacheLineSize = 64;
+
 	static void construct (void* instance, uint32 count);
 
+	struct CacheSlot
+	{
+		int32 volatile lock;
+		int32 volatile count;
+		Block* head;
+		char padding[kCacheLineSize - 2 * sizeof(int32) - sizeof(Block*)];
+	};
+
 	typename AtomicPolicy::Stack* blockStack;
+	typename AtomicPolicy::Stack* magazineStack; ///< full magazines, head block links to the remaining blocks
+	CacheSlot* cacheSlots; ///< aligned to cache lines within cacheSlotData
+	char* cacheSlotData;
+	bool threadCacheEnabled;
 	uint32 blockSize;
 	uint32 numBlocksAllocated;
-	uint32 numBlocksUsed;
+	uint32 numBlocksUsed; ///< includes blocks held in thread caches
 	CStringPtr name;
 	
 	struct Bucket
@@ -164,6 +203,14 @@ protected:
 	LinkedList<Bucket> allocatedData;
 
 	uint32 getBlockOffset () const;
+
+	void createCacheSlots ();
+	CacheSlot& getCacheSlot () const;
+	Block* newCachedBlock ();
+	bool deleteCachedBlock (Block* block);
+	void refillCacheSlot (CacheSlot& slot);
+	void flushCaches ();
+	static INLINE Block*& getMagazineLink (Block* block) { return reinterpret_cast<Block**> (block)[1]; }
 };
 
 //************************************************************************************************
@@ -231,8 +278,12 @@ private:
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 template <class AtomicPolicy>
-MemoryPool<AtomicPolicy>::MemoryPool (uint32 blockSize, uint32 count, CStringPtr name)
+MemoryPool<AtomicPolicy>::MemoryPool (uint32 blockSize, uint32 count, CStringPtr name, bool threadCacheEnabled)
 : blockStack (nullptr),
+  magazineStack (nullptr),
+  cacheSlots (nullptr),
+  cacheSlotData (nullptr),
+  threadCacheEnabled (threadCacheEnabled),
   blockSize (blockSize),
   numBlocksAllocated (0),
   numBlocksUsed (0),
@@ -253,6 +304,12 @@ void MemoryPool<AtomicPolicy>::construct (void* instance, uint32 count)
 	MemoryPool<AtomicPolicy>* This = reinterpret_cast<MemoryPool<AtomicPolicy>*> (instance);
 	This->blockStack = AtomicPolicy::createStack ();
 	ASSERT (This->blockStack != nullptr)
+	if(This->threadCacheEnabled)
+	{
+		This->magazineStack = AtomicPolicy::createStack ();
+		ASSERT (This->magazineStack != nullptr)
+		This->createCacheSlots ();
+	}
 	if(count > 0)
 		This->allocate (count);
 }
@@ -268,6 +325,9 @@ MemoryPool<AtomicPolicy>::~MemoryPool ()
 	#endif
 	deallocate ();	
 	AtomicPolicy::releaseStack (blockStack);
+	if(magazineStack)
+		AtomicPolicy::releaseStack (magazineStack);
+	delete [] cacheSlotData;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -280,6 +340,14 @@ CStringPtr MemoryPool<AtomicPolicy>::getName () const
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+template <class AtomicPolicy>
+bool MemoryPool<AtomicPolicy>::isThreadCacheEnabled () const
+{
+	return threadCacheEnabled;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 template <class AtomicPolicy>
 bool MemoryPool<AtomicPolicy>::allocate (uint32 count)
 {
@@ -349,6 +417,8 @@ template <class AtomicPolicy>
 void MemoryPool<AtomicPolicy>::deallocate ()
 {
 	blockStack->flush ();
+	if(cacheSlots)
+		flushCaches ();
 		
 	while(!allocatedData.isEmpty ())
 	{
@@ -366,7 +436,28 @@ void MemoryPool<AtomicPolicy>::deallocate ()
 template <class AtomicPolicy>
 void* MemoryPool<AtomicPolicy>::newBlock ()
 {
+	if(cacheSlots)
+		if(Block* block = newCachedBlock ())
+			return block;
+
 	Block* block = blockStack->pop ();
+	if(block == nullptr && magazineStack)
+	{
+		// cache slot held by another thread, free blocks might only be left in full magazines
+		block = magazineStack->pop ();
+		if(block)
+		{
+			Block* next = getMagazineLink (block);
+			while(next)
+			{
+				Block* remaining = next;
+				next = remaining->next;
+				remaining->next = nullptr;
+				blockStack->push (remaining);
+			}
+			block->next = nullptr;
+		}
+	}
 	if(block)
 		AtomicPolicy::add ((int32&)numBlocksUsed, 1);
 	return block;
@@ -385,6 +476,9 @@ void MemoryPool<AtomicPolicy>::deleteBlock (void* ptr)
 		#endif
 			
 		block->next = nullptr;
+		if(cacheSlots && deleteCachedBlock (block))
+			return;
+
 		blockStack->push (block);
 		AtomicPolicy::add ((int32&)numBlocksUsed, -1);
 	}
@@ -408,12 +502,32 @@ uint32 MemoryPool<AtomicPolicy>::getBytesAllocated () const
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+template <class AtomicPolicy>
+uint32 MemoryPool<AtomicPolicy>::getNumBlocksAllocated () const
+{
+	return numBlocksAllocated;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class AtomicPolicy>
+uint32 MemoryPool<AtomicPolicy>::getNumBlocksUsed () const
+{
+	int32 used = numBlocksUsed;
+	if(cacheSlots)
+		for(int i = 0; i < kNumCacheSlots; i++)
+			used -= cacheSlots[i].count; // might be outdated when other threads are active
+	return used < 0 ? 0 : (uint32)used;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 template <class AtomicPolicy>
 float MemoryPool<AtomicPolicy>::getBlockUtilization () const
 {
 	if(numBlocksAllocated == 0)
 		return 0.f;
-	return (float)numBlocksUsed / (float)numBlocksAllocated; 
+	return (float)getNumBlocksUsed () / (float)numBlocksAllocated; 
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -435,6 +549,140 @@ bool MemoryPool<AtomicPolicy>::check () const
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+template <class AtomicPolicy>
+void MemoryPool<AtomicPolicy>::createCacheSlots ()
+{
+	static_assert (sizeof(CacheSlot) == kCacheLineSize, "Cache slot size mismatch");
+
+	// slots must not share cache lines with each other or with other data
+	uint32 totalBytes = (kNumCacheSlots + 1) * kCacheLineSize;
+	cacheSlotData = NEW char[totalBytes];
+	ASSERT (cacheSlotData != nullptr)
+	::memset (cacheSlotData, 0, totalBytes); // unlocked and empty
+
+	UIntPtr address = ((UIntPtr)cacheSlotData + kCacheLineSize - 1) & ~(UIntPtr)(kCacheLineSize - 1);
+	cacheSlots = reinterpret_cast<CacheSlot*> (address);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class AtomicPolicy>
+typename MemoryPool<AtomicPolicy>::CacheSlot& MemoryPool<AtomicPolicy>::getCacheSlot () const
+{
+	uint64 id = (uint64)AtomicPolicy::getThreadID ();
+	uint32 hash = (uint32)(id ^ (id >> 12) ^ (id >> 32)) * 0x9E3779B1; // thread ids are often aligned addresses
+	return cacheSlots[hash >> (32 - kCacheSlotBits)];
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class AtomicPolicy>
+typename MemoryPool<AtomicPolicy>::Block* MemoryPool<AtomicPolicy>::newCachedBlock ()
+{
+	CacheSlot& slot = getCacheSlot ();
+	if(!AtomicPolicy::testAndSet (slot.lock, 1, 0))
+		return nullptr;
+
+	if(slot.count == 0)
+		refillCacheSlot (slot);
+
+	Block* block = slot.head;
+	if(block)
+	{
+		slot.head = block->next;
+		block->next = nullptr;
+		slot.count = slot.count - 1;
+	}
+
+	AtomicPolicy::testAndSet (slot.lock, 0, 1);
+	return block;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class AtomicPolicy>
+void MemoryPool<AtomicPolicy>::refillCacheSlot (CacheSlot& slot)
+{
+	ASSERT (slot.head == nullptr)
+
+	int32 count = 0;
+	if(Block* magazine = magazineStack->pop ())
+	{
+		magazine->next = getMagazineLink (magazine);
+		slot.head = magazine;
+		count = kMagazineSize;
+	}
+	else
+	{
+		while(count < kMagazineSize)
+		{
+			Block* block = blockStack->pop ();
+			if(block == nullptr)
+				break;
+			block->next = slot.head;
+			slot.head = block;
+			count++;
+		}
+	}
+
+	if(count > 0)
+	{
+		AtomicPolicy::add ((int32&)numBlocksUsed, count);
+		slot.count = count;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class AtomicPolicy>
+bool MemoryPool<AtomicPolicy>::deleteCachedBlock (Block* block)
+{
+	CacheSlot& slot = getCacheSlot ();
+	if(!AtomicPolicy::testAndSet (slot.lock, 1, 0))
+		return false;
+
+	block->next = slot.head;
+	slot.head = block;
+	slot.count = slot.count + 1;
+
+	// return one magazine to the shared stack, keep the other one for subsequent allocations
+	if(slot.count >= 2 * kMagazineSize)
+	{
+		Block* magazine = slot.head;
+		Block* last = magazine;
+		for(int i = 1; i < kMagazineSize; i++)
+			last = last->next;
+
+		slot.head = last->next;
+		slot.count = slot.count - kMagazineSize;
+		last->next = nullptr;
+
+		ASSERT (getBlockOffset () >= 2 * sizeof(Block*))
+		getMagazineLink (magazine) = magazine->next;
+		magazine->next = nullptr;
+		magazineStack->push (magazine);
+		AtomicPolicy::add ((int32&)numBlocksUsed, -kMagazineSize);
+	}
+
+	AtomicPolicy::testAndSet (slot.lock, 0, 1);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class AtomicPolicy>
+void MemoryPool<AtomicPolicy>::flushCaches ()
+{
+	magazineStack->flush ();
+	for(int i = 0; i < kNumCacheSlots; i++)
+	{
+		cacheSlots[i].head = nullptr;
+		cacheSlots[i].count = 0;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 } // namespace Core
 
 #endif // _coremempool_h
@@ -109,6 +109,21 @@ using Platform::AtomicGetPtr;
 */
 using Platform::AtomicTestAndSetPtr;
 
+//************************************************************************************************
+// AtomicPrimitives
+/** Atomic primitives as policy class for lock-free containers, see corelockfree.h.
+	\ingroup core_thread */
+//************************************************************************************************
+
+struct AtomicPrimitives
+{
+	static INLINE int32 add (int32 volatile& variable, int32 value) { return AtomicAdd (variable, value); }
+	static INLINE int32 get (const int32 volatile& variable) { return AtomicGet (variable); }
+	static INLINE bool testAndSet (int32 volatile& variable, int32 value, int32 comperand) { return AtomicTestAndSet (variable, value, comperand); }
+	static INLINE void* getPtr (void* const volatile& variable) { return AtomicGetPtr (variable); }
+	static INLINE bool testAndSetPtr (void* volatile& variable, void* value, void* comperand) { return AtomicTestAndSetPtr (variable, value, comperand); }
+};
+
 #endif // CORE_HAS_ATOMICS
 
 } // namespace Core
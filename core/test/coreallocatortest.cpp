@@ -19,10 +19,144 @@
 #include "coreallocatortest.h"
 
 #include "core/public/corepoolallocator.h"
+#include "core/public/corestringbuffer.h"
+
+#include "core/portable/corepool.h"
+
+#include "corestresstest.h"
+
+namespace Core {
+namespace Test {
+
+//************************************************************************************************
+// MemoryPoolTestThread
+//************************************************************************************************
+
+class MemoryPoolTestThread: public StressTestThread
+{
+public:
+	static const int kBatchSize = 64;
+	static const int kBlockSize = 48;
+
+	MemoryPoolTestThread (Portable::CoreMemoryPool& pool, int index, int iterations)
+	: StressTestThread ("Memory Pool Test Thread", index, iterations),
+	  pool (pool)
+	{}
+
+protected:
+	Portable::CoreMemoryPool& pool;
+
+	// StressTestThread
+	void run (int iteration) override
+	{
+		// allocate a batch and free it in reverse order, blocks must not be shared between threads
+		int32* blocks[kBatchSize] = {};
+		int numBlocks = 0;
+		for(; numBlocks < kBatchSize; numBlocks++)
+		{
+			blocks[numBlocks] = static_cast<int32*> (pool.newBlock ());
+			if(blocks[numBlocks] == nullptr)
+				break;
+			blocks[numBlocks][0] = index;
+			blocks[numBlocks][1] = numBlocks;
+		}
+
+		for(int j = numBlocks - 1; j >= 0; j--)
+		{
+			if(blocks[j][0] != index || blocks[j][1] != j)
+				numErrors++;
+			pool.deleteBlock (blocks[j]);
+		}
+		count += numBlocks;
+	}
+};
+
+//************************************************************************************************
+// SharedSlotPolicy
+/** Maps all threads to the same cache slot. */
+//************************************************************************************************
+
+class SharedSlotPolicy: public Portable::AtomicPolicy
+{
+public:
+	static INLINE Threads::ThreadID getThreadID () { return 0; }
+};
+
+//************************************************************************************************
+// SharedSlotTestPool
+//************************************************************************************************
+
+class SharedSlotTestPool: public MemoryPool<SharedSlotPolicy>
+{
+public:
+	SharedSlotTestPool (uint32 count)
+	: MemoryPool<SharedSlotPolicy> (MemoryPoolTestThread::kBlockSize, count, "SharedSlotTestPool", true)
+	{}
+
+	/** Simulate another thread holding the cache slot. */
+	void setCacheSlotLocked (bool state) { getCacheSlot ().lock = state ? 1 : 0; }
+	int getCacheSlotCount () const { return getCacheSlot ().count; }
+};
+
+//************************************************************************************************
+// PoolDrainTestThread
+//************************************************************************************************
+
+class PoolDrainTestThread: public StressTestThread
+{
+public:
+	static const int kMaxBlocks = 256;
+
+	PoolDrainTestThread (SharedSlotTestPool& pool, int index, int iterations)
+	: StressTestThread ("Pool Drain Test Thread", index, iterations),
+	  pool (pool)
+	{}
+
+protected:
+	SharedSlotTestPool& pool;
+
+	// StressTestThread
+	void run (int iteration) override
+	{
+		// allocate until the pool is exhausted, the other thread competes for the same cache slot
+		int32* blocks[kMaxBlocks] = {};
+		int numBlocks = 0;
+		for(; numBlocks < kMaxBlocks; numBlocks++)
+		{
+			blocks[numBlocks] = static_cast<int32*> (pool.newBlock ());
+			if(blocks[numBlocks] == nullptr)
+				break;
+			blocks[numBlocks][0] = index;
+			blocks[numBlocks][1] = numBlocks;
+		}
+
+		for(int j = numBlocks - 1; j >= 0; j--)
+		{
+			if(blocks[j][0] != index || blocks[j][1] != j)
+				numErrors++;
+			pool.deleteBlock (blocks[j]);
+		}
+		count += numBlocks;
+	}
+};
+
+//************************************************************************************************
+// CachedPoolTestObject
+//************************************************************************************************
+
+struct CachedPoolTestObject: PooledObject<CachedPoolTestObject, Portable::CoreMemoryPool>
+{
+	int64 data[4] = {};
+};
+
+} // namespace Test
+} // namespace Core
 
 using namespace Core;
 using namespace Test;
 
+DEFINE_OBJECTPOOL_CACHED (CachedPoolTestObject, Portable::CoreMemoryPool, 16)
+
 //************************************************************************************************
 // AllocatorTest
 //************************************************************************************************
@@ -117,3 +251,149 @@ bool AllocatorTest::run (ITestContext& testContext)
 
 	return true;
 }
+
+//************************************************************************************************
+// MemoryPoolTest
+//************************************************************************************************
+
+CORE_REGISTER_TEST (MemoryPoolTest)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CStringPtr MemoryPoolTest::getName () const
+{
+	return "Core Memory Pool";
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool MemoryPoolTest::run (ITestContext& testContext)
+{
+	static const int kIterations = 20000;
+	static const int kMaxThreads = 8;
+	static const int kNumBlocks = kMaxThreads * MemoryPoolTestThread::kBatchSize * 4;
+
+	bool succeeded = true;
+
+	// pools declared with DEFINE_OBJECTPOOL_CACHED
+	{
+		Portable::CoreMemoryPool& pool = CachedPoolTestObject::getPool ();
+		if(!pool.isThreadCacheEnabled ())
+		{
+			CORE_TEST_FAILED ("Thread cache not enabled for cached object pool.")
+			succeeded = false;
+		}
+
+		CachedPoolTestObject* objects[16] = {};
+		for(int i = 0; i < ARRAY_COUNT (objects); i++)
+			objects[i] = CachedPoolTestObject::pool_new ();
+		if(pool.getNumBlocksUsed () != ARRAY_COUNT (objects))
+		{
+			CORE_TEST_FAILED ("Memory pool utilization wrong with objects in use.")
+			succeeded = false;
+		}
+		for(int i = 0; i < ARRAY_COUNT (objects); i++)
+			delete objects[i];
+		if(pool.getNumBlocksUsed () != 0)
+		{
+			CORE_TEST_FAILED ("Memory pool utilization wrong after all objects have been freed.")
+			succeeded = false;
+		}
+	}
+
+	// free blocks in full magazines while the cache slot is held by another thread
+	{
+		static const int kNumBlocks = 128;
+		SharedSlotTestPool pool (kNumBlocks);
+
+		void* blocks[kNumBlocks] = {};
+		int numBlocks = 0;
+		while(numBlocks < kNumBlocks && (blocks[numBlocks] = pool.newBlock ()) != nullptr)
+			numBlocks++;
+		if(numBlocks != kNumBlocks)
+		{
+			CORE_TEST_FAILED ("Memory pool not drained completely.")
+			succeeded = false;
+		}
+		for(int i = 0; i < numBlocks; i++)
+			pool.deleteBlock (blocks[i]);
+
+		pool.setCacheSlotLocked (true);
+		int numExpected = numBlocks - pool.getCacheSlotCount ();
+		numBlocks = 0;
+		while(numBlocks < kNumBlocks && (blocks[numBlocks] = pool.newBlock ()) != nullptr)
+			numBlocks++;
+		if(numExpected <= 0 || numBlocks != numExpected)
+		{
+			CORE_TEST_FAILED ("Free blocks in magazines not used while cache slot is locked.")
+			succeeded = false;
+		}
+		for(int i = 0; i < numBlocks; i++)
+			pool.deleteBlock (blocks[i]);
+		pool.setCacheSlotLocked (false);
+
+		if(pool.getNumBlocksUsed () != 0 || !pool.check ())
+		{
+			CORE_TEST_FAILED ("Memory pool utilization wrong after draining with locked cache slot.")
+			succeeded = false;
+		}
+	}
+
+	// two threads sharing a cache slot, each draining the pool
+	{
+		SharedSlotTestPool pool (PoolDrainTestThread::kMaxBlocks / 2);
+
+		StressTestThread* threads[2] = {};
+		for(int i = 0; i < ARRAY_COUNT (threads); i++)
+			threads[i] = NEW PoolDrainTestThread (pool, i, kIterations / 10);
+
+		StressTestResult result = runStressTestThreads (threads, ARRAY_COUNT (threads));
+
+		if(result.numErrors != 0)
+		{
+			CORE_TEST_FAILED ("Memory block used by multiple threads.")
+			succeeded = false;
+		}
+		if(pool.getNumBlocksUsed () != 0 || !pool.check ())
+		{
+			CORE_TEST_FAILED ("Memory pool utilization wrong after draining from threads sharing a cache slot.")
+			succeeded = false;
+		}
+	}
+
+	for(int threadCache = 0; threadCache <= 1; threadCache++)
+	{
+		for(int numThreads = 1; numThreads <= kMaxThreads; numThreads *= 2)
+		{
+			Portable::CoreMemoryPool pool (MemoryPoolTestThread::kBlockSize, kNumBlocks, "TestPool", threadCache != 0);
+
+			StressTestThread* threads[kMaxThreads] = {};
+			for(int i = 0; i < numThreads; i++)
+				threads[i] = NEW MemoryPoolTestThread (pool, i, kIterations);
+
+			StressTestResult result = runStressTestThreads (threads, numThreads);
+
+			if(result.numErrors != 0)
+			{
+				CORE_TEST_FAILED ("Memory block used by multiple threads.")
+				succeeded = false;
+			}
+			if(pool.getNumBlocksUsed () != 0 || pool.getBlockUtilization () != 0.f)
+			{
+				CORE_TEST_FAILED ("Memory pool utilization wrong after all blocks have been freed.")
+				succeeded = false;
+			}
+			if(!pool.check ())
+			{
+				CORE_TEST_FAILED ("Memory pool corrupted.")
+				succeeded = false;
+			}
+
+			CStringBuffer<STRING_STACK_SPACE_MAX> message;
+			message.appendFormat ("MemoryPool%s: %d threads, %.2f M ops/s", threadCache ? " (thread cache)" : "", numThreads, result.getMegaOpsPerSecond ());
+			CORE_TEST_MESSAGE (message)
+		}
+	}
+
+	return succeeded;
+}
@@ -36,6 +36,18 @@ public:
 	bool run (ITestContext& testContext) override;
 };
 
+//************************************************************************************************
+// MemoryPoolTest
+//************************************************************************************************
+
+class MemoryPoolTest: public TestBase
+{
+public:
+	// TestBase
+	CStringPtr getName () const override;
+	bool run (ITestContext& testContext) override;
+};
+
 } // namespace Test
 } // namespace Core
 
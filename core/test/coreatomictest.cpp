@@ -19,7 +19,14 @@
 #include "coreatomictest.h"
 
 #include "core/system/coreatomic.h"
+#include "core/system/coreatomicstack.h"
 #include "core/system/corethread.h"
+#include "core/system/coretime.h"
+
+#include "core/public/corelockfree.h"
+#include "core/public/corestringbuffer.h"
+
+#include "corestresstest.h"
 
 namespace Core {
 namespace Test {
@@ -48,6 +55,171 @@ protected:
 	int32& value;
 };
 
+//************************************************************************************************
+// Lock-free test threads
+//************************************************************************************************
+
+static const int kMaxTestThreads = 8;
+
+typedef LockFree::BoundedQueue<int32, AtomicPrimitives> TestQueue;
+
+struct TestNode
+{
+	TestNode* next = nullptr;
+	int32 volatile owned = 0;
+};
+typedef LockFree::TaggedStack<TestNode, AtomicPrimitives> TestStack;
+
+//************************************************************************************************
+// QueueProducerThread
+//************************************************************************************************
+
+class QueueProducerThread: public StressTestThread
+{
+public:
+	QueueProducerThread (TestQueue& queue, int index, int iterations)
+	: StressTestThread ("Queue Producer Thread", index, iterations),
+	  queue (queue)
+	{}
+
+protected:
+	TestQueue& queue;
+
+	// StressTestThread
+	void run (int iteration) override
+	{
+		// values encode producer index and sequence number
+		while(!queue.push (iteration * kMaxTestThreads + index))
+			Threads::CurrentThread::yield ();
+		count++;
+	}
+};
+
+//************************************************************************************************
+// QueueConsumerThread
+//************************************************************************************************
+
+class QueueConsumerThread: public StressTestThread
+{
+public:
+	QueueConsumerThread (TestQueue& queue, int32 volatile& numRemaining, int64& sum, int index)
+	: StressTestThread ("Queue Consumer Thread", index, 0),
+	  queue (queue),
+	  numRemaining (numRemaining),
+	  sum (sum)
+	{
+		for(int i = 0; i < kMaxTestThreads; i++)
+			lastValue[i] = -1;
+	}
+
+	// Thread
+	int threadEntry () override
+	{
+		while(AtomicGet (numRemaining) > 0)
+		{
+			int32 value = 0;
+			if(!queue.pop (value))
+			{
+				Threads::CurrentThread::yield ();
+				continue;
+			}
+
+			AtomicAdd (numRemaining, -1);
+
+			// order of each producer must be preserved
+			int producer = value % kMaxTestThreads;
+			if(value <= lastValue[producer])
+				numErrors++;
+			lastValue[producer] = value;
+			sum += value;
+			count++;
+		}
+		return true;
+	}
+
+protected:
+	TestQueue& queue;
+	int32 volatile& numRemaining;
+	int64& sum;	///< written by this thread only
+	int32 lastValue[kMaxTestThreads];
+
+	// StressTestThread
+	void run (int iteration) override {}
+};
+
+//************************************************************************************************
+// QueuePushPopThread
+//************************************************************************************************
+
+class QueuePushPopThread: public StressTestThread
+{
+public:
+	QueuePushPopThread (TestQueue& queue, int index, int iterations)
+	: StressTestThread ("Queue Push/Pop Thread", index, iterations),
+	  queue (queue)
+	{}
+
+protected:
+	TestQueue& queue;
+
+	// StressTestThread
+	void run (int iteration) override
+	{
+		int32 value = 0;
+		while(!queue.push (iteration))
+			Threads::CurrentThread::yield ();
+		while(!queue.pop (value))
+			Threads::CurrentThread::yield ();
+		count++;
+	}
+};
+
+//************************************************************************************************
+// StackPopPushThread
+//************************************************************************************************
+
+template <class Stack, class Element>
+class StackPopPushThread: public StressTestThread
+{
+public:
+	StackPopPushThread (Stack& stack, int index, int iterations)
+	: StressTestThread ("Stack Pop/Push Thread", index, iterations),
+	  stack (stack)
+	{}
+
+protected:
+	Stack& stack;
+
+	// StressTestThread
+	void run (int iteration) override
+	{
+		Element* e = static_cast<Element*> (stack.pop ());
+		if(e == nullptr)
+		{
+			Threads::CurrentThread::yield ();
+			return;
+		}
+
+		// an element must never be handed out twice
+		if(!AtomicTestAndSet (e->owned, 1, 0))
+			numErrors++;
+		AtomicSet (e->owned, 0);
+
+		e->next = nullptr;
+		stack.push (e);
+		count++;
+	}
+};
+
+//************************************************************************************************
+// AtomicStackTestElement
+//************************************************************************************************
+
+struct AtomicStackTestElement: Platform::AtomicStackElement
+{
+	int32 volatile owned = 0;
+};
+
 } // namespace Test
 } // namespace Core
 
@@ -105,3 +277,260 @@ bool AtomicTest::run (ITestContext& testContext)
 	
 	return succeeded;
 }
+
+//************************************************************************************************
+// LockFreeQueueTest
+//************************************************************************************************
+
+CORE_REGISTER_TEST (LockFreeQueueTest)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CStringPtr LockFreeQueueTest::getName () const
+{
+	return "Core Lock-free Queue";
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool LockFreeQueueTest::run (ITestContext& testContext)
+{
+	typedef TestQueue Queue;
+	static const int kIterations = 100000;
+	static const int kNumProducers = 4;
+	static const int kNumConsumers = 4;
+
+	bool succeeded = true;
+
+	// single-threaded behavior
+	{
+		Queue queue (5);
+		if(queue.getCapacity () != 8)
+		{
+			CORE_TEST_FAILED ("Queue capacity is not rounded up to a power of two.")
+			succeeded = false;
+		}
+
+		int32 value = 0;
+		for(int i = 0; i < queue.getCapacity (); i++)
+			queue.push (i);
+		if(queue.push (100) || queue.count () != queue.getCapacity ())
+		{
+			CORE_TEST_FAILED ("Push succeeded on full queue.")
+			succeeded = false;
+		}
+		for(int i = 0; i < queue.getCapacity (); i++)
+			if(!queue.pop (value) || value != i)
+			{
+				CORE_TEST_FAILED ("Queue does not preserve order.")
+				succeeded = false;
+				break;
+			}
+		if(queue.pop (value) || queue.count () != 0)
+		{
+			CORE_TEST_FAILED ("Pop succeeded on empty queue.")
+			succeeded = false;
+		}
+	}
+
+	// stress test with multiple producers and consumers
+	{
+		Queue queue (64);
+		int32 volatile numRemaining = kIterations * kNumProducers;
+
+		int64 sums[kNumConsumers] = {};
+
+		StressTestThread* threads[kNumProducers + kNumConsumers];
+		for(int i = 0; i < kNumProducers; i++)
+			threads[i] = NEW QueueProducerThread (queue, i, kIterations);
+		for(int i = 0; i < kNumConsumers; i++)
+			threads[kNumProducers + i] = NEW QueueConsumerThread (queue, numRemaining, sums[i], i);
+
+		StressTestResult result = runStressTestThreads (threads, kNumProducers + kNumConsumers);
+
+		int64 sum = 0;
+		for(int64 s : sums)
+			sum += s;
+
+		int64 expectedSum = 0;
+		for(int i = 0; i < kIterations; i++)
+			for(int p = 0; p < kNumProducers; p++)
+				expectedSum += i * kMaxTestThreads + p;
+
+		// producers and consumers both count each element
+		if(result.count != 2 * kIterations * kNumProducers || sum != expectedSum)
+		{
+			CORE_TEST_FAILED ("Elements lost or duplicated with concurrent producers and consumers.")
+			succeeded = false;
+		}
+		if(result.numErrors != 0)
+		{
+			CORE_TEST_FAILED ("Order of elements from one producer not preserved.")
+			succeeded = false;
+		}
+	}
+
+	// throughput with 1..N threads, each pushing and popping
+	for(int numThreads = 1; numThreads <= kMaxTestThreads; numThreads *= 2)
+	{
+		Queue queue (1024);
+		StressTestThread* threads[kMaxTestThreads] = {};
+		for(int i = 0; i < numThreads; i++)
+			threads[i] = NEW QueuePushPopThread (queue, i, kIterations);
+
+		StressTestResult result = runStressTestThreads (threads, numThreads);
+
+		CStringBuffer<STRING_STACK_SPACE_MAX> message;
+		message.appendFormat ("BoundedQueue: %d threads, %.2f M ops/s", numThreads, result.getMegaOpsPerSecond ());
+		CORE_TEST_MESSAGE (message)
+	}
+
+	return succeeded;
+}
+
+//************************************************************************************************
+// LockFreeStackTest
+//************************************************************************************************
+
+CORE_REGISTER_TEST (LockFreeStackTest)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CStringPtr LockFreeStackTest::getName () const
+{
+	return "Core Lock-free Stack";
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool LockFreeStackTest::run (ITestContext& testContext)
+{
+	typedef TestNode Node;
+	typedef TestStack Stack;
+	static const int kIterations = 200000;
+	static const int kNumNodes = 4; // few nodes provoke ABA situations
+
+	bool succeeded = true;
+
+	Node nodes[kNumNodes];
+
+	// single-threaded behavior
+	{
+		Stack stack;
+		for(int i = 0; i < kNumNodes; i++)
+			stack.push (&nodes[i]);
+		for(int i = kNumNodes - 1; i >= 0; i--)
+			if(stack.pop () != &nodes[i])
+			{
+				CORE_TEST_FAILED ("Stack does not return elements in LIFO order.")
+				succeeded = false;
+				break;
+			}
+		if(!stack.isEmpty () || stack.pop () != nullptr)
+		{
+			CORE_TEST_FAILED ("Stack not empty.")
+			succeeded = false;
+		}
+	}
+
+	// stress test and throughput with 1..N threads
+	for(int numThreads = 1; numThreads <= kMaxTestThreads; numThreads *= 2)
+	{
+		Stack stack;
+		for(int i = 0; i < kNumNodes; i++)
+			stack.push (&nodes[i]);
+
+		StressTestThread* threads[kMaxTestThreads] = {};
+		for(int i = 0; i < numThreads; i++)
+			threads[i] = NEW StackPopPushThread<Stack, Node> (stack, i, kIterations);
+
+		StressTestResult result = runStressTestThreads (threads, numThreads);
+
+		int numNodes = 0;
+		while(stack.pop ())
+			numNodes++;
+
+		if(result.numErrors != 0 || numNodes != kNumNodes)
+		{
+			CORE_TEST_FAILED ("Stack corrupted by concurrent push and pop.")
+			succeeded = false;
+		}
+
+		CStringBuffer<STRING_STACK_SPACE_MAX> message;
+		message.appendFormat ("TaggedStack: %d threads, %.2f M ops/s", numThreads, result.getMegaOpsPerSecond ());
+		CORE_TEST_MESSAGE (message)
+	}
+
+	return succeeded;
+}
+
+//************************************************************************************************
+// AtomicStackTest
+//************************************************************************************************
+
+CORE_REGISTER_TEST (AtomicStackTest)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CStringPtr AtomicStackTest::getName () const
+{
+	return "Core Atomic Stack";
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class Stack>
+static bool testAtomicStack (ITestContext& testContext, CStringPtr name)
+{
+	static const int kIterations = 200000;
+	static const int kNumElements = 16;
+	bool succeeded = true;
+
+	AtomicStackTestElement elements[kNumElements];
+
+	for(int numThreads = 1; numThreads <= kMaxTestThreads; numThreads *= 2)
+	{
+		Stack stack;
+		for(int i = 0; i < kNumElements; i++)
+			stack.push (&elements[i]);
+
+		StressTestThread* threads[kMaxTestThreads] = {};
+		for(int i = 0; i < numThreads; i++)
+			threads[i] = NEW StackPopPushThread<Stack, AtomicStackTestElement> (stack, i, kIterations);
+
+		StressTestResult result = runStressTestThreads (threads, numThreads);
+
+		int depth = stack.depth ();
+		int numElements = 0;
+		while(Platform::AtomicStackElement* e = stack.pop ())
+		{
+			e->next = nullptr;
+			numElements++;
+		}
+
+		if(result.numErrors != 0 || depth != kNumElements || numElements != kNumElements)
+		{
+			CORE_TEST_FAILED ("Stack corrupted by concurrent push and pop.")
+			succeeded = false;
+		}
+
+		CStringBuffer<STRING_STACK_SPACE_MAX> message;
+		message.appendFormat ("%s: %d threads, %.2f M ops/s", name, numThreads, result.getMegaOpsPerSecond ());
+		CORE_TEST_MESSAGE (message)
+	}
+	return succeeded;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool AtomicStackTest::run (ITestContext& testContext)
+{
+	bool succeeded = true;
+	#if CORE_HAS_ATOMIC_STACK
+	if(!testAtomicStack<AtomicStack> (testContext, "AtomicStack"))
+		succeeded = false;
+	#endif
+	if(!testAtomicStack<AtomicStackLocked> (testContext, "AtomicStackLocked"))
+		succeeded = false;
+	return succeeded;
+}
@@ -36,6 +36,42 @@ public:
 	bool run (ITestContext& testContext) override;
 };
 
+//************************************************************************************************
+// LockFreeQueueTest
+//************************************************************************************************
+
+class LockFreeQueueTest: public TestBase
+{
+public:
+	// TestBase
+	CStringPtr getName () const override;
+	bool run (ITestContext& testContext) override;
+};
+
+//************************************************************************************************
+// LockFreeStackTest
+//************************************************************************************************
+
+class LockFreeStackTest: public TestBase
+{
+public:
+	// TestBase
+	CStringPtr getName () const override;
+	bool run (ITestContext& testContext) override;
+};
+
+//************************************************************************************************
+// AtomicStackTest
+//************************************************************************************************
+
+class AtomicStackTest: public TestBase
+{
+public:
+	// TestBase
+	CStringPtr getName () const override;
+	bool run (ITestContext& testContext) override;
+};
+
 } // namespace Test
 } // namespace Core
 
@@ -0,0 +1,345 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+// 
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : core/test/corebitmaptest.cpp
+// Description : Core Bitmap Manager Tests
+//
+//************************************************************************************************
+
+#include "corebitmaptest.h"
+
+#include "core/portable/gui/corebitmap.h"
+#include "core/portable/corefile.h"
+
+#include "core/system/coretime.h"
+
+namespace Core {
+namespace Test {
+
+// 8x8 RGBA image with a different color per pixel
+static const uint8 kTestPNG[] =
+{
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x08, 0x08, 0x06, 0x00, 0x00, 0x00, 0xc4, 0x0f, 0xbe,
+	0x8b, 0x00, 0x00, 0x00, 0xa0, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x0d, 0xca, 0xd1, 0x00, 0x04,
+	0x31, 0x0c, 0x45, 0xd1, 0x20, 0x0c, 0x42, 0x10, 0x06, 0x21, 0x08, 0x45, 0x78, 0x08, 0x45, 0x08,
+	0x42, 0x11, 0x82, 0x30, 0x08, 0x41, 0x58, 0x84, 0x98, 0xdc, 0xed, 0xf9, 0x3e, 0x66, 0x66, 0xb8,
+	0x3d, 0x84, 0x39, 0xb2, 0x97, 0xb4, 0xa0, 0x6c, 0xd1, 0x26, 0xc6, 0x36, 0x66, 0xfe, 0xe0, 0xee,
+	0x84, 0xbf, 0xc8, 0x83, 0xf4, 0x45, 0xb9, 0x68, 0xdf, 0x8c, 0xe7, 0x0d, 0xe1, 0x78, 0xbc, 0x44,
+	0x04, 0x8a, 0x45, 0x86, 0xa8, 0xd8, 0x74, 0x24, 0x13, 0xe7, 0x06, 0xbd, 0xb8, 0x82, 0xd0, 0x42,
+	0x12, 0xa9, 0x4d, 0x29, 0x69, 0x1d, 0x46, 0x75, 0x43, 0x06, 0x9e, 0x8b, 0x48, 0xa1, 0xdc, 0x64,
+	0x26, 0x95, 0x87, 0xce, 0x62, 0xf2, 0xbb, 0xa1, 0x16, 0x5e, 0x22, 0x6a, 0xa3, 0x4a, 0xb2, 0x0e,
+	0x55, 0x45, 0xd7, 0xc7, 0x54, 0xdf, 0xd0, 0xc2, 0x7b, 0x13, 0x9d, 0xa8, 0x0f, 0xd9, 0x45, 0xf5,
+	0x47, 0x77, 0x33, 0xfd, 0xbb, 0x61, 0x36, 0x3e, 0x49, 0xcc, 0x41, 0x53, 0xe4, 0x7c, 0xd4, 0x34,
+	0x3d, 0x3f, 0x66, 0x86, 0x3f, 0xe3, 0x46, 0x93, 0xc1, 0x1b, 0xe9, 0x62, 0xdb, 0x00, 0x00, 0x00,
+	0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+static const int kNumTestBitmaps = 64;
+static const int kNumDecodeThreads = 2;
+
+//************************************************************************************************
+// BitmapTestPackage
+/** Bitmap list with kNumTestBitmaps entries, all files contain the same PNG image. */
+//************************************************************************************************
+
+class BitmapTestPackage: public Portable::FilePackage
+{
+public:
+	// FilePackage
+	bool fileExists (CStringPtr fileName) override
+	{
+		return ConstString (fileName) == Skin::FileNames::kBitmapFile1 || ConstString (fileName).endsWith (".png");
+	}
+
+	IO::Stream* openStream (CStringPtr fileName) override
+	{
+		if(!fileExists (fileName))
+			return nullptr;
+
+		IO::MemoryStream* stream = NEW IO::MemoryStream;
+		if(ConstString (fileName) == Skin::FileNames::kBitmapFile1)
+		{
+			stream->writeBytes ("[", 1);
+			for(int i = 0; i < kNumTestBitmaps; i++)
+			{
+				CString64 entry;
+				entry.appendFormat ("%s{\"name\": \"bitmap%d\", \"file\": \"bitmap%d.png\"}", i > 0 ? ", " : "", i, i);
+				stream->writeBytes (entry.str (), entry.length ());
+			}
+			stream->writeBytes ("]", 1);
+		}
+		else
+			stream->writeBytes (kTestPNG, sizeof(kTestPNG));
+
+		stream->setPosition (0, IO::kSeekSet);
+		return stream;
+	}
+};
+
+//************************************************************************************************
+// BitmapLoadedCounter
+//************************************************************************************************
+
+struct BitmapLoadedCounter: Portable::BitmapManagerObserver
+{
+	int count = 0;
+
+	// BitmapManagerObserver
+	void onDelayLoadingBitmap (CStringPtr filename) override {}
+	void onBitmapLoaded (CStringPtr filename) override { count++; }
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static Portable::Bitmap* loadReferenceBitmap ()
+{
+	IO::MemoryStream stream;
+	stream.writeBytes (kTestPNG, sizeof(kTestPNG));
+	stream.setPosition (0, IO::kSeekSet);
+	return Portable::Bitmap::loadPNGImage (stream, kBitmapRGBAlpha, false);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool isEqualBitmap (const Portable::Bitmap* bitmap, const Portable::Bitmap& reference)
+{
+	if(bitmap == nullptr || bitmap->getWidth () != reference.getWidth () || bitmap->getHeight () != reference.getHeight ()
+		|| bitmap->getFormat () != reference.getFormat ())
+		return false;
+
+	const BitmapData& data = bitmap->accessForRead ();
+	const BitmapData& referenceData = reference.accessForRead ();
+	int rowSize = data.width * data.bitsPerPixel / 8;
+	for(int y = 0; y < data.height; y++)
+		if(::memcmp (data.getScanline (y), referenceData.getScanline (y), rowSize) != 0)
+			return false;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool isFilledBitmap (const Portable::Bitmap* bitmap, uint8 value)
+{
+	if(bitmap == nullptr)
+		return false;
+
+	const BitmapData& data = bitmap->accessForRead ();
+	int rowSize = data.width * data.bitsPerPixel / 8;
+	for(int y = 0; y < data.height; y++)
+	{
+		const uint8* row = static_cast<const uint8*> (data.getScanline (y));
+		for(int i = 0; i < rowSize; i++)
+			if(row[i] != value)
+				return false;
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool checkAllBitmaps (Portable::BitmapManager& manager, const Portable::Bitmap& reference)
+{
+	for(int i = 0; i < kNumTestBitmaps; i++)
+	{
+		CString32 name;
+		name.appendFormat ("bitmap%d", i);
+		if(!isEqualBitmap (manager.getBitmap (name).getBitmap (), reference))
+			return false;
+	}
+	return true;
+}
+
+} // namespace Test
+} // namespace Core
+
+using namespace Core;
+using namespace Portable;
+using namespace Test;
+
+//************************************************************************************************
+// BitmapDecodingTest
+//************************************************************************************************
+
+CORE_REGISTER_TEST (BitmapDecodingTest)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CStringPtr BitmapDecodingTest::getName () const
+{
+	return "Core Bitmap Decoding";
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool BitmapDecodingTest::run (ITestContext& testContext)
+{
+	bool succeeded = true;
+
+	Bitmap* reference = loadReferenceBitmap ();
+	if(reference == nullptr)
+	{
+		CORE_TEST_FAILED ("Test image could not be decoded.")
+		return false;
+	}
+	Deleter<Bitmap> referenceDeleter (reference);
+
+	BitmapTestPackage package;
+
+	// decode on first use after workers have been terminated
+	{
+		BitmapManager manager;
+		manager.setNumDecodeThreads (kNumDecodeThreads);
+		manager.loadBitmaps (package, true);
+
+		double startTime = SystemClock::getSeconds ();
+		manager.terminate ();
+		if(SystemClock::getSeconds () - startTime > 2.)
+		{
+			CORE_TEST_FAILED ("Terminating decode workers blocked.")
+			succeeded = false;
+		}
+
+		if(!checkAllBitmaps (manager, *reference))
+		{
+			CORE_TEST_FAILED ("Bitmap not decoded on first use after terminate.")
+			succeeded = false;
+		}
+	}
+
+	// wait for workers decoding the requested bitmap
+	{
+		BitmapManager manager;
+		manager.setNumDecodeThreads (kNumDecodeThreads);
+		manager.loadBitmaps (package, true);
+
+		if(!checkAllBitmaps (manager, *reference))
+		{
+			CORE_TEST_FAILED ("Bitmap not decoded on first use while workers are running.")
+			succeeded = false;
+		}
+	}
+
+	// placeholders are returned immediately, decoded pixels are swapped in by idle ()
+	{
+		BitmapManager manager;
+		manager.setNumDecodeThreads (kNumDecodeThreads);
+		manager.setPlaceholdersEnabled (true);
+		BitmapLoadedCounter counter;
+		manager.addObserver (&counter);
+		manager.loadBitmaps (package, true);
+
+		Bitmap* placeholders[kNumTestBitmaps] = {};
+		for(int i = 0; i < kNumTestBitmaps; i++)
+		{
+			CString32 name;
+			name.appendFormat ("bitmap%d", i);
+			placeholders[i] = manager.getBitmap (name).getBitmap ();
+		}
+
+		double startTime = SystemClock::getSeconds ();
+		while(counter.count < kNumTestBitmaps && SystemClock::getSeconds () - startTime < 10.)
+		{
+			manager.idle ();
+			Threads::CurrentThread::sleep (1);
+		}
+
+		if(counter.count != kNumTestBitmaps)
+		{
+			CORE_TEST_FAILED ("Placeholders not decoded in background.")
+			succeeded = false;
+		}
+		for(int i = 0; i < kNumTestBitmaps; i++)
+			if(!isEqualBitmap (placeholders[i], *reference))
+			{
+				CORE_TEST_FAILED ("Decoded pixels not swapped into placeholder.")
+				succeeded = false;
+				break;
+			}
+		manager.removeObserver (&counter);
+	}
+
+	// placeholders still pending after terminate are decoded on first use
+	{
+		BitmapManager manager;
+		manager.setNumDecodeThreads (kNumDecodeThreads);
+		manager.setPlaceholdersEnabled (true);
+		manager.loadBitmaps (package, true);
+		manager.terminate ();
+
+		if(!checkAllBitmaps (manager, *reference))
+		{
+			CORE_TEST_FAILED ("Placeholder not decoded on first use after terminate.")
+			succeeded = false;
+		}
+	}
+
+	// warm start from pixel cache
+	{
+		FileName cacheFolder;
+		FileUtils::getTempDir (cacheFolder);
+		cacheFolder.descend ("corebitmaptest");
+		FileUtils::removeDirectoryTree (cacheFolder);
+
+		{
+			BitmapManager manager;
+			manager.setNumDecodeThreads (kNumDecodeThreads);
+			manager.setCacheFolder (cacheFolder);
+			manager.loadBitmaps (package, true);
+			if(!checkAllBitmaps (manager, *reference))
+			{
+				CORE_TEST_FAILED ("Bitmap not decoded with cache folder.")
+				succeeded = false;
+			}
+		}
+
+		// all files have the same content, so there is one cache file, replace its pixels
+		FileName cachePath;
+		FileIterator iterator (cacheFolder);
+		while(const FileIterator::Entry* entry = iterator.next ())
+			if(!entry->directory)
+				cachePath = entry->name;
+
+		IO::MemoryStream* cacheData = cachePath.isEmpty () ? nullptr : FileUtils::loadFile (cachePath);
+		int headerSize = cacheData ? (int)cacheData->getBytesWritten () - (int)reference->getBufferSize () : -1;
+		if(headerSize <= 0)
+		{
+			CORE_TEST_FAILED ("Decoded pixels not written to cache folder.")
+			succeeded = false;
+		}
+		else
+		{
+			static const uint8 kMarker = 0x5A;
+			IO::MemoryStream modifiedData;
+			modifiedData.writeBytes (cacheData->getBuffer ().getAddress (), headerSize);
+			for(uint32 i = 0; i < reference->getBufferSize (); i++)
+				modifiedData.writeBytes (&kMarker, 1);
+			FileUtils::saveFile (cachePath, modifiedData);
+
+			BitmapManager manager;
+			manager.setNumDecodeThreads (kNumDecodeThreads);
+			manager.setCacheFolder (cacheFolder);
+			manager.loadBitmaps (package, true);
+			if(!isFilledBitmap (manager.getBitmap ("bitmap0").getBitmap (), kMarker))
+			{
+				CORE_TEST_FAILED ("Bitmap not restored from cache folder.")
+				succeeded = false;
+			}
+		}
+		delete cacheData;
+
+		FileUtils::removeDirectoryTree (cacheFolder);
+	}
+
+	return succeeded;
+}
@@ -0,0 +1,42 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+// 
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : core/test/corebitmaptest.h
+// Description : Core Bitmap Manager Tests
+//
+//************************************************************************************************
+
+#ifndef _corebitmaptest_h
+#define _corebitmaptest_h
+
+#include "coretestbase.h"
+
+namespace Core {
+namespace Test {
+
+//************************************************************************************************
+// BitmapDecodingTest
+//************************************************************************************************
+
+class BitmapDecodingTest: public TestBase
+{
+public:
+	// TestBase
+	CStringPtr getName () const override;
+	bool run (ITestContext& testContext) override;
+};
+
+} // namespace Test
+} // namespace Core
+
+#endif // _corebitmaptest_h
@@ -19,6 +19,53 @@
 #include "corenetworktest.h"
 
 #include "core/network/corenetwork.h"
+#include "core/network/coresocketreactor.h"
+
+#include "core/system/coretime.h"
+#include "core/public/corestringbuffer.h"
+
+namespace Core {
+namespace Test {
+
+//************************************************************************************************
+// ReactorTestHandler
+//************************************************************************************************
+
+class ReactorTestHandler: public Sockets::ISocketEventHandler
+{
+public:
+	ReactorTestHandler (Sockets::Socket* socket = nullptr)
+	: socket (socket),
+	  calls (0),
+	  bytesReceived (0)
+	{}
+
+	int getCalls () const { return calls; }
+	int getBytesReceived () const { return bytesReceived; }
+
+	// ISocketEventHandler
+	void onSocketEvent (Sockets::SocketID, int events) override
+	{
+		calls++;
+
+		// drain socket, required for edge-triggered registrations
+		if(socket && (events & Sockets::SocketEvent::kReadable))
+		{
+			char buffer[256];
+			int count = 0;
+			while((count = socket->receive (buffer, sizeof(buffer))) > 0)
+				bytesReceived += count;
+		}
+	}
+
+protected:
+	Sockets::Socket* socket;
+	int calls;
+	int bytesReceived;
+};
+
+} // namespace Test
+} // namespace Core
 
 using namespace Core;
 using namespace Sockets;
@@ -68,3 +115,136 @@ bool NetworkTest::run (ITestContext& testContext)
 	
 	return succeeded;
 }
+
+//************************************************************************************************
+// SocketReactorTest
+//************************************************************************************************
+
+CORE_REGISTER_TEST (SocketReactorTest)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CStringPtr SocketReactorTest::getName () const
+{
+	return "Core Socket Reactor";
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SocketReactorTest::run (ITestContext& testContext)
+{
+	if(!Network::startup ())
+	{
+		CORE_TEST_FAILED ("Failed to startup network.")
+		return false;
+	}
+
+	bool succeeded = true;
+	SocketReactor reactor;
+	if(!reactor.open ())
+	{
+		CORE_TEST_FAILED ("Failed to open socket reactor.")
+		Network::shutdown ();
+		return false;
+	}
+
+	// connected pair of TCP sockets on loopback
+	IPAddress address;
+	address.setIP (127, 0, 0, 1);
+	Socket listener (kInternet, kStream, kTCP);
+	listener.bind (address);
+	listener.listen (SocketOption::kMaxConnections);
+	listener.getLocalAddress (address);
+
+	Socket client (kInternet, kStream, kTCP);
+	client.connect (address);
+	Socket server (listener.accept ());
+	server.setOption (SocketOption::kNonBlocking, 1);
+
+	ReactorTestHandler handler (&server);
+	reactor.addSocket (server.getDescriptor (), SocketEvent::kReadable|SocketEvent::kEdgeTriggered, &handler);
+
+	if(reactor.poll (0) != 0)
+	{
+		succeeded = false;
+		CORE_TEST_FAILED ("Event reported for idle socket.")
+	}
+
+	static const char kData[] = "Hello Reactor";
+	client.sendAll (kData, sizeof(kData));
+	reactor.poll (1000);
+	if(handler.getCalls () != 1 || handler.getBytesReceived () != sizeof(kData))
+	{
+		succeeded = false;
+		CORE_TEST_FAILED ("Readable event not dispatched.")
+	}
+
+	reactor.poll (0);
+	if(handler.getCalls () != 1)
+	{
+		succeeded = false;
+		CORE_TEST_FAILED ("Event reported again for drained socket.")
+	}
+
+	// wakeup interrupts waiting
+	reactor.wakeup ();
+	double startTime = SystemClock::getSeconds ();
+	reactor.poll (5000);
+	if(SystemClock::getSeconds () - startTime > 1.)
+	{
+		succeeded = false;
+		CORE_TEST_FAILED ("Wakeup did not interrupt poll.")
+	}
+
+	reactor.removeSocket (server.getDescriptor ());
+	client.disconnect ();
+
+	// only the socket with pending data is reported from a larger set
+	static const int kNumSockets = 200;
+	Socket* sockets[kNumSockets] = {};
+	ReactorTestHandler* handlers[kNumSockets] = {};
+	for(int i = 0; i < kNumSockets; i++)
+	{
+		sockets[i] = NEW Socket (kInternet, kDatagram, kUDP);
+		sockets[i]->setOption (SocketOption::kNonBlocking, 1);
+		IPAddress localAddress;
+		localAddress.setIP (127, 0, 0, 1);
+		sockets[i]->bind (localAddress);
+		handlers[i] = NEW ReactorTestHandler (sockets[i]);
+		reactor.addSocket (sockets[i]->getDescriptor (), SocketEvent::kReadable, handlers[i]);
+	}
+
+	IPAddress targetAddress;
+	sockets[kNumSockets / 2]->getLocalAddress (targetAddress);
+	sockets[0]->sendTo (kData, sizeof(kData), targetAddress);
+
+	double pollStart = SystemClock::getSeconds ();
+	int handlerCalls = reactor.poll (1000);
+	double pollDuration = SystemClock::getSeconds () - pollStart;
+	if(handlerCalls != 1 || handlers[kNumSockets / 2]->getBytesReceived () != sizeof(kData))
+	{
+		succeeded = false;
+		CORE_TEST_FAILED ("Wrong events for socket set.")
+	}
+
+	CStringBuffer<STRING_STACK_SPACE_MAX> message;
+	message.appendFormat ("%s backend, %d sockets, poll took %.3f ms.", SocketReactor::isScalable () ? "epoll" : "select", reactor.countSockets (), pollDuration * 1000.);
+	CORE_TEST_MESSAGE (message);
+
+	for(int i = 0; i < kNumSockets; i++)
+	{
+		reactor.removeSocket (sockets[i]->getDescriptor ());
+		delete sockets[i];
+		delete handlers[i];
+	}
+
+	if(reactor.countSockets () != 0)
+	{
+		succeeded = false;
+		CORE_TEST_FAILED ("Sockets not removed.")
+	}
+
+	reactor.close ();
+	Network::shutdown ();
+	return succeeded;
+}
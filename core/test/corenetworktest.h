@@ -36,6 +36,18 @@ public:
 	bool run (ITestContext& testContext);
 };
 
+//************************************************************************************************
+// SocketReactorTest
+//************************************************************************************************
+
+class SocketReactorTest: public TestBase
+{
+public:
+	// TestBase
+	CStringPtr getName () const;
+	bool run (ITestContext& testContext);
+};
+
 } // namespace Test
 } // namespace Core
 
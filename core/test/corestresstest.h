@@ -0,0 +1,114 @@
+//************************************************************************************************
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : corestresstest.h
+// Description : Multi-threaded Test Helpers
+//
+//************************************************************************************************
+
+#ifndef _corestresstest_h
+#define _corestresstest_h
+
+#include "core/system/corethread.h"
+#include "core/system/coretime.h"
+
+namespace Core {
+namespace Test {
+
+//************************************************************************************************
+// StressTestThread
+/** Thread running one operation per iteration, counts operations and detected errors. */
+//************************************************************************************************
+
+class StressTestThread: public Threads::Thread
+{
+public:
+	StressTestThread (CStringPtr name, int index, int iterations)
+	: Thread (name),
+	  index (index),
+	  iterations (iterations),
+	  count (0),
+	  numErrors (0)
+	{}
+
+	int getCount () const { return count; }
+	int getNumErrors () const { return numErrors; }
+
+	// Thread
+	int threadEntry () override
+	{
+		for(int i = 0; i < iterations; i++)
+			run (i);
+		return true;
+	}
+
+protected:
+	int index;
+	int iterations;
+	int count;
+	int numErrors;
+
+	/** Perform one iteration, increment count for each completed operation. */
+	virtual void run (int iteration) = 0;
+};
+
+//************************************************************************************************
+// StressTestResult
+//************************************************************************************************
+
+struct StressTestResult
+{
+	int count = 0;
+	int numErrors = 0;
+	double duration = 0.;	///< in seconds
+
+	double getMegaOpsPerSecond (int opsPerCount = 2) const
+	{
+		return duration > 0. ? double (opsPerCount) * count / duration / 1000000. : 0.;
+	}
+};
+
+//************************************************************************************************
+// runStressTestThreads
+/** Start all threads, wait for them to finish, collect their results and delete them. */
+//************************************************************************************************
+
+template <class T>
+StressTestResult runStressTestThreads (T* threads[], int numThreads)
+{
+	StressTestResult result;
+
+	double startTime = SystemClock::getSeconds ();
+	for(int i = 0; i < numThreads; i++)
+		threads[i]->start ();
+
+	for(int i = 0; i < numThreads; i++)
+	{
+		threads[i]->join (Threads::kWaitForever);
+		result.count += threads[i]->getCount ();
+		result.numErrors += threads[i]->getNumErrors ();
+	}
+	result.duration = SystemClock::getSeconds () - startTime;
+
+	for(int i = 0; i < numThreads; i++)
+	{
+		delete threads[i];
+		threads[i] = nullptr;
+	}
+	return result;
+}
+
+} // namespace Test
+} // namespace Core
+
+#endif // _corestresstest_h
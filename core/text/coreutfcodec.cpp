@@ -18,6 +18,14 @@
 
 #include "coreutfcodec.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define CORE_UTF_SSE2 1
+	#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define CORE_UTF_NEON 1
+	#include <arm_neon.h>
+#endif
+
 namespace Core { 
 namespace Text {
 namespace UTFCodec {
@@ -279,3 +287,203 @@ int UTFCodec::encodeUTF16 (uchar32 c, unsigned char* destBuffer, int destSize, i
 	}
 	return kIllegalInput;
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Block functions
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int UTFCodec::countASCII (const unsigned char* source, int length)
+{
+	int i = 0;
+
+	#if CORE_UTF_SSE2
+	const __m128i zero = _mm_setzero_si128 ();
+	for(; i + 16 <= length; i += 16)
+	{
+		__m128i v = _mm_loadu_si128 ((const __m128i*)(source + i));
+		if(_mm_movemask_epi8 (_mm_or_si128 (v, _mm_cmpeq_epi8 (v, zero))) != 0)
+			break;
+	}
+	#elif CORE_UTF_NEON
+	const uint8x16_t one = vdupq_n_u8 (1);
+	for(; i + 16 <= length; i += 16)
+		if(vmaxvq_u8 (vsubq_u8 (vld1q_u8 (source + i), one)) > 0x7E) // null wraps around
+			break;
+	#endif
+
+	while(i < length && source[i] != 0 && source[i] < 0x80)
+		i++;
+	return i;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <int kMax>
+inline int countBelow (const uchar* source, int length)
+{
+	int i = 0;
+
+	#if CORE_UTF_SSE2
+	const __m128i zero = _mm_setzero_si128 ();
+	const __m128i mask = _mm_set1_epi16 ((short)~kMax);
+	for(; i + 8 <= length; i += 8)
+	{
+		__m128i v = _mm_loadu_si128 ((const __m128i*)(source + i));
+		__m128i inRange = _mm_andnot_si128 (_mm_cmpeq_epi16 (v, zero), _mm_cmpeq_epi16 (_mm_and_si128 (v, mask), zero));
+		if(_mm_movemask_epi8 (inRange) != 0xFFFF)
+			break;
+	}
+	#elif CORE_UTF_NEON
+	const uint16x8_t one = vdupq_n_u16 (1);
+	for(; i + 8 <= length; i += 8)
+		if(vmaxvq_u16 (vsubq_u16 (vld1q_u16 ((const uint16_t*)source + i), one)) > kMax - 1) // null wraps around
+			break;
+	#endif
+
+	while(i < length && source[i] != 0 && source[i] <= kMax)
+		i++;
+	return i;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int UTFCodec::countASCII (const uchar* source, int length)
+{
+	return countBelow<0x7F> (source, length);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int UTFCodec::countLatin1 (const uchar* source, int length)
+{
+	return countBelow<0xFF> (source, length);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UTFCodec::widenLatin1 (uchar* dest, const unsigned char* source, int length)
+{
+	int i = 0;
+
+	#if CORE_UTF_SSE2
+	const __m128i zero = _mm_setzero_si128 ();
+	for(; i + 16 <= length; i += 16)
+	{
+		__m128i v = _mm_loadu_si128 ((const __m128i*)(source + i));
+		_mm_storeu_si128 ((__m128i*)(dest + i), _mm_unpacklo_epi8 (v, zero));
+		_mm_storeu_si128 ((__m128i*)(dest + i + 8), _mm_unpackhi_epi8 (v, zero));
+	}
+	#elif CORE_UTF_NEON
+	for(; i + 16 <= length; i += 16)
+	{
+		uint8x16_t v = vld1q_u8 (source + i);
+		vst1q_u16 ((uint16_t*)dest + i, vmovl_u8 (vget_low_u8 (v)));
+		vst1q_u16 ((uint16_t*)dest + i + 8, vmovl_u8 (vget_high_u8 (v)));
+	}
+	#endif
+
+	for(; i < length; i++)
+		dest[i] = source[i];
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UTFCodec::narrowLatin1 (unsigned char* dest, const uchar* source, int length)
+{
+	int i = 0;
+
+	#if CORE_UTF_SSE2
+	for(; i + 16 <= length; i += 16)
+	{
+		__m128i low = _mm_loadu_si128 ((const __m128i*)(source + i));
+		__m128i high = _mm_loadu_si128 ((const __m128i*)(source + i + 8));
+		_mm_storeu_si128 ((__m128i*)(dest + i), _mm_packus_epi16 (low, high));
+	}
+	#elif CORE_UTF_NEON
+	for(; i + 16 <= length; i += 16)
+	{
+		uint8x8_t low = vmovn_u16 (vld1q_u16 ((const uint16_t*)source + i));
+		uint8x8_t high = vmovn_u16 (vld1q_u16 ((const uint16_t*)source + i + 8));
+		vst1q_u8 (dest + i, vcombine_u8 (low, high));
+	}
+	#endif
+
+	for(; i < length; i++)
+		dest[i] = (unsigned char)source[i];
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int UTFCodec::convertUTF8ToUTF16 (uchar* dest, int destSize, const unsigned char* source, int sourceLength)
+{
+	int count = 0;
+	for(int i = 0; i < sourceLength;)
+	{
+		int run = countASCII (source + i, sourceLength - i);
+		if(run > 0)
+		{
+			if(dest && count < destSize)
+				widenLatin1 (dest + count, source + i, run < destSize - count ? run : destSize - count);
+			i += run;
+			count += run;
+			continue;
+		}
+
+		uchar32 c = 0;
+		int used = decodeUTF8 (c, source + i, sourceLength - i);
+		if(used <= 0 || used > 4 || c > 0x10FFFF || (c >= 0xD800 && c < 0xE000))
+			return kIllegalInput;
+		i += used;
+
+		if(c < 0x10000)
+		{
+			if(dest && count < destSize)
+				dest[count] = (uchar)c;
+			count++;
+		}
+		else
+		{
+			if(dest && count + 2 <= destSize)
+			{
+				dest[count] = (uchar)(0xD800 + ((c - 0x10000) >> 10));
+				dest[count + 1] = (uchar)(0xDC00 + ((c - 0x10000) & 0x3FF));
+			}
+			count += 2;
+		}
+	}
+	return count;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int UTFCodec::convertUTF16ToUTF8 (unsigned char* dest, int destSize, const uchar* source, int sourceLength)
+{
+	int count = 0;
+	for(int i = 0; i < sourceLength;)
+	{
+		int run = countASCII (source + i, sourceLength - i);
+		if(run > 0)
+		{
+			if(dest && count < destSize)
+				narrowLatin1 (dest + count, source + i, run < destSize - count ? run : destSize - count);
+			i += run;
+			count += run;
+			continue;
+		}
+
+		uchar32 c = source[i++];
+		if(c >= 0xD800 && c < 0xE000)
+		{
+			if(!isHighSurrogateUTF16 ((uchar)c) || i >= sourceLength || !isLowSurrogateUTF16 (source[i]))
+				return kIllegalInput;
+			c = makeSurrogatePairUTF16 ((uchar)c, source[i++]);
+		}
+
+		unsigned char buffer[4];
+		int used = encodeUTF8 (c, buffer, 4);
+		if(dest && count + used <= destSize)
+			::memcpy (dest + count, buffer, used);
+		count += used;
+	}
+	return count;
+}
@@ -56,6 +56,18 @@ namespace UTFCodec
 
 	typedef int (*DecodeFunction) (uchar32& c, const unsigned char* sourceBuffer, int sourceSize);
 	typedef int (*EncodeFunction) (uchar32 c, unsigned char* destBuffer, int destSize);
+
+	// block functions, vectorized with SSE2 or NEON where available
+	int countASCII (const unsigned char* source, int length);	// number of leading characters in range 0x01..0x7F
+	int countASCII (const uchar* source, int length);			// number of leading characters in range 0x01..0x7F
+	int countLatin1 (const uchar* source, int length);			// number of leading characters in range 0x01..0xFF
+	void widenLatin1 (uchar* dest, const unsigned char* source, int length);
+	void narrowLatin1 (unsigned char* dest, const uchar* source, int length); // characters must be below 0x100
+
+	/** Strict conversion of a complete string, without null terminator. Returns the number of units
+		required or kIllegalInput for malformed input. Writes at most destSize units, dest can be null. */
+	int convertUTF8ToUTF16 (uchar* dest, int destSize, const unsigned char* source, int sourceLength);
+	int convertUTF16ToUTF8 (unsigned char* dest, int destSize, const uchar* source, int sourceLength);
 }
 
 //************************************************************************************************
@@ -212,8 +224,17 @@ namespace UTFFunctions
 	{
 		ASSERT (cStringLength >= 0)
 
-		UTF8Reader reader (cString, cStringLength);
-		UTF16Writer writer (uString, uStringSize);
+		// leading ASCII characters are converted in blocks
+		int count = UTFCodec::countASCII ((const unsigned char*)cString, cStringLength);
+		if(uString)
+		{
+			if(count > uStringSize)
+				count = uStringSize;
+			UTFCodec::widenLatin1 (uString, (const unsigned char*)cString, count);
+		}
+
+		UTF8Reader reader (cString + count, cStringLength - count);
+		UTF16Writer writer (uString ? uString + count : nullptr, uString ? uStringSize - count : 0);
 
 		uchar32 c = 0;
 		while((c = reader.getNext ()))
@@ -221,7 +242,7 @@ namespace UTFFunctions
 				break;
 
 		writer.finish ();
-		return writer.getLength ();
+		return count + writer.getLength ();
 	}
 
 	/** Encode UTF-16 to UTF-8. */
@@ -229,8 +250,17 @@ namespace UTFFunctions
 	{
 		ASSERT (uStringLength >= 0)
 
-		UTF16Reader reader (uString, uStringLength);
-		UTF8Writer writer (cString, cStringSize);
+		// leading ASCII characters are converted in blocks
+		int count = UTFCodec::countASCII (uString, uStringLength);
+		if(cString)
+		{
+			if(count > cStringSize)
+				count = cStringSize;
+			UTFCodec::narrowLatin1 ((unsigned char*)cString, uString, count);
+		}
+
+		UTF16Reader reader (uString + count, uStringLength - count);
+		UTF8Writer writer (cString ? cString + count : nullptr, cString ? cStringSize - count : 0);
 
 		uchar32 c = 0;
 		while((c = reader.getNext ()))
@@ -238,7 +268,7 @@ namespace UTFFunctions
 				break;
 
 		writer.finish ();
-		return writer.getLength ();
+		return count + writer.getLength ();
 	}
 }
 
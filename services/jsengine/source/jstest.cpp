@@ -163,6 +163,52 @@ bool TestClass::runTest (Engine* engine)
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+CCL_TEST_F (JsTest, TestNativeMemberPerformance)
+{
+	static const int kNumIterations = 100000;
+
+	AutoPtr<Scripting::IContext> context = engine->createContext ();
+	context->attachModule (System::GetCurrentModuleRef ());
+
+	AutoPtr<TestClass> gTest = NEW TestClass;
+	context->registerObject ("gTest", gTest);
+
+	static CStringPtr code =
+		"function test (count)"
+		"{"
+		"  var sum = 0;"
+		"  for(var i = 0; i < count; i++)"
+		"  {"
+		"    gTest.width = i;"
+		"    sum += gTest.width;"
+		"    gTest.getChild ();"
+		"  }"
+		"  return sum;"
+		"}";
+
+	String codeString (code);
+	StringChars codeChars (codeString);
+	Scripting::CodePiece codePiece (codeChars, codeString.length (), CCLSTR ("Benchmark"));
+	TestScript script (codePiece);
+
+	AutoPtr<IObject> scriptObject = context->compileScript (script);
+	CCL_TEST_ASSERT (scriptObject != nullptr);
+	if(scriptObject)
+	{
+		Variant returnValue;
+		double startTime = System::GetProfileTime ();
+		scriptObject->invokeMethod (returnValue, Message ("test", kNumIterations));
+		double duration = System::GetProfileTime () - startTime;
+
+		CCL_TEST_ASSERT_EQUAL (returnValue.asDouble (), (double)kNumIterations * (kNumIterations - 1) / 2);
+		Debugger::printf ("Native member access from script: %.0f calls/s\n", 3 * kNumIterations / duration);
+	}
+
+	context->detachModule (System::GetCurrentModuleRef ());
+}
+
 //************************************************************************************************
 // TestClass
 //************************************************************************************************
@@ -195,8 +241,9 @@ TestClass::~TestClass ()
 
 tbool CCL_API TestClass::getProperty (Variant& var, MemberID propertyId) const
 {
-	if(propertyId == "width")
+	MEMBER_SWITCH (propertyId)
 	{
+	MEMBER_CASE ("width")
 		var = width;
 		return true;
 	}
@@ -207,8 +254,9 @@ tbool CCL_API TestClass::getProperty (Variant& var, MemberID propertyId) const
 
 tbool CCL_API TestClass::setProperty (MemberID propertyId, const Variant& var)
 {
-	if(propertyId == "width")
+	MEMBER_SWITCH (propertyId)
 	{
+	MEMBER_CASE ("width")
 		width = var;
 		return true;
 	}
@@ -219,29 +267,29 @@ tbool CCL_API TestClass::setProperty (MemberID propertyId, const Variant& var)
 
 tbool CCL_API TestClass::invokeMethod (Variant& returnValue, MessageRef msg)
 {
-	if(msg == "TestClass") // ctor!
+	MEMBER_SWITCH (msg.getID ())
 	{
+	MEMBER_CASE ("TestClass") // ctor!
 		for(int i = 0; i < msg.getArgCount (); i++)
 		{
 			short type = msg[i].getType ();
 			type = type;
 		}
 		return true;
-	}
-	else if(msg == "sayHello")
-	{
-		String string = msg[0];
-		if(!string.isEmpty ())
-			Debugger::print (string);
+
+	MEMBER_CASE ("sayHello")
+		{
+			String string = msg[0];
+			if(!string.isEmpty ())
+				Debugger::print (string);
+		}
 		return true;
-	}
-	else if(msg == "getChild")
-	{
+
+	MEMBER_CASE ("getChild")
 		if(!child)
 			child = NEW TestClass;
 		returnValue = (IObject*)child;
 		return true;
 	}
-	else
-		return Object::invokeMethod (returnValue, msg);
+	return Object::invokeMethod (returnValue, msg);
 }